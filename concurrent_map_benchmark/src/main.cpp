@@ -0,0 +1,186 @@
+#include <gsl/container/concurrent_map.hpp>
+
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <latch>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// Measures container::ConcurrentMap (the symbol tables of ast::Module) against a mutex-guarded std::unordered_map
+// under the load of linking modules in parallel: every thread mostly looks symbols up and sometimes registers one.
+// Writes one tab separated line per map: name, threads, operations, milliseconds, million operations per second.
+//
+// concurrent_map_benchmark [threads (32)] [operations per thread (200000)] [percent of insertions (10)]
+namespace
+{
+	namespace gsl = gal::gsl;
+
+	struct options
+	{
+		unsigned threads = 32;
+		std::size_t operations = 200'000;
+		unsigned insert_percent = 10;
+	};
+
+	// the symbols every thread looks up
+	constexpr std::size_t preloaded = 10'000;
+
+	[[nodiscard]] auto symbol_name(const std::string_view prefix, const std::size_t index) -> std::string
+	{
+		auto name = std::string{prefix};
+		name.append(std::to_string(index));
+		return name;
+	}
+
+	// xorshift64, cheap enough not to weigh on the measure
+	[[nodiscard]] auto next_random(std::uint64_t& state) noexcept -> std::uint64_t
+	{
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		return state;
+	}
+
+	class ConcurrentTable
+	{
+		gsl::container::ConcurrentMap<std::string, int, std::hash<std::string_view>> map_;
+
+	public:
+		[[nodiscard]] static auto name() noexcept -> std::string_view { return "concurrent_map"; }
+
+		auto insert(std::string&& key, const int value) -> void { (void)map_.try_emplace(std::move(key), [value](const auto&) { return value; }); }
+
+		[[nodiscard]] auto find(const std::string& key) const -> const int* { return map_.find(std::string_view{key}); }
+	};
+
+	template<typename Mutex>
+	class GuardedTable
+	{
+		// readers share a std::shared_mutex
+		using read_lock_type = std::conditional_t<std::is_same_v<Mutex, std::shared_mutex>, std::shared_lock<Mutex>, std::scoped_lock<Mutex>>;
+
+		std::unordered_map<std::string, int> map_;
+		mutable Mutex mutex_;
+
+	public:
+		[[nodiscard]] static auto name() noexcept -> std::string_view
+		{
+			if constexpr (std::is_same_v<Mutex, std::shared_mutex>) { return "shared_mutex_unordered_map"; }
+			else { return "mutex_unordered_map"; }
+		}
+
+		auto insert(std::string&& key, const int value) -> void
+		{
+			std::scoped_lock lock{mutex_};
+			(void)map_.try_emplace(std::move(key), value);
+		}
+
+		// the pointer stays valid, nothing is erased while measuring
+		[[nodiscard]] auto find(const std::string& key) const -> const int*
+		{
+			read_lock_type lock{mutex_};
+			const auto it = map_.find(key);
+			return it == map_.end() ? nullptr : &it->second;
+		}
+	};
+
+	template<typename Table>
+	auto measure(const options& o) -> void
+	{
+		Table table{};
+
+		std::vector<std::string> symbols{};
+		symbols.reserve(preloaded);
+		for (std::size_t i = 0; i < preloaded; ++i)
+		{
+			symbols.push_back(symbol_name("symbol_", i));
+			table.insert(symbol_name("symbol_", i), static_cast<int>(i));
+		}
+
+		// built ahead, a thread inserts only its own names
+		std::vector<std::vector<std::string>> registered(o.threads);
+		for (unsigned t = 0; t < o.threads; ++t)
+		{
+			registered[t].reserve(o.operations * o.insert_percent / 100 + 1);
+			for (std::size_t i = 0; i < o.operations * o.insert_percent / 100 + 1; ++i) { registered[t].push_back(symbol_name("module_" + std::to_string(t) + "::symbol_", i)); }
+		}
+
+		std::latch ready{static_cast<std::ptrdiff_t>(o.threads) + 1};
+		std::latch start{1};
+		std::atomic<std::size_t> found{0};
+
+		std::chrono::steady_clock::duration elapsed{};
+		{
+			std::vector<std::jthread> workers{};
+			for (unsigned t = 0; t < o.threads; ++t)
+			{
+				workers.emplace_back(
+						[&, t]
+						{
+							auto state = std::uint64_t{0x9e3779b97f4a7c15} ^ (t + 1);
+							auto& names = registered[t];
+							std::size_t inserted = 0;
+							std::size_t hits = 0;
+
+							ready.count_down();
+							start.wait();
+
+							for (std::size_t i = 0; i < o.operations; ++i)
+							{
+								const auto random = next_random(state);
+								if (random % 100 < o.insert_percent && inserted != names.size()) { table.insert(std::move(names[inserted++]), static_cast<int>(i)); }
+								else { hits += table.find(symbols[(random >> 8) % preloaded]) != nullptr; }
+							}
+
+							found.fetch_add(hits, std::memory_order_relaxed);
+						});
+			}
+
+			ready.arrive_and_wait();
+			const auto begin = std::chrono::steady_clock::now();
+			start.count_down();
+			workers.clear();
+			elapsed = std::chrono::steady_clock::now() - begin;
+		}
+
+		const auto total = static_cast<double>(o.operations) * o.threads;
+		const auto milliseconds = std::chrono::duration<double, std::milli>{elapsed}.count();
+		std::cout << Table::name() << '\t' << o.threads << '\t' << static_cast<std::size_t>(total) << '\t' << milliseconds << '\t' << total / milliseconds / 1000.0 << '\n';
+
+		// every lookup is of a preloaded symbol, also keeps them from being optimized away
+		if (found.load() == 0 && o.insert_percent < 100) { std::cerr << "nothing found by " << Table::name() << '\n'; }
+	}
+
+	[[nodiscard]] auto parse(const std::string_view text, auto& value) -> bool
+	{
+		const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+		return error == std::errc{} && end == text.data() + text.size();
+	}
+}
+
+auto main(const int argc, char* argv[]) -> int
+{
+	options o{};
+
+	if ((argc > 1 && !parse(argv[1], o.threads)) || (argc > 2 && !parse(argv[2], o.operations)) || (argc > 3 && !parse(argv[3], o.insert_percent)) || o.threads == 0 || o.insert_percent > 100)
+	{
+		std::cerr << "usage: " << argv[0] << " [threads (32)] [operations per thread (200000)] [percent of insertions (10)]\n";
+		return 1;
+	}
+
+	std::cout << "map\tthreads\toperations\tmilliseconds\tmillion operations per second\n";
+	measure<ConcurrentTable>(o);
+	measure<GuardedTable<std::mutex>>(o);
+	measure<GuardedTable<std::shared_mutex>>(o);
+
+	return 0;
+}
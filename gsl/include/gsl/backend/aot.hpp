@@ -0,0 +1,40 @@
+#pragma once
+
+#include <gsl/backend/type_check.hpp>
+
+namespace gal::gsl::ir
+{
+	struct aot_options
+	{
+		// the namespace of the generated code
+		symbol_name_view name_space = "gsl_aot";
+		// the name of the generated `auto name(gal::gsl::ast::Module& module) -> void`
+		symbol_name_view register_function = "register_module";
+	};
+
+	struct aot_error
+	{
+		symbol_name function;
+		// invalid_value ==> the function itself (its signature)
+		value_id value;
+		string::string message;
+	};
+
+	struct aot_result
+	{
+		// one translation unit, empty if anything failed
+		string::string source;
+		container::vector<aot_error> errors;
+
+		[[nodiscard]] auto success() const noexcept -> bool { return errors.empty(); }
+	};
+
+	// Translate the checked functions (see check_types) of the module into C++ to be compiled into the host.
+	// Every function becomes a native function using the same record layout (field offsets of ast::Structure) and Value ABI
+	// (see type::BuiltinFunction::make) as the interpreter, the calls between the functions of the module are direct calls.
+	// The generated register function declares each of them as an ast::BuiltinFunction in the given module,
+	// the structures of the records are looked up by name in that module (it throws std::invalid_argument if one is missing or laid out differently).
+	// A record is allocated like the records of the interpreter (see type::allocate_record), the collector scans it precisely.
+	// Not supported (yet): strings, globals and calls to functions outside the module.
+	[[nodiscard]] auto emit_cpp(const Module& module, const aot_options& options = {}) -> aot_result;
+}
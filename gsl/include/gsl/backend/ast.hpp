@@ -1,10 +1,16 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
 #include <gsl/string/string.hpp>
 #include <gsl/string/string_view.hpp>
 #include <gsl/container/vector.hpp>
 #include <gsl/container/unordered_map.hpp>
+#include <gsl/container/concurrent_map.hpp>
 #include <gsl/memory/memory.hpp>
+#include <gsl/type/function.hpp>
 #include <gsl/utility/utility.hpp>
 
 namespace gal::gsl::ast
@@ -67,6 +73,26 @@ namespace gal::gsl::ast
 			dimensions_{std::move(dimensions)} {}
 
 		[[nodiscard]] constexpr auto type() const noexcept -> variable_type { return type_; }
+
+		[[nodiscard]] constexpr auto owner() const noexcept -> Structure* { return owner_; }
+
+		// type[1][2][3] ==> {1, 2, 3}, empty if not an array
+		[[nodiscard]] constexpr auto dimensions() const noexcept -> const dimension_container_type& { return dimensions_; }
+
+		[[nodiscard]] constexpr auto is_array() const noexcept -> bool { return !dimensions_.empty(); }
+
+		// the product of the dimensions, 1 if not an array
+		[[nodiscard]] auto element_count() const noexcept -> std::size_t;
+
+		// the memory footprint of a variable of this type, arrays and structures are stored inline
+		[[nodiscard]] auto size() const noexcept -> std::size_t;
+		[[nodiscard]] auto alignment() const noexcept -> std::size_t;
+
+		// whether the collector has to scan a variable of this type
+		[[nodiscard]] auto contains_pointer() const noexcept -> bool;
+
+		// set the bit of every word (see memory::make_type_descriptor) that may hold a pointer in a variable of this type stored at offset
+		auto mark_pointers(container::vector<std::uintptr_t>& bitmap, std::size_t offset) const -> void;
 	};
 
 	class Variable final
@@ -134,24 +160,89 @@ namespace gal::gsl::ast
 		{
 			Variable::variable_declaration variable;
 			field_offset_type index;
+			// byte offset inside one record (natural alignment, declaration order)
+			std::size_t offset;
 		};
 
+		// how an array of this structure is stored
+		enum class layout_type
+		{
+			// one block of records
+			ARRAY_OF_STRUCTURES,
+			// every field in its own contiguous column, see `@soa struct name {...}`
+			STRUCTURE_OF_ARRAYS,
+		};
+
+		// identifies one structure object, see FieldInlineCache
+		// generations are drawn from one process-wide counter, no two structures ever share one (even at the same address)
+		using generation_type = std::uint64_t;
+
 	private:
 		symbol_name name_;
 		field_container_type fields_;
+		layout_type layout_;
+		// the end of the last field
+		std::size_t size_;
+		std::size_t alignment_;
+		generation_type generation_;
+
+		// built on first use, the fields must not change after that
+		mutable std::once_flag descriptor_flag_;
+		mutable memory::type_descriptor descriptor_;
+
+		auto do_register_field(Variable::variable_declaration&& variable) -> void;
+
+		[[nodiscard]] static auto next_generation() noexcept -> generation_type;
 
 	public:
 		explicit Structure(const symbol_name_view name)
-			: name_{name} {}
+			: name_{name},
+			layout_{layout_type::ARRAY_OF_STRUCTURES},
+			size_{0},
+			alignment_{1},
+			generation_{next_generation()},
+			descriptor_{0} {}
 
 		[[nodiscard]] auto get_name() const -> symbol_name_view { return name_; }
 
+		[[nodiscard]] auto get_generation() const noexcept -> generation_type { return generation_; }
+
+		[[nodiscard]] auto get_layout() const noexcept -> layout_type { return layout_; }
+
+		auto set_layout(const layout_type layout) noexcept -> void { layout_ = layout; }
+
+		[[nodiscard]] auto get_fields() const noexcept -> const field_container_type& { return fields_; }
+
+		// nullptr if not found
+		[[nodiscard]] auto get_field(symbol_name_view name) const noexcept -> const field_declaration*;
+
+		// the size of one record, padded to its alignment
+		[[nodiscard]] auto get_size() const noexcept -> std::size_t { return (size_ + alignment_ - 1) / alignment_ * alignment_; }
+
+		[[nodiscard]] auto get_alignment() const noexcept -> std::size_t { return alignment_; }
+
+		[[nodiscard]] auto contains_pointer() const noexcept -> bool;
+
+		// one bit per word of a record, set if the word may hold a pointer
+		[[nodiscard]] auto pointer_bitmap() const -> container::vector<std::uintptr_t>;
+
+		// for memory::allocate_typed, a record is scanned only where its strings (and nested records' strings) are
+		[[nodiscard]] auto get_type_descriptor() const -> memory::type_descriptor;
+
 		// this functions do not move from rvalue arguments if the insertion does not happen
 		auto register_field(symbol_name&& name, type_declaration_type&& type) -> bool;
 		// this functions do not move from rvalue arguments if the insertion does not happen
 		auto register_field(Variable::variable_declaration&& variable) -> bool;
 
 		auto register_field(symbol_name_view name, const type_declaration_type& type) -> bool;
+
+		// A field at a given offset instead of the next naturally aligned one (e.g. a member of a host type, see type::bind_structure).
+		// The fields may leave gaps, the record grows to the end of the field if needed.
+		// False if the name is taken, the offset is not aligned for the type or the field overlaps another one.
+		auto register_field(symbol_name_view name, const type_declaration_type& type, std::size_t offset) -> bool;
+
+		// a record is at least `size` bytes aligned to `alignment` (e.g. the host type itself, members not bound included)
+		auto reserve_layout(std::size_t size, std::size_t alignment) noexcept -> void;
 	};
 
 	class Function
@@ -159,11 +250,27 @@ namespace gal::gsl::ast
 	public:
 		using arguments_container_type = container::vector<variable_type>;
 
+		// source ==> body, see set_lazy_function_body
+		using body_parser_type = std::function<expression_type(const Function& function, std::string_view source)>;
+
 	private:
+		// the source of a body not parsed yet, shared by all the functions of the file
+		struct lazy_body
+		{
+			std::once_flag parsed;
+			std::atomic<bool> done;
+			memory::shared_ptr<const string::string> source;
+			std::size_t offset;
+			std::size_t size;
+			body_parser_type parser;
+		};
+
 		symbol_name name_;
 		arguments_container_type arguments_;
 		type_declaration_type return_type_;
-		expression_type function_body_;
+		// parsed on first use if lazy_body_ is set
+		mutable expression_type function_body_;
+		memory::shared_ptr<lazy_body> lazy_body_;
 
 	public:
 		explicit Function(
@@ -191,11 +298,51 @@ namespace gal::gsl::ast
 
 		[[nodiscard]] auto get_name() const -> symbol_name_view { return name_; }
 
+		[[nodiscard]] auto get_arguments() const noexcept -> const arguments_container_type& { return arguments_; }
+
+		[[nodiscard]] auto get_return_type() const noexcept -> const type_declaration_type& { return return_type_; }
+
 		auto set_arguments(arguments_container_type&& arguments) -> void { arguments_ = std::move(arguments); }
 
 		auto set_return_type(type_declaration_type return_type) -> void { return_type_ = std::move(return_type); }
 
-		auto set_function_body(expression_type&& function_body) -> void { function_body_ = std::move(function_body); }
+		auto set_function_body(expression_type&& function_body) -> void
+		{
+			function_body_ = std::move(function_body);
+			lazy_body_.reset();
+		}
+
+		// Record where the body is in the source (of the whole file), it is parsed by the parser the first time it is needed.
+		// Not thread safe with get_function_body, the declaration is set up before the function is used.
+		auto set_lazy_function_body(memory::shared_ptr<const string::string> source, std::size_t offset, std::size_t size, body_parser_type&& parser) -> void;
+
+		// whether the body is there without parsing anything
+		[[nodiscard]] auto is_function_body_parsed() const noexcept -> bool { return !lazy_body_ || lazy_body_->done.load(std::memory_order_acquire); }
+
+		// The body, parsed now if it is lazy and not parsed yet.
+		// Concurrent first uses parse it once, the others wait for it. A parser throwing leaves it lazy, the next use parses again.
+		[[nodiscard]] auto get_function_body() const -> const expression_type&;
+	};
+
+	// A host function declared in a module (e.g. a function compiled ahead of time, see ir::emit_cpp), it has no body.
+	class BuiltinFunction final : public Function
+	{
+	private:
+		type::BuiltinFunction function_;
+
+	public:
+		BuiltinFunction(
+				const symbol_name_view name,
+				arguments_container_type&& arguments,
+				type_declaration_type&& return_type,
+				const type::BuiltinFunction function
+				)
+			: Function{name, std::move(arguments), std::move(return_type)},
+			function_{function} {}
+
+		[[nodiscard]] constexpr auto is_builtin() const noexcept -> bool override { return true; }
+
+		[[nodiscard]] auto get_builtin() const noexcept -> const type::BuiltinFunction& { return function_; }
 	};
 
 	class Expression
@@ -210,24 +357,44 @@ namespace gal::gsl::ast
 	class Module : public memory::enable_shared_from_this<Module>
 	{
 	public:
+		// Registering symbols from several threads at once is safe (e.g. linking modules in parallel), lookups never wait.
+		// A symbol handed out stays alive as long as its module, even once redefined or unregistered.
 		template<typename T>
-		using symbol_table_type = container::unordered_map<symbol_name, T, utility::string_hasher<symbol_name>>;
+		using symbol_table_type = container::ConcurrentMap<symbol_name, T, utility::string_hasher<symbol_name>>;
+
+		// changed whenever a symbol is added or replaced, see InlineCache
+		// versions are drawn from one process-wide counter, no two modules ever share one (even at the same address)
+		using version_type = std::uint64_t;
 
 	private:
 		symbol_name name_;
 		symbol_table_type<structure_type> structures_;
 		symbol_table_type<variable_type> globals_;
 		symbol_table_type<function_type> functions_;
+		// `import name;` in declaration order, see frontend::ModuleRegistry
+		container::vector<symbol_name> imports_;
+		std::atomic<version_type> version_;
+
+		[[nodiscard]] static auto next_version() noexcept -> version_type;
 
 	public:
 		explicit Module(symbol_name&& name)
-			: name_{std::move(name)} {}
+			: name_{std::move(name)},
+			version_{next_version()} {}
 
 		explicit Module(const symbol_name_view name)
-			: name_{name} {}
+			: name_{name},
+			version_{next_version()} {}
 
 		[[nodiscard]] auto get_name() const -> symbol_name_view { return name_; }
 
+		[[nodiscard]] auto get_version() const noexcept -> version_type { return version_.load(std::memory_order_acquire); }
+
+		// false if already imported, the imports are registered while parsing the module (not thread safe)
+		[[nodiscard]] auto register_import(symbol_name&& name) -> bool;
+
+		[[nodiscard]] auto get_imports() const noexcept -> const container::vector<symbol_name>& { return imports_; }
+
 		// try_emplace: Unlike insert or emplace, this functions do not move from rvalue arguments if the insertion does not happen
 		[[nodiscard]] auto register_structure(symbol_name&& name) -> std::pair<bool, structure_type>;
 		[[nodiscard]] auto register_structure(const symbol_name_view name) -> std::pair<bool, structure_type> { return register_structure(symbol_name{name}); }
@@ -244,12 +411,26 @@ namespace gal::gsl::ast
 		[[nodiscard]] auto register_function(symbol_name&& name) -> std::pair<bool, function_type>;
 		[[nodiscard]] auto register_function(const symbol_name_view name) -> std::pair<bool, function_type> { return register_function(symbol_name{name}); }
 
+		// Replace (or add) a symbol, e.g. hot reload or a symbol injected by the host.
+		// Every InlineCache that resolved a symbol of this module will resolve again.
+		auto redefine_structure(symbol_name_view name, structure_type structure) -> void;
+		auto redefine_global(symbol_name_view name, variable_type global) -> void;
+		auto redefine_function(symbol_name_view name, function_type function) -> void;
+
+		// return whether the symbol existed, the declarations already handed out stay valid
+		auto unregister_global(symbol_name_view name) -> bool;
+		auto unregister_function(symbol_name_view name) -> bool;
+
+		// every symbol of the module, in no particular order
+		[[nodiscard]] auto get_structures() const noexcept -> const symbol_table_type<structure_type>& { return structures_; }
+		[[nodiscard]] auto get_globals() const noexcept -> const symbol_table_type<variable_type>& { return globals_; }
+		[[nodiscard]] auto get_functions() const noexcept -> const symbol_table_type<function_type>& { return functions_; }
+
 		[[nodiscard]] auto has_structure(const symbol_name_view name) const -> bool { return structures_.contains(name); }
 
 		[[nodiscard]] auto get_structure(const symbol_name_view name) const -> structure_type
 		{
-			if (const auto it = structures_.find(name);
-				it != structures_.end()) { return it->second; }
+			if (const auto* structure = structures_.find(name)) { return *structure; }
 			return nullptr;
 		}
 
@@ -257,8 +438,7 @@ namespace gal::gsl::ast
 
 		[[nodiscard]] auto get_global(const symbol_name_view name) const -> variable_type
 		{
-			if (const auto it = globals_.find(name);
-				it != globals_.end()) { return it->second; }
+			if (const auto* global = globals_.find(name)) { return *global; }
 			return nullptr;
 		}
 
@@ -266,8 +446,7 @@ namespace gal::gsl::ast
 
 		[[nodiscard]] auto get_function(const symbol_name_view name) const -> function_type
 		{
-			if (const auto it = functions_.find(name);
-				it != functions_.end()) { return it->second; }
+			if (const auto* function = functions_.find(name)) { return *function; }
 			return nullptr;
 		}
 	};
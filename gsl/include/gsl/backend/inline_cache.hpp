@@ -0,0 +1,189 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <gsl/backend/ast.hpp>
+
+namespace gal::gsl::ast
+{
+	enum class symbol_category
+	{
+		STRUCTURE,
+		GLOBAL,
+		FUNCTION,
+	};
+
+	namespace inline_cache_detail
+	{
+		template<symbol_category Category>
+		struct symbol_trait;
+
+		template<>
+		struct symbol_trait<symbol_category::STRUCTURE>
+		{
+			using value_type = Structure;
+
+			[[nodiscard]] static auto resolve(const Module& mod, const symbol_name_view name) -> value_type* { return mod.get_structure(name).get(); }
+		};
+
+		template<>
+		struct symbol_trait<symbol_category::GLOBAL>
+		{
+			using value_type = Variable;
+
+			[[nodiscard]] static auto resolve(const Module& mod, const symbol_name_view name) -> value_type* { return mod.get_global(name).get(); }
+		};
+
+		template<>
+		struct symbol_trait<symbol_category::FUNCTION>
+		{
+			using value_type = Function;
+
+			[[nodiscard]] static auto resolve(const Module& mod, const symbol_name_view name) -> value_type* { return mod.get_function(name).get(); }
+		};
+	}
+
+	// Name-based lookup of one site (an instruction, a host call site...).
+	// A hit is a compare of the module and its version plus a load, only a miss hashes the name.
+	// Ways == 1 is a monomorphic cache, otherwise the site remembers the last `Ways` modules it saw (round robin).
+	// The cached pointer is owned by the module, it stays valid as long as the module is alive and its version does not change.
+	// A module allocated where a destroyed one lived never has the same version (see Module::version_type), its entry just misses.
+	template<symbol_category Category, std::size_t Ways = 1>
+		requires(Ways != 0)
+	class InlineCache
+	{
+	public:
+		using trait_type = inline_cache_detail::symbol_trait<Category>;
+		using value_type = typename trait_type::value_type;
+		using version_type = Module::version_type;
+
+	private:
+		struct entry
+		{
+			const Module* mod;
+			version_type version;
+			value_type* value;
+		};
+
+		symbol_name name_;
+		std::array<entry, Ways> entries_;
+		std::size_t next_;
+
+	public:
+		explicit InlineCache(const symbol_name_view name)
+			: name_{name},
+			entries_{},
+			next_{0} {}
+
+		[[nodiscard]] auto get_name() const noexcept -> symbol_name_view { return name_; }
+
+		// nullptr if the module does not have this symbol (a miss is not cached)
+		[[nodiscard]] auto lookup(const Module& mod) -> value_type*
+		{
+			const auto version = mod.get_version();
+
+			for (const auto& [m, v, value]: entries_) { if (m == &mod && v == version) { return value; } }
+
+			auto* value = trait_type::resolve(mod, name_);
+			if (value)
+			{
+				// replace the stale entry of this module if any, otherwise the next one
+				auto* target = &entries_[next_];
+				for (auto& e: entries_)
+				{
+					if (e.mod == &mod)
+					{
+						target = &e;
+						break;
+					}
+				}
+				if (target == &entries_[next_]) { next_ = (next_ + 1) % Ways; }
+
+				*target = {.mod = &mod, .version = version, .value = value};
+			}
+
+			return value;
+		}
+
+		auto invalidate() noexcept -> void
+		{
+			entries_ = {};
+			next_ = 0;
+		}
+	};
+
+	// Field lookup of one site, keyed on the structure and its generation (field offsets never change once registered).
+	// A structure allocated where a destroyed one lived (e.g. after Module::redefine_structure) never has the same generation, its entry just misses.
+	template<std::size_t Ways = 1>
+		requires(Ways != 0)
+	class FieldInlineCache
+	{
+	public:
+		using field_index_type = Structure::field_offset_type;
+
+		struct field_location
+		{
+			field_index_type index;
+			std::size_t offset;
+		};
+
+	private:
+		struct entry
+		{
+			const Structure* structure;
+			Structure::generation_type generation;
+			field_location location;
+		};
+
+		symbol_name name_;
+		std::array<entry, Ways> entries_;
+		std::size_t next_;
+
+	public:
+		explicit FieldInlineCache(const symbol_name_view name)
+			: name_{name},
+			entries_{},
+			next_{0} {}
+
+		[[nodiscard]] auto get_name() const noexcept -> symbol_name_view { return name_; }
+
+		// nullptr if the structure does not have this field (a miss is not cached)
+		[[nodiscard]] auto lookup(const Structure& structure) -> const field_location*
+		{
+			const auto generation = structure.get_generation();
+
+			for (const auto& e: entries_) { if (e.structure == &structure && e.generation == generation) { return &e.location; } }
+
+			const auto* field = structure.get_field(name_);
+			if (!field) { return nullptr; }
+
+			// replace the stale entry of this address if any, otherwise the next one
+			auto* target = &entries_[next_];
+			for (auto& e: entries_)
+			{
+				if (e.structure == &structure)
+				{
+					target = &e;
+					break;
+				}
+			}
+			if (target == &entries_[next_]) { next_ = (next_ + 1) % Ways; }
+
+			*target = {.structure = &structure, .generation = generation, .location = {.index = field->index, .offset = field->offset}};
+			return &target->location;
+		}
+
+		auto invalidate() noexcept -> void
+		{
+			entries_ = {};
+			next_ = 0;
+		}
+	};
+
+	template<std::size_t Ways = 1>
+	using StructureInlineCache = InlineCache<symbol_category::STRUCTURE, Ways>;
+	template<std::size_t Ways = 1>
+	using GlobalInlineCache = InlineCache<symbol_category::GLOBAL, Ways>;
+	template<std::size_t Ways = 1>
+	using FunctionInlineCache = InlineCache<symbol_category::FUNCTION, Ways>;
+}
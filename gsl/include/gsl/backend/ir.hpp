@@ -0,0 +1,460 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <span>
+#include <variant>
+#include <gsl/backend/ast.hpp>
+#include <gsl/debug/assert.hpp>
+
+// Mid-level SSA representation of function bodies, see backend/pass.hpp for the optimizer.
+// Values and blocks are plain indices into their function, an erased instruction only leaves its slot unused.
+namespace gal::gsl::ir
+{
+	using symbol_name = ast::symbol_name;
+	using symbol_name_view = ast::symbol_name_view;
+
+	using value_id = std::uint32_t;
+	using block_id = std::uint32_t;
+
+	constexpr value_id invalid_value = std::numeric_limits<value_id>::max();
+	constexpr block_id invalid_block = std::numeric_limits<block_id>::max();
+
+	// NIL ==> not inferred yet
+	using type_t = ast::TypeDeclaration::variable_type;
+
+	// BOOLEAN / INT / FLOAT / DOUBLE
+	using constant_type = std::variant<std::monostate, bool, std::int32_t, float, double>;
+
+	enum class opcode
+	{
+		// ===================================
+		// values
+		// ===================================
+
+		// constant
+		CONSTANT,
+		// index
+		ARGUMENT,
+		// operands[i] comes from blocks[i], only at the beginning of a block
+		PHI,
+
+		// ===================================
+		// arithmetic
+		// ===================================
+
+		ADD,
+		SUB,
+		MUL,
+		DIV,
+		REM,
+		NEG,
+		// operands: {value}, the value converted to the (numeric) type of the instruction, see check_types
+		CONVERT,
+
+		// ===================================
+		// comparison ==> BOOLEAN
+		// ===================================
+
+		EQUAL,
+		NOT_EQUAL,
+		LESS,
+		LESS_EQUAL,
+		GREATER,
+		GREATER_EQUAL,
+
+		// ===================================
+		// logical
+		// ===================================
+
+		AND,
+		OR,
+		NOT,
+
+		// ===================================
+		// memory
+		// ===================================
+
+		// symbol
+		LOAD_GLOBAL,
+		// symbol, operands: {value}
+		STORE_GLOBAL,
+		// structure, a new (zeroed) record on the heap
+		ALLOC,
+		// structure, index: byte offset in the frame
+		// a record that never outlives the call (see make_escape_analysis), zeroed every time it executes
+		FRAME_ALLOC,
+		// index, operands: {object}
+		LOAD_FIELD,
+		// index, operands: {object, value}
+		STORE_FIELD,
+		// index, operands: {object, element}, the element of an array field (row-major over all its dimensions), not checked
+		LOAD_ELEMENT,
+		// index, operands: {object, element, value}
+		STORE_ELEMENT,
+		// index: the extent, operands: {element}
+		// the element itself (INT), traps unless 0 <= element < extent, see make_bounds_check_elimination
+		CHECK_BOUNDS,
+
+		// symbol, operands: arguments
+		CALL,
+
+		// ===================================
+		// terminators
+		// ===================================
+
+		// blocks: {target}
+		JUMP,
+		// operands: {condition}, blocks: {if_true, if_false}
+		BRANCH,
+		// operands: {} or {value}
+		RETURN,
+	};
+
+	[[nodiscard]] constexpr auto is_terminator(const opcode op) noexcept -> bool { return op == opcode::JUMP || op == opcode::BRANCH || op == opcode::RETURN; }
+
+	// EQUAL..GREATER_EQUAL, the result is BOOLEAN
+	[[nodiscard]] constexpr auto is_comparison(const opcode op) noexcept -> bool { return op >= opcode::EQUAL && op <= opcode::GREATER_EQUAL; }
+
+	[[nodiscard]] constexpr auto is_binary(const opcode op) noexcept -> bool
+	{
+		return
+				(op >= opcode::ADD && op <= opcode::REM) ||
+				is_comparison(op) ||
+				op == opcode::AND ||
+				op == opcode::OR;
+	}
+
+	[[nodiscard]] constexpr auto is_unary(const opcode op) noexcept -> bool { return op == opcode::NEG || op == opcode::NOT; }
+
+	[[nodiscard]] constexpr auto is_commutative(const opcode op) noexcept -> bool
+	{
+		return
+				op == opcode::ADD ||
+				op == opcode::MUL ||
+				op == opcode::EQUAL ||
+				op == opcode::NOT_EQUAL ||
+				op == opcode::AND ||
+				op == opcode::OR;
+	}
+
+	// the result only depends on the operands, it can be removed, merged or moved freely
+	// (DIV/REM may trap, see may_trap)
+	[[nodiscard]] constexpr auto is_pure(const opcode op) noexcept -> bool { return op == opcode::CONSTANT || op == opcode::CONVERT || is_binary(op) || is_unary(op); }
+
+	// observable even if the result is unused
+	[[nodiscard]] constexpr auto has_side_effect(const opcode op) noexcept -> bool
+	{
+		return
+				op == opcode::STORE_GLOBAL ||
+				op == opcode::STORE_FIELD ||
+				op == opcode::STORE_ELEMENT ||
+				op == opcode::CHECK_BOUNDS ||
+				op == opcode::CALL ||
+				is_terminator(op);
+	}
+
+	[[nodiscard]] constexpr auto may_trap(const opcode op) noexcept -> bool { return op == opcode::DIV || op == opcode::REM; }
+
+	struct Instruction
+	{
+		opcode op{opcode::CONSTANT};
+		type_t type{type_t::NIL};
+		// the owner
+		block_id block{invalid_block};
+
+		container::vector<value_id> operands{};
+		// JUMP: {target}
+		// BRANCH: {if_true, if_false}
+		// PHI: the incoming block of each operand
+		container::vector<block_id> blocks{};
+
+		// CONSTANT
+		constant_type constant{};
+		// ARGUMENT: argument index
+		// LOAD_FIELD/STORE_FIELD/LOAD_ELEMENT/STORE_ELEMENT: field index
+		// CHECK_BOUNDS: the extent, 0 until check_types resolves it
+		// FRAME_ALLOC: frame offset
+		std::uint32_t index{0};
+		// LOAD_GLOBAL/STORE_GLOBAL/CALL
+		symbol_name symbol{};
+		// ALLOC/FRAME_ALLOC
+		// ARGUMENT: the structure of a record argument (optional)
+		// LOAD_FIELD/STORE_FIELD/LOAD_ELEMENT/STORE_ELEMENT: the structure of the record, set by check_types
+		const ast::Structure* structure{nullptr};
+	};
+
+	struct BasicBlock
+	{
+		// in execution order, phis first, the terminator last
+		container::vector<value_id> instructions;
+		// see Function::recompute_predecessors
+		container::vector<block_id> predecessors;
+		// erased blocks keep their id
+		bool alive{true};
+	};
+
+	class Function
+	{
+	public:
+		using argument_count_type = std::uint32_t;
+
+		using value_container_type = container::vector<Instruction>;
+		using block_container_type = container::vector<BasicBlock>;
+
+	private:
+		symbol_name name_;
+		argument_count_type arity_;
+		type_t return_type_;
+
+		value_container_type values_;
+		block_container_type blocks_;
+
+		// records living in the frame, see FRAME_ALLOC
+		std::size_t frame_size_;
+		std::size_t frame_alignment_;
+
+	public:
+		Function(symbol_name_view name, argument_count_type arity, type_t return_type = type_t::VOID);
+
+		[[nodiscard]] auto get_name() const noexcept -> symbol_name_view { return name_; }
+
+		[[nodiscard]] auto get_arity() const noexcept -> argument_count_type { return arity_; }
+
+		[[nodiscard]] auto get_return_type() const noexcept -> type_t { return return_type_; }
+
+		[[nodiscard]] auto get_frame_size() const noexcept -> std::size_t { return frame_size_; }
+
+		[[nodiscard]] auto get_frame_alignment() const noexcept -> std::size_t { return frame_alignment_; }
+
+		// reserve a slot in the frame, return its offset
+		[[nodiscard]] auto allocate_frame(std::size_t size, std::size_t alignment) -> std::uint32_t;
+
+		// created with the function
+		[[nodiscard]] constexpr static auto entry() noexcept -> block_id { return 0; }
+
+		[[nodiscard]] auto create_block() -> block_id;
+
+		[[nodiscard]] auto block_count() const noexcept -> block_id { return static_cast<block_id>(blocks_.size()); }
+
+		[[nodiscard]] auto value_count() const noexcept -> value_id { return static_cast<value_id>(values_.size()); }
+
+		[[nodiscard]] auto block(const block_id id) noexcept -> BasicBlock&
+		{
+			gsl_assert(id < blocks_.size(), "block out of range!");
+			return blocks_[id];
+		}
+
+		[[nodiscard]] auto block(const block_id id) const noexcept -> const BasicBlock&
+		{
+			gsl_assert(id < blocks_.size(), "block out of range!");
+			return blocks_[id];
+		}
+
+		[[nodiscard]] auto value(const value_id id) noexcept -> Instruction&
+		{
+			gsl_assert(id < values_.size(), "value out of range!");
+			return values_[id];
+		}
+
+		[[nodiscard]] auto value(const value_id id) const noexcept -> const Instruction&
+		{
+			gsl_assert(id < values_.size(), "value out of range!");
+			return values_[id];
+		}
+
+		// number of live instructions
+		[[nodiscard]] auto size() const noexcept -> std::size_t;
+
+		// invalid_value if the block is not terminated (yet)
+		[[nodiscard]] auto terminator(block_id id) const noexcept -> value_id;
+
+		[[nodiscard]] auto successors(block_id id) const noexcept -> std::span<const block_id>;
+
+		// insert at position (an index into the block's instruction list), position == size ==> append
+		auto insert(block_id id, std::size_t position, Instruction&& instruction) -> value_id;
+
+		auto append(const block_id id, Instruction&& instruction) -> value_id { return insert(id, block(id).instructions.size(), std::move(instruction)); }
+
+		// insert right before the terminator of the block
+		auto insert_before_terminator(block_id id, Instruction&& instruction) -> value_id;
+
+		// move an existing instruction right before the terminator of another block
+		auto move_before_terminator(value_id value, block_id id) -> void;
+
+		// remove from its block, the value must be unused
+		auto erase(value_id value) -> void;
+
+		auto replace_all_uses(value_id from, value_id to) -> void;
+
+		// the users of every value (each user listed once per use)
+		[[nodiscard]] auto compute_uses() const -> container::vector<container::vector<value_id>>;
+
+		auto recompute_predecessors() -> void;
+
+		// drop the edge from -> to: phis of `to` forget the incoming value of `from`
+		auto remove_incoming(block_id to, block_id from) -> void;
+
+		// erase every block not reachable from the entry, return whether anything changed
+		auto remove_unreachable_blocks() -> bool;
+
+		// the reachable blocks in reverse post order
+		[[nodiscard]] auto reverse_post_order() const -> container::vector<block_id>;
+
+		// check the structural invariants (terminators, phi placement and arity, operand ranges)
+		[[nodiscard]] auto verify() const -> bool;
+
+		[[nodiscard]] auto dump() const -> string::string;
+	};
+
+	using function_type = memory::shared_ptr<Function>;
+
+	class Module
+	{
+	public:
+		using function_table_type = container::unordered_map<symbol_name, function_type, utility::string_hasher<symbol_name>>;
+
+	private:
+		symbol_name name_;
+		function_table_type functions_;
+
+	public:
+		explicit Module(const symbol_name_view name)
+			: name_{name} {}
+
+		[[nodiscard]] auto get_name() const noexcept -> symbol_name_view { return name_; }
+
+		// nullptr if the name exists
+		[[nodiscard]] auto create_function(symbol_name_view name, Function::argument_count_type arity, type_t return_type = type_t::VOID) -> function_type;
+
+		[[nodiscard]] auto get_function(const symbol_name_view name) const -> function_type
+		{
+			if (const auto it = functions_.find(name);
+				it != functions_.end()) { return it->second; }
+			return nullptr;
+		}
+
+		[[nodiscard]] auto get_functions() const noexcept -> const function_table_type& { return functions_; }
+	};
+
+	// Appends instructions to one block.
+	class Builder
+	{
+	private:
+		Function& function_;
+		block_id current_;
+
+		auto emit(Instruction&& instruction) -> value_id;
+
+	public:
+		explicit Builder(Function& function, const block_id current = Function::entry())
+			: function_{function},
+			current_{current} {}
+
+		[[nodiscard]] auto get_function() const noexcept -> Function& { return function_; }
+
+		[[nodiscard]] auto get_insert_point() const noexcept -> block_id { return current_; }
+
+		auto set_insert_point(const block_id block) noexcept -> void { current_ = block; }
+
+		[[nodiscard]] auto create_block() const -> block_id { return function_.create_block(); }
+
+		auto constant(constant_type value) -> value_id;
+
+		auto argument(std::uint32_t index, type_t type = type_t::NIL) -> value_id;
+
+		// a record argument
+		auto argument(std::uint32_t index, const ast::Structure& structure) -> value_id;
+
+		auto binary(opcode op, value_id lhs, value_id rhs) -> value_id;
+
+		auto unary(opcode op, value_id operand) -> value_id;
+
+		auto convert(value_id value, type_t type) -> value_id;
+
+		// add the incoming values with add_incoming
+		auto phi(type_t type = type_t::NIL) -> value_id;
+
+		auto add_incoming(value_id phi, value_id value, block_id from) const -> void;
+
+		auto load_global(symbol_name_view name, type_t type = type_t::NIL) -> value_id;
+
+		auto store_global(symbol_name_view name, value_id value) -> value_id;
+
+		auto alloc(const ast::Structure& structure) -> value_id;
+
+		auto load_field(value_id object, std::uint32_t index, type_t type = type_t::NIL) -> value_id;
+
+		auto store_field(value_id object, std::uint32_t index, value_id value) -> value_id;
+
+		// object.field[element], the element is checked first (CHECK_BOUNDS)
+		auto load_element(value_id object, std::uint32_t index, value_id element, type_t type = type_t::NIL) -> value_id;
+
+		auto store_element(value_id object, std::uint32_t index, value_id element, value_id value) -> value_id;
+
+		auto call(symbol_name_view name, std::span<const value_id> arguments, type_t type = type_t::NIL) -> value_id;
+
+		auto jump(block_id target) -> value_id;
+
+		auto branch(value_id condition, block_id if_true, block_id if_false) -> value_id;
+
+		auto ret() -> value_id;
+
+		auto ret(value_id value) -> value_id;
+
+		// for (i = begin; i < end; i += 1) { body(i) }, return i (end once the loop is done)
+		// body starts in an empty block and may leave the insert point anywhere (the latch), the insert point ends after the loop
+		auto loop(value_id begin, value_id end, const std::function<void(value_id)>& body) -> value_id;
+
+		// for (element: record.field) { body(element) } over every element of an array field of the structure (all its dimensions, row-major)
+		// body gets the element index (see load_element), the static extent of the field bounds the loop (see make_bounds_check_elimination)
+		auto for_each_element(const ast::Structure& structure, std::uint32_t index, const std::function<void(value_id)>& body) -> void;
+	};
+
+	// ===================================
+	// analysis
+	// ===================================
+
+	class DominatorTree
+	{
+	private:
+		// invalid_block for the entry and unreachable blocks
+		container::vector<block_id> immediate_dominators_;
+		container::vector<container::vector<block_id>> children_;
+		// position in reverse post order, used to answer dominates() without walking
+		container::vector<std::uint32_t> preorder_;
+		container::vector<std::uint32_t> postorder_;
+
+	public:
+		explicit DominatorTree(const Function& function);
+
+		[[nodiscard]] auto immediate_dominator(const block_id block) const noexcept -> block_id { return immediate_dominators_[block]; }
+
+		[[nodiscard]] auto children(const block_id block) const noexcept -> std::span<const block_id> { return children_[block]; }
+
+		[[nodiscard]] auto is_reachable(block_id block) const noexcept -> bool;
+
+		// a dominates b (a block dominates itself)
+		[[nodiscard]] auto dominates(block_id a, block_id b) const noexcept -> bool;
+	};
+
+	struct Loop
+	{
+		block_id header;
+		// every block of the loop, header included
+		container::vector<block_id> blocks;
+		// every predecessor of the header inside the loop
+		container::vector<block_id> latches;
+
+		[[nodiscard]] auto contains(const block_id block) const noexcept -> bool { return std::ranges::find(blocks, block) != blocks.end(); }
+	};
+
+	// natural loops, inner loops come before the loops containing them
+	[[nodiscard]] auto find_loops(const Function& function, const DominatorTree& dominator_tree) -> container::vector<Loop>;
+
+	// the unique block outside the loop jumping (only) to the header, created if necessary (the loops found before do not contain it)
+	// {invalid_block, false} if the header is the entry of the function
+	auto make_preheader(Function& function, const Loop& loop) -> std::pair<block_id, bool>;
+}
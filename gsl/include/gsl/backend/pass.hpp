@@ -0,0 +1,108 @@
+#pragma once
+
+#include <chrono>
+#include <span>
+#include <gsl/backend/ir.hpp>
+
+namespace gal::gsl::ir
+{
+	enum class optimization_level
+	{
+		// no pass at all
+		O0,
+		// cheap cleanups: escape analysis, constant propagation, common subexpression elimination, bounds check elimination, dead code elimination
+		O1,
+		// O1 + small function inlining + loop invariant code motion, iterated until nothing changes
+		O2,
+	};
+
+	class Pass
+	{
+	public:
+		Pass() = default;
+		Pass(const Pass&) = default;
+		auto operator=(const Pass&) -> Pass& = default;
+		Pass(Pass&&) = default;
+		auto operator=(Pass&&) -> Pass& = default;
+		virtual ~Pass() noexcept;
+
+		[[nodiscard]] virtual auto name() const noexcept -> symbol_name_view = 0;
+
+		// return whether the function changed
+		virtual auto run(Module& module, Function& function) -> bool = 0;
+	};
+
+	using pass_type = memory::shared_ptr<Pass>;
+
+	// fold constant operations and branches, forward trivial phis, drop the blocks that became unreachable
+	[[nodiscard]] auto make_constant_propagation() -> pass_type;
+
+	// remove every instruction whose result is unused and that has no side effect, merge straight-line blocks
+	[[nodiscard]] auto make_dead_code_elimination() -> pass_type;
+
+	// merge pure instructions computed again in a dominated block, forward loads within a block
+	[[nodiscard]] auto make_common_subexpression_elimination() -> pass_type;
+
+	// hoist invariant instructions of every loop into its preheader
+	[[nodiscard]] auto make_loop_invariant_code_motion() -> pass_type;
+
+	// Remove the CHECK_BOUNDS whose element is proven in range: constants, loop counters (i = phi(init, i + 1), the loop runs while i < end),
+	// offsets of those and the comparisons of the branches leading to the check, against the static extent of the array.
+	// The check of a loop counter executed on every iteration is hoisted before the loop otherwise (the first and the last value are checked once),
+	// it then fails before the first iteration instead of at the faulty one.
+	// Only the checks resolved by check_types are considered.
+	[[nodiscard]] auto make_bounds_check_elimination() -> pass_type;
+
+	// records (ALLOC) that never outlive the call: the fields of those only read and written become SSA values,
+	// the others move to the frame (FRAME_ALLOC), neither is allocated by nor scanned by the collector
+	// (a record holding a string, maybe in a nested record, stays on the heap unless its fields become SSA values)
+	[[nodiscard]] auto make_escape_analysis() -> pass_type;
+
+	// inline the calls to functions of the module with at most `threshold` instructions
+	[[nodiscard]] auto make_inline(std::size_t threshold = 32) -> pass_type;
+
+	class PassManager
+	{
+	public:
+		using clock_type = std::chrono::steady_clock;
+
+		struct pass_statistics
+		{
+			symbol_name_view name;
+			clock_type::duration elapsed;
+			// number of functions the pass ran over / changed
+			std::size_t runs;
+			std::size_t changes;
+		};
+
+	private:
+		container::vector<pass_type> passes_;
+		container::vector<pass_statistics> statistics_;
+		// how many times the pipeline may run over one function before we stop waiting for a fixed point
+		std::size_t iterations_;
+
+	public:
+		explicit PassManager(const std::size_t iterations = 1)
+			: iterations_{iterations} {}
+
+		[[nodiscard]] static auto create(optimization_level level) -> PassManager;
+
+		auto add(pass_type pass) -> PassManager&;
+
+		[[nodiscard]] auto empty() const noexcept -> bool { return passes_.empty(); }
+
+		// return whether the function changed
+		auto run(Module& module, Function& function) -> bool;
+
+		// every function of the module
+		auto run(Module& module) -> bool;
+
+		// one entry per added pass, in pipeline order
+		[[nodiscard]] auto statistics() const noexcept -> std::span<const pass_statistics> { return statistics_; }
+
+		auto reset_statistics() noexcept -> void;
+
+		// log the statistics (debug level)
+		auto report() const -> void;
+	};
+}
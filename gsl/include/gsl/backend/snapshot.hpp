@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <gsl/backend/ast.hpp>
+
+namespace gal::gsl::ast
+{
+	// The structure an imported module declares, nullptr if none.
+	// frontend::ModuleRegistry::find_structure is one (the restored module keeps its imports).
+	using structure_resolver_type = std::function<structure_type(const Module& module, symbol_name_view name)>;
+
+	// The image of a loaded module: its structures (fields and layout), globals and function declarations, plus the strings interned so far.
+	// Builtin functions are not part of it, the host registers them again after the restore.
+	// The structures of the imported modules are not part of it either, only their names, the restore resolves them again.
+	// Position independent (only names, no pointer), restoring it is one pass over the image instead of reading and parsing the sources again.
+	// Throw std::invalid_argument if the module uses an imported structure of the same name as one of its own (it could not be resolved again).
+	[[nodiscard]] auto make_snapshot(const Module& module) -> container::vector<std::byte>;
+
+	// nullptr if the image is not a (valid) snapshot of this version, or if it uses an imported structure the resolver does not find
+	[[nodiscard]] auto restore_snapshot(std::span<const std::byte> image, const structure_resolver_type& resolver = {}) -> module_type;
+
+	// written to a temporary file first then renamed, a concurrent load_snapshot never sees half an image
+	auto save_snapshot(const Module& module, string::string_view filename) -> bool;
+
+	// nullptr if the file cannot be read or is not a (valid) snapshot of this version (see restore_snapshot)
+	[[nodiscard]] auto load_snapshot(string::string_view filename, const structure_resolver_type& resolver = {}) -> module_type;
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <span>
+#include <gsl/backend/type_check.hpp>
+
+// Superinstructions: a short chain of specialized instructions (see specialize) executed by a single handler, one dispatch instead of several.
+// The set is fixed at build time (see superinstructions), the sequence profile of a corpus of checked functions tells which chains pay off.
+namespace gal::gsl::ir
+{
+	constexpr std::size_t max_superinstruction_length = 3;
+
+	struct superinstruction_pattern
+	{
+		// the unused trailing opcodes are UNTYPED
+		std::array<specialized_opcode, max_superinstruction_length> opcodes;
+		std::size_t length;
+
+		[[nodiscard]] constexpr auto view() const noexcept -> std::span<const specialized_opcode> { return {opcodes.data(), length}; }
+
+		[[nodiscard]] constexpr auto operator==(const superinstruction_pattern&) const noexcept -> bool = default;
+	};
+
+	// Regenerate with OpcodeSequenceProfile::dump over a representative corpus (the superinstruction_profile target does it for its own),
+	// then paste the table here by hand. The handlers are indexed by position.
+	constexpr auto superinstructions = []
+	{
+		using enum specialized_opcode;
+
+		return std::to_array<superinstruction_pattern>({
+				// while (i < object.field)
+				{{LOAD_FIELD_OFFSET, LESS_I32, BRANCH}, 3},
+				{{LOAD_FIELD_OFFSET, LESS_EQUAL_I32, BRANCH}, 3},
+				{{LOAD_FIELD_OFFSET, EQUAL_I32, BRANCH}, 3},
+				{{LOAD_FIELD_OFFSET, NOT_EQUAL_I32, BRANCH}, 3},
+				{{LOAD_FIELD_OFFSET, LESS_F64, BRANCH}, 3},
+				{{LESS_I32, BRANCH}, 2},
+				{{LESS_EQUAL_I32, BRANCH}, 2},
+				{{GREATER_I32, BRANCH}, 2},
+				{{GREATER_EQUAL_I32, BRANCH}, 2},
+				{{EQUAL_I32, BRANCH}, 2},
+				{{NOT_EQUAL_I32, BRANCH}, 2},
+				{{LESS_F64, BRANCH}, 2},
+				{{EQUAL_REFERENCE, BRANCH}, 2},
+				{{NOT, BRANCH}, 2},
+				// f(global)
+				{{LOAD_GLOBAL, CALL}, 2},
+				// i + 1
+				{{CONSTANT_I32, ADD_I32}, 2},
+				{{CONSTANT_I32, LESS_I32}, 2},
+				{{LOAD_FIELD_OFFSET, ADD_I32}, 2},
+				{{LOAD_FIELD_OFFSET, ADD_F64}, 2},
+				{{LOAD_FIELD_OFFSET, MUL_F64}, 2},
+				// object.field.field
+				{{LOAD_FIELD_OFFSET, LOAD_FIELD_OFFSET}, 2},
+				{{ADD_I32, STORE_FIELD_OFFSET}, 2},
+				{{ADD_F64, STORE_FIELD_OFFSET}, 2},
+				{{ADD_I32, STORE_GLOBAL}, 2},
+				{{CALL, RETURN}, 2},
+		});
+	}();
+
+	// Weighted counts of the chains (2 or 3 instructions in a row of one block, each result only used by the next instruction) of checked functions.
+	class OpcodeSequenceProfile
+	{
+	public:
+		struct entry
+		{
+			superinstruction_pattern sequence;
+			std::uint64_t count;
+		};
+
+	private:
+		// see key_of
+		container::unordered_map<std::uint64_t, std::uint64_t> counts_;
+		// every (weighted) dispatch without superinstruction
+		std::uint64_t instructions_{0};
+
+	public:
+		// a block nested in n loops counts loop_weight^n times
+		auto record(const Function& function, std::uint64_t loop_weight = 8) -> void;
+
+		auto record(const Module& module, std::uint64_t loop_weight = 8) -> void;
+
+		[[nodiscard]] auto get_instruction_count() const noexcept -> std::uint64_t { return instructions_; }
+
+		// the most frequent first
+		[[nodiscard]] auto sequences() const -> container::vector<entry>;
+
+		// the `count` sequences saving the most dispatches (count * (length - 1))
+		[[nodiscard]] auto select(std::size_t count) const -> container::vector<superinstruction_pattern>;
+
+		// sequences() as tab separated text, followed by select(table_size) as the initializer of `superinstructions`
+		auto dump(string::string_view filename, std::size_t table_size = superinstructions.size()) const -> bool;
+	};
+
+	// one dispatch of the interpreter
+	struct dispatch
+	{
+		constexpr static auto no_superinstruction = std::numeric_limits<std::uint32_t>::max();
+
+		// index into the superinstruction set, no_superinstruction ==> length == 1
+		std::uint32_t superinstruction;
+		// in execution order
+		std::array<value_id, max_superinstruction_length> values;
+		std::size_t length;
+	};
+
+	struct dispatch_block
+	{
+		block_id id;
+		container::vector<dispatch> dispatches;
+	};
+
+	// The dispatches of a checked function, block by block in reverse post order.
+	// Every chain matching a superinstruction of the set becomes one dispatch (the longest match first).
+	[[nodiscard]] auto fuse_superinstructions(const Function& function, std::span<const superinstruction_pattern> set = superinstructions) -> container::vector<dispatch_block>;
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <gsl/backend/ir.hpp>
+
+namespace gal::gsl::ir
+{
+	struct type_error
+	{
+		value_id value;
+		string::string message;
+	};
+
+	struct type_check_result
+	{
+		container::vector<type_error> errors;
+		// a type was inferred or a conversion inserted
+		bool changed;
+
+		[[nodiscard]] auto success() const noexcept -> bool { return errors.empty(); }
+	};
+
+	// Infer the type of every value of the function and check every instruction against it.
+	// Numeric promotions (INT ==> FLOAT ==> DOUBLE) become explicit CONVERT, record fields get their structure.
+	// Once it succeeded, every instruction has exactly one specialized form (see specialize), the optimization passes keep it that way.
+	// The calls to the functions of the module are checked against their arguments and return type.
+	[[nodiscard]] auto check_types(const Module& module, Function& function) -> type_check_result;
+
+	// The instructions of a checked function with the operand types folded into the opcode:
+	// executing them needs no type test nor dispatch on the type of a value.
+	enum class specialized_opcode
+	{
+		// not checked (or not checkable)
+		UNTYPED,
+
+		CONSTANT_BOOLEAN,
+		CONSTANT_I32,
+		CONSTANT_F32,
+		CONSTANT_F64,
+		ARGUMENT,
+		PHI,
+
+		ADD_I32,
+		ADD_F32,
+		ADD_F64,
+		// concatenation
+		ADD_STRING,
+		SUB_I32,
+		SUB_F32,
+		SUB_F64,
+		MUL_I32,
+		MUL_F32,
+		MUL_F64,
+		DIV_I32,
+		DIV_F32,
+		DIV_F64,
+		REM_I32,
+		REM_F32,
+		REM_F64,
+		NEG_I32,
+		NEG_F32,
+		NEG_F64,
+
+		CONVERT_I32_TO_F32,
+		CONVERT_I32_TO_F64,
+		CONVERT_F32_TO_F64,
+
+		EQUAL_BOOLEAN,
+		EQUAL_I32,
+		EQUAL_F32,
+		EQUAL_F64,
+		EQUAL_STRING,
+		// same record
+		EQUAL_REFERENCE,
+		NOT_EQUAL_BOOLEAN,
+		NOT_EQUAL_I32,
+		NOT_EQUAL_F32,
+		NOT_EQUAL_F64,
+		NOT_EQUAL_STRING,
+		NOT_EQUAL_REFERENCE,
+		LESS_I32,
+		LESS_F32,
+		LESS_F64,
+		LESS_EQUAL_I32,
+		LESS_EQUAL_F32,
+		LESS_EQUAL_F64,
+		GREATER_I32,
+		GREATER_F32,
+		GREATER_F64,
+		GREATER_EQUAL_I32,
+		GREATER_EQUAL_F32,
+		GREATER_EQUAL_F64,
+
+		AND,
+		OR,
+		NOT,
+
+		LOAD_GLOBAL,
+		STORE_GLOBAL,
+		ALLOC,
+		FRAME_ALLOC,
+		// the byte offset of the field is known, see field_offset
+		LOAD_FIELD_OFFSET,
+		STORE_FIELD_OFFSET,
+		// the byte offset of the array and the size of an element are known, see element_size
+		LOAD_ELEMENT_OFFSET,
+		STORE_ELEMENT_OFFSET,
+		// the extent is known
+		CHECK_BOUNDS,
+		CALL,
+
+		JUMP,
+		BRANCH,
+		RETURN,
+	};
+
+	[[nodiscard]] auto specialize(const Function& function, const Instruction& instruction) noexcept -> specialized_opcode;
+
+	// LOAD_FIELD/STORE_FIELD/LOAD_ELEMENT/STORE_ELEMENT of a checked function
+	[[nodiscard]] auto field_offset(const Instruction& instruction) noexcept -> std::size_t;
+
+	// LOAD_ELEMENT/STORE_ELEMENT of a checked function
+	[[nodiscard]] auto element_size(const Instruction& instruction) noexcept -> std::size_t;
+}
@@ -0,0 +1,443 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <gsl/container/vector.hpp>
+#include <gsl/memory/allocator.hpp>
+
+namespace gal::gsl::container
+{
+	// Hash map shared by concurrent writers, with wait-free reads.
+	// - find never blocks nor retries: a few acquire loads along an open addressing probe that always ends at an empty slot
+	// - try_emplace/insert_or_assign/erase lock one of `Stripes` mutexes (chosen by hash), a growth locks them all
+	// The entries are never moved: what find returned stays valid until reclaim (or the map dies), even once replaced or erased.
+	// Memory: an insertion (by try_emplace or insert_or_assign) allocates an entry, a growth allocates a table, an erasure allocates nothing.
+	// The replaced entries and the outgrown tables are kept for the readers that may still use them, so a map rewritten
+	// forever grows forever until reclaim frees them, at a point where nothing reads the map.
+	// concurrent_map_benchmark measures it against a mutex-guarded std::unordered_map (mostly lookups, some insertions, 32 threads by default).
+	template<
+		typename Key,
+		typename Value,
+		typename Hasher = std::hash<Key>,
+		typename KeyComparator = std::equal_to<>,
+		std::size_t Stripes = 64>
+		requires(std::has_single_bit(Stripes))
+	class ConcurrentMap
+	{
+	public:
+		using key_type = Key;
+		using mapped_type = Value;
+		using value_type = std::pair<const Key, Value>;
+		using size_type = std::size_t;
+
+	private:
+		struct entry
+		{
+			value_type value;
+			size_type hash;
+			// keeps the probe going, never found (set in place under the stripe lock)
+			std::atomic<bool> erased;
+			// every entry not reclaimed yet, freed with the map
+			entry* next_allocated;
+
+			entry(Key&& key, Value&& v, const size_type h)
+				: value{std::move(key), std::move(v)},
+				hash{h},
+				erased{false},
+				next_allocated{nullptr} {}
+		};
+
+		struct table
+		{
+			// power of 2, never more than half used
+			container::vector<std::atomic<entry*>> slots;
+			// the first slot of a hash is in the top log2(capacity) bits of its product with the golden ratio (fibonacci hashing)
+			int shift;
+			// the table this one replaced, readers may still probe it
+			table* retired;
+
+			explicit table(const size_type capacity)
+				: slots(capacity),
+				shift{std::numeric_limits<size_type>::digits - std::countr_zero(capacity)},
+				retired{nullptr} {}
+
+			[[nodiscard]] auto first_slot(const size_type hash) const noexcept -> size_type
+			{
+				return static_cast<size_type>((hash * static_cast<size_type>(0x9e37'79b9'7f4a'7c15ull)) >> shift);
+			}
+
+			[[nodiscard]] auto next_slot(const size_type slot) const noexcept -> size_type { return (slot + 1) & (slots.size() - 1); }
+		};
+
+		struct alignas(64) stripe
+		{
+			std::mutex mutex;
+		};
+
+		constexpr static size_type initial_capacity = 64;
+
+		// the current table, the retired ones are chained to it
+		std::atomic<table*> table_;
+		std::atomic<entry*> allocated_;
+		// not erased
+		std::atomic<size_type> size_;
+		// not empty slots of the current table
+		std::atomic<size_type> used_;
+		std::array<stripe, Stripes> stripes_;
+
+		[[no_unique_address]] Hasher hasher_;
+		[[no_unique_address]] KeyComparator comparator_;
+
+		[[nodiscard]] auto stripe_of(const size_type hash) noexcept -> std::mutex& { return stripes_[hash & (Stripes - 1)].mutex; }
+
+		// the collector must see the keys and values, they live in its (scanned) memory
+		template<typename T, typename... Args>
+		[[nodiscard]] static auto make(Args&&... args) -> T*
+		{
+			using traits_type = std::allocator_traits<memory::StlAllocator<T>>;
+
+			memory::StlAllocator<T> allocator{};
+			auto* p = traits_type::allocate(allocator, 1);
+			traits_type::construct(allocator, p, std::forward<Args>(args)...);
+			return p;
+		}
+
+		template<typename T>
+		static auto destroy(T* p) noexcept -> void
+		{
+			using traits_type = std::allocator_traits<memory::StlAllocator<T>>;
+
+			memory::StlAllocator<T> allocator{};
+			traits_type::destroy(allocator, p);
+			traits_type::deallocate(allocator, p, 1);
+		}
+
+		auto make_entry(Key&& key, Value&& value, const size_type hash) -> entry*
+		{
+			auto* e = make<entry>(std::move(key), std::move(value), hash);
+
+			e->next_allocated = allocated_.load(std::memory_order_relaxed);
+			while (!allocated_.compare_exchange_weak(e->next_allocated, e, std::memory_order_release, std::memory_order_relaxed)) {}
+			return e;
+		}
+
+		// the slot of the key, or nullptr if not found
+		template<typename K>
+		[[nodiscard]] auto find_slot(table& t, const K& key, const size_type hash) const noexcept -> std::atomic<entry*>*
+		{
+			for (auto slot = t.first_slot(hash);; slot = t.next_slot(slot))
+			{
+				const auto* e = t.slots[slot].load(std::memory_order_acquire);
+				if (!e) { return nullptr; }
+				if (e->hash == hash && comparator_(e->value.first, key)) { return &t.slots[slot]; }
+			}
+		}
+
+		// A table of at least `capacity` slots with the live entries of `current` (the erased ones are dropped), nothing written meanwhile.
+		[[nodiscard]] auto rebuild(const table& current, size_type capacity) const -> table*
+		{
+			const auto live = size_.load(std::memory_order_relaxed);
+			while (live + 1 > capacity / 4) { capacity *= 2; }
+
+			auto* next = make<table>(capacity);
+			for (const auto& s: current.slots)
+			{
+				auto* e = s.load(std::memory_order_relaxed);
+				if (!e || e->erased.load(std::memory_order_relaxed)) { continue; }
+
+				auto slot = next->first_slot(e->hash);
+				while (next->slots[slot].load(std::memory_order_relaxed)) { slot = next->next_slot(slot); }
+				next->slots[slot].store(e, std::memory_order_relaxed);
+			}
+			return next;
+		}
+
+		// all stripes locked
+		auto grow(const table* current) -> void
+		{
+			std::array<std::unique_lock<std::mutex>, Stripes> locks;
+			for (std::size_t i = 0; i < Stripes; ++i) { locks[i] = std::unique_lock{stripes_[i].mutex}; }
+
+			// someone else did it
+			if (table_.load(std::memory_order_relaxed) != current) { return; }
+
+			auto* next = rebuild(*current, current->slots.size());
+			next->retired = table_.load(std::memory_order_relaxed);
+			used_.store(size_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+			table_.store(next, std::memory_order_release);
+		}
+
+		// Put a new entry of the key in the first empty slot of its probe, the stripe of the key is locked.
+		// The key is only moved from once there is room, nullptr if the table must grow first.
+		template<typename Factory>
+		auto insert_new(table& t, Key& key, Factory& factory, const size_type hash) -> entry*
+		{
+			if (used_.fetch_add(1, std::memory_order_relaxed) + 1 > t.slots.size() / 2)
+			{
+				used_.fetch_sub(1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			auto value = factory(std::as_const(key));
+			auto* e = make_entry(std::move(key), std::move(value), hash);
+
+			// the other stripes only ever fill empty slots, never with this key
+			for (auto slot = t.first_slot(hash);; slot = t.next_slot(slot))
+			{
+				entry* expected = nullptr;
+				if (t.slots[slot].compare_exchange_strong(expected, e, std::memory_order_release, std::memory_order_relaxed))
+				{
+					size_.fetch_add(1, std::memory_order_relaxed);
+					return e;
+				}
+			}
+		}
+
+	public:
+		class const_iterator
+		{
+			friend ConcurrentMap;
+
+		public:
+			using iterator_concept = std::forward_iterator_tag;
+			using value_type = ConcurrentMap::value_type;
+			using difference_type = std::ptrdiff_t;
+			using reference = const value_type&;
+
+		private:
+			const table* table_;
+			size_type slot_;
+			// the slot may be written meanwhile, the entry does not change
+			const entry* entry_;
+
+			// the next live entry from slot_ (included)
+			auto skip() noexcept -> void
+			{
+				for (; slot_ != table_->slots.size(); ++slot_)
+				{
+					if (entry_ = table_->slots[slot_].load(std::memory_order_acquire);
+						entry_ && !entry_->erased.load(std::memory_order_acquire)) { return; }
+				}
+				entry_ = nullptr;
+			}
+
+			const_iterator(const table* t, const size_type slot) noexcept
+				: table_{t},
+				slot_{slot},
+				entry_{nullptr} { skip(); }
+
+		public:
+			const_iterator() noexcept
+				: table_{nullptr},
+				slot_{0},
+				entry_{nullptr} {}
+
+			[[nodiscard]] auto operator*() const noexcept -> reference { return entry_->value; }
+
+			[[nodiscard]] auto operator->() const noexcept -> const value_type* { return &**this; }
+
+			auto operator++() noexcept -> const_iterator&
+			{
+				++slot_;
+				skip();
+				return *this;
+			}
+
+			auto operator++(int) noexcept -> const_iterator
+			{
+				auto copy = *this;
+				++*this;
+				return copy;
+			}
+
+			[[nodiscard]] friend auto operator==(const const_iterator& lhs, const const_iterator& rhs) noexcept -> bool = default;
+
+			[[nodiscard]] friend auto operator==(const const_iterator& it, std::default_sentinel_t) noexcept -> bool { return it.slot_ == it.table_->slots.size(); }
+		};
+
+		ConcurrentMap()
+			: table_{make<table>(initial_capacity)},
+			allocated_{nullptr},
+			size_{0},
+			used_{0},
+			stripes_{},
+			hasher_{},
+			comparator_{} {}
+
+		ConcurrentMap(const ConcurrentMap&) = delete;
+		auto operator=(const ConcurrentMap&) -> ConcurrentMap& = delete;
+		ConcurrentMap(ConcurrentMap&&) = delete;
+		auto operator=(ConcurrentMap&&) -> ConcurrentMap& = delete;
+
+		~ConcurrentMap() noexcept
+		{
+			for (auto* e = allocated_.load(std::memory_order_acquire); e;)
+			{
+				auto* next = e->next_allocated;
+				destroy(e);
+				e = next;
+			}
+
+			for (auto* t = table_.load(std::memory_order_acquire); t;)
+			{
+				auto* retired = t->retired;
+				destroy(t);
+				t = retired;
+			}
+		}
+
+		// not erased, may be stale if written concurrently
+		[[nodiscard]] auto size() const noexcept -> size_type { return size_.load(std::memory_order_relaxed); }
+
+		[[nodiscard]] auto empty() const noexcept -> bool { return size() == 0; }
+
+		// The entries of the table current at the call, in no particular order.
+		// Safe while writing concurrently: an entry written meanwhile may or may not be visited.
+		[[nodiscard]] auto begin() const noexcept -> const_iterator { return {table_.load(std::memory_order_acquire), 0}; }
+
+		[[nodiscard]] constexpr auto end() const noexcept -> std::default_sentinel_t { return std::default_sentinel; }
+
+		// wait-free, nullptr if not found
+		template<typename K>
+		[[nodiscard]] auto find(const K& key) const noexcept -> const Value*
+		{
+			const auto hash = hasher_(key);
+			if (const auto* slot = find_slot(*table_.load(std::memory_order_acquire), key, hash))
+			{
+				const auto* e = slot->load(std::memory_order_acquire);
+				return e->erased.load(std::memory_order_acquire) ? nullptr : &e->value.second;
+			}
+			return nullptr;
+		}
+
+		template<typename K>
+		[[nodiscard]] auto contains(const K& key) const noexcept -> bool { return find(key) != nullptr; }
+
+		// Insert factory(key) if the key is not there, otherwise return the value already there.
+		// Only the first of several concurrent insertions of the same key inserts, factory is called only if it does.
+		// Like std::unordered_map::try_emplace, the key is not moved from if the insertion does not happen.
+		template<typename Factory>
+		auto try_emplace(Key&& key, Factory factory) -> std::pair<bool, const Value&>
+		{
+			const auto hash = hasher_(key);
+
+			while (true)
+			{
+				const table* full;
+				{
+					std::scoped_lock lock{stripe_of(hash)};
+					// cannot grow while a stripe is locked
+					auto* current = table_.load(std::memory_order_acquire);
+
+					if (auto* slot = find_slot(*current, key, hash))
+					{
+						auto* e = slot->load(std::memory_order_relaxed);
+						if (!e->erased.load(std::memory_order_relaxed)) { return {false, e->value.second}; }
+
+						// reuse the slot of the erased entry
+						auto value = factory(std::as_const(key));
+						e = make_entry(std::move(key), std::move(value), hash);
+						slot->store(e, std::memory_order_release);
+						size_.fetch_add(1, std::memory_order_relaxed);
+						return {true, e->value.second};
+					}
+
+					if (const auto* e = insert_new(*current, key, factory, hash)) { return {true, e->value.second}; }
+					full = current;
+				}
+
+				grow(full);
+			}
+		}
+
+		auto insert_or_assign(Key&& key, Value value) -> void
+		{
+			const auto hash = hasher_(key);
+
+			while (true)
+			{
+				const table* full;
+				{
+					std::scoped_lock lock{stripe_of(hash)};
+					auto* current = table_.load(std::memory_order_acquire);
+
+					if (auto* slot = find_slot(*current, key, hash))
+					{
+						// the readers holding the old value keep it
+						const auto* old = slot->load(std::memory_order_relaxed);
+						if (old->erased.load(std::memory_order_relaxed)) { size_.fetch_add(1, std::memory_order_relaxed); }
+						slot->store(make_entry(std::move(key), std::move(value), hash), std::memory_order_release);
+						return;
+					}
+
+					auto factory = [&value](const Key&) { return std::move(value); };
+					if (insert_new(*current, key, factory, hash)) { return; }
+					full = current;
+				}
+
+				grow(full);
+			}
+		}
+
+		// whether the key was there
+		template<typename K>
+		auto erase(const K& key) -> bool
+		{
+			const auto hash = hasher_(key);
+
+			std::scoped_lock lock{stripe_of(hash)};
+			auto* slot = find_slot(*table_.load(std::memory_order_acquire), key, hash);
+			if (!slot) { return false; }
+
+			auto* old = slot->load(std::memory_order_relaxed);
+			if (old->erased.load(std::memory_order_relaxed)) { return false; }
+
+			// the entry stays in the slot so the probes going through it still work, the readers holding its value keep it
+			old->erased.store(true, std::memory_order_release);
+			size_.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+
+		// Free the replaced and erased entries and the outgrown tables, the table shrinks to fit the live entries.
+		// Not thread safe: nothing may use the map meanwhile, nor still hold what find, try_emplace or an iterator gave before.
+		auto reclaim() -> void
+		{
+			auto* current = table_.load(std::memory_order_relaxed);
+			auto* next = rebuild(*current, initial_capacity);
+
+			// the live entries are the ones the new table holds
+			entry* kept = nullptr;
+			for (auto* e = allocated_.load(std::memory_order_relaxed); e;)
+			{
+				auto* following = e->next_allocated;
+				if (const auto* slot = find_slot(*next, e->value.first, e->hash);
+					slot && slot->load(std::memory_order_relaxed) == e)
+				{
+					e->next_allocated = kept;
+					kept = e;
+				}
+				else { destroy(e); }
+				e = following;
+			}
+
+			for (auto* t = current; t;)
+			{
+				auto* retired = t->retired;
+				destroy(t);
+				t = retired;
+			}
+
+			allocated_.store(kept, std::memory_order_relaxed);
+			used_.store(size_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+			table_.store(next, std::memory_order_release);
+		}
+	};
+}
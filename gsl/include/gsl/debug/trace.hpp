@@ -0,0 +1,73 @@
+#pragma once
+
+// Scoped-span instrumentation, emitted as chrome trace-event json (chrome://tracing, https://ui.perfetto.dev).
+// Everything here compiles out unless GSL_TRACE is defined (see GAL_SCRIPT_LANG_ENABLE_TRACE).
+
+#include <gsl/string/string_view.hpp>
+
+#ifdef GSL_TRACE
+#include <algorithm>
+#include <cstdint>
+#endif
+
+namespace gal::gsl::debug::trace
+{
+	#ifdef GSL_TRACE
+	using time_point_type = std::uint64_t;
+
+	// the detail of a span is copied (and truncated) into the event
+	constexpr std::size_t detail_size = 48;
+
+	// nanoseconds since the trace epoch (the first time anything asked for it)
+	[[nodiscard]] auto now() noexcept -> time_point_type;
+
+	// Record a complete event into the ring buffer of the calling thread.
+	// Note: this may be called from inside the collector (with the allocation lock held), so it never allocates from gc.
+	auto record(const char* name, const char* category, time_point_type begin, time_point_type end, string::string_view detail = {}) noexcept -> void;
+
+	// Write all recorded events of all threads, the threads being traced should be quiescent.
+	auto dump(string::string_view filename) -> bool;
+
+	// Drop all recorded events of all threads, the threads being traced should be quiescent.
+	auto clear() noexcept -> void;
+
+	class ScopedSpan
+	{
+	public:
+		ScopedSpan(const char* name, const char* category, const string::string_view detail = {}) noexcept
+			: name_{name},
+			category_{category},
+			detail_length_{std::min(detail.size(), detail_size)},
+			begin_{now()} { std::ranges::copy_n(detail.data(), static_cast<std::ptrdiff_t>(detail_length_), detail_); }
+
+		ScopedSpan(const ScopedSpan&) = delete;
+		auto operator=(const ScopedSpan&) -> ScopedSpan& = delete;
+		ScopedSpan(ScopedSpan&&) = delete;
+		auto operator=(ScopedSpan&&) -> ScopedSpan& = delete;
+
+		~ScopedSpan() noexcept { record(name_, category_, begin_, now(), {detail_, detail_length_}); }
+
+	private:
+		const char* name_;
+		const char* category_;
+		char detail_[detail_size];
+		std::size_t detail_length_;
+		time_point_type begin_;
+	};
+	#else
+	inline auto dump(string::string_view) -> bool { return false; }
+
+	inline auto clear() noexcept -> void {}
+	#endif
+}
+
+#ifdef GSL_TRACE
+	#define GSL_TRACE_PRIVATE_CONCAT_IMPL(lhs, rhs) lhs##rhs
+	#define GSL_TRACE_PRIVATE_CONCAT(lhs, rhs) GSL_TRACE_PRIVATE_CONCAT_IMPL(lhs, rhs)
+
+	#define GSL_TRACE_SCOPE(name, category) const ::gal::gsl::debug::trace::ScopedSpan GSL_TRACE_PRIVATE_CONCAT(gsl_trace_span_, __LINE__){name, category}
+	#define GSL_TRACE_SCOPE_DETAIL(name, category, detail) const ::gal::gsl::debug::trace::ScopedSpan GSL_TRACE_PRIVATE_CONCAT(gsl_trace_span_, __LINE__){name, category, detail}
+#else
+	#define GSL_TRACE_SCOPE(name, category)
+	#define GSL_TRACE_SCOPE_DETAIL(name, category, detail)
+#endif
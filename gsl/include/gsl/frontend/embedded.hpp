@@ -0,0 +1,770 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string_view>
+#include <vector>
+#include <gsl/backend/ast.hpp>
+#include <gsl/frontend/parse.hpp>
+
+// Scripts embedded in the host, parsed while the host is compiled.
+// `embed<"module name; ...">` is the constant description of the declarations of the script (structure layouts, globals, function signatures),
+// a syntax error in the script is a compile error, see embedded::error. instantiate turns it into an ast::Module without parsing anything,
+// the bodies of the functions are parsed on first use like the lazy bodies of parse_file.
+// The declarations follow the grammar of parse_file, an initializer (of a global or an argument) is a name or a literal,
+// `true`, `false`, `42`, `-1.5` or `"text"` (on one line, a backslash escapes the next character, the text is kept as written).
+namespace gal::gsl::frontend::embedded
+{
+	// The compile errors, each one is named after the problem it reports.
+	// Not constexpr on purpose: calling one ends the constant evaluation, the compiler points at the call.
+	namespace error
+	{
+		inline auto expected_module_declaration() -> void {}
+		inline auto expected_identifier() -> void {}
+		inline auto expected_semicolon() -> void {}
+		inline auto expected_declaration() -> void {}
+		inline auto expected_structure_declaration() -> void {}
+		inline auto expected_opening_brace() -> void {}
+		inline auto expected_opening_parenthesis() -> void {}
+		inline auto expected_closing_parenthesis() -> void {}
+		inline auto expected_closing_bracket() -> void {}
+		inline auto expected_dimension() -> void {}
+		inline auto expected_return_type() -> void {}
+		inline auto expected_function_body() -> void {}
+		inline auto expected_initializer() -> void {}
+		inline auto unterminated_structure() -> void {}
+		inline auto unterminated_function_body() -> void {}
+		inline auto unterminated_string() -> void {}
+		inline auto unknown_annotation() -> void {}
+		inline auto unknown_type() -> void {}
+		inline auto void_variable() -> void {}
+		inline auto immutable_global_without_initializer() -> void {}
+		inline auto initializer_type_mismatch() -> void {}
+		inline auto integer_out_of_range() -> void {}
+		inline auto duplicate_import() -> void {}
+		inline auto duplicate_structure() -> void {}
+		inline auto duplicate_field() -> void {}
+		inline auto duplicate_global() -> void {}
+		inline auto duplicate_function() -> void {}
+		inline auto duplicate_argument() -> void {}
+	}
+
+	// a string literal as a template argument
+	template<std::size_t N>
+	struct fixed_string
+	{
+		char data[N];
+
+		consteval fixed_string(const char (&string)[N]) noexcept// NOLINT(google-explicit-constructor)
+		{
+			std::ranges::copy(string, data);
+		}
+
+		[[nodiscard]] constexpr auto view() const noexcept -> std::string_view { return {data, N - 1}; }
+	};
+
+	using type_kind = ast::TypeDeclaration::variable_type;
+	using dimension_type = ast::TypeDeclaration::dimension_type;
+	using layout_type = ast::Structure::layout_type;
+
+	constexpr auto no_structure = std::numeric_limits<std::size_t>::max();
+
+	struct type_description
+	{
+		type_kind type = type_kind::NIL;
+		// index into module_view::structures if STRUCTURE
+		std::size_t structure = no_structure;
+		// the dimensions are module_view::dimensions[first_dimension, first_dimension + dimension_count)
+		std::size_t first_dimension = 0;
+		std::size_t dimension_count = 0;
+		// see ast::TypeDeclaration::size/alignment
+		std::size_t size = 0;
+		std::size_t alignment = 1;
+	};
+
+	struct field_description
+	{
+		std::string_view name;
+		type_description type;
+		// see ast::Structure::field_declaration::offset
+		std::size_t offset = 0;
+	};
+
+	struct structure_description
+	{
+		std::string_view name;
+		layout_type layout = layout_type::ARRAY_OF_STRUCTURES;
+		// the fields are module_view::fields[first_field, first_field + field_count)
+		std::size_t first_field = 0;
+		std::size_t field_count = 0;
+		// see ast::Structure::get_size/get_alignment
+		std::size_t size = 0;
+		std::size_t alignment = 1;
+	};
+
+	struct constant_description
+	{
+		enum class kind_type
+		{
+			// no initializer
+			NONE,
+			BOOLEAN,
+			// INT
+			INTEGER,
+			// FLOAT/DOUBLE, an integer literal included
+			FLOATING_POINT,
+			STRING,
+			// a name, resolved when the module runs
+			IDENTIFIER,
+		};
+
+		kind_type kind = kind_type::NONE;
+		bool boolean = false;
+		std::int64_t integer = 0;
+		double floating_point = 0;
+		// the content of a STRING, the name of an IDENTIFIER
+		std::string_view text;
+	};
+
+	struct global_description
+	{
+		std::string_view name;
+		type_description type;
+		bool is_mutable = false;
+		constant_description initializer;
+	};
+
+	struct argument_description
+	{
+		std::string_view name;
+		type_description type;
+		constant_description default_value;
+	};
+
+	struct function_description
+	{
+		std::string_view name;
+		// the arguments are module_view::arguments[first_argument, first_argument + argument_count)
+		std::size_t first_argument = 0;
+		std::size_t argument_count = 0;
+		type_description return_type;
+		// the body (braces included) is module_view::source.substr(body_offset, body_size)
+		std::size_t body_offset = 0;
+		std::size_t body_size = 0;
+	};
+
+	// a module_description of any size
+	struct module_view
+	{
+		std::string_view source;
+		std::string_view name;
+		std::span<const std::string_view> imports;
+		std::span<const dimension_type> dimensions;
+		std::span<const structure_description> structures;
+		std::span<const field_description> fields;
+		std::span<const global_description> globals;
+		std::span<const argument_description> arguments;
+		std::span<const function_description> functions;
+
+		[[nodiscard]] constexpr auto dimensions_of(const type_description& type) const noexcept -> std::span<const dimension_type> { return dimensions.subspan(type.first_dimension, type.dimension_count); }
+
+		[[nodiscard]] constexpr auto fields_of(const structure_description& structure) const noexcept -> std::span<const field_description> { return fields.subspan(structure.first_field, structure.field_count); }
+
+		[[nodiscard]] constexpr auto arguments_of(const function_description& function) const noexcept -> std::span<const argument_description> { return arguments.subspan(function.first_argument, function.argument_count); }
+
+		[[nodiscard]] constexpr auto body_of(const function_description& function) const noexcept -> std::string_view { return source.substr(function.body_offset, function.body_size); }
+
+		// nullptr if there is no such declaration
+		[[nodiscard]] constexpr auto find_structure(const std::string_view structure_name) const noexcept -> const structure_description* { return find(structures, structure_name); }
+
+		[[nodiscard]] constexpr auto find_field(const structure_description& structure, const std::string_view field_name) const noexcept -> const field_description* { return find(fields_of(structure), field_name); }
+
+		[[nodiscard]] constexpr auto find_global(const std::string_view global_name) const noexcept -> const global_description* { return find(globals, global_name); }
+
+		[[nodiscard]] constexpr auto find_function(const std::string_view function_name) const noexcept -> const function_description* { return find(functions, function_name); }
+
+	private:
+		template<typename T>
+		[[nodiscard]] constexpr static auto find(const std::span<const T> declarations, const std::string_view declaration_name) noexcept -> const T*
+		{
+			for (const auto& declaration: declarations)
+			{
+				if (declaration.name == declaration_name) { return &declaration; }
+			}
+			return nullptr;
+		}
+	};
+
+	struct module_counts
+	{
+		std::size_t imports;
+		std::size_t dimensions;
+		std::size_t structures;
+		std::size_t fields;
+		std::size_t globals;
+		std::size_t arguments;
+		std::size_t functions;
+	};
+
+	// Constant initialized, the names and the bodies refer to the source (the template argument of embed).
+	template<module_counts Counts>
+	struct module_description
+	{
+		std::string_view source;
+		std::string_view name;
+		std::array<std::string_view, Counts.imports> imports;
+		std::array<dimension_type, Counts.dimensions> dimensions;
+		std::array<structure_description, Counts.structures> structures;
+		std::array<field_description, Counts.fields> fields;
+		std::array<global_description, Counts.globals> globals;
+		std::array<argument_description, Counts.arguments> arguments;
+		std::array<function_description, Counts.functions> functions;
+
+		[[nodiscard]] constexpr auto view() const noexcept -> module_view
+		{
+			return {
+					.source = source,
+					.name = name,
+					.imports = imports,
+					.dimensions = dimensions,
+					.structures = structures,
+					.fields = fields,
+					.globals = globals,
+					.arguments = arguments,
+					.functions = functions
+			};
+		}
+	};
+
+	namespace embedded_detail
+	{
+		// A recursive descent parser of the declarations, only ever evaluated at compile time (see parse).
+		// The whole parse is transient (std::vector) and runs twice, once for the sizes of the description and once to fill it.
+		class Parser
+		{
+		public:
+			std::string_view name;
+			std::vector<std::string_view> imports;
+			std::vector<dimension_type> dimensions;
+			std::vector<structure_description> structures;
+			std::vector<field_description> fields;
+			std::vector<global_description> globals;
+			std::vector<argument_description> arguments;
+			std::vector<function_description> functions;
+
+		private:
+			std::string_view source_;
+			std::size_t position_;
+
+			[[nodiscard]] constexpr static auto is_alpha_underscore(const char c) noexcept -> bool { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_'; }
+
+			[[nodiscard]] constexpr static auto is_digit(const char c) noexcept -> bool { return c >= '0' && c <= '9'; }
+
+			[[nodiscard]] constexpr static auto align(const std::size_t offset, const std::size_t alignment) noexcept -> std::size_t { return (offset + alignment - 1) / alignment * alignment; }
+
+			// case insensitive, like ast::TypeDeclaration::parse_type
+			[[nodiscard]] constexpr static auto builtin_type(const std::string_view type_name) noexcept -> type_kind
+			{
+				constexpr auto equal = [](const std::string_view lhs, const std::string_view rhs) -> bool
+				{
+					constexpr auto lower = [](const char c) -> char { return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c; };
+					return std::ranges::equal(lhs, rhs, std::ranges::equal_to{}, lower, lower);
+				};
+
+				if (equal(type_name, "void")) { return type_kind::VOID; }
+				if (equal(type_name, "boolean")) { return type_kind::BOOLEAN; }
+				if (equal(type_name, "int")) { return type_kind::INT; }
+				if (equal(type_name, "float")) { return type_kind::FLOAT; }
+				if (equal(type_name, "double")) { return type_kind::DOUBLE; }
+				if (equal(type_name, "string")) { return type_kind::STRING; }
+				return type_kind::NIL;
+			}
+
+			template<typename T>
+			[[nodiscard]] constexpr static auto contains(const std::span<const T> declarations, const std::string_view declaration_name) noexcept -> bool
+			{
+				return std::ranges::any_of(declarations, [declaration_name](const T& declaration) { return declaration.name == declaration_name; });
+			}
+
+			// blanks, new lines and comments (`#` until the end of the line)
+			constexpr auto skip_whitespace() noexcept -> void
+			{
+				while (position_ < source_.size())
+				{
+					if (const auto c = source_[position_];
+						c == ' ' || c == '\t' || c == '\r' || c == '\n') { ++position_; }
+					else if (c == '#') { while (position_ < source_.size() && source_[position_] != '\n') { ++position_; } }
+					else { break; }
+				}
+			}
+
+			// "text", the position is at the opening quote, the text is kept as written (escapes included)
+			constexpr auto string_literal() -> std::string_view
+			{
+				const auto begin = ++position_;
+				while (position_ < source_.size() && source_[position_] != '"' && source_[position_] != '\n')
+				{
+					if (source_[position_] == '\\' && position_ + 1 < source_.size() && source_[position_ + 1] != '\n') { ++position_; }
+					++position_;
+				}
+				if (position_ == source_.size() || source_[position_] != '"')
+				{
+					error::unterminated_string();
+					return {};
+				}
+
+				return source_.substr(begin, position_++ - begin);
+			}
+
+			[[nodiscard]] constexpr auto peek() noexcept -> char
+			{
+				skip_whitespace();
+				return position_ < source_.size() ? source_[position_] : '\0';
+			}
+
+			[[nodiscard]] constexpr auto accept(const char c) noexcept -> bool
+			{
+				if (peek() != c) { return false; }
+				++position_;
+				return true;
+			}
+
+			// empty if there is none
+			[[nodiscard]] constexpr auto try_identifier() noexcept -> std::string_view
+			{
+				if (!is_alpha_underscore(peek())) { return {}; }
+
+				const auto begin = position_;
+				while (position_ < source_.size() && (is_alpha_underscore(source_[position_]) || is_digit(source_[position_]))) { ++position_; }
+				return source_.substr(begin, position_ - begin);
+			}
+
+			[[nodiscard]] constexpr auto identifier() -> std::string_view
+			{
+				const auto result = try_identifier();
+				if (result.empty()) { error::expected_identifier(); }
+				return result;
+			}
+
+			[[nodiscard]] constexpr auto accept_keyword(const std::string_view keyword) noexcept -> bool
+			{
+				const auto begin = position_;
+				if (try_identifier() == keyword) { return true; }
+				position_ = begin;
+				return false;
+			}
+
+			constexpr auto semicolon() -> void
+			{
+				if (!accept(';')) { error::expected_semicolon(); }
+			}
+
+			[[nodiscard]] constexpr auto unsigned_integer() -> std::uint64_t
+			{
+				if (!is_digit(peek())) { error::expected_dimension(); }
+
+				std::uint64_t result = 0;
+				while (position_ < source_.size() && is_digit(source_[position_]))
+				{
+					const auto digit = static_cast<std::uint64_t>(source_[position_] - '0');
+					if (result > (std::numeric_limits<std::uint64_t>::max() - digit) / 10) { error::integer_out_of_range(); }
+					result = result * 10 + digit;
+					++position_;
+				}
+				return result;
+			}
+
+			// type[1][2][3]...
+			[[nodiscard]] constexpr auto type(const bool allow_void) -> type_description
+			{
+				const auto type_name = identifier();
+
+				type_description result{.type = builtin_type(type_name), .structure = no_structure, .first_dimension = dimensions.size(), .dimension_count = 0, .size = 0, .alignment = 1};
+				switch (result.type)
+				{
+					case type_kind::VOID:
+					{
+						if (!allow_void) { error::void_variable(); }
+						result.size = 0;
+						result.alignment = 1;
+						break;
+					}
+					case type_kind::BOOLEAN:
+					{
+						result.size = sizeof(bool);
+						result.alignment = alignof(bool);
+						break;
+					}
+					case type_kind::INT:
+					{
+						result.size = sizeof(std::int32_t);
+						result.alignment = alignof(std::int32_t);
+						break;
+					}
+					case type_kind::FLOAT:
+					{
+						result.size = sizeof(float);
+						result.alignment = alignof(float);
+						break;
+					}
+					case type_kind::DOUBLE:
+					{
+						result.size = sizeof(double);
+						result.alignment = alignof(double);
+						break;
+					}
+					case type_kind::STRING:
+					{
+						result.size = sizeof(type::Value);
+						result.alignment = alignof(type::Value);
+						break;
+					}
+					case type_kind::NIL:
+					case type_kind::STRUCTURE:
+					default:
+					{
+						// only the structures declared before
+						const auto it = std::ranges::find(structures, type_name, &structure_description::name);
+						if (it == structures.end())
+						{
+							error::unknown_type();
+							break;
+						}
+
+						result.type = type_kind::STRUCTURE;
+						result.structure = static_cast<std::size_t>(it - structures.begin());
+						result.size = it->size;
+						result.alignment = it->alignment;
+						break;
+					}
+				}
+
+				while (accept('['))
+				{
+					const auto dimension = unsigned_integer();
+					if (dimension > std::numeric_limits<dimension_type>::max()) { error::integer_out_of_range(); }
+					if (!accept(']')) { error::expected_closing_bracket(); }
+
+					dimensions.push_back(static_cast<dimension_type>(dimension));
+					result.size *= dimension;
+				}
+				result.dimension_count = dimensions.size() - result.first_dimension;
+
+				return result;
+			}
+
+			// a literal or a name, checked against the declared type
+			[[nodiscard]] constexpr auto constant(const type_description& type) -> constant_description
+			{
+				using enum constant_description::kind_type;
+
+				constant_description result{};
+				if (const auto c = peek();
+					c == '"')
+				{
+					result.kind = STRING;
+					result.text = string_literal();
+				}
+				else if (is_digit(c) || c == '-')
+				{
+					const auto negative = accept('-');
+					const auto integer = unsigned_integer();
+
+					if (position_ < source_.size() && source_[position_] == '.')
+					{
+						++position_;
+						double fraction = 0;
+						double scale = 1;
+						while (position_ < source_.size() && is_digit(source_[position_]))
+						{
+							fraction = fraction * 10 + (source_[position_] - '0');
+							scale *= 10;
+							++position_;
+						}
+
+						result.kind = FLOATING_POINT;
+						result.floating_point = (static_cast<double>(integer) + fraction / scale) * (negative ? -1 : 1);
+					}
+					else
+					{
+						if (integer > static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max())) { error::integer_out_of_range(); }
+
+						result.kind = INTEGER;
+						result.integer = static_cast<std::int64_t>(integer) * (negative ? -1 : 1);
+					}
+				}
+				else if (const auto name = try_identifier();
+					!name.empty())
+				{
+					if (name == "true" || name == "false")
+					{
+						result.kind = BOOLEAN;
+						result.boolean = name == "true";
+					}
+					else
+					{
+						result.kind = IDENTIFIER;
+						result.text = name;
+					}
+				}
+				else { error::expected_initializer(); }
+
+				if (result.kind == IDENTIFIER) { return result; }
+				if (type.dimension_count != 0)
+				{
+					error::initializer_type_mismatch();
+					return result;
+				}
+
+				switch (type.type)
+				{
+					case type_kind::BOOLEAN:
+					{
+						if (result.kind != BOOLEAN) { error::initializer_type_mismatch(); }
+						break;
+					}
+					case type_kind::INT:
+					{
+						if (result.kind != INTEGER) { error::initializer_type_mismatch(); }
+						if (result.integer < std::numeric_limits<std::int32_t>::min() || result.integer > std::numeric_limits<std::int32_t>::max()) { error::integer_out_of_range(); }
+						break;
+					}
+					case type_kind::FLOAT:
+					case type_kind::DOUBLE:
+					{
+						if (result.kind == INTEGER)
+						{
+							result.kind = FLOATING_POINT;
+							result.floating_point = static_cast<double>(result.integer);
+							result.integer = 0;
+						}
+						if (result.kind != FLOATING_POINT) { error::initializer_type_mismatch(); }
+						break;
+					}
+					case type_kind::STRING:
+					{
+						if (result.kind != STRING) { error::initializer_type_mismatch(); }
+						break;
+					}
+					case type_kind::NIL:
+					case type_kind::VOID:
+					case type_kind::STRUCTURE:
+					default:
+					{
+						error::initializer_type_mismatch();
+						break;
+					}
+				}
+
+				return result;
+			}
+
+			// [@annotation...] struct name { type name ... }
+			constexpr auto structure(const layout_type layout) -> void
+			{
+				structure_description result{.name = identifier(), .layout = layout, .first_field = fields.size(), .field_count = 0, .size = 0, .alignment = 1};
+				if (contains<structure_description>(structures, result.name)) { error::duplicate_structure(); }
+
+				if (!accept('{')) { error::expected_opening_brace(); }
+
+				std::size_t end = 0;
+				while (!accept('}'))
+				{
+					if (position_ == source_.size())
+					{
+						error::unterminated_structure();
+						return;
+					}
+
+					const auto field_type = type(false);
+					const auto field_name = identifier();
+					if (contains<field_description>(std::span{fields}.subspan(result.first_field), field_name)) { error::duplicate_field(); }
+
+					const auto offset = align(end, field_type.alignment);
+					fields.push_back({.name = field_name, .type = field_type, .offset = offset});
+
+					end = offset + field_type.size;
+					result.alignment = std::ranges::max(result.alignment, field_type.alignment);
+				}
+
+				result.field_count = fields.size() - result.first_field;
+				result.size = align(end, result.alignment);
+				structures.push_back(result);
+			}
+
+			// global [mut] type name [= initializer];
+			constexpr auto global() -> void
+			{
+				const auto is_mutable = accept_keyword("mut");
+				const auto global_type = type(false);
+
+				global_description result{.name = identifier(), .type = global_type, .is_mutable = is_mutable, .initializer = {}};
+				if (contains<global_description>(globals, result.name)) { error::duplicate_global(); }
+
+				// an immutable global needs an initializer
+				if (accept('=')) { result.initializer = constant(global_type); }
+				else if (!is_mutable) { error::immutable_global_without_initializer(); }
+
+				semicolon();
+				globals.push_back(result);
+			}
+
+			// fn name(type name [= initializer], ...) -> type {...}
+			constexpr auto function() -> void
+			{
+				function_description result{.name = identifier(), .first_argument = arguments.size(), .argument_count = 0, .return_type = {}, .body_offset = 0, .body_size = 0};
+				if (contains<function_description>(functions, result.name)) { error::duplicate_function(); }
+
+				if (!accept('(')) { error::expected_opening_parenthesis(); }
+				if (!accept(')'))
+				{
+					do
+					{
+						const auto argument_type = type(false);
+
+						argument_description argument{.name = identifier(), .type = argument_type, .default_value = {}};
+						if (contains<argument_description>(std::span{arguments}.subspan(result.first_argument), argument.name)) { error::duplicate_argument(); }
+						if (accept('=')) { argument.default_value = constant(argument_type); }
+
+						arguments.push_back(argument);
+					} while (accept(','));
+
+					if (!accept(')')) { error::expected_closing_parenthesis(); }
+				}
+				result.argument_count = arguments.size() - result.first_argument;
+
+				if (!accept('-') || position_ == source_.size() || source_[position_] != '>') { error::expected_return_type(); }
+				++position_;
+				result.return_type = type(true);
+
+				// the body is skipped by brace matching (the braces of comments and strings do not count), see parse_options::lazy_function_bodies
+				if (peek() != '{') { error::expected_function_body(); }
+
+				result.body_offset = position_;
+				std::size_t depth = 0;
+				do
+				{
+					skip_whitespace();
+					if (position_ == source_.size())
+					{
+						error::unterminated_function_body();
+						return;
+					}
+
+					if (source_[position_] == '"')
+					{
+						(void)string_literal();
+						continue;
+					}
+
+					if (source_[position_] == '{') { ++depth; }
+					else if (source_[position_] == '}') { --depth; }
+					++position_;
+				} while (depth != 0);
+				result.body_size = position_ - result.body_offset;
+
+				functions.push_back(result);
+			}
+
+		public:
+			constexpr explicit Parser(const std::string_view source)
+				: source_{source},
+				position_{0} {}
+
+			// module name; import name; ... declarations ...
+			constexpr auto parse() -> void
+			{
+				if (!accept_keyword("module")) { error::expected_module_declaration(); }
+				name = identifier();
+				semicolon();
+
+				// the imports precede every other declaration
+				while (accept_keyword("import"))
+				{
+					const auto import = identifier();
+					if (std::ranges::find(imports, import) != imports.end()) { error::duplicate_import(); }
+					semicolon();
+
+					imports.push_back(import);
+				}
+
+				while (peek() != '\0')
+				{
+					auto layout = layout_type::ARRAY_OF_STRUCTURES;
+					auto annotated = false;
+					while (accept('@'))
+					{
+						if (const auto annotation = identifier();
+							annotation == "soa") { layout = layout_type::STRUCTURE_OF_ARRAYS; }
+						else if (annotation == "aos") { layout = layout_type::ARRAY_OF_STRUCTURES; }
+						else { error::unknown_annotation(); }
+						annotated = true;
+					}
+
+					if (accept_keyword("struct")) { structure(layout); }
+					else if (annotated) { error::expected_structure_declaration(); }
+					else if (accept_keyword("global")) { global(); }
+					else if (accept_keyword("fn")) { function(); }
+					else
+					{
+						error::expected_declaration();
+						return;
+					}
+				}
+			}
+
+			[[nodiscard]] constexpr auto counts() const noexcept -> module_counts
+			{
+				return {
+						.imports = imports.size(),
+						.dimensions = dimensions.size(),
+						.structures = structures.size(),
+						.fields = fields.size(),
+						.globals = globals.size(),
+						.arguments = arguments.size(),
+						.functions = functions.size()
+				};
+			}
+		};
+
+		[[nodiscard]] consteval auto count(const std::string_view source) -> module_counts
+		{
+			Parser parser{source};
+			parser.parse();
+			return parser.counts();
+		}
+	}
+
+	// the sizes of the description come from a first parse, the second one fills it
+	template<fixed_string Source>
+	[[nodiscard]] consteval auto parse() -> module_description<embedded_detail::count(Source.view())>
+	{
+		embedded_detail::Parser parser{Source.view()};
+		parser.parse();
+
+		module_description<embedded_detail::count(Source.view())> result{};
+		result.source = Source.view();
+		result.name = parser.name;
+		std::ranges::copy(parser.imports, result.imports.begin());
+		std::ranges::copy(parser.dimensions, result.dimensions.begin());
+		std::ranges::copy(parser.structures, result.structures.begin());
+		std::ranges::copy(parser.fields, result.fields.begin());
+		std::ranges::copy(parser.globals, result.globals.begin());
+		std::ranges::copy(parser.arguments, result.arguments.begin());
+		std::ranges::copy(parser.functions, result.functions.begin());
+		return result;
+	}
+
+	// `constexpr auto& script = embed<R"(module name; ...)">;`
+	template<fixed_string Source>
+	constexpr auto embed = parse<Source>();
+
+	// The module described, without parsing anything but the function bodies (on first use, options.lazy_function_bodies is implied).
+	// The names not declared by the module are resolved through options.registry, if any.
+	// The source is copied once if the module has functions, their lazy bodies share it.
+	[[nodiscard]] auto instantiate(const module_view& module, const parse_options& options = {}) -> ast::module_type;
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <gsl/backend/ast.hpp>
+#include <gsl/container/concurrent_map.hpp>
+#include <gsl/container/unordered_map.hpp>
+#include <gsl/frontend/parse.hpp>
+
+namespace gal::gsl::frontend
+{
+	// a -> b -> ... -> a
+	class import_cycle_error : public std::runtime_error
+	{
+	private:
+		container::vector<ast::symbol_name> cycle_;
+
+	public:
+		// the first and the last module are the same
+		explicit import_cycle_error(container::vector<ast::symbol_name>&& cycle);
+
+		[[nodiscard]] auto cycle() const noexcept -> const container::vector<ast::symbol_name>& { return cycle_; }
+	};
+
+	// a module without a file in the search paths, or whose file declares another module
+	class module_error : public std::runtime_error
+	{
+	public:
+		enum class reason_type
+		{
+			NOT_FOUND,
+			NAME_MISMATCH,
+		};
+
+	private:
+		reason_type reason_;
+		ast::symbol_name name_;
+		string::string path_;
+
+	public:
+		// path is empty if not found
+		module_error(reason_type reason, ast::symbol_name_view name, string::string_view path);
+
+		[[nodiscard]] auto reason() const noexcept -> reason_type { return reason_; }
+
+		// the module wanted
+		[[nodiscard]] auto name() const noexcept -> ast::symbol_name_view { return name_; }
+
+		// the file resolved for it
+		[[nodiscard]] auto path() const noexcept -> string::string_view { return path_; }
+	};
+
+	// Every module loaded so far by name, a module named `name` is the first file `<search path>/name.gsl` found.
+	// - lazily: a module is loaded (and parsed) the first time one of its importers looks up a name it does not declare itself
+	// - eagerly: load_all reads the headers of the whole import graph first, then parses it level by level, the modules of a level in parallel
+	// The imports are not transitive, a module only sees what itself and the modules it imports declare.
+	// Loading is thread safe and every module is parsed once, a lazy load that would wait (maybe through other threads) for
+	// a module its own thread is loading throws import_cycle_error instead.
+	class ModuleRegistry
+	{
+	public:
+		constexpr static string::string_view module_extension{".gsl"};
+
+	private:
+		struct entry
+		{
+			std::once_flag loaded;
+			std::atomic<bool> ready{false};
+			ast::module_type module;
+		};
+
+		using entry_type = memory::shared_ptr<entry>;
+
+		// a thread inside load
+		struct loader
+		{
+			// the modules it is loading, outermost first (the names are owned by the callers of load)
+			std::vector<ast::symbol_name_view> stack;
+			// the module it waits for another thread to load, empty if none
+			ast::symbol_name_view waiting;
+		};
+
+		container::vector<string::string> search_paths_;
+		parse_options options_;
+		container::ConcurrentMap<ast::symbol_name, entry_type, utility::string_hasher<ast::symbol_name>> modules_;
+
+		// who loads what and who waits for what, only locked around the lazy loads (never while parsing)
+		std::mutex loading_mutex_;
+		container::unordered_map<std::thread::id, loader> loaders_;
+		container::unordered_map<ast::symbol_name_view, std::thread::id, utility::string_hasher<ast::symbol_name>> loading_by_;
+
+		[[nodiscard]] auto entry_of(ast::symbol_name_view name) -> entry&;
+
+		// throw import_cycle_error if the module is loaded by this thread, or by a thread waiting (maybe through others) for this thread
+		auto begin_waiting(std::thread::id self, ast::symbol_name_view name) -> void;
+		auto end_waiting(std::thread::id self) -> void;
+
+		auto begin_loading(std::thread::id self, ast::symbol_name_view name) -> void;
+		auto end_loading(std::thread::id self, ast::symbol_name_view name) -> void;
+
+	public:
+		// options.registry is always this registry
+		explicit ModuleRegistry(container::vector<string::string> search_paths, const parse_options& options = {});
+
+		// empty if there is no such file
+		[[nodiscard]] auto resolve(ast::symbol_name_view name) const -> string::string;
+
+		// Load the module (once), throw if it cannot be found or does not match its file (module_error), cannot be read or parsed,
+		// or if it imports itself (maybe indirectly, import_cycle_error).
+		auto load(ast::symbol_name_view name) -> ast::module_type;
+
+		// nullptr if not loaded (yet)
+		[[nodiscard]] auto get(ast::symbol_name_view name) const -> ast::module_type;
+
+		// Declared by the module itself, otherwise by the first module it imports that declares it (loading them if needed).
+		[[nodiscard]] auto find_structure(const ast::Module& module, ast::symbol_name_view name) -> ast::structure_type;
+		[[nodiscard]] auto find_global(const ast::Module& module, ast::symbol_name_view name) -> ast::variable_type;
+		[[nodiscard]] auto find_function(const ast::Module& module, ast::symbol_name_view name) -> ast::function_type;
+
+		// The roots and everything they import (from their headers only, see parse_module_header), grouped by depth:
+		// level 0 imports nothing, the modules of level n only import modules of the levels before it.
+		// Throw import_cycle_error if the import graph is not acyclic, module_error if a module cannot be found or does not match its file.
+		[[nodiscard]] auto dependency_levels(std::span<const ast::symbol_name> roots) const -> container::vector<container::vector<ast::symbol_name>>;
+
+		// Load the roots and everything they import, a level after the other, the modules of a level on (up to) `threads` threads.
+		// 0 ==> std::thread::hardware_concurrency()
+		// The modules in load order.
+		auto load_all(std::span<const ast::symbol_name> roots, std::size_t threads = 0) -> container::vector<ast::module_type>;
+	};
+}
@@ -1,8 +1,50 @@
 #pragma once
 
+#include <functional>
 #include <gsl/backend/ast.hpp>
 
 namespace gal::gsl::frontend
 {
-	[[nodiscard]] auto parse_file(string::string_view filename) -> ast::module_type;
+	class ModuleRegistry;
+
+	struct parse_options
+	{
+		// Only parse the declaration of the functions (name, arguments, return type), skip their body by brace matching.
+		// A body is parsed the first time it is used (see ast::Function::get_function_body), the file is kept in memory until then.
+		bool lazy_function_bodies = false;
+
+		// The names not declared by the module are looked up in the modules it imports (loaded on first use).
+		// Without it, the imports are only recorded (see ast::Module::get_imports).
+		ModuleRegistry* registry = nullptr;
+	};
+
+	[[nodiscard]] auto parse_file(string::string_view filename, const parse_options& options = {}) -> ast::module_type;
+
+	// The parser of the bodies (`{...}`) of the functions of the module, for the functions declared without parsing their body
+	// (see ast::Function::set_lazy_function_body and frontend::embedded::instantiate). The module is not kept alive by the parser.
+	[[nodiscard]] auto make_function_body_parser(const ast::module_type& module, string::string_view filename, const parse_options& options = {}) -> ast::Function::body_parser_type;
+
+	struct module_header
+	{
+		ast::symbol_name name;
+		container::vector<ast::symbol_name> imports;
+	};
+
+	// `module name;` and the `import name;` following it, the rest of the file is not read
+	[[nodiscard]] auto parse_module_header(string::string_view filename) -> module_header;
+
+	// Every completed top level declaration of parse_file_streaming, in source order.
+	// A global/function given to its handler is removed from the module right after, the handler owns it from then on.
+	// Structures always stay in the module, the declarations after them may use them.
+	struct streaming_handler
+	{
+		std::function<void(const ast::Module&, const ast::structure_type&)> on_structure;
+		std::function<void(const ast::Module&, ast::variable_type)> on_global;
+		std::function<void(const ast::Module&, ast::function_type)> on_function;
+	};
+
+	// Read and parse the file one declaration at a time, only the declaration being parsed is held in memory (plus what stays in the module).
+	// The returned module holds the structures and the declarations without a handler.
+	// A handed over global is no longer known by the following declarations (no shadow warning, no duplicate check).
+	[[nodiscard]] auto parse_file_streaming(string::string_view filename, const streaming_handler& handler) -> ast::module_type;
 }
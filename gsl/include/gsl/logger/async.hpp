@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <gsl/logger/logger.hpp>
+
+namespace gal::gsl::logger
+{
+	// What a producer does when the queue is full.
+	enum class overflow_policy
+	{
+		// wait (spin then yield) until the sink thread frees a slot, nothing is lost
+		BLOCK,
+		// drop the new message and count it, the producer never waits
+		DISCARD,
+	};
+
+	struct async_options
+	{
+		// rounded up to a power of 2
+		std::size_t queue_size = 8192;
+		overflow_policy policy = overflow_policy::BLOCK;
+	};
+
+	// Start the background sink thread, after that all logger calls only format the message and push it into a lock-free queue.
+	// Return false if it is already running.
+	auto start_async(const async_options& options = {}) -> bool;
+
+	// Drain the queue, stop the sink thread and go back to synchronous logging.
+	// Producers racing with it are waited for, the ones not yet queued write synchronously (possibly ahead of queued messages).
+	auto stop_async() -> void;
+
+	// Number of messages dropped by overflow_policy::DISCARD since the last start_async.
+	[[nodiscard]] auto dropped_messages() noexcept -> std::size_t;
+}
@@ -1,11 +1,46 @@
 #pragma once
 
+// Compile-time minimum level, same values as spdlog: 0(trace) 1(debug) 2(info) 3(warn) 4(error) 5(critical) 6(off).
+// Calls below this level compile to nothing, use the GSL_LOGGER_XXX macros to leave their arguments unevaluated too.
+#ifndef GSL_LOGGER_LEVEL
+	#ifdef GSL_NO_LOGGER
+		#define GSL_LOGGER_LEVEL 6
+	#else
+		#define GSL_LOGGER_LEVEL 0
+	#endif
+#endif
+
+#include <string_view>
+#include <utility>
+
 #ifndef GSL_NO_LOGGER
 #include <spdlog/spdlog.h>
+#include <algorithm>
+#endif
+
+#ifndef GSL_LOGGER_ASYNC_MESSAGE_SIZE
+// messages longer than this are truncated in async mode
+#define GSL_LOGGER_ASYNC_MESSAGE_SIZE 256
 #endif
 
 namespace gal::gsl::logger
 {
+	enum class level
+	{
+		TRACE = 0,
+		DEBUG = 1,
+		INFO = 2,
+		WARN = 3,
+		ERROR = 4,
+		CRITICAL = 5,
+		OFF = 6,
+	};
+
+	constexpr auto minimum_level = static_cast<level>(GSL_LOGGER_LEVEL);
+
+	template<level Level>
+	constexpr bool is_enabled_v = static_cast<int>(Level) >= static_cast<int>(minimum_level) && Level != level::OFF;
+
 	namespace logger_detail
 	{
 		template<typename... Args>
@@ -14,53 +49,88 @@ namespace gal::gsl::logger
 		#else
 		using format_string_t = spdlog::format_string_t<Args...>;
 		#endif
+
+		constexpr std::size_t async_message_size = GSL_LOGGER_ASYNC_MESSAGE_SIZE;
+
+		// see logger/async.hpp
+		[[nodiscard]] auto is_async() noexcept -> bool;
+		auto async_log(level l, std::string_view message) -> void;
+
+		template<level Level, typename... Args>
+		auto log([[maybe_unused]] format_string_t<Args...> fmt, [[maybe_unused]] Args&&... args) -> void
+		{
+			#ifndef GSL_NO_LOGGER
+			if constexpr (is_enabled_v<Level>)
+			{
+				if (is_async())
+				{
+					// the runtime level of the default logger, checked before formatting as the synchronous path does
+					if (!spdlog::should_log(static_cast<spdlog::level::level_enum>(Level))) { return; }
+
+					// format in the calling thread, the sink thread does the (synchronous) writing
+					char buffer[async_message_size];
+					const auto result = spdlog::fmt_lib::format_to_n(buffer, async_message_size, fmt, std::forward<Args>(args)...);
+					async_log(Level, {buffer, std::min(static_cast<std::size_t>(result.size), async_message_size)});
+				}
+				else { spdlog::log(static_cast<spdlog::level::level_enum>(Level), fmt, std::forward<Args>(args)...); }
+			}
+			#endif
+		}
 	}
 
 	template<typename... Args>
-	auto trace([[maybe_unused]] logger_detail::format_string_t<Args...> fmt, [[maybe_unused]] Args&&... args) -> void
-	{
-		#ifndef GSL_NO_LOGGER
-		spdlog::trace(fmt, std::forward<Args>(args)...);
-		#endif
-	}
+	auto trace(logger_detail::format_string_t<Args...> fmt, Args&&... args) -> void { logger_detail::log<level::TRACE>(fmt, std::forward<Args>(args)...); }
 
 	template<typename... Args>
-	auto debug([[maybe_unused]] logger_detail::format_string_t<Args...> fmt, [[maybe_unused]] Args&&... args) -> void
-	{
-		#ifndef GSL_NO_LOGGER
-		spdlog::debug(fmt, std::forward<Args>(args)...);
-		#endif
-	}
+	auto debug(logger_detail::format_string_t<Args...> fmt, Args&&... args) -> void { logger_detail::log<level::DEBUG>(fmt, std::forward<Args>(args)...); }
 
 	template<typename... Args>
-	auto info([[maybe_unused]] logger_detail::format_string_t<Args...> fmt, [[maybe_unused]] Args&&... args) -> void
-	{
-		#ifndef GSL_NO_LOGGER
-		spdlog::info(fmt, std::forward<Args>(args)...);
-		#endif
-	}
+	auto info(logger_detail::format_string_t<Args...> fmt, Args&&... args) -> void { logger_detail::log<level::INFO>(fmt, std::forward<Args>(args)...); }
 
 	template<typename... Args>
-	auto warn([[maybe_unused]] logger_detail::format_string_t<Args...> fmt, [[maybe_unused]] Args&&... args) -> void
-	{
-		#ifndef GSL_NO_LOGGER
-		spdlog::warn(fmt, std::forward<Args>(args)...);
-		#endif
-	}
+	auto warn(logger_detail::format_string_t<Args...> fmt, Args&&... args) -> void { logger_detail::log<level::WARN>(fmt, std::forward<Args>(args)...); }
 
 	template<typename... Args>
-	auto error([[maybe_unused]] logger_detail::format_string_t<Args...> fmt, [[maybe_unused]] Args&&... args) -> void
-	{
-		#ifndef GSL_NO_LOGGER
-		spdlog::error(fmt, std::forward<Args>(args)...);
-		#endif
-	}
+	auto error(logger_detail::format_string_t<Args...> fmt, Args&&... args) -> void { logger_detail::log<level::ERROR>(fmt, std::forward<Args>(args)...); }
 
 	template<typename... Args>
-	auto critical([[maybe_unused]] logger_detail::format_string_t<Args...> fmt, [[maybe_unused]] Args&&... args) -> void
-	{
-		#ifndef GSL_NO_LOGGER
-		spdlog::critical(fmt, std::forward<Args>(args)...);
-		#endif
-	}
+	auto critical(logger_detail::format_string_t<Args...> fmt, Args&&... args) -> void { logger_detail::log<level::CRITICAL>(fmt, std::forward<Args>(args)...); }
 }
+
+#define GSL_LOGGER_PRIVATE_DISCARD(...) static_cast<void>(0)
+
+#if GSL_LOGGER_LEVEL <= 0
+	#define GSL_LOGGER_TRACE(...) ::gal::gsl::logger::trace(__VA_ARGS__)
+#else
+	#define GSL_LOGGER_TRACE(...) GSL_LOGGER_PRIVATE_DISCARD(__VA_ARGS__)
+#endif
+
+#if GSL_LOGGER_LEVEL <= 1
+	#define GSL_LOGGER_DEBUG(...) ::gal::gsl::logger::debug(__VA_ARGS__)
+#else
+	#define GSL_LOGGER_DEBUG(...) GSL_LOGGER_PRIVATE_DISCARD(__VA_ARGS__)
+#endif
+
+#if GSL_LOGGER_LEVEL <= 2
+	#define GSL_LOGGER_INFO(...) ::gal::gsl::logger::info(__VA_ARGS__)
+#else
+	#define GSL_LOGGER_INFO(...) GSL_LOGGER_PRIVATE_DISCARD(__VA_ARGS__)
+#endif
+
+#if GSL_LOGGER_LEVEL <= 3
+	#define GSL_LOGGER_WARN(...) ::gal::gsl::logger::warn(__VA_ARGS__)
+#else
+	#define GSL_LOGGER_WARN(...) GSL_LOGGER_PRIVATE_DISCARD(__VA_ARGS__)
+#endif
+
+#if GSL_LOGGER_LEVEL <= 4
+	#define GSL_LOGGER_ERROR(...) ::gal::gsl::logger::error(__VA_ARGS__)
+#else
+	#define GSL_LOGGER_ERROR(...) GSL_LOGGER_PRIVATE_DISCARD(__VA_ARGS__)
+#endif
+
+#if GSL_LOGGER_LEVEL <= 5
+	#define GSL_LOGGER_CRITICAL(...) ::gal::gsl::logger::critical(__VA_ARGS__)
+#else
+	#define GSL_LOGGER_CRITICAL(...) GSL_LOGGER_PRIVATE_DISCARD(__VA_ARGS__)
+#endif
@@ -60,7 +60,7 @@ namespace gal::gsl::memory
 
 			static_assert(sizeof(value_type), "value_type must be complete before calling allocate.");
 
-			if constexpr (can_allocate_atomic_v<value_type>) { return static_cast<pointer>(allocate_without_pointer(size)); }
+			if constexpr (can_allocate_atomic_v<value_type>) { return static_cast<pointer>(allocate_without_pointer(size * sizeof(value_type))); }
 			else { return static_cast<pointer>(memory::allocate(size * sizeof(value_type))); }
 		}
 
@@ -120,7 +120,7 @@ namespace gal::gsl::memory
 
 			static_assert(sizeof(value_type), "value_type must be complete before calling allocate.");
 
-			if constexpr (can_allocate_atomic_v<value_type>) { return static_cast<pointer>(allocate_without_collect_and_pointer(size)); }
+			if constexpr (can_allocate_atomic_v<value_type>) { return static_cast<pointer>(allocate_without_collect_and_pointer(size * sizeof(value_type))); }
 			else { return static_cast<pointer>(allocate_without_collect(size * sizeof(value_type))); }
 		}
 
@@ -152,7 +152,7 @@ namespace gal::gsl::memory
 			if constexpr (std::is_same_v<T, value_type>) { return memory::allocate(size); }
 			else
 			{
-				if constexpr (can_allocate_atomic_v<T>) { return static_cast<pointer>(memory::allocate_without_pointer(size)); }
+				if constexpr (can_allocate_atomic_v<T>) { return static_cast<pointer>(memory::allocate_without_pointer(size * sizeof(T))); }
 				else { return static_cast<pointer>(memory::allocate(size * sizeof(T))); }
 			}
 		}
@@ -0,0 +1,66 @@
+#pragma once
+
+// Sampled heap profile by allocation site: about one allocation every `sample_interval` bytes is recorded
+// (its site, its size and an estimate of the bytes it stands for), a sampled object is forgotten when it is freed or collected.
+// Everything here compiles out unless GSL_MEMORY_PROFILE is defined (see GAL_SCRIPT_LANG_ENABLE_MEMORY_PROFILE).
+
+#include <gsl/string/string_view.hpp>
+
+#ifdef GSL_MEMORY_PROFILE
+#include <cstdint>
+#include <source_location>
+#include <vector>
+#endif
+
+namespace gal::gsl::memory::profile
+{
+	#ifdef GSL_MEMORY_PROFILE
+	constexpr std::size_t default_sample_interval = 512 * 1024;
+
+	// estimated from the samples
+	struct allocation_site
+	{
+		// the caller of memory::allocate*, usually an allocator instantiation (its function name tells the type allocated)
+		const char* file;
+		const char* function;
+		std::uint32_t line;
+
+		std::size_t live_bytes;
+		std::size_t live_objects;
+		std::size_t allocated_bytes;
+		std::size_t allocated_objects;
+	};
+
+	// 0 ==> stop sampling (the samples taken so far are kept)
+	auto set_sample_interval(std::size_t bytes) noexcept -> void;
+
+	[[nodiscard]] auto get_sample_interval() noexcept -> std::size_t;
+
+	// every site sampled so far, the most live bytes first
+	[[nodiscard]] auto report() -> std::vector<allocation_site>;
+
+	// report() as tab separated text
+	auto dump(string::string_view filename) -> bool;
+
+	// forget every sample
+	auto clear() noexcept -> void;
+
+	enum class allocation_kind
+	{
+		COLLECTABLE,
+		// collectable, without a debug header even with GSL_MEMORY_DEBUG (see memory::allocate_typed)
+		TYPED,
+		UNCOLLECTABLE,
+	};
+
+	// Called by memory::allocate*/reallocate/deallocate*, the allocation is sampled once the bytes allocated by this thread since the last sample
+	// exceed a random (exponential) draw of mean sample_interval.
+	// Note: it never allocates from gc (the profile lives in the system heap).
+	auto on_allocate(void* object, std::size_t size, allocation_kind kind, const std::source_location& location) noexcept -> void;
+	auto on_deallocate(void* object) noexcept -> void;
+	#else
+	inline auto dump(string::string_view) -> bool { return false; }
+
+	inline auto clear() noexcept -> void {}
+	#endif
+}
@@ -1,27 +1,65 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <span>
 
+// The backend behind the functions below (see GAL_SCRIPT_LANG_MEMORY_BACKEND), the collector unless told otherwise:
+// - GSL_MEMORY_BACKEND_BDWGC: the conservative collector (bdwgc), nothing has to be deallocated
+// - GSL_MEMORY_BACKEND_SYSTEM: std::malloc and friends, nothing is collected (what is not deallocated leaks)
+// - GSL_MEMORY_BACKEND_SIZE_CLASS: memory::size_class (thread cached size classes), nothing is collected either
+#if !defined(GSL_MEMORY_BACKEND_BDWGC) && !defined(GSL_MEMORY_BACKEND_SYSTEM) && !defined(GSL_MEMORY_BACKEND_SIZE_CLASS)
+#define GSL_MEMORY_BACKEND_BDWGC
+#endif
+
+// debug allocations (GC_debug_*, with a header recording the allocation site) unless NDEBUG
 #ifndef GSL_MEMORY_DEBUG
-#ifndef _NDEBUG
-#include <source_location>
-#include <string_view>
+#ifndef NDEBUG
 #define GSL_MEMORY_DEBUG
 #define FIND_LEAK 1
-#define GSL_MEMORY_DEBUG_MESSAGE_DECL(message) , std::string_view(message) = "", const std::source_location& location = std::source_location::current()
-#define GSL_MEMORY_DEBUG_MESSAGE(message) , const std::string_view(message), const std::source_location& location
-#define GSL_MEMORY_DEBUG_MESSAGE_USE(message) , (message).empty() ? location.function_name() : (message).data(), static_cast<int>(location.line())
 #endif
 #endif
 
-#ifndef GSL_MEMORY_DEBUG
+// the allocation site is passed along for the debug allocations and the heap profiler (see memory/profile.hpp) only,
+// otherwise allocating is a plain call of the collector
+#if defined(GSL_MEMORY_DEBUG) || defined(GSL_MEMORY_PROFILE)
+#include <source_location>
+#include <string_view>
+#define GSL_MEMORY_DEBUG_MESSAGE_DECL(message) , std::string_view(message) = "", const std::source_location& location = std::source_location::current()
+#define GSL_MEMORY_DEBUG_MESSAGE(message) , const std::string_view(message), const std::source_location& location
+#else
 	#define GSL_MEMORY_DEBUG_MESSAGE_DECL(message)
 	#define GSL_MEMORY_DEBUG_MESSAGE(message)
+#endif
+
+#ifdef GSL_MEMORY_DEBUG
+#define GSL_MEMORY_DEBUG_MESSAGE_USE(message) , (message).empty() ? location.function_name() : (message).data(), static_cast<int>(location.line())
+#else
 	#define GSL_MEMORY_DEBUG_MESSAGE_USE(message)
 #endif
 
 namespace gal::gsl::memory
 {
+	enum class backend_type
+	{
+		BDWGC,
+		SYSTEM,
+		SIZE_CLASS,
+	};
+
+	constexpr backend_type backend =
+	#if defined(GSL_MEMORY_BACKEND_SYSTEM)
+			backend_type::SYSTEM
+	#elif defined(GSL_MEMORY_BACKEND_SIZE_CLASS)
+			backend_type::SIZE_CLASS
+	#else
+			backend_type::BDWGC
+	#endif
+			;
+
+	// false ==> every allocation must be deallocated by its owner
+	constexpr bool collected = backend == backend_type::BDWGC;
+
 	// For any type of object
 	[[nodiscard]] auto allocate(std::size_t size GSL_MEMORY_DEBUG_MESSAGE_DECL(message)) -> void*;
 
@@ -34,8 +72,28 @@ namespace gal::gsl::memory
 	// Like allocate_without_pointer
 	[[nodiscard]] auto allocate_without_collect_and_pointer(std::size_t size GSL_MEMORY_DEBUG_MESSAGE_DECL(message)) -> void*;
 
+	// The words of an object that may hold a pointer, see allocate_typed
+	using type_descriptor = std::uintptr_t;
+
+	constexpr std::size_t bits_per_bitmap_word = sizeof(std::uintptr_t) * 8;
+
+	// bit (i % bits_per_bitmap_word) of bitmap[i / bits_per_bitmap_word] set ==> the i-th pointer-sized word of the object may hold a pointer
+	[[nodiscard]] auto make_type_descriptor(std::span<const std::uintptr_t> bitmap, std::size_t word_count) -> type_descriptor;
+
+	// Zeroed, the collector only scans the words marked in the descriptor (no debug header, even with GSL_MEMORY_DEBUG)
+	[[nodiscard]] auto allocate_typed(std::size_t size, type_descriptor descriptor GSL_MEMORY_DEBUG_MESSAGE_DECL(message)) -> void*;
+
+	// Like allocate_typed, `count` contiguous objects of `size` bytes with the same layout
+	[[nodiscard]] auto allocate_typed_array(std::size_t count, std::size_t size, type_descriptor descriptor GSL_MEMORY_DEBUG_MESSAGE_DECL(message)) -> void*;
+
 	[[nodiscard]] auto reallocate(void* old_object, std::size_t required_size GSL_MEMORY_DEBUG_MESSAGE_DECL(message)) -> void*;
 
 	// Optional deallocate memory
 	auto deallocate(void* data) -> void;
+
+	// Optional deallocate memory returned by allocate_typed/allocate_typed_array
+	auto deallocate_typed(void* data) -> void;
+
+	// Run a full collection now, nothing to do if the backend does not collect
+	auto collect() -> void;
 }
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <gsl/memory/allocator.hpp>
+
+namespace gal::gsl::memory
+{
+	// A bump allocator for everything that dies at the same time (e.g. the objects of one script invocation).
+	// The memory is never collected but is scanned by the collector, the objects of the region keep the objects of the heap alive.
+	// The opposite is not true, nothing outside the region may point into it after reset (copy what escapes to the heap first).
+	// Not thread safe, install it on the thread running the invocation (see RegionScope).
+	class Region
+	{
+	public:
+		using size_type = std::size_t;
+
+		constexpr static size_type default_chunk_size = 64 * 1024;
+		constexpr static size_type default_alignment = alignof(std::max_align_t);
+
+	private:
+		struct chunk
+		{
+			chunk* next;
+			// excluding this header
+			size_type capacity;
+
+			[[nodiscard]] auto begin() noexcept -> std::byte* { return reinterpret_cast<std::byte*>(this + 1); }
+
+			[[nodiscard]] auto end() noexcept -> std::byte* { return begin() + capacity; }
+		};
+
+		static_assert(sizeof(chunk) % default_alignment == 0);
+
+		size_type chunk_size_;
+
+		chunk* head_;
+		chunk* current_;
+		std::byte* cursor_;
+
+		// handed out since the last reset
+		size_type allocated_;
+		// reserved from the collector
+		size_type reserved_;
+
+		// use the next chunk (or a new one) able to hold size bytes aligned as required
+		auto grow(size_type size, size_type alignment) -> void;
+
+	public:
+		explicit Region(size_type chunk_size = default_chunk_size);
+
+		Region(const Region&) = delete;
+		auto operator=(const Region&) -> Region& = delete;
+		Region(Region&&) = delete;
+		auto operator=(Region&&) -> Region& = delete;
+		~Region() noexcept;
+
+		// the region installed on this thread, nullptr if none
+		[[nodiscard]] static auto current() noexcept -> Region*;
+
+		[[nodiscard]] auto allocate(const size_type size, const size_type alignment = default_alignment) -> void*
+		{
+			auto* aligned = reinterpret_cast<std::byte*>((reinterpret_cast<std::uintptr_t>(cursor_) + alignment - 1) & ~(alignment - 1));
+			if (!current_ || aligned + size > current_->end()) [[unlikely]]
+			{
+				grow(size, alignment);
+				aligned = reinterpret_cast<std::byte*>((reinterpret_cast<std::uintptr_t>(cursor_) + alignment - 1) & ~(alignment - 1));
+			}
+
+			cursor_ = aligned + size;
+			allocated_ += size;
+			return aligned;
+		}
+
+		// destructors never run, only for trivially destructible objects
+		template<typename T, typename... Args>
+			requires std::is_trivially_destructible_v<T>
+		[[nodiscard]] auto make(Args&&... args) -> T*
+		{
+			return std::construct_at(static_cast<T*>(allocate(sizeof(T), alignof(T))), std::forward<Args>(args)...);
+		}
+
+		// Release everything allocated from the region in O(1), the chunks are kept for the next use.
+		// The old content is not cleared, it may keep a few objects of the heap alive until overwritten.
+		auto reset() noexcept -> void;
+
+		// like reset, but give the chunks back to the collector
+		auto release() noexcept -> void;
+
+		// O(number of chunks), mostly for assertions
+		[[nodiscard]] auto contains(const void* pointer) const noexcept -> bool;
+
+		[[nodiscard]] auto bytes_allocated() const noexcept -> size_type { return allocated_; }
+
+		[[nodiscard]] auto bytes_reserved() const noexcept -> size_type { return reserved_; }
+	};
+
+	// Install a region as the current one of this thread until the end of the scope.
+	class RegionScope
+	{
+	private:
+		Region* previous_;
+
+	public:
+		explicit RegionScope(Region& region) noexcept;
+
+		RegionScope(const RegionScope&) = delete;
+		auto operator=(const RegionScope&) -> RegionScope& = delete;
+		RegionScope(RegionScope&&) = delete;
+		auto operator=(RegionScope&&) -> RegionScope& = delete;
+		~RegionScope() noexcept;
+	};
+
+	// Like 'AnyAllocator', but allocate from the region current when the allocator was created (if any).
+	// Deallocation of region memory does nothing, the region resets it all at once.
+	template<typename T>
+	class RegionAllocator
+	{
+		template<typename>
+		friend class RegionAllocator;
+
+	public:
+		using allocator_type = RegionAllocator<T>;
+
+		using value_type = T;
+
+		using pointer = T*;
+		using const_pointer = const T*;
+		using void_pointer = void*;
+		using const_void_pointer = const void*;
+
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		using propagate_on_container_copy_assignment = std::true_type;
+		using propagate_on_container_move_assignment = std::true_type;
+		using propagate_on_container_swap = std::true_type;
+		using is_always_equal = std::false_type;
+
+		template<typename U>
+		using rebind_alloc = RegionAllocator<U>;
+
+	private:
+		Region* region_;
+
+	public:
+		RegionAllocator() noexcept
+			: region_{Region::current()} {}
+
+		constexpr explicit RegionAllocator(Region* region) noexcept
+			: region_{region} {}
+
+		constexpr RegionAllocator(const RegionAllocator&) noexcept = default;
+		constexpr RegionAllocator(RegionAllocator&&) noexcept = default;
+		constexpr auto operator=(const RegionAllocator&) noexcept -> RegionAllocator& = default;
+		constexpr auto operator=(RegionAllocator&&) noexcept -> RegionAllocator& = default;
+		constexpr ~RegionAllocator() noexcept = default;
+
+		template<typename U>
+		constexpr explicit(false) RegionAllocator(const RegionAllocator<U>& other) noexcept
+			: region_{other.region_} {}
+
+		[[nodiscard]] constexpr auto get_region() const noexcept -> Region* { return region_; }
+
+		[[nodiscard]] auto allocate(const size_type size) -> pointer
+		{
+			static_assert(sizeof(value_type), "value_type must be complete before calling allocate.");
+
+			if (region_) { return static_cast<pointer>(region_->allocate(size * sizeof(value_type), alignof(value_type))); }
+
+			if constexpr (can_allocate_atomic_v<value_type>) { return static_cast<pointer>(allocate_without_pointer(size * sizeof(value_type))); }
+			else { return static_cast<pointer>(memory::allocate(size * sizeof(value_type))); }
+		}
+
+		auto deallocate(const pointer pointer, const size_type size) noexcept -> void
+		{
+			(void)size;
+
+			if (!region_) { memory::deallocate(pointer); }
+		}
+
+		template<typename U>
+		[[nodiscard]] friend constexpr auto operator==(const RegionAllocator& lhs, const RegionAllocator<U>& rhs) noexcept -> bool { return lhs.region_ == rhs.region_; }
+	};
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace gal::gsl::memory::size_class
+{
+	// A malloc for lifetimes managed by hand (the SIZE_CLASS backend of memory::allocate*, see GAL_SCRIPT_LANG_MEMORY_BACKEND).
+	// The sizes up to max_size are rounded up to one of class_count classes (16 bytes apart up to 128, then 4 classes per power of 2),
+	// a block of each class is taken from the free list of the calling thread, refilled by batch from a central list (or a new span).
+	// A block freed by another thread goes to the list of that thread, the lists hand their surplus back to the central lists.
+	// The spans are never given back to the system, larger sizes are forwarded to std::malloc.
+
+	constexpr std::size_t alignment = alignof(std::max_align_t);
+	constexpr std::size_t max_size = 32 * 1024;
+	constexpr std::size_t class_count = 8 + (std::bit_width(max_size - 1) - 7) * 4;
+
+	[[nodiscard]] constexpr auto class_of(const std::size_t size) noexcept -> std::size_t
+	{
+		if (size <= 128) { return size == 0 ? 0 : (size + 15) / 16 - 1; }
+
+		// (2^(p - 1), 2^p] ==> 4 classes 2^(p - 3) apart
+		const auto p = static_cast<std::size_t>(std::bit_width(size - 1));
+		const auto step = std::size_t{1} << (p - 3);
+		return 8 + (p - 8) * 4 + (size - (std::size_t{1} << (p - 1)) + step - 1) / step - 1;
+	}
+
+	[[nodiscard]] constexpr auto size_of_class(const std::size_t index) noexcept -> std::size_t
+	{
+		if (index < 8) { return (index + 1) * 16; }
+
+		const auto p = 8 + (index - 8) / 4;
+		return (std::size_t{1} << (p - 1)) + ((index - 8) % 4 + 1) * (std::size_t{1} << (p - 3));
+	}
+
+	static_assert(class_of(max_size) == class_count - 1 && size_of_class(class_count - 1) == max_size);
+	static_assert(class_of(129) == 8 && size_of_class(8) == 160);
+
+	// aligned to `alignment`, nullptr if out of memory
+	[[nodiscard]] auto allocate(std::size_t size) noexcept -> void*;
+
+	[[nodiscard]] auto allocate_zeroed(std::size_t size) noexcept -> void*;
+
+	// in place if the class of the object fits the size
+	[[nodiscard]] auto reallocate(void* object, std::size_t size) noexcept -> void*;
+
+	auto deallocate(void* object) noexcept -> void;
+
+	// the size of the class of the object
+	[[nodiscard]] auto usable_size(const void* object) noexcept -> std::size_t;
+}
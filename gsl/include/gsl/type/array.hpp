@@ -0,0 +1,249 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <concepts>
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <utility>
+#include <gsl/container/vector.hpp>
+#include <gsl/memory/raw.hpp>
+#include <gsl/debug/assert.hpp>
+
+namespace gal::gsl::type
+{
+	// script int/float/double
+	template<typename T>
+	concept array_element_t =
+			std::same_as<T, std::int32_t> ||
+			std::same_as<T, float> ||
+			std::same_as<T, double>;
+
+	// Bulk kernels over contiguous elements, see src/type/array.cpp.
+	// The output of the element-wise kernels may alias one of the inputs exactly, but not partially.
+	namespace kernel
+	{
+		template<array_element_t T>
+		auto add(std::span<const T> lhs, std::span<const T> rhs, std::span<T> out) noexcept -> void;
+
+		template<array_element_t T>
+		auto mul(std::span<const T> lhs, std::span<const T> rhs, std::span<T> out) noexcept -> void;
+
+		// out[i] = lhs[i] * scalar
+		template<array_element_t T>
+		auto scale(std::span<const T> lhs, T scalar, std::span<T> out) noexcept -> void;
+
+		template<array_element_t T>
+		[[nodiscard]] auto sum(std::span<const T> data) noexcept -> T;
+
+		// data must not be empty
+		template<array_element_t T>
+		[[nodiscard]] auto min(std::span<const T> data) noexcept -> T;
+
+		// data must not be empty
+		template<array_element_t T>
+		[[nodiscard]] auto max(std::span<const T> data) noexcept -> T;
+
+		template<array_element_t T>
+		[[nodiscard]] auto dot(std::span<const T> lhs, std::span<const T> rhs) noexcept -> T;
+	}
+
+	// Fixed-dimension array: type[1][2][3]
+	// All elements live in one contiguous, aligned, row-major block, the strides are computed once on construction.
+	template<array_element_t T>
+	class Array
+	{
+	public:
+		using value_type = T;
+		using size_type = std::uint32_t;
+		using extent_container_type = container::vector<size_type>;
+
+		// enough for every vector instruction set we care about
+		constexpr static std::size_t alignment = 64;
+
+	private:
+		extent_container_type extents_;
+		// in elements, strides_.back() == 1
+		extent_container_type strides_;
+		std::size_t size_;
+
+		void* block_;
+		value_type* data_;
+
+		auto allocate() -> void
+		{
+			// the elements contain no pointer, so the collector never scans them
+			block_ = memory::allocate_without_pointer(size_ * sizeof(value_type) + alignment);
+			data_ = reinterpret_cast<value_type*>((reinterpret_cast<std::uintptr_t>(block_) + alignment - 1) & ~(alignment - 1));
+		}
+
+	public:
+		explicit Array(const std::span<const size_type> extents)
+			: extents_{extents.begin(), extents.end()},
+			strides_(extents.size(), 1),
+			size_{std::accumulate(extents.begin(), extents.end(), std::size_t{1}, std::multiplies<>{})},
+			block_{nullptr},
+			data_{nullptr}
+		{
+			gsl_assert(!extents_.empty(), "an array should have at least one dimension!");
+
+			for (auto i = extents_.size() - 1; i != 0; --i) { strides_[i - 1] = strides_[i] * extents_[i]; }
+
+			allocate();
+			std::ranges::fill_n(data_, static_cast<std::ptrdiff_t>(size_), value_type{});
+		}
+
+		Array(const std::initializer_list<size_type> extents)
+			: Array{std::span{extents.begin(), extents.size()}} {}
+
+		Array(const Array& other)
+			: extents_{other.extents_},
+			strides_{other.strides_},
+			size_{other.size_},
+			block_{nullptr},
+			data_{nullptr}
+		{
+			allocate();
+			std::ranges::copy_n(other.data_, static_cast<std::ptrdiff_t>(size_), data_);
+		}
+
+		auto operator=(const Array& other) -> Array&
+		{
+			if (this != &other)
+			{
+				Array copy{other};
+				swap(copy);
+			}
+			return *this;
+		}
+
+		Array(Array&& other) noexcept
+			: extents_{std::move(other.extents_)},
+			strides_{std::move(other.strides_)},
+			size_{std::exchange(other.size_, 0)},
+			block_{std::exchange(other.block_, nullptr)},
+			data_{std::exchange(other.data_, nullptr)} {}
+
+		auto operator=(Array&& other) noexcept -> Array&
+		{
+			Array moved{std::move(other)};
+			swap(moved);
+			return *this;
+		}
+
+		~Array() noexcept { if (block_) { memory::deallocate(block_); } }
+
+		auto swap(Array& other) noexcept -> void
+		{
+			using std::swap;
+			swap(extents_, other.extents_);
+			swap(strides_, other.strides_);
+			swap(size_, other.size_);
+			swap(block_, other.block_);
+			swap(data_, other.data_);
+		}
+
+		[[nodiscard]] auto rank() const noexcept -> std::size_t { return extents_.size(); }
+
+		[[nodiscard]] auto extents() const noexcept -> std::span<const size_type> { return extents_; }
+
+		[[nodiscard]] auto strides() const noexcept -> std::span<const size_type> { return strides_; }
+
+		[[nodiscard]] auto size() const noexcept -> std::size_t { return size_; }
+
+		[[nodiscard]] auto data() noexcept -> value_type* { return data_; }
+
+		[[nodiscard]] auto data() const noexcept -> const value_type* { return data_; }
+
+		[[nodiscard]] auto elements() noexcept -> std::span<value_type> { return {data_, size_}; }
+
+		[[nodiscard]] auto elements() const noexcept -> std::span<const value_type> { return {data_, size_}; }
+
+		[[nodiscard]] auto same_shape(const Array& other) const noexcept -> bool { return std::ranges::equal(extents_, other.extents_); }
+
+		// row-major flat offset of array[i0][i1]...
+		[[nodiscard]] auto offset_of(const std::span<const size_type> indices) const noexcept -> std::size_t
+		{
+			gsl_assert(indices.size() == rank(), "dimension mismatch!");
+
+			std::size_t offset = 0;
+			for (std::size_t i = 0; i < indices.size(); ++i)
+			{
+				gsl_assert(indices[i] < extents_[i], "index out of range!");
+				offset += static_cast<std::size_t>(indices[i]) * strides_[i];
+			}
+			return offset;
+		}
+
+		[[nodiscard]] auto operator[](const std::size_t flat_index) noexcept -> value_type& { return data_[flat_index]; }
+
+		[[nodiscard]] auto operator[](const std::size_t flat_index) const noexcept -> const value_type& { return data_[flat_index]; }
+
+		[[nodiscard]] auto at(const std::span<const size_type> indices) noexcept -> value_type& { return data_[offset_of(indices)]; }
+
+		[[nodiscard]] auto at(const std::span<const size_type> indices) const noexcept -> const value_type& { return data_[offset_of(indices)]; }
+
+		[[nodiscard]] auto at(const std::initializer_list<size_type> indices) noexcept -> value_type& { return at(std::span{indices.begin(), indices.size()}); }
+
+		[[nodiscard]] auto at(const std::initializer_list<size_type> indices) const noexcept -> const value_type& { return at(std::span{indices.begin(), indices.size()}); }
+
+		// ===================================
+		// builtin bulk operations
+		// ===================================
+
+		// this += other
+		auto add(const Array& other) noexcept -> Array&
+		{
+			gsl_assert(same_shape(other), "shape mismatch!");
+			kernel::add<value_type>(elements(), other.elements(), elements());
+			return *this;
+		}
+
+		// this *= other (element-wise)
+		auto mul(const Array& other) noexcept -> Array&
+		{
+			gsl_assert(same_shape(other), "shape mismatch!");
+			kernel::mul<value_type>(elements(), other.elements(), elements());
+			return *this;
+		}
+
+		// this *= scalar
+		auto scale(const value_type scalar) noexcept -> Array&
+		{
+			kernel::scale<value_type>(elements(), scalar, elements());
+			return *this;
+		}
+
+		[[nodiscard]] auto sum() const noexcept -> value_type { return kernel::sum<value_type>(elements()); }
+
+		[[nodiscard]] auto min() const noexcept -> value_type { return kernel::min<value_type>(elements()); }
+
+		[[nodiscard]] auto max() const noexcept -> value_type { return kernel::max<value_type>(elements()); }
+
+		// sum of the element-wise product, the shape is ignored
+		[[nodiscard]] auto dot(const Array& other) const noexcept -> value_type
+		{
+			gsl_assert(size() == other.size(), "size mismatch!");
+			return kernel::dot<value_type>(elements(), other.elements());
+		}
+
+		[[nodiscard]] friend auto operator+(const Array& lhs, const Array& rhs) -> Array
+		{
+			gsl_assert(lhs.same_shape(rhs), "shape mismatch!");
+
+			Array result{lhs.extents()};
+			kernel::add<value_type>(lhs.elements(), rhs.elements(), result.elements());
+			return result;
+		}
+
+		[[nodiscard]] friend auto operator*(const Array& lhs, const Array& rhs) -> Array
+		{
+			gsl_assert(lhs.same_shape(rhs), "shape mismatch!");
+
+			Array result{lhs.extents()};
+			kernel::mul<value_type>(lhs.elements(), rhs.elements(), result.elements());
+			return result;
+		}
+	};
+}
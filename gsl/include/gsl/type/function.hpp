@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <gsl/type/value.hpp>
+
+namespace gal::gsl::type
+{
+	// how BuiltinFunction::invoke_batch splits the rows of a batch
+	struct batch_options
+	{
+		// 0 ==> std::thread::hardware_concurrency()
+		std::size_t threads = 1;
+		// no thread gets fewer rows than this, small batches stay on the calling thread
+		std::size_t min_rows_per_thread = 4096;
+	};
+
+	// A host function callable by scripts, its arguments and result go through ValueCaster.
+	// Made by make<Function>(), which generates both a single call invoker and a batch invoker:
+	// the batch invoker is entered once per batch and unpacks the rows inline, without any argument frame.
+	class BuiltinFunction
+	{
+	public:
+		using argument_count_type = std::uint32_t;
+
+		// arguments[arity] ==> result
+		using invoker_type = auto (*)(const Value* arguments) -> Value;
+		// columns[arity][count] ==> results[count]
+		using batch_invoker_type = auto (*)(const Value* const* columns, Value* results, std::size_t count) -> void;
+
+	private:
+		argument_count_type arity_;
+		invoker_type invoker_;
+		batch_invoker_type batch_invoker_;
+
+		// by value if the type has its own caster (see ValueCaster<String>), T& ==> an observer otherwise
+		template<typename T>
+		using caster_of = std::conditional_t<
+			ValueCaster<std::remove_cvref_t<T>>::value != value_caster_policy::UNDEFINED,
+			ValueCaster<std::remove_cvref_t<T>>,
+			ValueCaster<T>
+		>;
+
+		template<auto Function, typename Result, typename... Arguments, std::size_t... Index>
+		static auto invoke_row(const Value* const* columns, const std::size_t row, std::index_sequence<Index...>) -> Value
+		{
+			if constexpr (std::is_void_v<Result>)
+			{
+				Function(caster_of<Arguments>::to(columns[Index][row])...);
+				return Value{};
+			}
+			else { return caster_of<Result>::from(Function(caster_of<Arguments>::to(columns[Index][row])...)); }
+		}
+
+		template<auto Function, typename Result, typename... Arguments>
+		[[nodiscard]] constexpr static auto make(Result (*)(Arguments...)) noexcept -> BuiltinFunction
+		{
+			using sequence = std::index_sequence_for<Arguments...>;
+
+			return BuiltinFunction{
+					static_cast<argument_count_type>(sizeof...(Arguments)),
+					[](const Value* arguments) -> Value
+					{
+						// every argument is a column of one row
+						return [arguments]<std::size_t... Index>(std::index_sequence<Index...>)
+						{
+							const std::array<const Value*, sizeof...(Index)> columns{(arguments + Index)...};
+							return invoke_row<Function, Result, Arguments...>(columns.data(), 0, sequence{});
+						}(sequence{});
+					},
+					[](const Value* const* columns, Value* results, const std::size_t count) -> void
+					{
+						for (std::size_t row = 0; row < count; ++row) { results[row] = invoke_row<Function, Result, Arguments...>(columns, row, sequence{}); }
+					}};
+		}
+
+	public:
+		constexpr BuiltinFunction(const argument_count_type arity, const invoker_type invoker, const batch_invoker_type batch_invoker) noexcept
+			: arity_{arity},
+			invoker_{invoker},
+			batch_invoker_{batch_invoker} {}
+
+		template<auto Function>
+		[[nodiscard]] constexpr static auto make() noexcept -> BuiltinFunction { return make<Function>(Function); }
+
+		[[nodiscard]] constexpr auto get_arity() const noexcept -> argument_count_type { return arity_; }
+
+		[[nodiscard]] auto invoke(std::span<const Value> arguments) const -> Value;
+
+		// Call the function for every row: results[row] = function(columns[0][row], columns[1][row], ...).
+		// Every column has exactly results.size() rows.
+		// With several threads the rows are split into contiguous slices, the function must be safe to call concurrently
+		// (and must not allocate collectable memory unless the collector knows the threads).
+		// The first exception thrown (if any) is rethrown once all the slices are done.
+		auto invoke_batch(std::span<const std::span<const Value>> columns, std::span<Value> results, const batch_options& options = {}) const -> void;
+	};
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <gsl/backend/ast.hpp>
+#include <gsl/type/string.hpp>
+#include <gsl/debug/assert.hpp>
+
+namespace gal::gsl::type
+{
+	// the builtin script type of a host type, NIL if there is none
+	template<typename T>
+	constexpr auto host_type_of = ast::TypeDeclaration::variable_type::NIL;
+	template<>
+	constexpr auto host_type_of<bool> = ast::TypeDeclaration::variable_type::BOOLEAN;
+	template<>
+	constexpr auto host_type_of<std::int32_t> = ast::TypeDeclaration::variable_type::INT;
+	template<>
+	constexpr auto host_type_of<float> = ast::TypeDeclaration::variable_type::FLOAT;
+	template<>
+	constexpr auto host_type_of<double> = ast::TypeDeclaration::variable_type::DOUBLE;
+	// exactly one Value slot, like the strings of the records of the scripts
+	// Note: a script may store a heap string (a collected buffer) into the member, see StructureBinding
+	template<>
+	constexpr auto host_type_of<String> = ast::TypeDeclaration::variable_type::STRING;
+
+	// a structure or a field name already bound, or a field overlapping one bound before
+	class host_binding_error : public std::runtime_error
+	{
+	private:
+		ast::symbol_name structure_;
+		ast::symbol_name field_;
+
+	public:
+		// empty field ==> the structure itself
+		host_binding_error(ast::symbol_name_view structure, ast::symbol_name_view field);
+
+		[[nodiscard]] auto structure() const noexcept -> ast::symbol_name_view { return structure_; }
+
+		[[nodiscard]] auto field() const noexcept -> ast::symbol_name_view { return field_; }
+	};
+
+	namespace host_structure_detail
+	{
+		// T[N][M] / std::array<std::array<T, M>, N> ==> T, {N, M}
+		template<typename T>
+		struct element
+		{
+			using type = T;
+
+			static auto append_dimensions(ast::TypeDeclaration::dimension_container_type&) -> void {}
+		};
+
+		template<typename T, std::size_t N>
+		struct element<T[N]>
+		{
+			using type = typename element<T>::type;
+
+			static auto append_dimensions(ast::TypeDeclaration::dimension_container_type& dimensions) -> void
+			{
+				dimensions.push_back(static_cast<ast::TypeDeclaration::dimension_type>(N));
+				element<T>::append_dimensions(dimensions);
+			}
+		};
+
+		template<typename T, std::size_t N>
+		struct element<std::array<T, N>> : element<T[N]> {};
+	}
+
+	// Declares the layout of a host type as a script structure, member by member (only the members bound are visible to the scripts).
+	// The records are the host objects themselves: a script reads and writes them in place through a pointer (see ValueCaster<T*>),
+	// nothing is copied in or out. A record keeps the size and the alignment of the host type.
+	// A host object with String members (or members of a bound type having some) must live in memory the collector scans
+	// (memory::allocate, a memory::Region, the stack...) as soon as a script writes one: a heap string is only kept alive
+	// by the pointers the collector finds, a std::malloc'ed object holding the last one leaves it dangling after the next collection.
+	template<typename Class>
+		requires std::is_standard_layout_v<Class> && std::default_initializable<Class>
+	class StructureBinding
+	{
+	public:
+		using class_type = Class;
+
+	private:
+		ast::structure_type structure_;
+
+		// the member of one value initialized object, shared by every member of the class
+		template<auto Member>
+		[[nodiscard]] static auto offset_of() noexcept -> std::size_t
+		{
+			static const Class object{};
+			return static_cast<std::size_t>(reinterpret_cast<const std::byte*>(&(object.*Member)) - reinterpret_cast<const std::byte*>(&object));
+		}
+
+		template<auto Member, typename T>
+		auto do_field(const ast::symbol_name_view name, T Class::*, const ast::structure_type& structure) -> StructureBinding&
+		{
+			using element_type = typename host_structure_detail::element<T>::type;
+
+			ast::TypeDeclaration::dimension_container_type dimensions{};
+			host_structure_detail::element<T>::append_dimensions(dimensions);
+
+			auto type = [&]
+			{
+				if constexpr (host_type_of<element_type> != ast::TypeDeclaration::variable_type::NIL)
+				{
+					gsl_assert(structure == nullptr, "a member of builtin type is not a structure!");
+					return memory::make_shared<ast::TypeDeclaration>(host_type_of<element_type>, nullptr, std::move(dimensions));
+				}
+				else
+				{
+					gsl_assert(structure != nullptr, "a member of host type needs the structure bound to that type!");
+					gsl_assert(structure->get_size() == sizeof(element_type), "the structure is not the layout of the member!");
+					return memory::make_shared<ast::TypeDeclaration>(ast::TypeDeclaration::variable_type::STRUCTURE, structure.get(), std::move(dimensions));
+				}
+			}();
+			gsl_assert(type->size() == sizeof(T), "the script type is not the layout of the member!");
+
+			if (!structure_->register_field(name, type, offset_of<Member>())) { throw host_binding_error{structure_->get_name(), name}; }
+			return *this;
+		}
+
+	public:
+		explicit StructureBinding(ast::structure_type structure)
+			: structure_{std::move(structure)} { structure_->reserve_layout(sizeof(Class), alignof(Class)); }
+
+		// a member of builtin type (bool, std::int32_t, float, double or String) or an array of them (T[N] or std::array<T, N>)
+		template<auto Member>
+		auto field(const ast::symbol_name_view name) -> StructureBinding& { return do_field<Member>(name, Member, nullptr); }
+
+		// a member of a host type bound before (or an array of them)
+		template<auto Member>
+		auto field(const ast::symbol_name_view name, const ast::structure_type& structure) -> StructureBinding& { return do_field<Member>(name, Member, structure); }
+
+		[[nodiscard]] auto get() const noexcept -> const ast::structure_type& { return structure_; }
+	};
+
+	// `bind_structure<Context>(module, "context").field<&Context::id>("id").field<&Context::deadline>("deadline")`
+	// Throw host_binding_error if a structure or a field of that name already exists.
+	template<typename Class>
+		requires std::is_standard_layout_v<Class> && std::default_initializable<Class>
+	[[nodiscard]] auto bind_structure(ast::Module& module, const ast::symbol_name_view name) -> StructureBinding<Class>
+	{
+		auto [success, structure] = module.register_structure(name);
+		if (!success) { throw host_binding_error{name, {}}; }
+		return StructureBinding<Class>{std::move(structure)};
+	}
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <gsl/backend/ast.hpp>
+
+namespace gal::gsl::type
+{
+	// Zeroed storage for records of a script structure.
+	// The collector only scans the words of the records that may hold a pointer (see ast::Structure::get_type_descriptor),
+	// a structure without any pointer is not scanned at all.
+	[[nodiscard]] auto allocate_record(const ast::Structure& structure) -> void*;
+
+	// `count` contiguous records
+	[[nodiscard]] auto allocate_records(const ast::Structure& structure, std::size_t count) -> void*;
+
+	// Optional, the memory of allocate_record/allocate_records of the same structure
+	auto deallocate_records(const ast::Structure& structure, void* records) -> void;
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <gsl/type/value.hpp>
+#include <gsl/container/vector.hpp>
+
+namespace gal::gsl::type
+{
+	// The runtime form of the builtin STRING, immutable and exactly one Value slot.
+	// SMALL    ==> at most max_small_size characters stored inline, copied with the slot
+	// HEAP     ==> a view of a collected buffer, slices share the buffer (the collector follows interior pointers)
+	// INTERNED ==> a view of a buffer of the intern pool, never collected, equal interned strings share the same buffer
+	class String
+	{
+	public:
+		using size_type = std::uint32_t;
+
+		constexpr static size_type max_small_size = 15;
+
+		enum class category : std::uint8_t
+		{
+			SMALL,
+			HEAP,
+			INTERNED,
+		};
+
+	private:
+		// the last byte, the size of a small string, or one of the following
+		constexpr static std::uint8_t heap_tag = 0x80;
+		constexpr static std::uint8_t interned_tag = 0x81;
+
+		struct heap_type
+		{
+			const char* data;
+			size_type size;
+			std::uint8_t padding[3];
+			std::uint8_t tag;
+		};
+
+		struct small_type
+		{
+			// zero filled after the size, two small strings are equal if their bytes are
+			char data[max_small_size];
+			std::uint8_t size;
+		};
+
+		// the tag (small_.size) overlaps the last byte of both
+		union
+		{
+			heap_type heap_;
+			small_type small_;
+		};
+
+		constexpr String(const char* data, const size_type size, const std::uint8_t tag) noexcept
+			: heap_{.data = data, .size = size, .padding = {}, .tag = tag} {}
+
+		[[nodiscard]] auto tag() const noexcept -> std::uint8_t { return small_.size; }
+
+	public:
+		constexpr String() noexcept
+			: small_{} {}
+
+		// copy the characters, into the slot if small enough
+		explicit String(std::string_view string);
+
+		// the interned copy of the string (small strings are never interned, they compare in O(1) anyway)
+		[[nodiscard]] static auto intern(std::string_view string) -> String;
+
+		// number of strings in the intern pool
+		[[nodiscard]] static auto interned_count() -> std::size_t;
+
+		// every string of the intern pool, the buffers viewed are never freed
+		[[nodiscard]] static auto interned_strings() -> container::vector<std::string_view>;
+
+		[[nodiscard]] auto get_category() const noexcept -> category
+		{
+			if (tag() == heap_tag) { return category::HEAP; }
+			if (tag() == interned_tag) { return category::INTERNED; }
+			return category::SMALL;
+		}
+
+		[[nodiscard]] auto is_small() const noexcept -> bool { return get_category() == category::SMALL; }
+
+		[[nodiscard]] auto is_interned() const noexcept -> bool { return get_category() == category::INTERNED; }
+
+		[[nodiscard]] auto size() const noexcept -> size_type { return is_small() ? small_.size : heap_.size; }
+
+		[[nodiscard]] auto empty() const noexcept -> bool { return size() == 0; }
+
+		// not null terminated
+		[[nodiscard]] auto data() const noexcept -> const char* { return is_small() ? small_.data : heap_.data; }
+
+		[[nodiscard]] auto view() const noexcept -> std::string_view { return {data(), size()}; }
+
+		[[nodiscard]] auto operator[](const size_type index) const noexcept -> char { return data()[index]; }
+
+		// O(1), the result shares the buffer unless it is small
+		[[nodiscard]] auto substr(size_type position, size_type count = static_cast<size_type>(-1)) const -> String;
+
+		friend auto operator+(const String& lhs, const String& rhs) -> String;
+
+		[[nodiscard]] friend auto operator==(const String& lhs, const String& rhs) noexcept -> bool
+		{
+			// the size of a string says whether it is small
+			if (lhs.is_small() || rhs.is_small()) { return std::memcmp(&lhs, &rhs, sizeof(String)) == 0; }
+			if (lhs.heap_.size != rhs.heap_.size) { return false; }
+			if (lhs.heap_.data == rhs.heap_.data) { return true; }
+			// different buffers of the pool ==> different strings
+			if (lhs.is_interned() && rhs.is_interned()) { return false; }
+			return std::memcmp(lhs.heap_.data, rhs.heap_.data, lhs.heap_.size) == 0;
+		}
+
+		[[nodiscard]] friend auto operator==(const String& lhs, const std::string_view rhs) noexcept -> bool { return lhs.view() == rhs; }
+
+		[[nodiscard]] friend auto operator<=>(const String& lhs, const String& rhs) noexcept -> std::strong_ordering { return lhs.view() <=> rhs.view(); }
+
+		// same as utility::string_hasher<string::string>
+		[[nodiscard]] auto hash() const noexcept -> std::size_t;
+	};
+
+	static_assert(sizeof(String) == sizeof(Value));
+	static_assert(std::is_trivially_copyable_v<String>);
+
+	template<>
+	class ValueCaster<String> : public value_caster_specified
+	{
+	public:
+		static auto from(const String& string) noexcept -> Value
+		{
+			Value value{};
+			std::memcpy(&value, &string, sizeof(String));
+			return value;
+		}
+
+		static auto to(const Value& value) noexcept -> String { return std::bit_cast<String>(value); }
+	};
+}
+
+template<>
+struct std::hash<gal::gsl::type::String>
+{
+	[[nodiscard]] auto operator()(const gal::gsl::type::String& string) const noexcept -> std::size_t { return string.hash(); }
+};
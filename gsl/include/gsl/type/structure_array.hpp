@@ -0,0 +1,194 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <gsl/backend/ast.hpp>
+#include <gsl/type/array.hpp>
+#include <gsl/debug/assert.hpp>
+
+namespace gal::gsl::type
+{
+	// One field of every record of a StructureArray.
+	// ARRAY_OF_STRUCTURES ==> stride == the size of a record
+	// STRUCTURE_OF_ARRAYS ==> stride == sizeof(T), the field is one contiguous column
+	template<typename T>
+	class FieldView
+	{
+	public:
+		using value_type = T;
+		using byte_pointer = std::conditional_t<std::is_const_v<T>, const std::byte*, std::byte*>;
+
+	private:
+		byte_pointer base_;
+		std::size_t stride_;
+		std::size_t size_;
+
+	public:
+		constexpr FieldView(const byte_pointer base, const std::size_t stride, const std::size_t size) noexcept
+			: base_{base},
+			stride_{stride},
+			size_{size} {}
+
+		template<typename U>
+			requires(std::is_const_v<T> && std::is_same_v<std::remove_const_t<T>, U>)
+		constexpr explicit(false) FieldView(const FieldView<U>& other) noexcept
+			: FieldView{other.base(), other.stride(), other.size()} {}
+
+		[[nodiscard]] constexpr auto base() const noexcept -> byte_pointer { return base_; }
+
+		[[nodiscard]] constexpr auto stride() const noexcept -> std::size_t { return stride_; }
+
+		[[nodiscard]] constexpr auto size() const noexcept -> std::size_t { return size_; }
+
+		[[nodiscard]] constexpr auto is_contiguous() const noexcept -> bool { return stride_ == sizeof(T); }
+
+		[[nodiscard]] auto operator[](const std::size_t index) const noexcept -> T& { return *std::launder(reinterpret_cast<T*>(base_ + index * stride_)); }
+
+		// only valid if is_contiguous()
+		[[nodiscard]] auto span() const noexcept -> std::span<T>
+		{
+			gsl_assert(is_contiguous(), "the field is not stored as a column!");
+			return {std::launder(reinterpret_cast<T*>(base_)), size_};
+		}
+	};
+
+	// Bulk operations over one field, columns go through the vectorized array kernels.
+	template<array_element_t T>
+	[[nodiscard]] auto sum(const FieldView<const T> field) noexcept -> T
+	{
+		if (field.is_contiguous()) { return kernel::sum<T>(field.span()); }
+
+		T result{0};
+		for (std::size_t i = 0; i < field.size(); ++i) { result += field[i]; }
+		return result;
+	}
+
+	template<array_element_t T>
+	[[nodiscard]] auto min(const FieldView<const T> field) noexcept -> T
+	{
+		gsl_assert(field.size() != 0, "min of nothing!");
+
+		if (field.is_contiguous()) { return kernel::min<T>(field.span()); }
+
+		auto result = field[0];
+		for (std::size_t i = 1; i < field.size(); ++i) { result = std::ranges::min(result, field[i]); }
+		return result;
+	}
+
+	template<array_element_t T>
+	[[nodiscard]] auto max(const FieldView<const T> field) noexcept -> T
+	{
+		gsl_assert(field.size() != 0, "max of nothing!");
+
+		if (field.is_contiguous()) { return kernel::max<T>(field.span()); }
+
+		auto result = field[0];
+		for (std::size_t i = 1; i < field.size(); ++i) { result = std::ranges::max(result, field[i]); }
+		return result;
+	}
+
+	template<array_element_t T>
+	[[nodiscard]] auto dot(const FieldView<const T> lhs, const FieldView<const T> rhs) noexcept -> T
+	{
+		gsl_assert(lhs.size() == rhs.size(), "size mismatch!");
+
+		if (lhs.is_contiguous() && rhs.is_contiguous()) { return kernel::dot<T>(lhs.span(), rhs.span()); }
+
+		T result{0};
+		for (std::size_t i = 0; i < lhs.size(); ++i) { result += lhs[i] * rhs[i]; }
+		return result;
+	}
+
+	// A fixed number of records of a script structure, stored as the structure's layout says.
+	class StructureArray
+	{
+	public:
+		using size_type = std::size_t;
+		using layout_type = ast::Structure::layout_type;
+		using field_index_type = ast::Structure::field_offset_type;
+
+		// same as Array
+		constexpr static std::size_t alignment = 64;
+
+	private:
+		struct column
+		{
+			// the field of the first record
+			std::byte* base;
+			// distance between the field of two adjacent records
+			std::size_t stride;
+		};
+
+		struct block
+		{
+			void* data;
+			// not null ==> records of this structure allocated by allocate_records (the collector only scans their pointers)
+			const ast::Structure* records;
+		};
+
+		ast::structure_type structure_;
+		layout_type layout_;
+		size_type size_;
+
+		// ARRAY_OF_STRUCTURES ==> one block of records
+		// STRUCTURE_OF_ARRAYS ==> one block per field
+		container::vector<block> blocks_;
+		container::vector<column> columns_;
+
+	public:
+		StructureArray(ast::structure_type structure, size_type size);
+
+		StructureArray(const StructureArray&) = delete;
+		auto operator=(const StructureArray&) -> StructureArray& = delete;
+		StructureArray(StructureArray&&) noexcept = default;
+		auto operator=(StructureArray&&) noexcept -> StructureArray& = default;
+		~StructureArray() noexcept;
+
+		[[nodiscard]] auto get_structure() const noexcept -> const ast::structure_type& { return structure_; }
+
+		[[nodiscard]] auto get_layout() const noexcept -> layout_type { return layout_; }
+
+		[[nodiscard]] auto size() const noexcept -> size_type { return size_; }
+
+		// the address of one field of one record
+		[[nodiscard]] auto address_of(const size_type record, const field_index_type field) const noexcept -> std::byte*
+		{
+			gsl_assert(record < size_ && field < columns_.size(), "index out of range!");
+
+			const auto& [base, stride] = columns_[field];
+			return base + record * stride;
+		}
+
+		template<typename T>
+		[[nodiscard]] auto field(const field_index_type index) noexcept -> FieldView<T>
+		{
+			gsl_assert(index < columns_.size(), "index out of range!");
+			gsl_assert(structure_->get_fields()[index].variable.type->size() == sizeof(T), "field type mismatch!");
+
+			const auto& [base, stride] = columns_[index];
+			return {base, stride, size_};
+		}
+
+		template<typename T>
+		[[nodiscard]] auto field(const field_index_type index) const noexcept -> FieldView<const T>
+		{
+			return const_cast<StructureArray&>(*this).field<T>(index);// NOLINT(cppcoreguidelines-pro-type-const-cast)
+		}
+
+		template<typename T>
+		[[nodiscard]] auto field(const ast::symbol_name_view name) noexcept -> FieldView<T>
+		{
+			const auto* f = structure_->get_field(name);
+			gsl_assert(f, "no such field!");
+			return field<T>(f->index);
+		}
+
+		template<typename T>
+		[[nodiscard]] auto field(const ast::symbol_name_view name) const noexcept -> FieldView<const T>
+		{
+			return const_cast<StructureArray&>(*this).field<T>(name);// NOLINT(cppcoreguidelines-pro-type-const-cast)
+		}
+	};
+}
@@ -2,12 +2,21 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <type_traits>
 
 namespace gal::gsl::type
 {
 	template<typename T>
 	class ValueCaster;
 
+	enum class value_caster_policy
+	{
+		UNDEFINED,
+		IMPLICIT,
+		SPECIFIED
+	};
+
 	class Value
 	{
 	public:
@@ -25,7 +34,7 @@ namespace gal::gsl::type
 		};
 
 		template<typename T>
-			requires ValueCaster<T>::value
+			requires(ValueCaster<T>::value != value_caster_policy::UNDEFINED)
 		[[nodiscard]] constexpr auto
 		as() const -> decltype(auto) { return ValueCaster<T>::to(*this); }
 	};
@@ -33,13 +42,6 @@ namespace gal::gsl::type
 	static_assert(sizeof(Value) == sizeof(std::uint32_t) * 4);
 	static_assert(sizeof(Value) == sizeof(float) * 4);
 
-	enum class value_caster_policy
-	{
-		UNDEFINED,
-		IMPLICIT,
-		SPECIFIED
-	};
-
 	struct value_caster_undefined
 	{
 		constexpr static value_caster_policy value = value_caster_policy::UNDEFINED;
@@ -66,6 +68,27 @@ namespace gal::gsl::type
 	template<typename T>
 	class ValueCaster<const T> : public ValueCaster<T> { };
 
+	// bool, integers and floating points are stored in the first bytes of the value
+	template<typename T>
+		requires(std::is_arithmetic_v<T> && !std::is_const_v<T>)
+	class ValueCaster<T> : public value_caster_implicit
+	{
+	public:
+		static auto from(const T data) noexcept -> Value
+		{
+			Value value{};
+			std::memcpy(value.bits, &data, sizeof(T));
+			return value;
+		}
+
+		static auto to(const Value& value) noexcept -> T
+		{
+			T data;
+			std::memcpy(&data, value.bits, sizeof(T));
+			return data;
+		}
+	};
+
 	template<typename T>
 	class ValueCaster<T*> : public value_caster_implicit
 	{
@@ -75,7 +98,7 @@ namespace gal::gsl::type
 		constexpr static auto to(const Value& data) -> decltype(auto)
 		{
 			// not checked
-			return static_cast<T*>(data.raw_observer);
+			return static_cast<T*>(const_cast<void*>(data.raw_observer));
 		}
 	};
 
@@ -101,7 +124,7 @@ namespace gal::gsl::type
 		constexpr static auto to(const Value& data) -> decltype(auto)
 		{
 			// not checked
-			return *static_cast<T*>(data.raw_observer);
+			return *static_cast<T*>(const_cast<void*>(data.raw_observer));
 		}
 	};
 
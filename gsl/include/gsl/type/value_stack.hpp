@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <gsl/container/vector.hpp>
+#include <gsl/debug/assert.hpp>
+#include <gsl/type/value.hpp>
+
+namespace gal::gsl::type
+{
+	class BuiltinFunction;
+
+	// The frames of one execution context, in one contiguous array of values:
+	//
+	// | caller: arguments, locals, outgoing | callee: arguments, locals, outgoing | ...
+	//                             ^ the arguments written by the caller are the first slots of the callee
+	//
+	// A frame is its base and size (a slot index, fixed by its function): a call neither copies its arguments nor allocates,
+	// a tail call moves its arguments down to the base of the current frame and reuses it.
+	// The array only grows (doubling) when a frame does not fit, it never shrinks: once the deepest frame was reached,
+	// running again does not touch the allocator (reserve it with the constructor to never grow at all).
+	// The slots are addressed by index, a pointer/span into them is only valid until the next call/tail_call/resize.
+	class ValueStack
+	{
+	public:
+		using size_type = std::uint32_t;
+
+		constexpr static size_type default_capacity = 16 * 1024;
+		constexpr static size_type default_max_size = 1024 * 1024;
+		constexpr static size_type default_max_depth = 64 * 1024;
+
+		struct frame
+		{
+			size_type base;
+			size_type size;
+		};
+
+	private:
+		container::vector<Value> slots_;
+		// frames_[0] is the frame of the host
+		container::vector<frame> frames_;
+		size_type max_size_;
+		size_type max_depth_;
+
+		// slots_.size() < end, false if end > max_size_
+		[[nodiscard]] auto grow(std::uint64_t end) -> bool;
+
+		[[nodiscard]] auto current() noexcept -> frame& { return frames_.back(); }
+
+		[[nodiscard]] auto current() const noexcept -> const frame& { return frames_.back(); }
+
+	public:
+		explicit ValueStack(size_type capacity = default_capacity, size_type max_size = default_max_size, size_type max_depth = default_max_depth);
+
+		// 1 ==> only the host frame
+		[[nodiscard]] auto depth() const noexcept -> std::size_t { return frames_.size(); }
+
+		[[nodiscard]] auto capacity() const noexcept -> std::size_t { return slots_.size(); }
+
+		// one past the last slot of the current frame
+		[[nodiscard]] auto top() const noexcept -> size_type { return current().base + current().size; }
+
+		[[nodiscard]] auto get_frame() const noexcept -> const frame& { return current(); }
+
+		[[nodiscard]] auto operator[](const size_type index) noexcept -> Value&
+		{
+			gsl_assert(index < current().size, "slot out of frame!");
+			return slots_[current().base + index];
+		}
+
+		[[nodiscard]] auto operator[](const size_type index) const noexcept -> const Value&
+		{
+			gsl_assert(index < current().size, "slot out of frame!");
+			return slots_[current().base + index];
+		}
+
+		// the slots of the current frame
+		[[nodiscard]] auto slots() noexcept -> std::span<Value> { return {slots_.data() + current().base, current().size}; }
+
+		[[nodiscard]] auto slots() const noexcept -> std::span<const Value> { return {slots_.data() + current().base, current().size}; }
+
+		// Resize the current frame (the host frame holds the arguments of the first call), the new slots are zeroed.
+		// false if it does not fit (nothing changed)
+		[[nodiscard]] auto resize(size_type size) -> bool;
+
+		// Enter a frame of `size` slots whose first `arguments` slots are the slots [first_argument, first_argument + arguments) of the current frame.
+		// The other slots (the locals) are zeroed. The slot first_argument receives the result (see ret), even without arguments.
+		// false on stack overflow (nothing changed)
+		[[nodiscard]] auto call(const size_type first_argument, const size_type arguments, const size_type size) -> bool
+		{
+			gsl_assert(arguments <= size, "frame smaller than its arguments!");
+			gsl_assert(first_argument < current().size && first_argument + arguments <= current().size, "arguments out of frame!");
+
+			const auto base = current().base + first_argument;
+			const auto end = static_cast<std::uint64_t>(base) + size;
+			if (frames_.size() >= max_depth_ || (end > slots_.size() && !grow(end))) { return false; }
+
+			std::memset(static_cast<void*>(slots_.data() + base + arguments), 0, (size - arguments) * sizeof(Value));
+			frames_.push_back({.base = base, .size = size});
+			return true;
+		}
+
+		// Replace the current frame by a frame of `size` slots whose arguments are the slots [first_argument, first_argument + arguments) of the current frame,
+		// the depth does not change: the callee returns to the caller of the current frame.
+		// false on stack overflow (nothing changed)
+		[[nodiscard]] auto tail_call(const size_type first_argument, const size_type arguments, const size_type size) -> bool
+		{
+			gsl_assert(depth() > 1, "the host frame cannot tail call!");
+			gsl_assert(arguments <= size, "frame smaller than its arguments!");
+			gsl_assert(first_argument + arguments <= current().size, "arguments out of frame!");
+
+			auto& f = current();
+			if (const auto end = static_cast<std::uint64_t>(f.base) + size;
+				end > slots_.size() && !grow(end)) { return false; }
+
+			auto* base = slots_.data() + f.base;
+			std::memmove(static_cast<void*>(base), base + first_argument, arguments * sizeof(Value));
+			std::memset(static_cast<void*>(base + arguments), 0, (size - arguments) * sizeof(Value));
+			f.size = size;
+			return true;
+		}
+
+		// Leave the current frame, the result goes into the slot of the caller that held the first argument.
+		auto ret(const Value& result) noexcept -> void
+		{
+			gsl_assert(depth() > 1, "the host frame cannot return!");
+
+			const auto base = current().base;
+			frames_.pop_back();
+			slots_[base] = result;
+		}
+
+		// Call a builtin with the slots [first_argument, first_argument + arity) of the current frame, the result goes into first_argument.
+		// No frame is entered, the builtin reads the arguments in place.
+		auto call_builtin(size_type first_argument, const BuiltinFunction& function) -> void;
+	};
+}
@@ -0,0 +1,822 @@
+#include <gsl/backend/aot.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+namespace gal::gsl::ir
+{
+	namespace
+	{
+		auto append_number(string::string& out, const auto number) -> void
+		{
+			char buffer[32];
+			const auto [end, error] = std::to_chars(std::ranges::begin(buffer), std::ranges::end(buffer), number);
+			gsl_assert(error == std::errc{}, "buffer too small!");
+			out.append(buffer, end);
+		}
+
+		template<typename T>
+		auto append_floating_point(string::string& out, const T value, const std::string_view type) -> void
+		{
+			if (std::isnan(value))
+			{
+				out.append("std::numeric_limits<").append(type).append(">::quiet_NaN()");
+				return;
+			}
+			if (std::isinf(value))
+			{
+				out.append(value < 0 ? "-" : "").append("std::numeric_limits<").append(type).append(">::infinity()");
+				return;
+			}
+
+			// the shortest representation reading back the same value
+			const auto begin = out.size();
+			append_number(out, value);
+			if (out.find_first_of(".e", begin) == string::string::npos) { out.append(".0"); }
+			if constexpr (std::is_same_v<T, float>) { out.append("f"); }
+		}
+
+		auto append_constant(string::string& out, const constant_type& constant) -> void
+		{
+			std::visit(
+					[&out]<typename T>(const T& value)
+					{
+						if constexpr (std::is_same_v<T, std::monostate>) { gsl_trap("constant without value!"); }
+						else if constexpr (std::is_same_v<T, bool>) { out.append(value ? "true" : "false"); }
+						else if constexpr (std::is_same_v<T, std::int32_t>)
+						{
+							if (value == std::numeric_limits<std::int32_t>::min()) { out.append("std::numeric_limits<std::int32_t>::min()"); }
+							else
+							{
+								out.append("std::int32_t{");
+								append_number(out, value);
+								out.append("}");
+							}
+						}
+						else if constexpr (std::is_same_v<T, float>) { append_floating_point(out, value, "float"); }
+						else { append_floating_point(out, value, "double"); }
+					},
+					constant);
+		}
+
+		// empty if not supported
+		[[nodiscard]] constexpr auto native_type(const type_t type) noexcept -> std::string_view
+		{
+			switch (type)
+			{
+				case type_t::VOID: { return "void"; }
+				case type_t::BOOLEAN: { return "bool"; }
+				case type_t::INT: { return "std::int32_t"; }
+				case type_t::FLOAT: { return "float"; }
+				case type_t::DOUBLE: { return "double"; }
+				// the address of the record
+				case type_t::STRUCTURE: { return "std::byte*"; }
+				default: { return {}; }
+			}
+		}
+
+		// the enumerator of ast::TypeDeclaration::variable_type
+		[[nodiscard]] constexpr auto declaration_type(const type_t type) noexcept -> std::string_view
+		{
+			switch (type)
+			{
+				case type_t::VOID: { return "VOID"; }
+				case type_t::BOOLEAN: { return "BOOLEAN"; }
+				case type_t::INT: { return "INT"; }
+				case type_t::FLOAT: { return "FLOAT"; }
+				case type_t::DOUBLE: { return "DOUBLE"; }
+				case type_t::STRUCTURE: { return "STRUCTURE"; }
+				default: { return "NIL"; }
+			}
+		}
+
+		// The integer arithmetic wraps around and the division traps (throws) like the interpreter,
+		// the host compiler may not assume anything else.
+		constexpr std::string_view prelude = R"(		[[nodiscard]] constexpr auto add_i32(const std::int32_t lhs, const std::int32_t rhs) noexcept -> std::int32_t { return static_cast<std::int32_t>(static_cast<std::uint32_t>(lhs) + static_cast<std::uint32_t>(rhs)); }
+
+		[[nodiscard]] constexpr auto sub_i32(const std::int32_t lhs, const std::int32_t rhs) noexcept -> std::int32_t { return static_cast<std::int32_t>(static_cast<std::uint32_t>(lhs) - static_cast<std::uint32_t>(rhs)); }
+
+		[[nodiscard]] constexpr auto mul_i32(const std::int32_t lhs, const std::int32_t rhs) noexcept -> std::int32_t { return static_cast<std::int32_t>(static_cast<std::uint32_t>(lhs) * static_cast<std::uint32_t>(rhs)); }
+
+		[[nodiscard]] constexpr auto neg_i32(const std::int32_t value) noexcept -> std::int32_t { return static_cast<std::int32_t>(0u - static_cast<std::uint32_t>(value)); }
+
+		[[nodiscard]] constexpr auto div_i32(const std::int32_t lhs, const std::int32_t rhs) -> std::int32_t
+		{
+			if (rhs == 0) { throw std::runtime_error{"Division by zero!"}; }
+			if (rhs == -1) { return neg_i32(lhs); }
+			return lhs / rhs;
+		}
+
+		[[nodiscard]] constexpr auto rem_i32(const std::int32_t lhs, const std::int32_t rhs) -> std::int32_t
+		{
+			if (rhs == 0) { throw std::runtime_error{"Division by zero!"}; }
+			if (rhs == -1) { return 0; }
+			return lhs % rhs;
+		}
+
+		[[nodiscard]] constexpr auto check_bounds(const std::int32_t element, const std::uint32_t extent) -> std::int32_t
+		{
+			if (element < 0 || static_cast<std::uint32_t>(element) >= extent) { throw std::out_of_range{"Index out of bounds!"}; }
+			return element;
+		}
+)";
+
+		class Emitter
+		{
+		private:
+			const Module& module_;
+			const aot_options& options_;
+			aot_result& result_;
+			string::string out_;
+
+			// sorted by name, the index is the name of the native function
+			container::vector<const Function*> functions_;
+			// the structures allocated (ALLOC), the index is the name of the pointer set by the register function
+			container::vector<const ast::Structure*> structures_;
+
+			auto error(const Function& function, const value_id value, const std::string_view message) -> void
+			{
+				result_.errors.push_back({.function = symbol_name{function.get_name()}, .value = value, .message = string::string{message}});
+			}
+
+			[[nodiscard]] auto index_of(const symbol_name_view name) const noexcept -> std::size_t
+			{
+				const auto it = std::ranges::lower_bound(functions_, name, {}, &Function::get_name);
+				return it != functions_.end() && (*it)->get_name() == name ? static_cast<std::size_t>(it - functions_.begin()) : functions_.size();
+			}
+
+			auto append_function_name(const std::size_t index) -> void
+			{
+				out_.append("function_");
+				append_number(out_, index);
+			}
+
+			auto append_structure_name(const std::size_t index) -> void
+			{
+				out_.append("structure_");
+				append_number(out_, index);
+			}
+
+			auto append_value(const value_id value) -> void
+			{
+				out_.append("value_");
+				append_number(out_, value);
+			}
+
+			// the ARGUMENT instruction of every argument (invalid_value if unused)
+			[[nodiscard]] static auto arguments_of(const Function& function) -> container::vector<value_id>
+			{
+				container::vector<value_id> arguments(function.get_arity(), invalid_value);
+				for (const auto id: function.reverse_post_order())
+				{
+					for (const auto value: function.block(id).instructions)
+					{
+						if (const auto& instruction = function.value(value);
+							instruction.op == opcode::ARGUMENT) { arguments[instruction.index] = value; }
+					}
+				}
+				return arguments;
+			}
+
+			// `auto function_N(...) -> T`
+			auto append_signature(const Function& function, const std::size_t index) -> void
+			{
+				const auto arguments = arguments_of(function);
+
+				out_.append("\t\tauto ");
+				append_function_name(index);
+				out_.append("(");
+				for (std::size_t i = 0; i < arguments.size(); ++i)
+				{
+					if (i != 0) { out_.append(", "); }
+					if (arguments[i] == invalid_value) { out_.append("[[maybe_unused]] const std::int32_t"); }
+					else
+					{
+						const auto type = native_type(function.value(arguments[i]).type);
+						out_.append(type == "std::byte*" ? "std::byte* const" : string::string{"const "}.append(type));
+					}
+					out_.append(" argument_");
+					append_number(out_, i);
+				}
+				out_.append(") -> ").append(native_type(function.get_return_type()));
+			}
+
+			[[nodiscard]] auto check_signature(const Function& function) -> bool
+			{
+				bool ok = true;
+
+				if (native_type(function.get_return_type()).empty() || function.get_return_type() == type_t::NIL)
+				{
+					error(function, invalid_value, "unsupported return type");
+					ok = false;
+				}
+
+				for (const auto argument: arguments_of(function))
+				{
+					if (argument == invalid_value) { continue; }
+					if (const auto type = function.value(argument).type;
+						native_type(type).empty() || type == type_t::VOID)
+					{
+						error(function, argument, "unsupported argument type");
+						ok = false;
+					}
+				}
+
+				return ok;
+			}
+
+			// the incoming values of the phis of every successor, right before the terminator
+			auto append_phi_copies(const Function& function, const block_id from) -> void
+			{
+				for (const auto to: function.successors(from))
+				{
+					for (const auto value: function.block(to).instructions)
+					{
+						const auto& phi = function.value(value);
+						if (phi.op != opcode::PHI) { break; }
+
+						for (std::size_t i = 0; i < phi.blocks.size(); ++i)
+						{
+							if (phi.blocks[i] != from) { continue; }
+
+							out_.append("\t\t\t");
+							append_value(value);
+							out_.append("_in = ");
+							append_value(phi.operands[i]);
+							out_.append(";\n");
+							break;
+						}
+					}
+				}
+			}
+
+			auto append_label(const block_id id) -> void
+			{
+				out_.append("block_");
+				append_number(out_, id);
+			}
+
+			// false if the instruction cannot be translated (reported)
+			[[nodiscard]] auto append_instruction(const Function& function, const block_id block, const value_id value) -> bool
+			{
+				using enum specialized_opcode;
+
+				const auto& instruction = function.value(value);
+				const auto op = specialize(function, instruction);
+
+				const auto operand = [&](const std::size_t i) { append_value(instruction.operands[i]); };
+				const auto assign = [&]
+				{
+					out_.append("\t\t\t");
+					append_value(value);
+					out_.append(" = ");
+				};
+				const auto binary = [&](const std::string_view symbol)
+				{
+					assign();
+					operand(0);
+					out_.append(" ").append(symbol).append(" ");
+					operand(1);
+					out_.append(";\n");
+				};
+				const auto call = [&](const std::string_view helper)
+				{
+					assign();
+					out_.append(helper).append("(");
+					for (std::size_t i = 0; i < instruction.operands.size(); ++i)
+					{
+						if (i != 0) { out_.append(", "); }
+						operand(i);
+					}
+					out_.append(");\n");
+				};
+
+				switch (op)
+				{
+					case UNTYPED:
+					{
+						error(function, value, "instruction not type checked");
+						return false;
+					}
+					case CONSTANT_BOOLEAN:
+					case CONSTANT_I32:
+					case CONSTANT_F32:
+					case CONSTANT_F64:
+					{
+						assign();
+						append_constant(out_, instruction.constant);
+						out_.append(";\n");
+						return true;
+					}
+					case ARGUMENT:
+					{
+						assign();
+						out_.append("argument_");
+						append_number(out_, instruction.index);
+						out_.append(";\n");
+						return true;
+					}
+					case PHI:
+					{
+						assign();
+						append_value(value);
+						out_.append("_in;\n");
+						return true;
+					}
+					case ADD_I32: { call("add_i32"); return true; }
+					case SUB_I32: { call("sub_i32"); return true; }
+					case MUL_I32: { call("mul_i32"); return true; }
+					case DIV_I32: { call("div_i32"); return true; }
+					case REM_I32: { call("rem_i32"); return true; }
+					case NEG_I32: { call("neg_i32"); return true; }
+					case ADD_F32:
+					case ADD_F64: { binary("+"); return true; }
+					case SUB_F32:
+					case SUB_F64: { binary("-"); return true; }
+					case MUL_F32:
+					case MUL_F64: { binary("*"); return true; }
+					case DIV_F32:
+					case DIV_F64: { binary("/"); return true; }
+					case REM_F32:
+					case REM_F64: { call("std::fmod"); return true; }
+					case NEG_F32:
+					case NEG_F64:
+					case NOT:
+					{
+						assign();
+						out_.append(op == NOT ? "!" : "-");
+						operand(0);
+						out_.append(";\n");
+						return true;
+					}
+					case CONVERT_I32_TO_F32:
+					case CONVERT_I32_TO_F64:
+					case CONVERT_F32_TO_F64:
+					{
+						assign();
+						out_.append("static_cast<").append(native_type(instruction.type)).append(">(");
+						operand(0);
+						out_.append(");\n");
+						return true;
+					}
+					case EQUAL_BOOLEAN:
+					case EQUAL_I32:
+					case EQUAL_F32:
+					case EQUAL_F64:
+					case EQUAL_REFERENCE: { binary("=="); return true; }
+					case NOT_EQUAL_BOOLEAN:
+					case NOT_EQUAL_I32:
+					case NOT_EQUAL_F32:
+					case NOT_EQUAL_F64:
+					case NOT_EQUAL_REFERENCE: { binary("!="); return true; }
+					case LESS_I32:
+					case LESS_F32:
+					case LESS_F64: { binary("<"); return true; }
+					case LESS_EQUAL_I32:
+					case LESS_EQUAL_F32:
+					case LESS_EQUAL_F64: { binary("<="); return true; }
+					case GREATER_I32:
+					case GREATER_F32:
+					case GREATER_F64: { binary(">"); return true; }
+					case GREATER_EQUAL_I32:
+					case GREATER_EQUAL_F32:
+					case GREATER_EQUAL_F64: { binary(">="); return true; }
+					// both operands are computed anyway
+					case AND: { binary("&&"); return true; }
+					case OR: { binary("||"); return true; }
+					case ADD_STRING:
+					case EQUAL_STRING:
+					case NOT_EQUAL_STRING:
+					{
+						error(function, value, "strings are not supported ahead of time");
+						return false;
+					}
+					case LOAD_GLOBAL:
+					case STORE_GLOBAL:
+					{
+						error(function, value, "globals are not supported ahead of time");
+						return false;
+					}
+					case ALLOC:
+					{
+						// zeroed, scanned precisely (only its strings) like the records of the interpreter
+						assign();
+						out_.append("static_cast<std::byte*>(gal::gsl::type::allocate_record(*");
+						append_structure_name(static_cast<std::size_t>(std::ranges::find(structures_, instruction.structure) - structures_.begin()));
+						out_.append("));\n");
+						return true;
+					}
+					case FRAME_ALLOC:
+					{
+						assign();
+						out_.append("frame + ");
+						append_number(out_, instruction.index);
+						out_.append(";\n\t\t\tstd::memset(");
+						append_value(value);
+						out_.append(", 0, ");
+						append_number(out_, instruction.structure->get_size());
+						out_.append(");\n");
+						return true;
+					}
+					case LOAD_FIELD_OFFSET:
+					case STORE_FIELD_OFFSET:
+					{
+						const auto& field = *instruction.structure->get_fields()[instruction.index].variable.type;
+						if (field.is_array() || native_type(field.type()).empty() || field.type() == type_t::VOID)
+						{
+							error(function, value, "field type not supported ahead of time");
+							return false;
+						}
+
+						const auto offset = field_offset(instruction);
+						if (op == LOAD_FIELD_OFFSET)
+						{
+							if (field.type() == type_t::STRUCTURE)
+							{
+								// the nested record is stored inline
+								assign();
+								operand(0);
+								out_.append(" + ");
+								append_number(out_, offset);
+								out_.append(";\n");
+							}
+							else
+							{
+								out_.append("\t\t\tstd::memcpy(&");
+								append_value(value);
+								out_.append(", ");
+								operand(0);
+								out_.append(" + ");
+								append_number(out_, offset);
+								out_.append(", sizeof(");
+								append_value(value);
+								out_.append("));\n");
+							}
+						}
+						else
+						{
+							out_.append("\t\t\tstd::memcpy(");
+							operand(0);
+							out_.append(" + ");
+							append_number(out_, offset);
+							if (field.type() == type_t::STRUCTURE)
+							{
+								out_.append(", ");
+								operand(1);
+								out_.append(", ");
+								append_number(out_, field.size());
+							}
+							else
+							{
+								out_.append(", &");
+								operand(1);
+								out_.append(", sizeof(");
+								operand(1);
+								out_.append(")");
+							}
+							out_.append(");\n");
+						}
+						return true;
+					}
+					case LOAD_ELEMENT_OFFSET:
+					case STORE_ELEMENT_OFFSET:
+					{
+						const auto& field = *instruction.structure->get_fields()[instruction.index].variable.type;
+						if (native_type(field.type()).empty() || field.type() == type_t::VOID)
+						{
+							error(function, value, "field type not supported ahead of time");
+							return false;
+						}
+
+						// the element operand is checked (or proven) in range
+						const auto address = [&]
+						{
+							operand(0);
+							out_.append(" + ");
+							append_number(out_, field_offset(instruction));
+							out_.append(" + static_cast<std::size_t>(");
+							operand(1);
+							out_.append(") * ");
+							append_number(out_, element_size(instruction));
+						};
+
+						if (op == LOAD_ELEMENT_OFFSET)
+						{
+							if (field.type() == type_t::STRUCTURE)
+							{
+								assign();
+								address();
+								out_.append(";\n");
+							}
+							else
+							{
+								out_.append("\t\t\tstd::memcpy(&");
+								append_value(value);
+								out_.append(", ");
+								address();
+								out_.append(", sizeof(");
+								append_value(value);
+								out_.append("));\n");
+							}
+						}
+						else
+						{
+							out_.append("\t\t\tstd::memcpy(");
+							address();
+							if (field.type() == type_t::STRUCTURE)
+							{
+								out_.append(", ");
+								operand(2);
+								out_.append(", ");
+								append_number(out_, element_size(instruction));
+							}
+							else
+							{
+								out_.append(", &");
+								operand(2);
+								out_.append(", sizeof(");
+								operand(2);
+								out_.append(")");
+							}
+							out_.append(");\n");
+						}
+						return true;
+					}
+					case CHECK_BOUNDS:
+					{
+						assign();
+						out_.append("check_bounds(");
+						operand(0);
+						out_.append(", ");
+						append_number(out_, instruction.index);
+						out_.append("u);\n");
+						return true;
+					}
+					case CALL:
+					{
+						const auto index = index_of(instruction.symbol);
+						if (index == functions_.size())
+						{
+							error(function, value, "call to a function outside the module");
+							return false;
+						}
+
+						if (instruction.type == type_t::VOID) { out_.append("\t\t\t"); }
+						else { assign(); }
+						append_function_name(index);
+						out_.append("(");
+						for (std::size_t i = 0; i < instruction.operands.size(); ++i)
+						{
+							if (i != 0) { out_.append(", "); }
+							operand(i);
+						}
+						out_.append(");\n");
+						return true;
+					}
+					case JUMP:
+					{
+						append_phi_copies(function, block);
+						out_.append("\t\t\tgoto ");
+						append_label(instruction.blocks[0]);
+						out_.append(";\n");
+						return true;
+					}
+					case BRANCH:
+					{
+						append_phi_copies(function, block);
+						out_.append("\t\t\tif (");
+						operand(0);
+						out_.append(") { goto ");
+						append_label(instruction.blocks[0]);
+						out_.append("; }\n\t\t\tgoto ");
+						append_label(instruction.blocks[1]);
+						out_.append(";\n");
+						return true;
+					}
+					case RETURN:
+					{
+						out_.append("\t\t\treturn");
+						if (!instruction.operands.empty())
+						{
+							out_.append(" ");
+							operand(0);
+						}
+						out_.append(";\n");
+						return true;
+					}
+				}
+
+				gsl_trap("unknown specialized opcode!");
+				return false;
+			}
+
+			auto append_body(const Function& function, const std::size_t index) -> void
+			{
+				const auto order = function.reverse_post_order();
+				const auto uses = function.compute_uses();
+
+				append_signature(function, index);
+				out_.append("\n\t\t{\n");
+
+				if (function.get_frame_size() != 0)
+				{
+					out_.append("\t\t\talignas(");
+					append_number(out_, function.get_frame_alignment());
+					out_.append(") std::byte frame[");
+					append_number(out_, function.get_frame_size());
+					out_.append("];\n");
+				}
+
+				// every value up front, the blocks jump over each other
+				container::vector<bool> targets(function.block_count(), false);
+				for (const auto id: order)
+				{
+					for (const auto target: function.successors(id)) { targets[target] = true; }
+
+					for (const auto value: function.block(id).instructions)
+					{
+						const auto& instruction = function.value(value);
+						if (instruction.type == type_t::VOID || instruction.type == type_t::NIL || (has_side_effect(instruction.op) && instruction.op != opcode::CALL && instruction.op != opcode::CHECK_BOUNDS)) { continue; }
+
+						const auto type = native_type(instruction.type);
+						if (type.empty()) { continue; }
+
+						out_.append("\t\t\t").append(uses[value].empty() ? "[[maybe_unused]] " : "").append(type).append(" ");
+						append_value(value);
+						out_.append("{};\n");
+						if (instruction.op == opcode::PHI)
+						{
+							out_.append("\t\t\t").append(type).append(" ");
+							append_value(value);
+							out_.append("_in{};\n");
+						}
+					}
+				}
+				out_.append("\n");
+
+				for (const auto id: order)
+				{
+					if (targets[id])
+					{
+						out_.append("\t\t");
+						append_label(id);
+						out_.append(":\n");
+					}
+
+					for (const auto value: function.block(id).instructions)
+					{
+						if (!append_instruction(function, id, value)) { return; }
+					}
+				}
+
+				out_.append("\t\t}\n");
+			}
+
+		public:
+			Emitter(const Module& module, const aot_options& options, aot_result& result)
+				: module_{module},
+				options_{options},
+				result_{result}
+			{
+				for (const auto& [_, function]: module_.get_functions()) { functions_.push_back(function.get()); }
+				std::ranges::sort(functions_, {}, &Function::get_name);
+
+				for (const auto* function: functions_)
+				{
+					for (const auto id: function->reverse_post_order())
+					{
+						for (const auto value: function->block(id).instructions)
+						{
+							if (const auto& instruction = function->value(value);
+								instruction.op == opcode::ALLOC && std::ranges::find(structures_, instruction.structure) == structures_.end()) { structures_.push_back(instruction.structure); }
+						}
+					}
+				}
+			}
+
+			auto emit() -> void
+			{
+				bool signatures = true;
+				for (const auto* function: functions_) { signatures &= check_signature(*function); }
+				if (!signatures) { return; }
+
+				out_.append("// Generated from the module '").append(module_.get_name()).append("' by gal::gsl::ir::emit_cpp, do not edit.\n\n");
+				out_.append(
+						"#include <cmath>\n"
+						"#include <cstddef>\n"
+						"#include <cstdint>\n"
+						"#include <cstring>\n"
+						"#include <limits>\n"
+						"#include <stdexcept>\n"
+						"#include <string_view>\n"
+						"#include <gsl/backend/ast.hpp>\n"
+						"#include <gsl/type/record.hpp>\n\n");
+				out_.append("namespace ").append(options_.name_space).append("\n{\n\tnamespace\n\t{\n").append(prelude);
+
+				// set by the register function
+				for (std::size_t i = 0; i < structures_.size(); ++i)
+				{
+					out_.append("\n\t\t// ").append(structures_[i]->get_name()).append("\n\t\tconst gal::gsl::ast::Structure* ");
+					append_structure_name(i);
+					out_.append(" = nullptr;\n");
+				}
+
+				// the functions of the module call each other in any order
+				for (std::size_t i = 0; i < functions_.size(); ++i)
+				{
+					out_.append("\n\t\t// ").append(functions_[i]->get_name()).append("\n");
+					append_signature(*functions_[i], i);
+					out_.append(";\n");
+				}
+
+				for (std::size_t i = 0; i < functions_.size(); ++i)
+				{
+					out_.append("\n");
+					append_body(*functions_[i], i);
+				}
+				out_.append("\t}\n\n");
+
+				append_register();
+				out_.append("}\n");
+			}
+
+			auto append_register() -> void
+			{
+				out_.append("\tauto ").append(options_.register_function).append("(gal::gsl::ast::Module& module) -> void\n\t{\n");
+				out_.append("\t\tusing gal::gsl::ast::TypeDeclaration;\n\n");
+
+				// the records are laid out as they were when compiled
+				for (std::size_t i = 0; i < structures_.size(); ++i)
+				{
+					const auto& structure = *structures_[i];
+
+					out_.append("\t\t");
+					append_structure_name(i);
+					out_.append(" = module.get_structure(std::string_view{\"").append(structure.get_name()).append("\"}).get();\n\t\tif (!");
+					append_structure_name(i);
+					out_.append(" || ");
+					append_structure_name(i);
+					out_.append("->get_size() != ");
+					append_number(out_, structure.get_size());
+					out_.append(" || ");
+					append_structure_name(i);
+					out_.append("->get_alignment() != ");
+					append_number(out_, structure.get_alignment());
+					out_.append(")\n\t\t{\n\t\t\tthrow std::invalid_argument{\"The structure '").append(structure.get_name()).append("' is missing or not laid out as when compiled!\"};\n\t\t}\n");
+				}
+				if (!structures_.empty()) { out_.append("\n"); }
+
+				const auto append_type = [this](const type_t type, const ast::Structure* structure)
+				{
+					out_.append("gal::gsl::memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::").append(declaration_type(type));
+					if (structure)
+					{
+						out_.append(", module.get_structure(std::string_view{\"").append(structure->get_name()).append("\"}).get()");
+					}
+					out_.append(")");
+				};
+
+				for (std::size_t i = 0; i < functions_.size(); ++i)
+				{
+					const auto& function = *functions_[i];
+					const auto arguments = arguments_of(function);
+
+					out_.append("\t\tmodule.redefine_function(\n\t\t\t\tstd::string_view{\"").append(function.get_name()).append("\"},\n");
+					out_.append("\t\t\t\tgal::gsl::memory::make_shared<gal::gsl::ast::BuiltinFunction>(\n");
+					out_.append("\t\t\t\t\t\tstd::string_view{\"").append(function.get_name()).append("\"},\n");
+					out_.append("\t\t\t\t\t\tgal::gsl::ast::Function::arguments_container_type{");
+					for (std::size_t a = 0; a < arguments.size(); ++a)
+					{
+						out_.append(a == 0 ? "\n" : ",\n").append("\t\t\t\t\t\t\t\tgal::gsl::memory::make_shared<gal::gsl::ast::Variable>(std::string_view{\"argument_");
+						append_number(out_, a);
+						out_.append("\"}, ");
+						if (arguments[a] == invalid_value) { append_type(type_t::NIL, nullptr); }
+						else { append_type(function.value(arguments[a]).type, function.value(arguments[a]).structure); }
+						out_.append(")");
+					}
+					out_.append("},\n\t\t\t\t\t\t");
+					append_type(function.get_return_type(), nullptr);
+					out_.append(",\n\t\t\t\t\t\tgal::gsl::type::BuiltinFunction::make<&");
+					append_function_name(i);
+					out_.append(">()));\n");
+				}
+
+				out_.append("\t}\n");
+			}
+
+			[[nodiscard]] auto source() && -> string::string { return std::move(out_); }
+		};
+	}
+
+	auto emit_cpp(const Module& module, const aot_options& options) -> aot_result
+	{
+		aot_result result{};
+
+		Emitter emitter{module, options, result};
+		emitter.emit();
+
+		if (result.success()) { result.source = std::move(emitter).source(); }
+		return result;
+	}
+}
@@ -1,9 +1,12 @@
 #include <gsl/backend/ast.hpp>
 #include <gsl/debug/assert.hpp>
+#include <gsl/type/value.hpp>
 
 #include <magic_enum.hpp>
 
 #include <algorithm>
+#include <functional>
+#include <numeric>
 
 namespace gal::gsl::ast
 {
@@ -25,6 +28,155 @@ namespace gal::gsl::ast
 		return variable_type::NIL;
 	}
 
+	auto TypeDeclaration::size() const noexcept -> std::size_t
+	{
+		const auto element_size = [this]() -> std::size_t
+		{
+			switch (type_)
+			{
+				case variable_type::BOOLEAN: { return sizeof(bool); }
+				case variable_type::INT: { return sizeof(std::int32_t); }
+				case variable_type::FLOAT: { return sizeof(float); }
+				case variable_type::DOUBLE: { return sizeof(double); }
+				// a string always occupies one Value slot
+				case variable_type::STRING: { return sizeof(type::Value); }
+				case variable_type::STRUCTURE: { return owner_ ? owner_->get_size() : 0; }
+				case variable_type::NIL:
+				case variable_type::VOID:
+				default: { return 0; }
+			}
+		}();
+
+		return std::accumulate(dimensions_.begin(), dimensions_.end(), element_size, std::multiplies<>{});
+	}
+
+	auto TypeDeclaration::element_count() const noexcept -> std::size_t { return std::accumulate(dimensions_.begin(), dimensions_.end(), std::size_t{1}, std::multiplies<>{}); }
+
+	auto TypeDeclaration::alignment() const noexcept -> std::size_t
+	{
+		switch (type_)
+		{
+			case variable_type::BOOLEAN: { return alignof(bool); }
+			case variable_type::INT: { return alignof(std::int32_t); }
+			case variable_type::FLOAT: { return alignof(float); }
+			case variable_type::DOUBLE: { return alignof(double); }
+			case variable_type::STRING: { return alignof(type::Value); }
+			case variable_type::STRUCTURE: { return owner_ ? owner_->get_alignment() : 1; }
+			case variable_type::NIL:
+			case variable_type::VOID:
+			default: { return 1; }
+		}
+	}
+
+	auto TypeDeclaration::contains_pointer() const noexcept -> bool
+	{
+		switch (type_)
+		{
+			case variable_type::STRING: { return true; }
+			case variable_type::STRUCTURE: { return !owner_ || owner_->contains_pointer(); }
+			case variable_type::NIL:
+			case variable_type::VOID:
+			case variable_type::BOOLEAN:
+			case variable_type::INT:
+			case variable_type::FLOAT:
+			case variable_type::DOUBLE:
+			default: { return false; }
+		}
+	}
+
+	auto TypeDeclaration::mark_pointers(container::vector<std::uintptr_t>& bitmap, const std::size_t offset) const -> void
+	{
+		if (!contains_pointer()) { return; }
+
+		const auto mark_words = [&bitmap](const std::size_t begin, const std::size_t end)
+		{
+			for (auto word = begin / sizeof(void*); word < (end + sizeof(void*) - 1) / sizeof(void*); ++word)
+			{
+				bitmap[word / memory::bits_per_bitmap_word] |= std::uintptr_t{1} << (word % memory::bits_per_bitmap_word);
+			}
+		};
+
+		// an unknown structure is scanned entirely
+		if (type_ != variable_type::STRUCTURE || !owner_)
+		{
+			mark_words(offset, offset + size());
+			return;
+		}
+
+		const auto element_size = owner_->get_size();
+		const auto count = element_count();
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			for (const auto& field: owner_->get_fields())
+			{
+				if (field.variable.type) { field.variable.type->mark_pointers(bitmap, offset + i * element_size + field.offset); }
+			}
+		}
+	}
+
+	auto Structure::next_generation() noexcept -> generation_type
+	{
+		// starts at 1, a default constructed cache entry (nullptr, 0) never matches
+		static std::atomic<generation_type> generation{1};
+		return generation.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	auto Structure::do_register_field(Variable::variable_declaration&& variable) -> void
+	{
+		const auto field_size = variable.type ? variable.type->size() : 0;
+		const auto field_alignment = variable.type ? variable.type->alignment() : 1;
+
+		const auto offset = (size_ + field_alignment - 1) / field_alignment * field_alignment;
+		size_ = offset + field_size;
+		alignment_ = std::ranges::max(alignment_, field_alignment);
+
+		fields_.emplace_back(std::move(variable), fields_.size(), offset);
+	}
+
+	auto Structure::get_field(const symbol_name_view name) const noexcept -> const field_declaration*
+	{
+		if (const auto it = std::ranges::find(
+					fields_,
+					name,
+					[](const auto& field) -> symbol_name_view { return field.variable.name; });
+			it != fields_.end()) { return &*it; }
+
+		return nullptr;
+	}
+
+	auto Structure::contains_pointer() const noexcept -> bool
+	{
+		return std::ranges::any_of(
+				fields_,
+				[](const auto& field) { return !field.variable.type || field.variable.type->contains_pointer(); });
+	}
+
+	auto Structure::pointer_bitmap() const -> container::vector<std::uintptr_t>
+	{
+		const auto word_count = (get_size() + sizeof(void*) - 1) / sizeof(void*);
+		container::vector<std::uintptr_t> bitmap((word_count + memory::bits_per_bitmap_word - 1) / memory::bits_per_bitmap_word, 0);
+
+		for (const auto& field: fields_)
+		{
+			if (field.variable.type) { field.variable.type->mark_pointers(bitmap, field.offset); }
+		}
+
+		return bitmap;
+	}
+
+	auto Structure::get_type_descriptor() const -> memory::type_descriptor
+	{
+		std::call_once(
+				descriptor_flag_,
+				[this]
+				{
+					const auto bitmap = pointer_bitmap();
+					descriptor_ = memory::make_type_descriptor(bitmap, (get_size() + sizeof(void*) - 1) / sizeof(void*));
+				});
+
+		return descriptor_;
+	}
+
 	auto Structure::register_field(symbol_name&& name, type_declaration_type&& type) -> bool
 	{
 		if (const auto it = std::ranges::find(
@@ -33,7 +185,7 @@ namespace gal::gsl::ast
 					[](const auto& field) -> const symbol_name& { return field.variable.name; });
 			it != fields_.end()) { return false; }
 
-		fields_.emplace_back(Variable::variable_declaration{.name = std::move(name), .type = std::move(type)}, fields_.size());
+		do_register_field(Variable::variable_declaration{.name = std::move(name), .type = std::move(type)});
 		return true;
 	}
 
@@ -45,7 +197,7 @@ namespace gal::gsl::ast
 					[](const auto& field) -> const symbol_name& { return field.variable.name; });
 			it != fields_.end()) { return false; }
 
-		fields_.emplace_back(std::move(variable));
+		do_register_field(std::move(variable));
 		return true;
 	}
 
@@ -57,43 +209,114 @@ namespace gal::gsl::ast
 					[](const auto& field) -> symbol_name_view { return field.variable.name; });
 			it != fields_.end()) { return false; }
 
-		fields_.emplace_back(Variable::variable_declaration{.name = symbol_name{name}, .type = type}, fields_.size());
+		do_register_field(Variable::variable_declaration{.name = symbol_name{name}, .type = type});
 		return true;
 	}
 
+	auto Structure::register_field(const symbol_name_view name, const type_declaration_type& type, const std::size_t offset) -> bool
+	{
+		if (const auto it = std::ranges::find(
+					fields_,
+					name,
+					[](const auto& field) -> symbol_name_view { return field.variable.name; });
+			it != fields_.end()) { return false; }
+
+		const auto size = type ? type->size() : 0;
+		if (type && offset % type->alignment() != 0) { return false; }
+		// the fields may leave gaps, never share bytes
+		if (std::ranges::any_of(
+				fields_,
+				[offset, size](const auto& field)
+				{
+					const auto field_size = field.variable.type ? field.variable.type->size() : 0;
+					return offset < field.offset + field_size && field.offset < offset + size;
+				})) { return false; }
+
+		// the alignment is the one of the layout given (see reserve_layout), not the natural one of the field
+		size_ = std::ranges::max(size_, offset + size);
+
+		fields_.emplace_back(Variable::variable_declaration{.name = symbol_name{name}, .type = type}, fields_.size(), offset);
+		return true;
+	}
+
+	auto Structure::reserve_layout(const std::size_t size, const std::size_t alignment) noexcept -> void
+	{
+		gsl_assert(alignment != 0 && (alignment & (alignment - 1)) == 0, "the alignment must be a power of 2!");
+
+		size_ = std::ranges::max(size_, size);
+		alignment_ = std::ranges::max(alignment_, alignment);
+	}
+
 	Function::~Function() noexcept = default;
 
-	auto Module::register_structure(symbol_name&& name) -> std::pair<bool, structure_type>
+	auto Function::set_lazy_function_body(memory::shared_ptr<const string::string> source, const std::size_t offset, const std::size_t size, body_parser_type&& parser) -> void
+	{
+		gsl_assert(source && offset + size <= source->size(), "the body must be inside the source!");
+
+		function_body_.reset();
+		lazy_body_ = memory::make_shared<lazy_body>();
+		lazy_body_->done.store(false, std::memory_order_relaxed);
+		lazy_body_->source = std::move(source);
+		lazy_body_->offset = offset;
+		lazy_body_->size = size;
+		lazy_body_->parser = std::move(parser);
+	}
+
+	auto Function::get_function_body() const -> const expression_type&
+	{
+		if (lazy_body_)
+		{
+			std::call_once(
+					lazy_body_->parsed,
+					[this]
+					{
+						auto& [parsed, done, source, offset, size, parser] = *lazy_body_;
+
+						function_body_ = parser(*this, std::string_view{*source}.substr(offset, size));
+
+						// the file is freed once all its bodies are parsed
+						source.reset();
+						parser = nullptr;
+						done.store(true, std::memory_order_release);
+					});
+		}
+
+		return function_body_;
+	}
+
+	auto Module::next_version() noexcept -> version_type
 	{
-		if (const auto it = structures_.find(name);
-			it != structures_.end()) { return std::make_pair(false, it->second); }
+		// starts at 1, a default constructed cache entry (nullptr, 0) never matches
+		static std::atomic<version_type> version{1};
+		return version.fetch_add(1, std::memory_order_relaxed);
+	}
 
-		// use name first
-		auto structure = memory::make_shared<Structure>(name);
-		// move it
-		auto [it, inserted] = structures_.try_emplace(
+	auto Module::register_import(symbol_name&& name) -> bool
+	{
+		if (std::ranges::find(imports_, name) != imports_.end()) { return false; }
+
+		imports_.push_back(std::move(name));
+		return true;
+	}
+
+	auto Module::register_structure(symbol_name&& name) -> std::pair<bool, structure_type>
+	{
+		const auto [inserted, structure] = structures_.try_emplace(
 				std::move(name),
-				std::move(structure)
-				);
+				[](const symbol_name& n) { return memory::make_shared<Structure>(n); });
 
-		gsl_assert(inserted, "impossible happened!");
-		return std::make_pair(true, it->second);
+		if (inserted) { version_.store(next_version(), std::memory_order_release); }
+		return std::make_pair(inserted, structure);
 	}
 
 	auto Module::register_global_mutable(symbol_name&& name) -> std::pair<bool, variable_type>
 	{
-		if (const auto it = globals_.find(name);
-			it != globals_.end()) { return std::make_pair(false, it->second); }
-
-		// use name first
-		auto global = memory::make_shared<Variable>(name);
-		// move it
-		auto [it, inserted] = globals_.try_emplace(
+		const auto [inserted, global] = globals_.try_emplace(
 				std::move(name),
-				std::move(global));
+				[](const symbol_name& n) { return memory::make_shared<Variable>(symbol_name_view{n}); });
 
-		gsl_assert(inserted, "impossible happened!");
-		return std::make_pair(true, it->second);
+		if (inserted) { version_.store(next_version(), std::memory_order_release); }
+		return std::make_pair(inserted, global);
 	}
 
 	auto Module::register_global_immutable(symbol_name&& name) -> std::pair<bool, variable_type>
@@ -104,17 +327,45 @@ namespace gal::gsl::ast
 
 	auto Module::register_function(symbol_name&& name) -> std::pair<bool, function_type>
 	{
-		if (const auto it = functions_.find(name);
-			it != functions_.end()) { return std::make_pair(false, it->second); }
-
-		// use name first
-		auto function = memory::make_shared<Function>(name);
-		// move it
-		auto [it, inserted] = functions_.try_emplace(
+		const auto [inserted, function] = functions_.try_emplace(
 				std::move(name),
-				std::move(function));
+				[](const symbol_name& n) { return memory::make_shared<Function>(symbol_name_view{n}); });
+
+		if (inserted) { version_.store(next_version(), std::memory_order_release); }
+		return std::make_pair(inserted, function);
+	}
+
+	auto Module::redefine_structure(const symbol_name_view name, structure_type structure) -> void
+	{
+		structures_.insert_or_assign(symbol_name{name}, std::move(structure));
+		version_.store(next_version(), std::memory_order_release);
+	}
 
-		gsl_assert(inserted, "impossible happened!");
-		return std::make_pair(true, it->second);
+	auto Module::redefine_global(const symbol_name_view name, variable_type global) -> void
+	{
+		globals_.insert_or_assign(symbol_name{name}, std::move(global));
+		version_.store(next_version(), std::memory_order_release);
+	}
+
+	auto Module::redefine_function(const symbol_name_view name, function_type function) -> void
+	{
+		functions_.insert_or_assign(symbol_name{name}, std::move(function));
+		version_.store(next_version(), std::memory_order_release);
+	}
+
+	auto Module::unregister_global(const symbol_name_view name) -> bool
+	{
+		if (!globals_.erase(name)) { return false; }
+
+		version_.store(next_version(), std::memory_order_release);
+		return true;
+	}
+
+	auto Module::unregister_function(const symbol_name_view name) -> bool
+	{
+		if (!functions_.erase(name)) { return false; }
+
+		version_.store(next_version(), std::memory_order_release);
+		return true;
 	}
 }
@@ -0,0 +1,723 @@
+#include <gsl/backend/ir.hpp>
+
+#include <magic_enum.hpp>
+
+#include <bit>
+#include <charconv>
+#include <ranges>
+
+namespace gal::gsl::ir
+{
+	namespace
+	{
+		auto append_number(string::string& out, const auto number) -> void
+		{
+			char buffer[32];
+			const auto [end, error] = std::to_chars(std::ranges::begin(buffer), std::ranges::end(buffer), number);
+			gsl_assert(error == std::errc{}, "buffer too small!");
+			out.append(buffer, end);
+		}
+
+		auto append_constant(string::string& out, const constant_type& constant) -> void
+		{
+			std::visit(
+					[&out]<typename T>(const T& value)
+					{
+						if constexpr (std::is_same_v<T, std::monostate>) { out.append("nil"); }
+						else if constexpr (std::is_same_v<T, bool>) { out.append(value ? "true" : "false"); }
+						else { append_number(out, value); }
+					},
+					constant);
+		}
+
+		[[nodiscard]] constexpr auto type_of(const constant_type& constant) noexcept -> type_t
+		{
+			switch (constant.index())
+			{
+				case 1: { return type_t::BOOLEAN; }
+				case 2: { return type_t::INT; }
+				case 3: { return type_t::FLOAT; }
+				case 4: { return type_t::DOUBLE; }
+				default: { return type_t::NIL; }
+			}
+		}
+	}
+
+	Function::Function(const symbol_name_view name, const argument_count_type arity, const type_t return_type)
+		: name_{name},
+		arity_{arity},
+		return_type_{return_type},
+		frame_size_{0},
+		frame_alignment_{1} { (void)create_block(); }
+
+	auto Function::allocate_frame(const std::size_t size, const std::size_t alignment) -> std::uint32_t
+	{
+		gsl_assert(std::has_single_bit(alignment), "alignment must be a power of 2!");
+
+		const auto offset = (frame_size_ + alignment - 1) & ~(alignment - 1);
+		frame_size_ = offset + size;
+		frame_alignment_ = std::ranges::max(frame_alignment_, alignment);
+
+		return static_cast<std::uint32_t>(offset);
+	}
+
+	auto Function::create_block() -> block_id
+	{
+		blocks_.emplace_back();
+		return static_cast<block_id>(blocks_.size() - 1);
+	}
+
+	auto Function::size() const noexcept -> std::size_t
+	{
+		std::size_t total = 0;
+		for (const auto& b: blocks_) { if (b.alive) { total += b.instructions.size(); } }
+		return total;
+	}
+
+	auto Function::terminator(const block_id id) const noexcept -> value_id
+	{
+		const auto& instructions = block(id).instructions;
+		if (instructions.empty()) { return invalid_value; }
+
+		const auto last = instructions.back();
+		return is_terminator(values_[last].op) ? last : invalid_value;
+	}
+
+	auto Function::successors(const block_id id) const noexcept -> std::span<const block_id>
+	{
+		if (const auto t = terminator(id);
+			t != invalid_value) { return values_[t].blocks; }
+		return {};
+	}
+
+	auto Function::insert(const block_id id, const std::size_t position, Instruction&& instruction) -> value_id
+	{
+		auto& instructions = block(id).instructions;
+		gsl_assert(position <= instructions.size(), "position out of range!");
+
+		const auto value = static_cast<value_id>(values_.size());
+		instruction.block = id;
+		values_.push_back(std::move(instruction));
+		instructions.insert(instructions.begin() + static_cast<std::ptrdiff_t>(position), value);
+
+		return value;
+	}
+
+	auto Function::insert_before_terminator(const block_id id, Instruction&& instruction) -> value_id
+	{
+		const auto& instructions = block(id).instructions;
+		const auto position = instructions.size() - (terminator(id) == invalid_value ? 0 : 1);
+		return insert(id, position, std::move(instruction));
+	}
+
+	auto Function::move_before_terminator(const value_id value, const block_id id) -> void
+	{
+		auto& instruction = values_[value];
+
+		auto& from = block(instruction.block).instructions;
+		from.erase(std::ranges::find(from, value));
+
+		auto& to = block(id).instructions;
+		const auto position = to.size() - (terminator(id) == invalid_value ? 0 : 1);
+		to.insert(to.begin() + static_cast<std::ptrdiff_t>(position), value);
+
+		instruction.block = id;
+	}
+
+	auto Function::erase(const value_id value) -> void
+	{
+		auto& instruction = values_[value];
+
+		auto& instructions = block(instruction.block).instructions;
+		const auto it = std::ranges::find(instructions, value);
+		gsl_assert(it != instructions.end(), "value already erased!");
+		instructions.erase(it);
+
+		instruction.block = invalid_block;
+	}
+
+	auto Function::replace_all_uses(const value_id from, const value_id to) -> void
+	{
+		for (const auto& b: blocks_)
+		{
+			if (!b.alive) { continue; }
+
+			for (const auto id: b.instructions) { std::ranges::replace(values_[id].operands, from, to); }
+		}
+	}
+
+	auto Function::compute_uses() const -> container::vector<container::vector<value_id>>
+	{
+		container::vector<container::vector<value_id>> uses(values_.size());
+
+		for (const auto& b: blocks_)
+		{
+			if (!b.alive) { continue; }
+
+			for (const auto id: b.instructions) { for (const auto operand: values_[id].operands) { uses[operand].push_back(id); } }
+		}
+
+		return uses;
+	}
+
+	auto Function::recompute_predecessors() -> void
+	{
+		for (auto& b: blocks_) { b.predecessors.clear(); }
+
+		for (block_id id = 0; id < blocks_.size(); ++id)
+		{
+			if (!blocks_[id].alive) { continue; }
+
+			for (const auto successor: successors(id))
+			{
+				if (auto& predecessors = blocks_[successor].predecessors;
+					std::ranges::find(predecessors, id) == predecessors.end()) { predecessors.push_back(id); }
+			}
+		}
+	}
+
+	auto Function::remove_incoming(const block_id to, const block_id from) -> void
+	{
+		for (const auto id: block(to).instructions)
+		{
+			auto& phi = values_[id];
+			if (phi.op != opcode::PHI) { break; }
+
+			for (std::size_t i = phi.blocks.size(); i != 0; --i)
+			{
+				if (phi.blocks[i - 1] == from)
+				{
+					phi.blocks.erase(phi.blocks.begin() + static_cast<std::ptrdiff_t>(i - 1));
+					phi.operands.erase(phi.operands.begin() + static_cast<std::ptrdiff_t>(i - 1));
+				}
+			}
+		}
+	}
+
+	auto Function::remove_unreachable_blocks() -> bool
+	{
+		container::vector<bool> reachable(blocks_.size(), false);
+		for (const auto id: reverse_post_order()) { reachable[id] = true; }
+
+		bool changed = false;
+		for (block_id id = 0; id < blocks_.size(); ++id)
+		{
+			if (!blocks_[id].alive || reachable[id]) { continue; }
+
+			for (const auto successor: successors(id)) { if (reachable[successor]) { remove_incoming(successor, id); } }
+
+			for (const auto value: blocks_[id].instructions) { values_[value].block = invalid_block; }
+			blocks_[id].instructions.clear();
+			blocks_[id].alive = false;
+			changed = true;
+		}
+
+		if (changed) { recompute_predecessors(); }
+		return changed;
+	}
+
+	auto Function::reverse_post_order() const -> container::vector<block_id>
+	{
+		container::vector<block_id> order;
+		order.reserve(blocks_.size());
+
+		container::vector<bool> visited(blocks_.size(), false);
+		// block, next successor
+		container::vector<std::pair<block_id, std::size_t>> stack;
+
+		stack.emplace_back(entry(), 0);
+		visited[entry()] = true;
+		while (!stack.empty())
+		{
+			auto& [id, next] = stack.back();
+
+			if (const auto s = successors(id);
+				next < s.size())
+			{
+				const auto successor = s[next++];
+				if (!visited[successor])
+				{
+					visited[successor] = true;
+					stack.emplace_back(successor, 0);
+				}
+			}
+			else
+			{
+				order.push_back(id);
+				stack.pop_back();
+			}
+		}
+
+		std::ranges::reverse(order);
+		return order;
+	}
+
+	auto Function::verify() const -> bool
+	{
+		for (block_id id = 0; id < blocks_.size(); ++id)
+		{
+			const auto& [instructions, predecessors, alive] = blocks_[id];
+			if (!alive) { continue; }
+
+			if (terminator(id) == invalid_value) { return false; }
+
+			bool in_phis = true;
+			for (std::size_t i = 0; i < instructions.size(); ++i)
+			{
+				const auto& instruction = values_[instructions[i]];
+
+				if (instruction.block != id) { return false; }
+				if (is_terminator(instruction.op) && i != instructions.size() - 1) { return false; }
+
+				if (instruction.op == opcode::PHI)
+				{
+					if (!in_phis) { return false; }
+					if (instruction.operands.size() != instruction.blocks.size() || instruction.blocks.size() != predecessors.size()) { return false; }
+					if (!std::ranges::all_of(predecessors, [&](const auto p) { return std::ranges::find(instruction.blocks, p) != instruction.blocks.end(); })) { return false; }
+				}
+				else { in_phis = false; }
+
+				for (const auto operand: instruction.operands)
+				{
+					if (operand >= values_.size() || values_[operand].block == invalid_block) { return false; }
+				}
+				for (const auto target: instruction.op == opcode::PHI ? std::span<const block_id>{} : std::span<const block_id>{instruction.blocks})
+				{
+					if (target >= blocks_.size() || !blocks_[target].alive) { return false; }
+				}
+			}
+		}
+
+		return true;
+	}
+
+	auto Function::dump() const -> string::string
+	{
+		string::string out{};
+
+		out.append("function ").append(name_).append("(");
+		append_number(out, arity_);
+		out.append(") -> ").append(magic_enum::enum_name(return_type_)).append("\n");
+
+		for (const auto id: reverse_post_order())
+		{
+			out.append("bb");
+			append_number(out, id);
+			out.append(":\n");
+
+			for (const auto value: blocks_[id].instructions)
+			{
+				const auto& instruction = values_[value];
+
+				out.append("\t");
+				if (!has_side_effect(instruction.op) || instruction.op == opcode::CALL || instruction.op == opcode::CHECK_BOUNDS)
+				{
+					out.append("%");
+					append_number(out, value);
+					out.append(" = ");
+				}
+				out.append(magic_enum::enum_name(instruction.op));
+
+				switch (instruction.op)
+				{
+					case opcode::CONSTANT:
+					{
+						out.append(" ");
+						append_constant(out, instruction.constant);
+						break;
+					}
+					case opcode::ARGUMENT:
+					case opcode::LOAD_FIELD:
+					case opcode::STORE_FIELD:
+					case opcode::LOAD_ELEMENT:
+					case opcode::STORE_ELEMENT:
+					case opcode::CHECK_BOUNDS:
+					{
+						out.append(" #");
+						append_number(out, instruction.index);
+						break;
+					}
+					case opcode::LOAD_GLOBAL:
+					case opcode::STORE_GLOBAL:
+					case opcode::CALL:
+					{
+						out.append(" @").append(instruction.symbol);
+						break;
+					}
+					case opcode::ALLOC:
+					{
+						out.append(" ").append(instruction.structure->get_name());
+						break;
+					}
+					case opcode::FRAME_ALLOC:
+					{
+						out.append(" ").append(instruction.structure->get_name()).append(" #");
+						append_number(out, instruction.index);
+						break;
+					}
+					default: { break; }
+				}
+
+				for (std::size_t i = 0; i < instruction.operands.size(); ++i)
+				{
+					out.append(i == 0 ? " %" : ", %");
+					append_number(out, instruction.operands[i]);
+					if (instruction.op == opcode::PHI)
+					{
+						out.append(" <- bb");
+						append_number(out, instruction.blocks[i]);
+					}
+				}
+
+				if (instruction.op != opcode::PHI)
+				{
+					for (std::size_t i = 0; i < instruction.blocks.size(); ++i)
+					{
+						out.append(i == 0 ? " -> bb" : ", bb");
+						append_number(out, instruction.blocks[i]);
+					}
+				}
+
+				if (instruction.type != type_t::NIL)
+				{
+					out.append(" : ").append(magic_enum::enum_name(instruction.type));
+				}
+				out.append("\n");
+			}
+		}
+
+		return out;
+	}
+
+	auto Module::create_function(const symbol_name_view name, const Function::argument_count_type arity, const type_t return_type) -> function_type
+	{
+		const auto [it, inserted] = functions_.try_emplace(symbol_name{name}, nullptr);
+		if (!inserted) { return nullptr; }
+
+		it->second = memory::make_shared<Function>(name, arity, return_type);
+		return it->second;
+	}
+
+	auto Builder::emit(Instruction&& instruction) -> value_id
+	{
+		gsl_assert(function_.terminator(current_) == invalid_value, "the block is already terminated!");
+		return function_.append(current_, std::move(instruction));
+	}
+
+	auto Builder::constant(constant_type value) -> value_id
+	{
+		const auto type = type_of(value);
+		return emit({.op = opcode::CONSTANT, .type = type, .constant = value});
+	}
+
+	auto Builder::argument(const std::uint32_t index, const type_t type) -> value_id
+	{
+		gsl_assert(index < function_.get_arity(), "argument out of range!");
+		return emit({.op = opcode::ARGUMENT, .type = type, .index = index});
+	}
+
+	auto Builder::argument(const std::uint32_t index, const ast::Structure& structure) -> value_id
+	{
+		gsl_assert(index < function_.get_arity(), "argument out of range!");
+		return emit({.op = opcode::ARGUMENT, .type = type_t::STRUCTURE, .index = index, .structure = &structure});
+	}
+
+	auto Builder::binary(const opcode op, const value_id lhs, const value_id rhs) -> value_id
+	{
+		gsl_assert(is_binary(op), "not a binary operator!");
+
+		const auto lhs_type = function_.value(lhs).type;
+		const auto rhs_type = function_.value(rhs).type;
+
+		auto type = type_t::NIL;
+		if (is_comparison(op) || op == opcode::AND || op == opcode::OR) { type = type_t::BOOLEAN; }
+		else if (lhs_type == rhs_type) { type = lhs_type; }
+
+		return emit({.op = op, .type = type, .operands = {lhs, rhs}});
+	}
+
+	auto Builder::unary(const opcode op, const value_id operand) -> value_id
+	{
+		gsl_assert(is_unary(op), "not an unary operator!");
+
+		const auto type = op == opcode::NOT ? type_t::BOOLEAN : function_.value(operand).type;
+		return emit({.op = op, .type = type, .operands = {operand}});
+	}
+
+	auto Builder::convert(const value_id value, const type_t type) -> value_id { return emit({.op = opcode::CONVERT, .type = type, .operands = {value}}); }
+
+	auto Builder::phi(const type_t type) -> value_id
+	{
+		gsl_assert(
+				std::ranges::all_of(function_.block(current_).instructions, [this](const auto id) { return function_.value(id).op == opcode::PHI; }),
+				"phi must be placed at the beginning of a block!");
+		return emit({.op = opcode::PHI, .type = type});
+	}
+
+	auto Builder::add_incoming(const value_id phi, const value_id value, const block_id from) const -> void
+	{
+		auto& instruction = function_.value(phi);
+		gsl_assert(instruction.op == opcode::PHI, "not a phi!");
+
+		instruction.operands.push_back(value);
+		instruction.blocks.push_back(from);
+	}
+
+	auto Builder::load_global(const symbol_name_view name, const type_t type) -> value_id { return emit({.op = opcode::LOAD_GLOBAL, .type = type, .symbol = symbol_name{name}}); }
+
+	auto Builder::store_global(const symbol_name_view name, const value_id value) -> value_id { return emit({.op = opcode::STORE_GLOBAL, .type = type_t::VOID, .operands = {value}, .symbol = symbol_name{name}}); }
+
+	auto Builder::alloc(const ast::Structure& structure) -> value_id { return emit({.op = opcode::ALLOC, .type = type_t::STRUCTURE, .structure = &structure}); }
+
+	auto Builder::load_field(const value_id object, const std::uint32_t index, const type_t type) -> value_id { return emit({.op = opcode::LOAD_FIELD, .type = type, .operands = {object}, .index = index}); }
+
+	auto Builder::store_field(const value_id object, const std::uint32_t index, const value_id value) -> value_id { return emit({.op = opcode::STORE_FIELD, .type = type_t::VOID, .operands = {object, value}, .index = index}); }
+
+	auto Builder::load_element(const value_id object, const std::uint32_t index, const value_id element, const type_t type) -> value_id
+	{
+		const auto checked = emit({.op = opcode::CHECK_BOUNDS, .type = type_t::INT, .operands = {element}});
+		return emit({.op = opcode::LOAD_ELEMENT, .type = type, .operands = {object, checked}, .index = index});
+	}
+
+	auto Builder::store_element(const value_id object, const std::uint32_t index, const value_id element, const value_id value) -> value_id
+	{
+		const auto checked = emit({.op = opcode::CHECK_BOUNDS, .type = type_t::INT, .operands = {element}});
+		return emit({.op = opcode::STORE_ELEMENT, .type = type_t::VOID, .operands = {object, checked, value}, .index = index});
+	}
+
+	auto Builder::call(const symbol_name_view name, const std::span<const value_id> arguments, const type_t type) -> value_id
+	{
+		return emit({.op = opcode::CALL, .type = type, .operands = {arguments.begin(), arguments.end()}, .symbol = symbol_name{name}});
+	}
+
+	auto Builder::jump(const block_id target) -> value_id
+	{
+		const auto value = emit({.op = opcode::JUMP, .type = type_t::VOID, .blocks = {target}});
+		function_.recompute_predecessors();
+		return value;
+	}
+
+	auto Builder::branch(const value_id condition, const block_id if_true, const block_id if_false) -> value_id
+	{
+		const auto value = emit({.op = opcode::BRANCH, .type = type_t::VOID, .operands = {condition}, .blocks = {if_true, if_false}});
+		function_.recompute_predecessors();
+		return value;
+	}
+
+	auto Builder::ret() -> value_id { return emit({.op = opcode::RETURN, .type = type_t::VOID}); }
+
+	auto Builder::ret(const value_id value) -> value_id { return emit({.op = opcode::RETURN, .type = type_t::VOID, .operands = {value}}); }
+
+	auto Builder::loop(const value_id begin, const value_id end, const std::function<void(value_id)>& body) -> value_id
+	{
+		const auto preheader = current_;
+		const auto header = create_block();
+		const auto first = create_block();
+		const auto exit = create_block();
+		(void)jump(header);
+
+		current_ = header;
+		const auto i = phi(type_t::INT);
+		(void)branch(binary(opcode::LESS, i, end), first, exit);
+
+		current_ = first;
+		body(i);
+		const auto next = binary(opcode::ADD, i, constant(std::int32_t{1}));
+		const auto latch = current_;
+		(void)jump(header);
+
+		add_incoming(i, begin, preheader);
+		add_incoming(i, next, latch);
+
+		current_ = exit;
+		return i;
+	}
+
+	auto Builder::for_each_element(const ast::Structure& structure, const std::uint32_t index, const std::function<void(value_id)>& body) -> void
+	{
+		const auto& fields = structure.get_fields();
+		gsl_assert(index < fields.size() && fields[index].variable.type && fields[index].variable.type->is_array(), "not an array field!");
+
+		const auto extent = fields[index].variable.type->element_count();
+		gsl_assert(extent <= static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max()), "array too large!");
+
+		(void)loop(constant(std::int32_t{0}), constant(static_cast<std::int32_t>(extent)), body);
+	}
+
+	DominatorTree::DominatorTree(const Function& function)
+		: immediate_dominators_(function.block_count(), invalid_block),
+		children_(function.block_count()),
+		preorder_(function.block_count(), 0),
+		postorder_(function.block_count(), 0)
+	{
+		// Cooper, Harvey, Kennedy: A Simple, Fast Dominance Algorithm
+		const auto order = function.reverse_post_order();
+
+		container::vector<std::uint32_t> rpo_index(function.block_count(), std::numeric_limits<std::uint32_t>::max());
+		for (std::uint32_t i = 0; i < order.size(); ++i) { rpo_index[order[i]] = i; }
+
+		const auto intersect = [&](block_id a, block_id b)
+		{
+			while (a != b)
+			{
+				while (rpo_index[a] > rpo_index[b]) { a = immediate_dominators_[a]; }
+				while (rpo_index[b] > rpo_index[a]) { b = immediate_dominators_[b]; }
+			}
+			return a;
+		};
+
+		immediate_dominators_[Function::entry()] = Function::entry();
+		for (bool changed = true; changed;)
+		{
+			changed = false;
+			for (const auto id: order | std::views::drop(1))
+			{
+				auto dominator = invalid_block;
+				for (const auto predecessor: function.block(id).predecessors)
+				{
+					if (immediate_dominators_[predecessor] == invalid_block) { continue; }
+					dominator = dominator == invalid_block ? predecessor : intersect(predecessor, dominator);
+				}
+
+				if (immediate_dominators_[id] != dominator)
+				{
+					immediate_dominators_[id] = dominator;
+					changed = true;
+				}
+			}
+		}
+		immediate_dominators_[Function::entry()] = invalid_block;
+
+		for (const auto id: order | std::views::drop(1)) { children_[immediate_dominators_[id]].push_back(id); }
+
+		// number the tree, a dominates b <==> a's interval contains b's
+		std::uint32_t counter = 0;
+		container::vector<std::pair<block_id, std::size_t>> stack;
+		stack.emplace_back(Function::entry(), 0);
+		preorder_[Function::entry()] = ++counter;
+		while (!stack.empty())
+		{
+			if (auto& [id, next] = stack.back();
+				next < children_[id].size())
+			{
+				const auto child = children_[id][next++];
+				preorder_[child] = ++counter;
+				stack.emplace_back(child, 0);
+			}
+			else
+			{
+				postorder_[id] = ++counter;
+				stack.pop_back();
+			}
+		}
+	}
+
+	auto DominatorTree::is_reachable(const block_id block) const noexcept -> bool { return block < preorder_.size() && preorder_[block] != 0; }
+
+	auto DominatorTree::dominates(const block_id a, const block_id b) const noexcept -> bool
+	{
+		if (!is_reachable(a) || !is_reachable(b)) { return false; }
+		return preorder_[a] <= preorder_[b] && postorder_[b] <= postorder_[a];
+	}
+
+	auto find_loops(const Function& function, const DominatorTree& dominator_tree) -> container::vector<Loop>
+	{
+		container::vector<Loop> loops;
+
+		for (const auto id: function.reverse_post_order())
+		{
+			for (const auto successor: function.successors(id))
+			{
+				// a back edge
+				if (!dominator_tree.dominates(successor, id)) { continue; }
+
+				auto it = std::ranges::find(loops, successor, &Loop::header);
+				if (it == loops.end())
+				{
+					loops.push_back({.header = successor, .blocks = {successor}, .latches = {}});
+					it = std::prev(loops.end());
+				}
+				it->latches.push_back(id);
+
+				// everything that reaches the latch without going through the header
+				container::vector<block_id> worklist{id};
+				while (!worklist.empty())
+				{
+					const auto current = worklist.back();
+					worklist.pop_back();
+
+					if (it->contains(current)) { continue; }
+					it->blocks.push_back(current);
+
+					for (const auto predecessor: function.block(current).predecessors)
+					{
+						if (dominator_tree.is_reachable(predecessor)) { worklist.push_back(predecessor); }
+					}
+				}
+			}
+		}
+
+		// an inner loop is a strict subset of the loops containing it
+		std::ranges::stable_sort(loops, std::ranges::less{}, [](const Loop& loop) { return loop.blocks.size(); });
+		return loops;
+	}
+
+	auto make_preheader(Function& function, const Loop& loop) -> std::pair<block_id, bool>
+	{
+		if (loop.header == Function::entry()) { return {invalid_block, false}; }
+
+		container::vector<block_id> outside;
+		for (const auto predecessor: function.block(loop.header).predecessors) { if (!loop.contains(predecessor)) { outside.push_back(predecessor); } }
+
+		if (outside.size() == 1 && function.successors(outside.front()).size() == 1) { return {outside.front(), false}; }
+
+		const auto preheader = function.create_block();
+
+		// the incoming values from outside now come through the preheader
+		const auto header_instructions = function.block(loop.header).instructions;
+		for (const auto phi: header_instructions)
+		{
+			if (function.value(phi).op != opcode::PHI) { break; }
+
+			container::vector<value_id> operands;
+			container::vector<block_id> blocks;
+			{
+				auto& instruction = function.value(phi);
+				for (std::size_t i = instruction.blocks.size(); i != 0; --i)
+				{
+					if (std::ranges::find(outside, instruction.blocks[i - 1]) == outside.end()) { continue; }
+
+					operands.push_back(instruction.operands[i - 1]);
+					blocks.push_back(instruction.blocks[i - 1]);
+					instruction.operands.erase(instruction.operands.begin() + static_cast<std::ptrdiff_t>(i - 1));
+					instruction.blocks.erase(instruction.blocks.begin() + static_cast<std::ptrdiff_t>(i - 1));
+				}
+			}
+
+			auto incoming = operands.empty() ? invalid_value : operands.front();
+			if (operands.size() > 1 && std::ranges::any_of(operands, [&](const auto v) { return v != operands.front(); }))
+			{
+				const auto type = function.value(phi).type;
+				incoming = function.append(preheader, {.op = opcode::PHI, .type = type, .operands = std::move(operands), .blocks = std::move(blocks)});
+			}
+
+			if (incoming != invalid_value)
+			{
+				auto& instruction = function.value(phi);
+				instruction.operands.push_back(incoming);
+				instruction.blocks.push_back(preheader);
+			}
+		}
+
+		(void)function.append(preheader, {.op = opcode::JUMP, .type = type_t::VOID, .blocks = {loop.header}});
+
+		for (const auto predecessor: outside)
+		{
+			const auto t = function.terminator(predecessor);
+			std::ranges::replace(function.value(t).blocks, loop.header, preheader);
+		}
+
+		function.recompute_predecessors();
+		return {preheader, true};
+	}
+}
@@ -0,0 +1,120 @@
+#include <gsl/backend/pass.hpp>
+#include <gsl/debug/trace.hpp>
+#include <gsl/logger/logger.hpp>
+
+namespace gal::gsl::ir
+{
+	Pass::~Pass() noexcept = default;
+
+	auto PassManager::create(const optimization_level level) -> PassManager
+	{
+		switch (level)
+		{
+			case optimization_level::O0: { return PassManager{}; }
+			case optimization_level::O1:
+			{
+				PassManager manager{2};
+				manager
+						.add(make_escape_analysis())
+						.add(make_constant_propagation())
+						.add(make_common_subexpression_elimination())
+						.add(make_bounds_check_elimination())
+						.add(make_dead_code_elimination());
+				return manager;
+			}
+			case optimization_level::O2:
+			{
+				PassManager manager{4};
+				manager
+						.add(make_inline())
+						// after inlining, a record passed to an inlined callee no longer escapes
+						.add(make_escape_analysis())
+						.add(make_constant_propagation())
+						.add(make_common_subexpression_elimination())
+						.add(make_bounds_check_elimination())
+						.add(make_loop_invariant_code_motion())
+						.add(make_dead_code_elimination());
+				return manager;
+			}
+		}
+
+		gsl_trap("unknown optimization level!");
+		return PassManager{};
+	}
+
+	auto PassManager::add(pass_type pass) -> PassManager&
+	{
+		statistics_.push_back({.name = pass->name(), .elapsed = {}, .runs = 0, .changes = 0});
+		passes_.push_back(std::move(pass));
+		return *this;
+	}
+
+	auto PassManager::run(Module& module, Function& function) -> bool
+	{
+		GSL_TRACE_SCOPE_DETAIL("optimize", "ir", function.get_name());
+
+		bool changed = false;
+		for (std::size_t iteration = 0; iteration < iterations_; ++iteration)
+		{
+			bool this_round = false;
+			for (std::size_t i = 0; i < passes_.size(); ++i)
+			{
+				auto& pass = *passes_[i];
+				auto& statistics = statistics_[i];
+
+				GSL_TRACE_SCOPE_DETAIL(pass.name().data(), "ir", function.get_name());
+
+				const auto begin = clock_type::now();
+				const auto pass_changed = pass.run(module, function);
+				statistics.elapsed += clock_type::now() - begin;
+
+				statistics.runs += 1;
+				if (pass_changed)
+				{
+					statistics.changes += 1;
+					this_round = true;
+				}
+
+				#ifndef GSL_NO_ASSERT
+				gsl_assert(function.verify(), "a pass broke the function!");
+				#endif
+			}
+
+			if (!this_round) { break; }
+			changed = true;
+		}
+
+		return changed;
+	}
+
+	auto PassManager::run(Module& module) -> bool
+	{
+		bool changed = false;
+		// the table does not change while we run, but inlining reads other functions of the module
+		for (const auto& [_, function]: module.get_functions()) { changed |= run(module, *function); }
+		return changed;
+	}
+
+	auto PassManager::reset_statistics() noexcept -> void
+	{
+		for (auto& statistics: statistics_)
+		{
+			statistics.elapsed = {};
+			statistics.runs = 0;
+			statistics.changes = 0;
+		}
+	}
+
+	auto PassManager::report() const -> void
+	{
+		for ([[maybe_unused]] const auto& statistics: statistics_)
+		{
+			GSL_LOGGER_DEBUG(
+					"[{}] {}us, {} run(s), {} change(s)",
+					statistics.name,
+					std::chrono::duration_cast<std::chrono::microseconds>(statistics.elapsed).count(),
+					statistics.runs,
+					statistics.changes);
+		}
+	}
+}
@@ -0,0 +1,396 @@
+#include <gsl/backend/pass.hpp>
+
+#include <optional>
+
+namespace gal::gsl::ir
+{
+	namespace
+	{
+		// the values an INT may take, the bounds never overflow
+		struct range
+		{
+			std::int64_t lo;
+			std::int64_t hi;
+
+			[[nodiscard]] constexpr static auto full() noexcept -> range { return {.lo = std::numeric_limits<std::int32_t>::min(), .hi = std::numeric_limits<std::int32_t>::max()}; }
+
+			[[nodiscard]] constexpr static auto exactly(const std::int64_t value) noexcept -> range { return {.lo = value, .hi = value}; }
+
+			// x + offset, full if it may wrap around
+			[[nodiscard]] constexpr auto shift(const std::int64_t offset) const noexcept -> range
+			{
+				if (lo + offset < full().lo || hi + offset > full().hi) { return full(); }
+				return {.lo = lo + offset, .hi = hi + offset};
+			}
+
+			[[nodiscard]] constexpr auto intersect(const range& other) const noexcept -> range { return {.lo = std::ranges::max(lo, other.lo), .hi = std::ranges::min(hi, other.hi)}; }
+
+			[[nodiscard]] constexpr auto merge(const range& other) const noexcept -> range { return {.lo = std::ranges::min(lo, other.lo), .hi = std::ranges::max(hi, other.hi)}; }
+
+			// empty ==> the code is not reachable, anything holds
+			[[nodiscard]] constexpr auto within(const std::uint32_t extent) const noexcept -> bool { return lo >= 0 && hi < static_cast<std::int64_t>(extent); }
+		};
+
+		// a op b ==> b op' a
+		[[nodiscard]] constexpr auto swap_comparison(const opcode op) noexcept -> opcode
+		{
+			switch (op)
+			{
+				case opcode::LESS: { return opcode::GREATER; }
+				case opcode::LESS_EQUAL: { return opcode::GREATER_EQUAL; }
+				case opcode::GREATER: { return opcode::LESS; }
+				case opcode::GREATER_EQUAL: { return opcode::LESS_EQUAL; }
+				default: { return op; }
+			}
+		}
+
+		// !(a op b) ==> a op' b
+		[[nodiscard]] constexpr auto negate_comparison(const opcode op) noexcept -> opcode
+		{
+			switch (op)
+			{
+				case opcode::EQUAL: { return opcode::NOT_EQUAL; }
+				case opcode::NOT_EQUAL: { return opcode::EQUAL; }
+				case opcode::LESS: { return opcode::GREATER_EQUAL; }
+				case opcode::LESS_EQUAL: { return opcode::GREATER; }
+				case opcode::GREATER: { return opcode::LESS_EQUAL; }
+				case opcode::GREATER_EQUAL: { return opcode::LESS; }
+				default: { return op; }
+			}
+		}
+
+		[[nodiscard]] auto constant_of(const Function& function, const value_id value) noexcept -> std::optional<std::int32_t>
+		{
+			const auto& instruction = function.value(value);
+			if (instruction.op != opcode::CONSTANT) { return std::nullopt; }
+
+			if (const auto* constant = std::get_if<std::int32_t>(&instruction.constant)) { return *constant; }
+			return std::nullopt;
+		}
+
+		// i = phi(init, i + 1) in the header of a loop, the header leaves the loop unless i < end
+		struct induction
+		{
+			// the incoming value from outside the loop
+			value_id init;
+			value_id end;
+			// index into the loops
+			std::size_t loop;
+			// the successor of the header in the loop, i < end holds in every block it dominates
+			block_id body;
+		};
+
+		// The ranges of the INT values of one function, see the comment of make_bounds_check_elimination.
+		class BoundsAnalysis
+		{
+		private:
+			// how far the operands are followed, a phi may depend on itself
+			constexpr static std::size_t max_depth = 8;
+
+			Function& function_;
+			DominatorTree dominator_tree_;
+			container::vector<Loop> loops_;
+			// the phi ==> its loop
+			container::unordered_map<value_id, induction> inductions_;
+			container::vector<container::vector<value_id>> uses_;
+
+			auto find_induction(const std::size_t index) -> void
+			{
+				const auto& loop = loops_[index];
+
+				const auto& branch = function_.value(function_.terminator(loop.header));
+				if (branch.op != opcode::BRANCH) { return; }
+
+				const auto stays_if_true = loop.contains(branch.blocks[0]);
+				if (stays_if_true == loop.contains(branch.blocks[1])) { return; }
+
+				// the condition holds in the whole body
+				const auto stay = branch.blocks[stays_if_true ? 0 : 1];
+				if (function_.block(stay).predecessors.size() != 1) { return; }
+
+				const auto& condition = function_.value(branch.operands[0]);
+				if (!is_comparison(condition.op)) { return; }
+
+				auto op = stays_if_true ? condition.op : negate_comparison(condition.op);
+				auto counter = condition.operands[0];
+				auto end = condition.operands[1];
+				if (op == opcode::GREATER)
+				{
+					std::swap(counter, end);
+					op = opcode::LESS;
+				}
+				if (op != opcode::LESS || function_.value(end).type != type_t::INT) { return; }
+
+				const auto& phi = function_.value(counter);
+				if (phi.op != opcode::PHI || phi.block != loop.header || phi.type != type_t::INT || phi.operands.size() != 2) { return; }
+
+				const std::size_t outside = loop.contains(phi.blocks[0]) ? 1 : 0;
+				if (loop.contains(phi.blocks[outside]) || !loop.contains(phi.blocks[1 - outside])) { return; }
+
+				// i + 1 once i < end held, it never wraps around
+				const auto& next = function_.value(phi.operands[1 - outside]);
+				if (next.op != opcode::ADD || next.type != type_t::INT || !dominator_tree_.dominates(stay, next.block)) { return; }
+
+				const auto step = next.operands[0] == counter ? next.operands[1] : next.operands[1] == counter ? next.operands[0] : invalid_value;
+				if (step == invalid_value || constant_of(function_, step) != 1) { return; }
+
+				inductions_.emplace(counter, induction{.init = phi.operands[outside], .end = end, .loop = index, .body = stay});
+			}
+
+			// the instruction a is executed before b on every path reaching b
+			[[nodiscard]] auto dominates(const value_id a, const value_id b) const noexcept -> bool
+			{
+				const auto block = function_.value(a).block;
+				if (block != function_.value(b).block) { return dominator_tree_.dominates(block, function_.value(b).block); }
+
+				const auto& instructions = function_.block(block).instructions;
+				return std::ranges::find(instructions, a) < std::ranges::find(instructions, b);
+			}
+
+			// the range of the value wherever it is defined
+			[[nodiscard]] auto range_of(const value_id value, const std::size_t depth = 0) const -> range
+			{
+				const auto& instruction = function_.value(value);
+				if (instruction.type != type_t::INT || depth == max_depth) { return range::full(); }
+
+				switch (instruction.op)
+				{
+					case opcode::CONSTANT:
+					{
+						if (const auto constant = constant_of(function_, value)) { return range::exactly(*constant); }
+						return range::full();
+					}
+					case opcode::ADD:
+					case opcode::SUB:
+					{
+						if (const auto rhs = constant_of(function_, instruction.operands[1]))
+						{
+							return range_of(instruction.operands[0], depth + 1).shift(instruction.op == opcode::ADD ? *rhs : -static_cast<std::int64_t>(*rhs));
+						}
+						if (const auto lhs = constant_of(function_, instruction.operands[0]);
+							lhs && instruction.op == opcode::ADD) { return range_of(instruction.operands[1], depth + 1).shift(*lhs); }
+						return range::full();
+					}
+					case opcode::PHI:
+					{
+						// only goes up
+						if (const auto it = inductions_.find(value);
+							it != inductions_.end()) { return {.lo = range_of(it->second.init, depth + 1).lo, .hi = range::full().hi}; }
+
+						if (instruction.operands.empty()) { return range::full(); }
+
+						auto result = range_of(instruction.operands[0], depth + 1);
+						for (std::size_t i = 1; i < instruction.operands.size(); ++i) { result = result.merge(range_of(instruction.operands[i], depth + 1)); }
+						return result;
+					}
+					case opcode::CHECK_BOUNDS:
+					{
+						const auto result = range_of(instruction.operands[0], depth + 1);
+						if (instruction.index == 0) { return result; }
+						return result.intersect({.lo = 0, .hi = static_cast<std::int64_t>(instruction.index) - 1});
+					}
+					default: { return range::full(); }
+				}
+			}
+
+			// the range of the value where the block executes: the branches leading there narrow it
+			[[nodiscard]] auto range_in(const value_id value, const block_id block) const -> range
+			{
+				auto result = range_of(value);
+
+				for (auto b = block; b != invalid_block; b = dominator_tree_.immediate_dominator(b))
+				{
+					const auto& predecessors = function_.block(b).predecessors;
+					if (predecessors.size() != 1) { continue; }
+
+					const auto& branch = function_.value(function_.terminator(predecessors.front()));
+					if (branch.op != opcode::BRANCH || branch.blocks[0] == branch.blocks[1]) { continue; }
+
+					const auto& condition = function_.value(branch.operands[0]);
+					if (!is_comparison(condition.op)) { continue; }
+
+					// value op other
+					auto op = branch.blocks[0] == b ? condition.op : negate_comparison(condition.op);
+					auto other = invalid_value;
+					if (condition.operands[0] == value && condition.operands[1] != value) { other = condition.operands[1]; }
+					else if (condition.operands[1] == value && condition.operands[0] != value)
+					{
+						other = condition.operands[0];
+						op = swap_comparison(op);
+					}
+					if (other == invalid_value || function_.value(other).type != type_t::INT) { continue; }
+
+					const auto bound = range_of(other);
+					switch (op)
+					{
+						case opcode::EQUAL: { result = result.intersect(bound); break; }
+						case opcode::LESS: { result.hi = std::ranges::min(result.hi, bound.hi - 1); break; }
+						case opcode::LESS_EQUAL: { result.hi = std::ranges::min(result.hi, bound.hi); break; }
+						case opcode::GREATER: { result.lo = std::ranges::max(result.lo, bound.lo + 1); break; }
+						case opcode::GREATER_EQUAL: { result.lo = std::ranges::max(result.lo, bound.lo); break; }
+						default: { break; }
+					}
+				}
+
+				return result;
+			}
+
+		public:
+			explicit BoundsAnalysis(Function& function)
+				: function_{function},
+				dominator_tree_{function},
+				loops_{find_loops(function, dominator_tree_)},
+				uses_{function.compute_uses()}
+			{
+				for (std::size_t i = 0; i < loops_.size(); ++i) { find_induction(i); }
+			}
+
+			// every check with a known extent, in execution order
+			[[nodiscard]] auto checks() const -> container::vector<value_id>
+			{
+				container::vector<value_id> result;
+				for (const auto id: function_.reverse_post_order())
+				{
+					for (const auto value: function_.block(id).instructions)
+					{
+						if (const auto& instruction = function_.value(value);
+							instruction.op == opcode::CHECK_BOUNDS && instruction.index != 0) { result.push_back(value); }
+					}
+				}
+				return result;
+			}
+
+			[[nodiscard]] auto proven(const value_id check) const -> bool
+			{
+				const auto& instruction = function_.value(check);
+				const auto element = instruction.operands[0];
+
+				auto result = range_in(element, instruction.block);
+
+				// the same element checked before
+				for (const auto user: uses_[element])
+				{
+					if (const auto& other = function_.value(user);
+						user == check || other.block == invalid_block || other.op != opcode::CHECK_BOUNDS || other.index == 0 || !dominates(user, check)) { continue; }
+
+					result = result.intersect({.lo = 0, .hi = static_cast<std::int64_t>(function_.value(user).index) - 1});
+				}
+
+				return result.within(instruction.index);
+			}
+
+			// The check of a loop counter executed on every iteration becomes the check of its first and last value before the loop.
+			// The function changes, the analysis is no longer valid.
+			[[nodiscard]] auto hoist(const value_id check) -> bool
+			{
+				const auto extent = function_.value(check).index;
+				const auto block = function_.value(check).block;
+				const auto counter = function_.value(check).operands[0];
+
+				const auto it = inductions_.find(counter);
+				if (it == inductions_.end()) { return false; }
+
+				const auto end = it->second.end;
+				const auto& loop = loops_[it->second.loop];
+
+				// the header also runs when the loop ends (i == end)
+				if (!dominator_tree_.dominates(it->second.body, block) || !std::ranges::all_of(loop.latches, [&](const auto latch) { return dominator_tree_.dominates(block, latch); })) { return false; }
+				// the loop is only left through its header
+				for (const auto id: loop.blocks)
+				{
+					if (id == loop.header) { continue; }
+					if (function_.value(function_.terminator(id)).op == opcode::RETURN ||
+						!std::ranges::all_of(function_.successors(id), [&](const auto successor) { return loop.contains(successor); })) { return false; }
+				}
+				// known before the loop
+				if (loop.contains(function_.value(end).block)) { return false; }
+
+				const auto header = loop.header;
+				const auto preheader = make_preheader(function_, loop).first;
+				if (preheader == invalid_block) { return false; }
+
+				const auto init = [&]
+				{
+					const auto& phi = function_.value(counter);
+					return phi.operands[static_cast<std::size_t>(std::ranges::find(phi.blocks, preheader) - phi.blocks.begin())];
+				}();
+
+				// preheader: JUMP header ==> BRANCH end > init, guard, enter
+				const auto guard = function_.create_block();
+				const auto enter = function_.create_block();
+
+				function_.erase(function_.terminator(preheader));
+				const auto runs = function_.append(preheader, {.op = opcode::GREATER, .type = type_t::BOOLEAN, .operands = {end, init}});
+				(void)function_.append(preheader, {.op = opcode::BRANCH, .type = type_t::VOID, .operands = {runs}, .blocks = {guard, enter}});
+
+				// the first and the last value of the counter, init <= i <= end - 1
+				if (!range_of(init).within(extent))
+				{
+					(void)function_.append(guard, {.op = opcode::CHECK_BOUNDS, .type = type_t::INT, .operands = {init}, .index = extent});
+				}
+				if (!range_of(end).shift(-1).within(extent))
+				{
+					const auto one = function_.append(guard, {.op = opcode::CONSTANT, .type = type_t::INT, .constant = std::int32_t{1}});
+					const auto last = function_.append(guard, {.op = opcode::SUB, .type = type_t::INT, .operands = {end, one}});
+					(void)function_.append(guard, {.op = opcode::CHECK_BOUNDS, .type = type_t::INT, .operands = {last}, .index = extent});
+				}
+				(void)function_.append(guard, {.op = opcode::JUMP, .type = type_t::VOID, .blocks = {enter}});
+				(void)function_.append(enter, {.op = opcode::JUMP, .type = type_t::VOID, .blocks = {header}});
+
+				for (const auto value: function_.block(header).instructions)
+				{
+					auto& phi = function_.value(value);
+					if (phi.op != opcode::PHI) { break; }
+					std::ranges::replace(phi.blocks, preheader, enter);
+				}
+				function_.recompute_predecessors();
+
+				function_.replace_all_uses(check, counter);
+				function_.erase(check);
+				return true;
+			}
+		};
+
+		class BoundsCheckElimination final : public Pass
+		{
+		public:
+			[[nodiscard]] auto name() const noexcept -> symbol_name_view override { return "bounds-check-elimination"; }
+
+			auto run([[maybe_unused]] Module& module, Function& function) -> bool override
+			{
+				bool changed = false;
+
+				// one loop at a time, the control flow changes
+				for (bool again = true; again;)
+				{
+					again = false;
+
+					BoundsAnalysis analysis{function};
+					const auto checks = analysis.checks();
+
+					for (const auto check: checks)
+					{
+						if (!analysis.proven(check)) { continue; }
+
+						function.replace_all_uses(check, function.value(check).operands[0]);
+						function.erase(check);
+						changed = true;
+					}
+
+					for (const auto check: checks)
+					{
+						if (function.value(check).block == invalid_block || !analysis.hoist(check)) { continue; }
+
+						changed = true;
+						again = true;
+						break;
+					}
+				}
+
+				return changed;
+			}
+		};
+	}
+
+	auto make_bounds_check_elimination() -> pass_type { return memory::make_shared<BoundsCheckElimination>(); }
+}
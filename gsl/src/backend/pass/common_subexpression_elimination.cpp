@@ -0,0 +1,206 @@
+#include <gsl/backend/pass.hpp>
+
+#include <bit>
+
+namespace gal::gsl::ir
+{
+	namespace
+	{
+		struct expression
+		{
+			opcode op;
+			type_t type;
+			value_id lhs;
+			value_id rhs;
+			// CONSTANT, compared bit by bit (0.0 and -0.0 are different constants)
+			std::size_t constant_index;
+			std::uint64_t constant_bits;
+
+			[[nodiscard]] constexpr auto operator==(const expression&) const noexcept -> bool = default;
+		};
+
+		struct expression_hasher
+		{
+			[[nodiscard]] constexpr auto operator()(const expression& e) const noexcept -> std::size_t
+			{
+				auto hash = static_cast<std::size_t>(e.op) * 31 + static_cast<std::size_t>(e.type);
+				hash = hash * 1099511628211ull ^ e.lhs;
+				hash = hash * 1099511628211ull ^ e.rhs;
+				hash = hash * 1099511628211ull ^ e.constant_index;
+				hash = hash * 1099511628211ull ^ e.constant_bits;
+				return hash;
+			}
+		};
+
+		[[nodiscard]] auto make_expression(const Instruction& instruction) noexcept -> expression
+		{
+			expression e{
+					.op = instruction.op,
+					.type = instruction.type,
+					.lhs = instruction.operands.empty() ? invalid_value : instruction.operands[0],
+					.rhs = instruction.operands.size() < 2 ? invalid_value : instruction.operands[1],
+					.constant_index = instruction.constant.index(),
+					.constant_bits = 0};
+
+			if (is_commutative(e.op) && e.rhs < e.lhs) { std::swap(e.lhs, e.rhs); }
+
+			std::visit(
+					[&e]<typename T>(const T& value)
+					{
+						if constexpr (std::is_same_v<T, bool>) { e.constant_bits = value; }
+						else if constexpr (std::is_same_v<T, std::int32_t>) { e.constant_bits = std::bit_cast<std::uint32_t>(value); }
+						else if constexpr (std::is_same_v<T, float>) { e.constant_bits = std::bit_cast<std::uint32_t>(value); }
+						else if constexpr (std::is_same_v<T, double>) { e.constant_bits = std::bit_cast<std::uint64_t>(value); }
+					},
+					instruction.constant);
+
+			return e;
+		}
+
+		// the last known value of a global/field inside one block
+		struct memory_state
+		{
+			container::unordered_map<symbol_name, value_id, utility::string_hasher<symbol_name>> globals;
+			// (object, field index) ==> value
+			container::unordered_map<std::uint64_t, value_id> fields;
+
+			[[nodiscard]] constexpr static auto key(const value_id object, const std::uint32_t index) noexcept -> std::uint64_t { return (static_cast<std::uint64_t>(object) << 32) | index; }
+
+			auto forget_field(const std::uint32_t index) -> void
+			{
+				// another object may be the same record
+				std::erase_if(fields, [index](const auto& pair) { return static_cast<std::uint32_t>(pair.first) == index; });
+			}
+
+			auto clear() -> void
+			{
+				globals.clear();
+				fields.clear();
+			}
+		};
+
+		class CommonSubexpressionElimination final : public Pass
+		{
+		public:
+			[[nodiscard]] auto name() const noexcept -> symbol_name_view override { return "common-subexpression-elimination"; }
+
+			auto run([[maybe_unused]] Module& module, Function& function) -> bool override
+			{
+				const DominatorTree dominator_tree{function};
+
+				container::vector<value_id> forward(function.value_count(), invalid_value);
+				container::vector<value_id> forwarded;
+
+				const auto resolve = [&forward](value_id value)
+				{
+					while (forward[value] != invalid_value) { value = forward[value]; }
+					return value;
+				};
+
+				// the expressions available in the current block, i.e. computed in a dominator
+				container::unordered_map<expression, value_id, expression_hasher> available;
+				memory_state memory;
+
+				// (block, leaving?) walk the dominator tree, scopes are popped when leaving a block
+				container::vector<std::pair<block_id, bool>> stack{{Function::entry(), false}};
+				container::vector<container::vector<expression>> scopes(function.block_count());
+
+				while (!stack.empty())
+				{
+					const auto [id, leaving] = stack.back();
+					stack.pop_back();
+
+					if (leaving)
+					{
+						for (const auto& e: scopes[id]) { available.erase(e); }
+						continue;
+					}
+
+					stack.emplace_back(id, true);
+					for (const auto child: dominator_tree.children(id)) { stack.emplace_back(child, false); }
+
+					memory.clear();
+					for (const auto value: function.block(id).instructions)
+					{
+						auto& instruction = function.value(value);
+						for (auto& operand: instruction.operands) { operand = resolve(operand); }
+
+						const auto replace = [&](const value_id with)
+						{
+							forward[value] = with;
+							forwarded.push_back(value);
+						};
+
+						switch (instruction.op)
+						{
+							case opcode::LOAD_GLOBAL:
+							{
+								if (const auto it = memory.globals.find(instruction.symbol);
+									it != memory.globals.end()) { replace(it->second); }
+								else { memory.globals.emplace(instruction.symbol, value); }
+								break;
+							}
+							case opcode::STORE_GLOBAL:
+							{
+								memory.globals.insert_or_assign(instruction.symbol, instruction.operands[0]);
+								break;
+							}
+							case opcode::LOAD_FIELD:
+							{
+								const auto key = memory_state::key(instruction.operands[0], instruction.index);
+								if (const auto it = memory.fields.find(key);
+									it != memory.fields.end()) { replace(it->second); }
+								else { memory.fields.emplace(key, value); }
+								break;
+							}
+							case opcode::STORE_FIELD:
+							{
+								memory.forget_field(instruction.index);
+								memory.fields.emplace(memory_state::key(instruction.operands[0], instruction.index), instruction.operands[1]);
+								break;
+							}
+							case opcode::STORE_ELEMENT:
+							{
+								// the fields of a record element loaded before may be overwritten
+								memory.fields.clear();
+								break;
+							}
+							case opcode::CALL:
+							{
+								// the callee may write anything
+								memory.clear();
+								break;
+							}
+							default:
+							{
+								if (!is_pure(instruction.op)) { break; }
+
+								const auto e = make_expression(instruction);
+								if (const auto [it, inserted] = available.try_emplace(e, value);
+									inserted) { scopes[id].push_back(e); }
+								else { replace(it->second); }
+								break;
+							}
+						}
+					}
+				}
+
+				if (forwarded.empty()) { return false; }
+
+				for (const auto value: forwarded) { function.erase(value); }
+				for (block_id id = 0; id < function.block_count(); ++id)
+				{
+					if (!function.block(id).alive) { continue; }
+					for (const auto value: function.block(id).instructions)
+					{
+						for (auto& operand: function.value(value).operands) { operand = resolve(operand); }
+					}
+				}
+
+				return true;
+			}
+		};
+	}
+
+	auto make_common_subexpression_elimination() -> pass_type { return memory::make_shared<CommonSubexpressionElimination>(); }
+}
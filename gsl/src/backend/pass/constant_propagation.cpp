@@ -0,0 +1,312 @@
+#include <gsl/backend/pass.hpp>
+
+#include <cmath>
+#include <limits>
+
+namespace gal::gsl::ir
+{
+	namespace
+	{
+		template<typename T>
+		[[nodiscard]] constexpr auto fold_arithmetic(const opcode op, const T lhs, const T rhs) noexcept -> constant_type
+		{
+			if constexpr (std::is_same_v<T, std::int32_t>)
+			{
+				// wrap around instead of overflowing
+				using unsigned_type = std::make_unsigned_t<T>;
+				const auto l = static_cast<unsigned_type>(lhs);
+				const auto r = static_cast<unsigned_type>(rhs);
+
+				switch (op)
+				{
+					case opcode::ADD: { return static_cast<T>(l + r); }
+					case opcode::SUB: { return static_cast<T>(l - r); }
+					case opcode::MUL: { return static_cast<T>(l * r); }
+					case opcode::DIV:
+					case opcode::REM:
+					{
+						// left to the runtime
+						if (rhs == 0 || (lhs == std::numeric_limits<T>::min() && rhs == -1)) { return {}; }
+						return op == opcode::DIV ? lhs / rhs : lhs % rhs;
+					}
+					default: { return {}; }
+				}
+			}
+			else
+			{
+				switch (op)
+				{
+					case opcode::ADD: { return lhs + rhs; }
+					case opcode::SUB: { return lhs - rhs; }
+					case opcode::MUL: { return lhs * rhs; }
+					case opcode::DIV: { return lhs / rhs; }
+					case opcode::REM: { return std::fmod(lhs, rhs); }
+					default: { return {}; }
+				}
+			}
+		}
+
+		[[nodiscard]] auto fold(const opcode op, const constant_type& lhs, const constant_type& rhs) noexcept -> constant_type
+		{
+			if (lhs.index() != rhs.index()) { return {}; }
+
+			return std::visit(
+					[op, &rhs]<typename T>(const T& l) -> constant_type
+					{
+						if constexpr (std::is_same_v<T, std::monostate>) { return {}; }
+						else
+						{
+							const auto r = std::get<T>(rhs);
+
+							switch (op)
+							{
+								case opcode::EQUAL: { return l == r; }
+								case opcode::NOT_EQUAL: { return l != r; }
+								case opcode::LESS: { return l < r; }
+								case opcode::LESS_EQUAL: { return l <= r; }
+								case opcode::GREATER: { return l > r; }
+								case opcode::GREATER_EQUAL: { return l >= r; }
+								default: { break; }
+							}
+
+							if constexpr (std::is_same_v<T, bool>)
+							{
+								if (op == opcode::AND) { return l && r; }
+								if (op == opcode::OR) { return l || r; }
+								return {};
+							}
+							else { return fold_arithmetic(op, l, r); }
+						}
+					},
+					lhs);
+		}
+
+		[[nodiscard]] auto fold(const opcode op, const constant_type& operand) noexcept -> constant_type
+		{
+			return std::visit(
+					[op]<typename T>(const T& value) -> constant_type
+					{
+						if constexpr (std::is_same_v<T, bool>) { if (op == opcode::NOT) { return !value; } }
+						else if constexpr (std::is_same_v<T, std::int32_t>) { if (op == opcode::NEG) { return static_cast<T>(0u - static_cast<std::uint32_t>(value)); } }
+						else if constexpr (!std::is_same_v<T, std::monostate>) { if (op == opcode::NEG) { return -value; } }
+						return {};
+					},
+					operand);
+		}
+
+		// widening only, see check_types
+		[[nodiscard]] auto fold_convert(const constant_type& operand, const type_t type) noexcept -> constant_type
+		{
+			return std::visit(
+					[type]<typename T>(const T& value) -> constant_type
+					{
+						if constexpr (std::is_same_v<T, std::int32_t> || std::is_same_v<T, float>)
+						{
+							if (type == type_t::DOUBLE) { return static_cast<double>(value); }
+							if constexpr (std::is_same_v<T, std::int32_t>) { if (type == type_t::FLOAT) { return static_cast<float>(value); } }
+						}
+						return {};
+					},
+					operand);
+		}
+
+		template<typename T>
+		[[nodiscard]] auto is_constant(const Function& function, const value_id value, const T expected) noexcept -> bool
+		{
+			const auto& instruction = function.value(value);
+			if (instruction.op != opcode::CONSTANT) { return false; }
+
+			const auto* c = std::get_if<T>(&instruction.constant);
+			return c && *c == expected;
+		}
+
+		class ConstantPropagation final : public Pass
+		{
+		public:
+			[[nodiscard]] auto name() const noexcept -> symbol_name_view override { return "constant-propagation"; }
+
+			auto run([[maybe_unused]] Module& module, Function& function) -> bool override
+			{
+				// value ==> the value replacing it
+				container::vector<value_id> forward(function.value_count(), invalid_value);
+				container::vector<value_id> forwarded;
+
+				const auto resolve = [&forward](value_id value)
+				{
+					while (forward[value] != invalid_value) { value = forward[value]; }
+					return value;
+				};
+
+				bool changed = false;
+				for (bool again = true; again;)
+				{
+					again = false;
+					bool cfg_changed = false;
+
+					for (const auto id: function.reverse_post_order())
+					{
+						for (const auto value: function.block(id).instructions)
+						{
+							auto& instruction = function.value(value);
+							for (auto& operand: instruction.operands) { operand = resolve(operand); }
+
+							if (forward[value] != invalid_value) { continue; }
+
+							const auto replace = [&](const value_id with)
+							{
+								forward[value] = with;
+								forwarded.push_back(value);
+								again = true;
+							};
+
+							const auto replace_constant = [&](constant_type&& constant)
+							{
+								instruction.op = opcode::CONSTANT;
+								instruction.operands.clear();
+								instruction.constant = std::move(constant);
+								again = true;
+							};
+
+							if (is_binary(instruction.op))
+							{
+								const auto lhs = instruction.operands[0];
+								const auto rhs = instruction.operands[1];
+
+								if (function.value(lhs).op == opcode::CONSTANT && function.value(rhs).op == opcode::CONSTANT)
+								{
+									if (auto result = fold(instruction.op, function.value(lhs).constant, function.value(rhs).constant);
+										result.index() != 0) { replace_constant(std::move(result)); }
+									continue;
+								}
+
+								// algebraic identities, integer/boolean only (x + 0.0 is not x for x == -0.0)
+								switch (instruction.op)
+								{
+									case opcode::ADD:
+									{
+										if (is_constant(function, rhs, std::int32_t{0})) { replace(lhs); }
+										else if (is_constant(function, lhs, std::int32_t{0})) { replace(rhs); }
+										break;
+									}
+									case opcode::SUB:
+									{
+										if (is_constant(function, rhs, std::int32_t{0})) { replace(lhs); }
+										break;
+									}
+									case opcode::MUL:
+									case opcode::DIV:
+									{
+										if (is_constant(function, rhs, std::int32_t{1})) { replace(lhs); }
+										else if (instruction.op == opcode::MUL && is_constant(function, lhs, std::int32_t{1})) { replace(rhs); }
+										break;
+									}
+									case opcode::AND:
+									{
+										if (is_constant(function, rhs, true)) { replace(lhs); }
+										else if (is_constant(function, lhs, true)) { replace(rhs); }
+										else if (is_constant(function, rhs, false)) { replace(rhs); }
+										else if (is_constant(function, lhs, false)) { replace(lhs); }
+										break;
+									}
+									case opcode::OR:
+									{
+										if (is_constant(function, rhs, false)) { replace(lhs); }
+										else if (is_constant(function, lhs, false)) { replace(rhs); }
+										else if (is_constant(function, rhs, true)) { replace(rhs); }
+										else if (is_constant(function, lhs, true)) { replace(lhs); }
+										break;
+									}
+									default: { break; }
+								}
+							}
+							else if (is_unary(instruction.op))
+							{
+								if (const auto& operand = function.value(instruction.operands[0]);
+									operand.op == opcode::CONSTANT)
+								{
+									if (auto result = fold(instruction.op, operand.constant);
+										result.index() != 0) { replace_constant(std::move(result)); }
+								}
+							}
+							else if (instruction.op == opcode::CONVERT)
+							{
+								if (const auto& operand = function.value(instruction.operands[0]);
+									operand.op == opcode::CONSTANT)
+								{
+									if (auto result = fold_convert(operand.constant, instruction.type);
+										result.index() != 0) { replace_constant(std::move(result)); }
+								}
+							}
+							else if (instruction.op == opcode::PHI)
+							{
+								// every incoming value is the same (or the phi itself)
+								auto unique = invalid_value;
+								bool trivial = true;
+								for (const auto operand: instruction.operands)
+								{
+									if (operand == value || operand == unique) { continue; }
+									if (unique != invalid_value)
+									{
+										trivial = false;
+										break;
+									}
+									unique = operand;
+								}
+
+								if (trivial && unique != invalid_value) { replace(unique); }
+							}
+							else if (instruction.op == opcode::BRANCH)
+							{
+								const auto& condition = function.value(instruction.operands[0]);
+								if (condition.op != opcode::CONSTANT) { continue; }
+
+								const auto* c = std::get_if<bool>(&condition.constant);
+								if (!c) { continue; }
+
+								const auto taken = instruction.blocks[*c ? 0 : 1];
+								const auto not_taken = instruction.blocks[*c ? 1 : 0];
+
+								instruction.op = opcode::JUMP;
+								instruction.operands.clear();
+								instruction.blocks = {taken};
+
+								if (taken != not_taken) { function.remove_incoming(not_taken, id); }
+
+								cfg_changed = true;
+								again = true;
+							}
+						}
+					}
+
+					if (cfg_changed)
+					{
+						function.recompute_predecessors();
+						(void)function.remove_unreachable_blocks();
+					}
+					changed |= again;
+				}
+
+				// the forwarded values may have been removed with their (unreachable) block already
+				for (const auto value: forwarded)
+				{
+					if (function.value(value).block != invalid_block) { function.erase(value); }
+				}
+				if (!forwarded.empty())
+				{
+					for (block_id id = 0; id < function.block_count(); ++id)
+					{
+						if (!function.block(id).alive) { continue; }
+						for (const auto value: function.block(id).instructions)
+						{
+							for (auto& operand: function.value(value).operands) { operand = resolve(operand); }
+						}
+					}
+				}
+
+				return changed;
+			}
+		};
+	}
+
+	auto make_constant_propagation() -> pass_type { return memory::make_shared<ConstantPropagation>(); }
+}
@@ -0,0 +1,131 @@
+#include <gsl/backend/pass.hpp>
+
+namespace gal::gsl::ir
+{
+	namespace
+	{
+		// fold a block into its predecessor if that is the only way into it and the only way out of the predecessor
+		auto merge_blocks(Function& function) -> bool
+		{
+			bool changed = false;
+
+			for (const auto id: function.reverse_post_order())
+			{
+				if (!function.block(id).alive) { continue; }
+
+				while (true)
+				{
+					const auto t = function.terminator(id);
+					if (function.value(t).op != opcode::JUMP) { break; }
+
+					const auto next = function.value(t).blocks.front();
+					if (next == id || next == Function::entry() || function.block(next).predecessors.size() != 1) { break; }
+
+					// one predecessor ==> every phi is trivial
+					const auto instructions = std::move(function.block(next).instructions);
+					function.block(next).instructions.clear();
+					function.block(next).alive = false;
+
+					function.erase(t);
+					for (const auto value: instructions)
+					{
+						if (auto& instruction = function.value(value);
+							instruction.op == opcode::PHI)
+						{
+							const auto incoming = instruction.operands.front();
+							instruction.block = invalid_block;
+							function.replace_all_uses(value, incoming);
+						}
+						else
+						{
+							instruction.block = id;
+							function.block(id).instructions.push_back(value);
+						}
+					}
+
+					for (const auto successor: function.successors(id))
+					{
+						for (const auto phi: function.block(successor).instructions)
+						{
+							auto& instruction = function.value(phi);
+							if (instruction.op != opcode::PHI) { break; }
+							std::ranges::replace(instruction.blocks, next, id);
+						}
+					}
+
+					function.recompute_predecessors();
+					changed = true;
+				}
+			}
+
+			return changed;
+		}
+
+		class DeadCodeElimination final : public Pass
+		{
+		public:
+			[[nodiscard]] auto name() const noexcept -> symbol_name_view override { return "dead-code-elimination"; }
+
+			auto run([[maybe_unused]] Module& module, Function& function) -> bool override
+			{
+				bool changed = function.remove_unreachable_blocks();
+
+				// mark: everything observable and whatever it depends on
+				container::vector<bool> live(function.value_count(), false);
+				container::vector<value_id> worklist;
+
+				for (block_id id = 0; id < function.block_count(); ++id)
+				{
+					if (!function.block(id).alive) { continue; }
+
+					for (const auto value: function.block(id).instructions)
+					{
+						if (has_side_effect(function.value(value).op))
+						{
+							live[value] = true;
+							worklist.push_back(value);
+						}
+					}
+				}
+
+				while (!worklist.empty())
+				{
+					const auto value = worklist.back();
+					worklist.pop_back();
+
+					for (const auto operand: function.value(value).operands)
+					{
+						if (!live[operand])
+						{
+							live[operand] = true;
+							worklist.push_back(operand);
+						}
+					}
+				}
+
+				// sweep
+				for (block_id id = 0; id < function.block_count(); ++id)
+				{
+					auto& block = function.block(id);
+					if (!block.alive) { continue; }
+
+					const auto removed = std::erase_if(
+							block.instructions,
+							[&](const value_id value)
+							{
+								if (live[value]) { return false; }
+								function.value(value).block = invalid_block;
+								return true;
+							});
+					changed |= removed != 0;
+				}
+
+				changed |= merge_blocks(function);
+
+				return changed;
+			}
+		};
+	}
+
+	auto make_dead_code_elimination() -> pass_type { return memory::make_shared<DeadCodeElimination>(); }
+}
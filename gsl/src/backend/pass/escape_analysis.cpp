@@ -0,0 +1,280 @@
+#include <gsl/backend/pass.hpp>
+
+namespace gal::gsl::ir
+{
+	namespace
+	{
+		enum class escape_state
+		{
+			// only its fields are read and written ==> every field becomes an SSA value
+			SCALAR_REPLACEABLE,
+			// compared by identity, never outlives the call ==> frame
+			LOCAL,
+			// stored somewhere, passed to a call, returned, merged by a phi... ==> heap
+			ESCAPED,
+		};
+
+		// The record and the interior pointers into it (a nested record is stored inline, loading it yields its address) are followed:
+		// the record only stays in the frame if none of them outlives the call.
+		[[nodiscard]] auto classify(const Function& function, const value_id object, const container::vector<container::vector<value_id>>& uses) -> escape_state
+		{
+			auto state = escape_state::SCALAR_REPLACEABLE;
+
+			// the record or an interior pointer, its structure (nullptr if unknown)
+			container::vector<std::pair<value_id, const ast::Structure*>> aliases{{object, function.value(object).structure}};
+			while (!aliases.empty())
+			{
+				const auto [alias, structure] = aliases.back();
+				aliases.pop_back();
+
+				for (const auto user: uses[alias])
+				{
+					const auto& instruction = function.value(user);
+					switch (instruction.op)
+					{
+						case opcode::LOAD_FIELD:
+						case opcode::LOAD_ELEMENT:
+						{
+							// the element is only known at runtime, the array stays in memory
+							if (instruction.op == opcode::LOAD_ELEMENT) { state = escape_state::LOCAL; }
+
+							const ast::TypeDeclaration* field = nullptr;
+							if (structure && instruction.index < structure->get_fields().size()) { field = structure->get_fields()[instruction.index].variable.type.get(); }
+
+							// an interior pointer
+							if (!field || field->type() == type_t::STRUCTURE)
+							{
+								state = escape_state::LOCAL;
+								aliases.emplace_back(user, field ? field->owner() : nullptr);
+							}
+							break;
+						}
+						case opcode::STORE_FIELD:
+						{
+							// the record itself is the stored value
+							if (instruction.operands[1] == alias) { return escape_state::ESCAPED; }
+							break;
+						}
+						case opcode::STORE_ELEMENT:
+						{
+							if (instruction.operands[2] == alias) { return escape_state::ESCAPED; }
+							state = escape_state::LOCAL;
+							break;
+						}
+						case opcode::EQUAL:
+						case opcode::NOT_EQUAL:
+						{
+							state = escape_state::LOCAL;
+							break;
+						}
+						default: { return escape_state::ESCAPED; }
+					}
+				}
+			}
+
+			return state;
+		}
+
+		// the zero of a scalar field, std::monostate if the field cannot live in a register
+		[[nodiscard]] auto zero_of(const ast::TypeDeclaration& type) noexcept -> constant_type
+		{
+			if (type.is_array()) { return {}; }
+
+			switch (type.type())
+			{
+				case type_t::BOOLEAN: { return false; }
+				case type_t::INT: { return std::int32_t{0}; }
+				case type_t::FLOAT: { return 0.f; }
+				case type_t::DOUBLE: { return 0.; }
+				default: { return {}; }
+			}
+		}
+
+		// the dominance frontier of every block
+		[[nodiscard]] auto dominance_frontiers(const Function& function, const DominatorTree& dominator_tree) -> container::vector<container::vector<block_id>>
+		{
+			container::vector<container::vector<block_id>> frontiers(function.block_count());
+
+			for (const auto id: function.reverse_post_order())
+			{
+				const auto& predecessors = function.block(id).predecessors;
+				if (predecessors.size() < 2) { continue; }
+
+				for (const auto predecessor: predecessors)
+				{
+					if (!dominator_tree.is_reachable(predecessor)) { continue; }
+
+					for (auto runner = predecessor; runner != invalid_block && runner != dominator_tree.immediate_dominator(id); runner = dominator_tree.immediate_dominator(runner))
+					{
+						if (auto& frontier = frontiers[runner];
+							std::ranges::find(frontier, id) == frontier.end()) { frontier.push_back(id); }
+					}
+				}
+			}
+
+			return frontiers;
+		}
+
+		// Replace every field of a non-escaping record by SSA values (promote the fields to registers).
+		// Phis are only needed in blocks strictly dominated by the allocation, every use of the record is there.
+		auto scalar_replace(
+				Function& function,
+				const DominatorTree& dominator_tree,
+				const container::vector<container::vector<block_id>>& frontiers,
+				const value_id object,
+				const std::span<const value_id> users
+				) -> void
+		{
+			const auto& fields = function.value(object).structure->get_fields();
+			const auto home = function.value(object).block;
+
+			// the initial value of each field, placed right after the allocation
+			container::vector<value_id> zeros(fields.size(), invalid_value);
+			{
+				const auto& instructions = function.block(home).instructions;
+				auto position = static_cast<std::size_t>(std::ranges::find(instructions, object) - instructions.begin()) + 1;
+				for (std::size_t f = 0; f < fields.size(); ++f)
+				{
+					const auto& type = *fields[f].variable.type;
+					zeros[f] = function.insert(home, position++, {.op = opcode::CONSTANT, .type = type.type(), .constant = zero_of(type)});
+				}
+			}
+
+			// (block, field) ==> phi
+			container::unordered_map<std::uint64_t, value_id> phis;
+			const auto phi_key = [](const block_id block, const std::size_t field) { return (static_cast<std::uint64_t>(block) << 32) | field; };
+
+			for (std::size_t f = 0; f < fields.size(); ++f)
+			{
+				container::vector<block_id> worklist;
+				for (const auto user: users)
+				{
+					if (const auto& instruction = function.value(user);
+						instruction.op == opcode::STORE_FIELD && instruction.index == f) { worklist.push_back(instruction.block); }
+				}
+
+				// iterated dominance frontier
+				while (!worklist.empty())
+				{
+					const auto block = worklist.back();
+					worklist.pop_back();
+
+					for (const auto frontier: frontiers[block])
+					{
+						if (frontier == home || !dominator_tree.dominates(home, frontier)) { continue; }
+						if (phis.contains(phi_key(frontier, f))) { continue; }
+
+						const auto phi = function.insert(frontier, 0, {.op = opcode::PHI, .type = fields[f].variable.type->type()});
+						phis.emplace(phi_key(frontier, f), phi);
+						worklist.push_back(frontier);
+					}
+				}
+			}
+
+			// rename: walk the dominator tree below the allocation with the current value of every field
+			container::vector<bool> is_user(function.value_count(), false);
+			for (const auto user: users) { is_user[user] = true; }
+
+			struct frame
+			{
+				block_id block;
+				container::vector<value_id> current;
+			};
+
+			container::vector<frame> stack{{.block = home, .current = zeros}};
+			while (!stack.empty())
+			{
+				auto [block, current] = std::move(stack.back());
+				stack.pop_back();
+
+				for (std::size_t f = 0; f < fields.size(); ++f)
+				{
+					if (const auto it = phis.find(phi_key(block, f));
+						it != phis.end()) { current[f] = it->second; }
+				}
+
+				const auto instructions = function.block(block).instructions;
+				for (const auto value: instructions)
+				{
+					if (value >= is_user.size() || !is_user[value]) { continue; }
+
+					if (const auto& instruction = function.value(value);
+						instruction.op == opcode::LOAD_FIELD) { function.replace_all_uses(value, current[instruction.index]); }
+					else if (instruction.op == opcode::STORE_FIELD) { current[instruction.index] = instruction.operands[1]; }
+					else { continue; }
+
+					function.erase(value);
+				}
+
+				for (const auto successor: function.successors(block))
+				{
+					for (std::size_t f = 0; f < fields.size(); ++f)
+					{
+						if (const auto it = phis.find(phi_key(successor, f));
+							it != phis.end())
+						{
+							auto& phi = function.value(it->second);
+							phi.operands.push_back(current[f]);
+							phi.blocks.push_back(block);
+						}
+					}
+				}
+
+				for (const auto child: dominator_tree.children(block)) { stack.push_back({.block = child, .current = current}); }
+			}
+
+			function.erase(object);
+		}
+
+		class EscapeAnalysis final : public Pass
+		{
+		public:
+			[[nodiscard]] auto name() const noexcept -> symbol_name_view override { return "escape-analysis"; }
+
+			auto run([[maybe_unused]] Module& module, Function& function) -> bool override
+			{
+				container::vector<value_id> allocations;
+				for (const auto id: function.reverse_post_order())
+				{
+					for (const auto value: function.block(id).instructions) { if (function.value(value).op == opcode::ALLOC) { allocations.push_back(value); } }
+				}
+				if (allocations.empty()) { return false; }
+
+				const auto uses = function.compute_uses();
+				const DominatorTree dominator_tree{function};
+				const auto frontiers = dominance_frontiers(function, dominator_tree);
+
+				bool changed = false;
+				for (const auto object: allocations)
+				{
+					const auto& users = uses[object];
+					const auto state = classify(function, object, uses);
+					if (state == escape_state::ESCAPED) { continue; }
+
+					const auto& structure = *function.value(object).structure;
+					const auto& fields = structure.get_fields();
+
+					if (state == escape_state::SCALAR_REPLACEABLE &&
+						std::ranges::all_of(fields, [](const auto& field) { return zero_of(*field.variable.type).index() != 0; }))
+					{
+						scalar_replace(function, dominator_tree, frontiers, object, users);
+					}
+					// the collector does not scan the frame, the only reference to a string there would not keep it alive
+					else if (structure.contains_pointer()) { continue; }
+					else
+					{
+						auto& instruction = function.value(object);
+						instruction.op = opcode::FRAME_ALLOC;
+						instruction.index = function.allocate_frame(structure.get_size(), structure.get_alignment());
+					}
+
+					changed = true;
+				}
+
+				return changed;
+			}
+		};
+	}
+
+	auto make_escape_analysis() -> pass_type { return memory::make_shared<EscapeAnalysis>(); }
+}
@@ -0,0 +1,145 @@
+#include <gsl/backend/pass.hpp>
+
+namespace gal::gsl::ir
+{
+	namespace
+	{
+		// replace the call with a copy of the callee's body
+		auto inline_call(Function& function, const value_id call, const Function& callee) -> void
+		{
+			const auto call_block = function.value(call).block;
+			const auto arguments = function.value(call).operands;
+			const auto type = function.value(call).type;
+
+			// split the block after the call, the continuation takes over its successors
+			const auto continuation = function.create_block();
+			{
+				auto& instructions = function.block(call_block).instructions;
+				const auto position = std::ranges::find(instructions, call) - instructions.begin();
+
+				auto& tail = function.block(continuation).instructions;
+				tail.assign(instructions.begin() + position + 1, instructions.end());
+				instructions.erase(instructions.begin() + position + 1, instructions.end());
+
+				for (const auto value: tail) { function.value(value).block = continuation; }
+			}
+			for (const auto successor: function.successors(continuation))
+			{
+				for (const auto phi: function.block(successor).instructions)
+				{
+					auto& instruction = function.value(phi);
+					if (instruction.op != opcode::PHI) { break; }
+					std::ranges::replace(instruction.blocks, call_block, continuation);
+				}
+			}
+
+			// copy the blocks first, then the instructions, then fix their operands (phis may refer to values defined later)
+			container::vector<block_id> block_map(callee.block_count(), invalid_block);
+			for (block_id id = 0; id < callee.block_count(); ++id) { if (callee.block(id).alive) { block_map[id] = function.create_block(); } }
+
+			container::vector<value_id> value_map(callee.value_count(), invalid_value);
+			container::vector<std::pair<value_id, value_id>> copied;
+			// callee's value, the block returning it
+			container::vector<std::pair<value_id, block_id>> returns;
+
+			for (block_id id = 0; id < callee.block_count(); ++id)
+			{
+				if (!callee.block(id).alive) { continue; }
+
+				for (const auto value: callee.block(id).instructions)
+				{
+					const auto& instruction = callee.value(value);
+
+					if (instruction.op == opcode::ARGUMENT)
+					{
+						value_map[value] = arguments[instruction.index];
+						continue;
+					}
+
+					if (instruction.op == opcode::RETURN)
+					{
+						if (!instruction.operands.empty()) { returns.emplace_back(instruction.operands.front(), block_map[id]); }
+						(void)function.append(block_map[id], {.op = opcode::JUMP, .type = type_t::VOID, .blocks = {continuation}});
+						continue;
+					}
+
+					auto copy = instruction;
+					// the record now lives in the caller's frame
+					if (copy.op == opcode::FRAME_ALLOC) { copy.index = function.allocate_frame(copy.structure->get_size(), copy.structure->get_alignment()); }
+					value_map[value] = function.append(block_map[id], std::move(copy));
+					copied.emplace_back(value, value_map[value]);
+				}
+			}
+
+			for (const auto& [from, to]: copied)
+			{
+				auto& instruction = function.value(to);
+				for (auto& operand: instruction.operands) { operand = value_map[operand]; }
+				for (auto& block: instruction.blocks) { block = block_map[block]; }
+			}
+
+			// the result
+			auto result = invalid_value;
+			if (returns.size() == 1) { result = value_map[returns.front().first]; }
+			else if (returns.size() > 1)
+			{
+				Instruction phi{.op = opcode::PHI, .type = type};
+				for (const auto& [value, block]: returns)
+				{
+					phi.operands.push_back(value_map[value]);
+					phi.blocks.push_back(block);
+				}
+				result = function.insert(continuation, 0, std::move(phi));
+			}
+
+			if (result != invalid_value) { function.replace_all_uses(call, result); }
+
+			function.erase(call);
+			(void)function.append(call_block, {.op = opcode::JUMP, .type = type_t::VOID, .blocks = {block_map[Function::entry()]}});
+			function.recompute_predecessors();
+		}
+
+		class Inline final : public Pass
+		{
+		public:
+			// stop inlining into a function once it is this big
+			constexpr static std::size_t max_caller_size = 4096;
+
+		private:
+			std::size_t threshold_;
+
+		public:
+			explicit Inline(const std::size_t threshold)
+				: threshold_{threshold} {}
+
+			[[nodiscard]] auto name() const noexcept -> symbol_name_view override { return "inline"; }
+
+			auto run(Module& module, Function& function) -> bool override
+			{
+				container::vector<value_id> calls;
+				for (const auto id: function.reverse_post_order())
+				{
+					for (const auto value: function.block(id).instructions) { if (function.value(value).op == opcode::CALL) { calls.push_back(value); } }
+				}
+
+				bool changed = false;
+				for (const auto call: calls)
+				{
+					if (function.size() > max_caller_size) { break; }
+
+					const auto callee = module.get_function(function.value(call).symbol);
+					// recursion is left as a call
+					if (!callee || callee.get() == &function) { continue; }
+					if (callee->size() > threshold_ || callee->get_arity() != function.value(call).operands.size()) { continue; }
+
+					inline_call(function, call, *callee);
+					changed = true;
+				}
+
+				return changed;
+			}
+		};
+	}
+
+	auto make_inline(const std::size_t threshold) -> pass_type { return memory::make_shared<Inline>(threshold); }
+}
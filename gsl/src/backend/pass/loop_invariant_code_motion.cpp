@@ -0,0 +1,104 @@
+#include <gsl/backend/pass.hpp>
+
+namespace gal::gsl::ir
+{
+	namespace
+	{
+		// executing it when the loop would not have is harmless
+		[[nodiscard]] auto is_speculatable(const Function& function, const Instruction& instruction) noexcept -> bool
+		{
+			if (!may_trap(instruction.op)) { return true; }
+
+			// x / c and x % c only, c != 0 (and c != -1 for int, INT_MIN / -1 overflows)
+			const auto& divisor = function.value(instruction.operands[1]);
+			if (divisor.op != opcode::CONSTANT) { return false; }
+
+			return std::visit(
+					[]<typename T>(const T& value) -> bool
+					{
+						if constexpr (std::is_same_v<T, std::int32_t>) { return value != 0 && value != -1; }
+						else if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) { return true; }
+						else { return false; }
+					},
+					divisor.constant);
+		}
+
+		class LoopInvariantCodeMotion final : public Pass
+		{
+		public:
+			[[nodiscard]] auto name() const noexcept -> symbol_name_view override { return "loop-invariant-code-motion"; }
+
+			auto run([[maybe_unused]] Module& module, Function& function) -> bool override
+			{
+				const DominatorTree dominator_tree{function};
+				auto loops = find_loops(function, dominator_tree);
+
+				bool changed = false;
+				for (std::size_t l = 0; l < loops.size(); ++l)
+				{
+					const auto& loop = loops[l];
+
+					const auto [preheader, created] = make_preheader(function, loop);
+					if (preheader == invalid_block) { continue; }
+
+					// a new preheader belongs to every loop containing this one
+					if (created)
+					{
+						for (std::size_t outer = l + 1; outer < loops.size(); ++outer)
+						{
+							if (loops[outer].contains(loop.header)) { loops[outer].blocks.push_back(preheader); }
+						}
+					}
+
+					// what the loop may write
+					bool has_call = false;
+					container::vector<symbol_name_view> stored_globals;
+					for (const auto id: loop.blocks)
+					{
+						for (const auto value: function.block(id).instructions)
+						{
+							const auto& instruction = function.value(value);
+							if (instruction.op == opcode::CALL) { has_call = true; }
+							else if (instruction.op == opcode::STORE_GLOBAL) { stored_globals.emplace_back(instruction.symbol); }
+						}
+					}
+
+					const auto is_invariant = [&](const value_id value)
+					{
+						const auto& instruction = function.value(value);
+
+						if (instruction.op == opcode::LOAD_GLOBAL)
+						{
+							if (has_call || std::ranges::find(stored_globals, symbol_name_view{instruction.symbol}) != stored_globals.end()) { return false; }
+						}
+						else if (!is_pure(instruction.op) || !is_speculatable(function, instruction)) { return false; }
+
+						return std::ranges::none_of(instruction.operands, [&](const auto operand) { return loop.contains(function.value(operand).block); });
+					};
+
+					// hoisting one instruction may make its users invariant
+					for (bool again = true; again;)
+					{
+						again = false;
+						for (const auto id: loop.blocks)
+						{
+							const auto instructions = function.block(id).instructions;
+							for (const auto value: instructions)
+							{
+								if (!is_invariant(value)) { continue; }
+
+								function.move_before_terminator(value, preheader);
+								again = true;
+								changed = true;
+							}
+						}
+					}
+				}
+
+				return changed;
+			}
+		};
+	}
+
+	auto make_loop_invariant_code_motion() -> pass_type { return memory::make_shared<LoopInvariantCodeMotion>(); }
+}
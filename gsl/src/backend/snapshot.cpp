@@ -0,0 +1,414 @@
+#include <gsl/backend/snapshot.hpp>
+#include <gsl/type/string.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace gal::gsl::ast
+{
+	namespace
+	{
+		// header ==> payload
+		// payload: module name, imports, interned strings, structures (a structure after the structures of its fields), globals, functions
+		// structure: name, layout, size, alignment, fields (name, type, offset), the layout is restored as is (a host type keeps its own)
+		// type: kind, [imported, structure name], dimensions, a structure of an imported module is only named (see structure_resolver_type)
+		constexpr char snapshot_magic[8]{'G', 'S', 'L', 'S', 'N', 'A', 'P', '\0'};
+		// bumped whenever the payload changes
+		constexpr std::uint32_t snapshot_version = 4;
+
+		struct snapshot_header
+		{
+			char magic[8];
+			std::uint32_t version;
+			// 0 ==> little endian, 1 ==> big endian
+			std::uint32_t byte_order;
+			std::uint64_t payload_size;
+			std::uint64_t checksum;
+		};
+
+		constexpr std::uint32_t native_byte_order = std::endian::native == std::endian::little ? 0 : 1;
+
+		// FNV-1a
+		[[nodiscard]] auto checksum(const std::span<const std::byte> data) noexcept -> std::uint64_t
+		{
+			std::uint64_t hash = 0xcbf2'9ce4'8422'2325;
+			for (const auto byte: data)
+			{
+				hash ^= static_cast<std::uint64_t>(byte);
+				hash *= 0x0000'0100'0000'01b3;
+			}
+			return hash;
+		}
+
+		// a type without declaration (no return type) ==> NIL
+		constexpr auto no_type = static_cast<std::uint8_t>(TypeDeclaration::variable_type::NIL);
+
+		// declared by the module itself, not by one of its imports
+		[[nodiscard]] auto is_local(const Module& module, const Structure& structure) -> bool { return module.get_structure(structure.get_name()).get() == &structure; }
+
+		class Writer
+		{
+		private:
+			const Module& module_;
+			container::vector<std::byte> buffer_;
+
+		public:
+			// the header is written by finish
+			explicit Writer(const Module& module)
+				: module_{module},
+				buffer_(sizeof(snapshot_header)) {}
+
+			template<typename T>
+				requires std::is_trivially_copyable_v<T>
+			auto write(const T& value) -> void
+			{
+				const auto size = buffer_.size();
+				buffer_.resize(size + sizeof(T));
+				std::memcpy(buffer_.data() + size, &value, sizeof(T));
+			}
+
+			auto write(const std::string_view string) -> void
+			{
+				write(static_cast<std::uint32_t>(string.size()));
+
+				const auto size = buffer_.size();
+				buffer_.resize(size + string.size());
+				std::memcpy(buffer_.data() + size, string.data(), string.size());
+			}
+
+			auto write(const type_declaration_type& type) -> void
+			{
+				if (!type)
+				{
+					write(no_type);
+					return;
+				}
+
+				write(static_cast<std::uint8_t>(type->type()));
+				if (type->type() == TypeDeclaration::variable_type::STRUCTURE)
+				{
+					const auto& owner = *type->owner();
+					const auto local = is_local(module_, owner);
+					// an imported one is restored by name, the module must not declare another one of that name
+					if (!local && module_.has_structure(owner.get_name()))
+					{
+						std::string message{"Cannot snapshot module '"};
+						message.append(module_.get_name()).append("', it uses an imported structure '").append(owner.get_name()).append("' shadowed by its own!");
+						throw std::invalid_argument{message};
+					}
+
+					write(static_cast<std::uint8_t>(!local));
+					write(owner.get_name());
+				}
+
+				write(static_cast<std::uint32_t>(type->dimensions().size()));
+				for (const auto dimension: type->dimensions()) { write(dimension); }
+			}
+
+			[[nodiscard]] auto finish() && -> container::vector<std::byte>
+			{
+				const std::span payload{buffer_.begin() + sizeof(snapshot_header), buffer_.end()};
+
+				snapshot_header header{.magic = {}, .version = snapshot_version, .byte_order = native_byte_order, .payload_size = payload.size(), .checksum = checksum(payload)};
+				std::ranges::copy(snapshot_magic, header.magic);
+				std::memcpy(buffer_.data(), &header, sizeof(snapshot_header));
+
+				return std::move(buffer_);
+			}
+		};
+
+		// every read is bounds checked, once failed every following read returns zero/empty
+		class Reader
+		{
+		private:
+			std::span<const std::byte> data_;
+			bool failed_;
+
+			[[nodiscard]] auto take(const std::size_t size) -> const std::byte*
+			{
+				if (failed_ || data_.size() < size)
+				{
+					failed_ = true;
+					return nullptr;
+				}
+
+				const auto* result = data_.data();
+				data_ = data_.subspan(size);
+				return result;
+			}
+
+		public:
+			explicit Reader(const std::span<const std::byte> data)
+				: data_{data},
+				failed_{false} {}
+
+			[[nodiscard]] auto failed() const noexcept -> bool { return failed_; }
+
+			[[nodiscard]] auto done() const noexcept -> bool { return !failed_ && data_.empty(); }
+
+			auto fail() noexcept -> void { failed_ = true; }
+
+			template<typename T>
+				requires std::is_trivially_copyable_v<T>
+			[[nodiscard]] auto read() -> T
+			{
+				T value{};
+				if (const auto* data = take(sizeof(T))) { std::memcpy(&value, data, sizeof(T)); }
+				return value;
+			}
+
+			[[nodiscard]] auto read_string() -> std::string_view
+			{
+				const auto size = read<std::uint32_t>();
+				if (const auto* data = take(size)) { return {reinterpret_cast<const char*>(data), size}; }
+				return {};
+			}
+
+			[[nodiscard]] auto read_type(const Module& module, const structure_resolver_type& resolver) -> type_declaration_type
+			{
+				const auto type = read<std::uint8_t>();
+				if (type == no_type) { return nullptr; }
+				if (type > static_cast<std::uint8_t>(TypeDeclaration::variable_type::STRUCTURE))
+				{
+					fail();
+					return nullptr;
+				}
+
+				Structure* owner = nullptr;
+				if (static_cast<TypeDeclaration::variable_type>(type) == TypeDeclaration::variable_type::STRUCTURE)
+				{
+					const auto imported = read<std::uint8_t>();
+					const auto name = read_string();
+					// a local one is always restored before its users
+					if (imported == 0) { owner = module.get_structure(name).get(); }
+					else if (imported == 1 && resolver) { owner = resolver(module, name).get(); }
+
+					if (!owner)
+					{
+						fail();
+						return nullptr;
+					}
+				}
+
+				TypeDeclaration::dimension_container_type dimensions(read<std::uint32_t>());
+				if (dimensions.size() > data_.size())
+				{
+					fail();
+					return nullptr;
+				}
+				for (auto& dimension: dimensions) { dimension = read<TypeDeclaration::dimension_type>(); }
+
+				return memory::make_shared<TypeDeclaration>(static_cast<TypeDeclaration::variable_type>(type), owner, std::move(dimensions));
+			}
+		};
+
+		// The local structures of the fields first, a structure is laid out when its fields are registered.
+		// The structures of the imported modules are not part of the snapshot, they keep their identity (see structure_resolver_type).
+		auto order_structure(
+				const Module& module,
+				const Structure& structure,
+				container::unordered_map<const Structure*, bool>& visited,
+				container::vector<const Structure*>& order
+				) -> void
+		{
+			if (!visited.emplace(&structure, true).second) { return; }
+
+			for (const auto& field: structure.get_fields())
+			{
+				if (const auto& type = field.variable.type;
+					type && type->owner() && is_local(module, *type->owner())) { order_structure(module, *type->owner(), visited, order); }
+			}
+
+			order.push_back(&structure);
+		}
+	}
+
+	auto make_snapshot(const Module& module) -> container::vector<std::byte>
+	{
+		Writer writer{module};
+
+		writer.write(module.get_name());
+
+		writer.write(static_cast<std::uint32_t>(module.get_imports().size()));
+		for (const auto& import: module.get_imports()) { writer.write(std::string_view{import}); }
+
+		const auto interned = type::String::interned_strings();
+		writer.write(static_cast<std::uint32_t>(interned.size()));
+		for (const auto string: interned) { writer.write(string); }
+
+		container::unordered_map<const Structure*, bool> visited{};
+		container::vector<const Structure*> structures{};
+		for (const auto& structure: module.get_structures() | std::views::values) { order_structure(module, *structure, visited, structures); }
+
+		writer.write(static_cast<std::uint32_t>(structures.size()));
+		for (const auto* structure: structures)
+		{
+			writer.write(structure->get_name());
+			writer.write(static_cast<std::uint8_t>(structure->get_layout()));
+			writer.write(static_cast<std::uint64_t>(structure->get_size()));
+			writer.write(static_cast<std::uint64_t>(structure->get_alignment()));
+			writer.write(static_cast<std::uint32_t>(structure->get_fields().size()));
+			for (const auto& [variable, index, offset]: structure->get_fields())
+			{
+				writer.write(std::string_view{variable.name});
+				writer.write(variable.type);
+				writer.write(static_cast<std::uint64_t>(offset));
+			}
+		}
+
+		// todo: the initial values, once expressions exist
+		writer.write(static_cast<std::uint32_t>(module.get_globals().size()));
+		for (const auto& [name, global]: module.get_globals())
+		{
+			writer.write(std::string_view{name});
+			writer.write(global->get_type());
+		}
+
+		const auto functions = std::ranges::count_if(module.get_functions() | std::views::values, [](const auto& function) { return !function->is_builtin(); });
+		writer.write(static_cast<std::uint32_t>(functions));
+		for (const auto& [name, function]: module.get_functions())
+		{
+			if (function->is_builtin()) { continue; }
+
+			writer.write(std::string_view{name});
+			writer.write(function->get_return_type());
+			writer.write(static_cast<std::uint32_t>(function->get_arguments().size()));
+			for (const auto& argument: function->get_arguments())
+			{
+				writer.write(argument->get_name());
+				writer.write(argument->get_type());
+			}
+		}
+
+		return std::move(writer).finish();
+	}
+
+	auto restore_snapshot(const std::span<const std::byte> image, const structure_resolver_type& resolver) -> module_type
+	{
+		if (image.size() < sizeof(snapshot_header)) { return nullptr; }
+
+		snapshot_header header{};
+		std::memcpy(&header, image.data(), sizeof(snapshot_header));
+
+		const auto payload = image.subspan(sizeof(snapshot_header));
+		if (!std::ranges::equal(header.magic, snapshot_magic) ||
+			header.version != snapshot_version ||
+			header.byte_order != native_byte_order ||
+			header.payload_size != payload.size() ||
+			header.checksum != checksum(payload)) { return nullptr; }
+
+		Reader reader{payload};
+
+		auto mod = memory::make_shared<Module>(reader.read_string());
+
+		for (auto count = reader.read<std::uint32_t>(); count != 0 && !reader.failed(); --count)
+		{
+			if (!mod->register_import(symbol_name{reader.read_string()})) { reader.fail(); }
+		}
+
+		for (auto count = reader.read<std::uint32_t>(); count != 0 && !reader.failed(); --count) { (void)type::String::intern(reader.read_string()); }
+
+		for (auto count = reader.read<std::uint32_t>(); count != 0 && !reader.failed(); --count)
+		{
+			const auto [inserted, structure] = mod->register_structure(reader.read_string());
+			if (!inserted) { reader.fail(); }
+
+			const auto layout = reader.read<std::uint8_t>();
+			if (layout > static_cast<std::uint8_t>(Structure::layout_type::STRUCTURE_OF_ARRAYS)) { reader.fail(); }
+			structure->set_layout(static_cast<Structure::layout_type>(layout));
+
+			const auto size = reader.read<std::uint64_t>();
+			const auto alignment = reader.read<std::uint64_t>();
+			if (!std::has_single_bit(alignment)) { reader.fail(); }
+
+			for (auto fields = reader.read<std::uint32_t>(); fields != 0 && !reader.failed(); --fields)
+			{
+				const auto name = reader.read_string();
+				const auto type = reader.read_type(*mod, resolver);
+				if (const auto offset = reader.read<std::uint64_t>();
+					reader.failed() || !structure->register_field(name, type, offset)) { reader.fail(); }
+			}
+
+			if (!reader.failed())
+			{
+				structure->reserve_layout(size, alignment);
+				// the fields must fit in the record
+				if (structure->get_size() != size) { reader.fail(); }
+			}
+		}
+
+		for (auto count = reader.read<std::uint32_t>(); count != 0 && !reader.failed(); --count)
+		{
+			const auto [inserted, global] = mod->register_global_mutable(reader.read_string());
+			if (!inserted) { reader.fail(); }
+
+			global->set_type(reader.read_type(*mod, resolver));
+		}
+
+		for (auto count = reader.read<std::uint32_t>(); count != 0 && !reader.failed(); --count)
+		{
+			const auto [inserted, function] = mod->register_function(reader.read_string());
+			if (!inserted) { reader.fail(); }
+
+			function->set_return_type(reader.read_type(*mod, resolver));
+
+			Function::arguments_container_type arguments{};
+			for (auto arity = reader.read<std::uint32_t>(); arity != 0 && !reader.failed(); --arity)
+			{
+				const auto name = reader.read_string();
+				arguments.push_back(memory::make_shared<Variable>(name, reader.read_type(*mod, resolver)));
+			}
+			function->set_arguments(std::move(arguments));
+		}
+
+		if (!reader.done()) { return nullptr; }
+		return mod;
+	}
+
+	auto save_snapshot(const Module& module, const string::string_view filename) -> bool
+	{
+		const auto image = make_snapshot(module);
+
+		const string::string path{filename};
+		auto temporary = path;
+		temporary.append(".tmp");
+
+		{
+			const std::unique_ptr<std::FILE, decltype(&std::fclose)> file{std::fopen(temporary.c_str(), "wb"), &std::fclose};
+			if (!file) { return false; }
+
+			if (std::fwrite(image.data(), 1, image.size(), file.get()) != image.size() || std::fflush(file.get()) != 0)
+			{
+				(void)std::remove(temporary.c_str());
+				return false;
+			}
+		}
+
+		return std::rename(temporary.c_str(), path.c_str()) == 0;
+	}
+
+	auto load_snapshot(const string::string_view filename, const structure_resolver_type& resolver) -> module_type
+	{
+		const string::string path{filename};
+
+		const std::unique_ptr<std::FILE, decltype(&std::fclose)> file{std::fopen(path.c_str(), "rb"), &std::fclose};
+		if (!file) { return nullptr; }
+
+		if (std::fseek(file.get(), 0, SEEK_END) != 0) { return nullptr; }
+		const auto size = std::ftell(file.get());
+		if (size < 0 || std::fseek(file.get(), 0, SEEK_SET) != 0) { return nullptr; }
+
+		// one read, the image is position independent
+		container::vector<std::byte> image(static_cast<std::size_t>(size));
+		if (std::fread(image.data(), 1, image.size(), file.get()) != image.size()) { return nullptr; }
+
+		return restore_snapshot(image, resolver);
+	}
+}
@@ -0,0 +1,201 @@
+#include <gsl/backend/superinstruction.hpp>
+
+#include <cstdio>
+#include <magic_enum.hpp>
+
+namespace gal::gsl::ir
+{
+	namespace
+	{
+		using uses_type = container::vector<container::vector<value_id>>;
+
+		[[nodiscard]] constexpr auto key_of(const std::span<const specialized_opcode> opcodes) noexcept -> std::uint64_t
+		{
+			std::uint64_t key = opcodes.size();
+			for (std::size_t i = 0; i < opcodes.size(); ++i) { key |= static_cast<std::uint64_t>(opcodes[i]) << (16 * (i + 1)); }
+			return key;
+		}
+
+		[[nodiscard]] constexpr auto pattern_of(const std::uint64_t key) noexcept -> superinstruction_pattern
+		{
+			superinstruction_pattern pattern{.opcodes = {}, .length = static_cast<std::size_t>(key & 0xffff)};
+			for (std::size_t i = 0; i < pattern.length; ++i) { pattern.opcodes[i] = static_cast<specialized_opcode>((key >> (16 * (i + 1))) & 0xffff); }
+			return pattern;
+		}
+
+		// the number of instructions (at most max_superinstruction_length) from `position` on, each result only used by the next one
+		[[nodiscard]] auto chain_length(const Function& function, const uses_type& uses, const std::span<const value_id> instructions, const std::size_t position) -> std::size_t
+		{
+			std::size_t length = 1;
+			while (length < max_superinstruction_length && position + length < instructions.size())
+			{
+				const auto value = instructions[position + length - 1];
+				const auto next = instructions[position + length];
+
+				if (uses[value].empty() || std::ranges::any_of(uses[value], [next](const auto user) { return user != next; })) { break; }
+				if (specialize(function, function.value(next)) == specialized_opcode::UNTYPED) { break; }
+
+				++length;
+			}
+			return length;
+		}
+
+		auto write_name(std::FILE* file, const specialized_opcode op) -> void
+		{
+			if (const auto name = magic_enum::enum_name(op);
+				!name.empty()) { (void)std::fwrite(name.data(), 1, name.size(), file); }
+		}
+
+		// the number of loops containing each block
+		[[nodiscard]] auto loop_depths(const Function& function) -> container::vector<std::size_t>
+		{
+			container::vector<std::size_t> depths(function.block_count(), 0);
+
+			const DominatorTree dominator_tree{function};
+			for (const auto& loop: find_loops(function, dominator_tree))
+			{
+				for (const auto block: loop.blocks) { depths[block] += 1; }
+			}
+
+			return depths;
+		}
+	}
+
+	auto OpcodeSequenceProfile::record(const Function& function, const std::uint64_t loop_weight) -> void
+	{
+		const auto uses = function.compute_uses();
+		const auto depths = loop_depths(function);
+
+		for (const auto id: function.reverse_post_order())
+		{
+			std::uint64_t weight = 1;
+			for (std::size_t i = 0; i < depths[id] && weight <= std::numeric_limits<std::uint32_t>::max(); ++i) { weight *= loop_weight; }
+
+			const auto& instructions = function.block(id).instructions;
+			instructions_ += weight * instructions.size();
+
+			std::array<specialized_opcode, max_superinstruction_length> opcodes{};
+			for (std::size_t position = 0; position < instructions.size(); ++position)
+			{
+				if (specialize(function, function.value(instructions[position])) == specialized_opcode::UNTYPED) { continue; }
+
+				const auto length = chain_length(function, uses, instructions, position);
+				for (std::size_t i = 0; i < length; ++i) { opcodes[i] = specialize(function, function.value(instructions[position + i])); }
+				// every prefix is a candidate
+				for (std::size_t i = 2; i <= length; ++i) { counts_[key_of({opcodes.data(), i})] += weight; }
+			}
+		}
+	}
+
+	auto OpcodeSequenceProfile::record(const Module& module, const std::uint64_t loop_weight) -> void
+	{
+		for (const auto& [_, function]: module.get_functions()) { record(*function, loop_weight); }
+	}
+
+	auto OpcodeSequenceProfile::sequences() const -> container::vector<entry>
+	{
+		container::vector<entry> result{};
+		result.reserve(counts_.size());
+		for (const auto& [key, count]: counts_) { result.push_back({.sequence = pattern_of(key), .count = count}); }
+
+		std::ranges::sort(
+				result,
+				[](const entry& lhs, const entry& rhs)
+				{
+					if (lhs.count != rhs.count) { return lhs.count > rhs.count; }
+					// stable across runs
+					return key_of(lhs.sequence.view()) < key_of(rhs.sequence.view());
+				});
+		return result;
+	}
+
+	auto OpcodeSequenceProfile::select(const std::size_t count) const -> container::vector<superinstruction_pattern>
+	{
+		auto entries = sequences();
+
+		const auto saved = [](const entry& e) { return e.count * (e.sequence.length - 1); };
+		std::ranges::stable_sort(entries, [saved](const entry& lhs, const entry& rhs) { return saved(lhs) > saved(rhs); });
+
+		container::vector<superinstruction_pattern> result{};
+		for (std::size_t i = 0; i < entries.size() && i < count; ++i) { result.push_back(entries[i].sequence); }
+		return result;
+	}
+
+	auto OpcodeSequenceProfile::dump(const string::string_view filename, const std::size_t table_size) const -> bool
+	{
+		auto* file = std::fopen(filename.data(), "w");
+		if (!file) { return false; }
+
+		(void)std::fprintf(file, "count\tpermille\tsequence\n");
+		for (const auto& [sequence, count]: sequences())
+		{
+			(void)std::fprintf(file, "%llu\t%llu\t", static_cast<unsigned long long>(count), static_cast<unsigned long long>(instructions_ == 0 ? 0 : count * 1000 / instructions_));
+			for (std::size_t i = 0; i < sequence.length; ++i)
+			{
+				if (i != 0) { (void)std::fputc(' ', file); }
+				write_name(file, sequence.opcodes[i]);
+			}
+			(void)std::fprintf(file, "\n");
+		}
+
+		(void)std::fprintf(file, "\n// superinstructions\n");
+		for (const auto& pattern: select(table_size))
+		{
+			(void)std::fprintf(file, "{{");
+			for (std::size_t i = 0; i < pattern.length; ++i)
+			{
+				if (i != 0) { (void)std::fputs(", ", file); }
+				write_name(file, pattern.opcodes[i]);
+			}
+			(void)std::fprintf(file, "}, %zu},\n", pattern.length);
+		}
+
+		return std::fclose(file) == 0;
+	}
+
+	auto fuse_superinstructions(const Function& function, const std::span<const superinstruction_pattern> set) -> container::vector<dispatch_block>
+	{
+		const auto uses = function.compute_uses();
+
+		container::vector<dispatch_block> result{};
+		for (const auto id: function.reverse_post_order())
+		{
+			const auto& instructions = function.block(id).instructions;
+
+			auto& block = result.emplace_back(dispatch_block{.id = id, .dispatches = {}});
+			block.dispatches.reserve(instructions.size());
+
+			std::size_t position = 0;
+			while (position < instructions.size())
+			{
+				dispatch d{.superinstruction = dispatch::no_superinstruction, .values = {instructions[position], invalid_value, invalid_value}, .length = 1};
+
+				if (const auto first = specialize(function, function.value(instructions[position]));
+					first != specialized_opcode::UNTYPED)
+				{
+					const auto length = chain_length(function, uses, instructions, position);
+
+					std::array<specialized_opcode, max_superinstruction_length> opcodes{first};
+					for (std::size_t i = 1; i < length; ++i) { opcodes[i] = specialize(function, function.value(instructions[position + i])); }
+
+					for (std::uint32_t i = 0; i < set.size(); ++i)
+					{
+						const auto& pattern = set[i];
+						if (pattern.length > length || pattern.length <= d.length) { continue; }
+						if (!std::ranges::equal(pattern.view(), std::span{opcodes.data(), pattern.length})) { continue; }
+
+						d.superinstruction = i;
+						d.length = pattern.length;
+					}
+
+					for (std::size_t i = 1; i < d.length; ++i) { d.values[i] = instructions[position + i]; }
+				}
+
+				position += d.length;
+				block.dispatches.push_back(d);
+			}
+		}
+
+		return result;
+	}
+}
@@ -0,0 +1,631 @@
+#include <gsl/backend/type_check.hpp>
+
+#include <magic_enum.hpp>
+
+#include <algorithm>
+#include <optional>
+
+namespace gal::gsl::ir
+{
+	namespace
+	{
+		// INT ==> FLOAT ==> DOUBLE, -1 if not numeric
+		[[nodiscard]] constexpr auto numeric_rank(const type_t type) noexcept -> int
+		{
+			switch (type)
+			{
+				case type_t::INT: { return 0; }
+				case type_t::FLOAT: { return 1; }
+				case type_t::DOUBLE: { return 2; }
+				default: { return -1; }
+			}
+		}
+
+		[[nodiscard]] constexpr auto is_numeric(const type_t type) noexcept -> bool { return numeric_rank(type) >= 0; }
+
+		// implicit conversions only widen
+		[[nodiscard]] constexpr auto is_convertible(const type_t from, const type_t to) noexcept -> bool
+		{
+			return from == to || (is_numeric(from) && is_numeric(to) && numeric_rank(from) < numeric_rank(to));
+		}
+
+		[[nodiscard]] constexpr auto type_of(const constant_type& constant) noexcept -> type_t
+		{
+			switch (constant.index())
+			{
+				case 1: { return type_t::BOOLEAN; }
+				case 2: { return type_t::INT; }
+				case 3: { return type_t::FLOAT; }
+				case 4: { return type_t::DOUBLE; }
+				default: { return type_t::NIL; }
+			}
+		}
+
+		// the type of each argument of the function, NIL if the argument is never used
+		[[nodiscard]] auto argument_types(const Function& function) -> container::vector<type_t>
+		{
+			container::vector<type_t> types(function.get_arity(), type_t::NIL);
+
+			for (const auto id: function.reverse_post_order())
+			{
+				for (const auto value: function.block(id).instructions)
+				{
+					if (const auto& instruction = function.value(value);
+						instruction.op == opcode::ARGUMENT) { types[instruction.index] = instruction.type; }
+				}
+			}
+
+			return types;
+		}
+
+		class TypeChecker
+		{
+		private:
+			struct inferred
+			{
+				type_t type;
+				// STRUCTURE only, nullptr if unknown
+				const ast::Structure* structure;
+			};
+
+			const Module& module_;
+			Function& function_;
+
+			// the structure of every record value
+			container::vector<const ast::Structure*> structures_;
+			// The values whose type cannot be inferred, and the values computed from them.
+			// Only the first one (the origin) is reported, it has a reason.
+			container::vector<bool> conflicts_;
+			container::unordered_map<value_id, string::string> reasons_;
+
+			type_check_result result_;
+
+			auto error(const value_id value, const std::string_view message, const opcode op) -> void
+			{
+				string::string m{message};
+				m.append(magic_enum::enum_name(op));
+				result_.errors.push_back({.value = value, .message = std::move(m)});
+			}
+
+			auto error(const value_id value, const std::string_view message) -> void { result_.errors.push_back({.value = value, .message = string::string{message}}); }
+
+			// the type of the instruction from the type of its operands, nullopt if they do not fit it (reason set)
+			[[nodiscard]] auto infer(const value_id value, string::string& reason) const -> std::optional<inferred>
+			{
+				const auto& instruction = function_.value(value);
+				const auto type_of_operand = [&](const std::size_t index) { return function_.value(instruction.operands[index]).type; };
+
+				switch (instruction.op)
+				{
+					case opcode::CONSTANT: { return inferred{.type = type_of(instruction.constant), .structure = nullptr}; }
+					case opcode::ARGUMENT:
+					case opcode::LOAD_GLOBAL:
+					case opcode::ALLOC:
+					case opcode::FRAME_ALLOC: { return inferred{.type = instruction.type, .structure = instruction.structure}; }
+					case opcode::PHI:
+					{
+						auto result = inferred{.type = type_t::NIL, .structure = nullptr};
+						for (const auto operand: instruction.operands)
+						{
+							const auto type = function_.value(operand).type;
+							if (type == type_t::NIL) { continue; }
+
+							if (result.type == type_t::NIL || is_convertible(result.type, type)) { result.type = type; }
+							else if (!is_convertible(type, result.type))
+							{
+								reason = "incompatible incoming values of PHI";
+								return std::nullopt;
+							}
+
+							if (!result.structure) { result.structure = structures_[operand]; }
+						}
+						return result;
+					}
+					case opcode::ADD:
+					case opcode::SUB:
+					case opcode::MUL:
+					case opcode::DIV:
+					case opcode::REM:
+					{
+						const auto lhs = type_of_operand(0);
+						const auto rhs = type_of_operand(1);
+						if (lhs == type_t::NIL || rhs == type_t::NIL) { return inferred{.type = type_t::NIL, .structure = nullptr}; }
+
+						if (is_numeric(lhs) && is_numeric(rhs)) { return inferred{.type = is_convertible(lhs, rhs) ? rhs : lhs, .structure = nullptr}; }
+						if (instruction.op == opcode::ADD && lhs == type_t::STRING && rhs == type_t::STRING) { return inferred{.type = type_t::STRING, .structure = nullptr}; }
+
+						reason = "invalid operand types for ";
+						reason.append(magic_enum::enum_name(instruction.op));
+						return std::nullopt;
+					}
+					case opcode::NEG:
+					{
+						const auto operand = type_of_operand(0);
+						if (operand == type_t::NIL || is_numeric(operand)) { return inferred{.type = operand, .structure = nullptr}; }
+
+						reason = "invalid operand type for NEG";
+						return std::nullopt;
+					}
+					case opcode::CONVERT:
+					{
+						const auto operand = type_of_operand(0);
+						if (operand == type_t::NIL || is_convertible(operand, instruction.type)) { return inferred{.type = instruction.type, .structure = nullptr}; }
+
+						reason = "invalid conversion";
+						return std::nullopt;
+					}
+					case opcode::EQUAL:
+					case opcode::NOT_EQUAL:
+					case opcode::LESS:
+					case opcode::LESS_EQUAL:
+					case opcode::GREATER:
+					case opcode::GREATER_EQUAL:
+					{
+						const auto lhs = type_of_operand(0);
+						const auto rhs = type_of_operand(1);
+						if (lhs == type_t::NIL || rhs == type_t::NIL) { return inferred{.type = type_t::BOOLEAN, .structure = nullptr}; }
+
+						const auto equality = instruction.op == opcode::EQUAL || instruction.op == opcode::NOT_EQUAL;
+						if ((is_numeric(lhs) && is_numeric(rhs)) || (equality && lhs == rhs && lhs != type_t::VOID)) { return inferred{.type = type_t::BOOLEAN, .structure = nullptr}; }
+
+						reason = "invalid operand types for ";
+						reason.append(magic_enum::enum_name(instruction.op));
+						return std::nullopt;
+					}
+					case opcode::AND:
+					case opcode::OR:
+					case opcode::NOT:
+					{
+						for (std::size_t i = 0; i < instruction.operands.size(); ++i)
+						{
+							if (const auto type = type_of_operand(i);
+								type != type_t::NIL && type != type_t::BOOLEAN)
+							{
+								reason = "non boolean operand for ";
+								reason.append(magic_enum::enum_name(instruction.op));
+								return std::nullopt;
+							}
+						}
+						return inferred{.type = type_t::BOOLEAN, .structure = nullptr};
+					}
+					case opcode::CHECK_BOUNDS:
+					{
+						if (const auto element = type_of_operand(0);
+							element == type_t::NIL || element == type_t::INT) { return inferred{.type = type_t::INT, .structure = nullptr}; }
+
+						reason = "non integer element index";
+						return std::nullopt;
+					}
+					case opcode::LOAD_FIELD:
+					case opcode::LOAD_ELEMENT:
+					{
+						const auto object = instruction.operands[0];
+						const auto type = function_.value(object).type;
+						if (type == type_t::NIL) { return inferred{.type = type_t::NIL, .structure = nullptr}; }
+
+						const auto* structure = structures_[object];
+						if (type != type_t::STRUCTURE || !structure)
+						{
+							reason = type != type_t::STRUCTURE ? "field of a value that is not a record" : "field of a record of unknown structure";
+							return std::nullopt;
+						}
+
+						const auto& fields = structure->get_fields();
+						if (instruction.index >= fields.size() || !fields[instruction.index].variable.type)
+						{
+							reason = "no such field";
+							return std::nullopt;
+						}
+
+						const auto& field = *fields[instruction.index].variable.type;
+						if (instruction.op == opcode::LOAD_ELEMENT)
+						{
+							if (const auto element = type_of_operand(1);
+								element != type_t::NIL && element != type_t::INT)
+							{
+								reason = "non integer element index";
+								return std::nullopt;
+							}
+							if (!field.is_array() || field.element_count() == 0)
+							{
+								reason = field.is_array() ? "element of an empty array" : "element of a field that is not an array";
+								return std::nullopt;
+							}
+						}
+						else if (field.is_array())
+						{
+							reason = "array fields are not loadable";
+							return std::nullopt;
+						}
+						return inferred{.type = field.type(), .structure = field.owner()};
+					}
+					case opcode::CALL:
+					{
+						if (const auto callee = module_.get_function(instruction.symbol)) { return inferred{.type = callee->get_return_type(), .structure = nullptr}; }
+						return inferred{.type = instruction.type, .structure = nullptr};
+					}
+					default: { return inferred{.type = type_t::VOID, .structure = nullptr}; }
+				}
+			}
+
+			// types only go up (NIL ==> a type ==> conflict), the loop ends
+			auto infer_all() -> void
+			{
+				const auto order = function_.reverse_post_order();
+
+				for (bool again = true; again;)
+				{
+					again = false;
+
+					for (const auto id: order)
+					{
+						for (const auto value: function_.block(id).instructions)
+						{
+							if (conflicts_[value]) { continue; }
+
+							auto& instruction = function_.value(value);
+
+							// computed from a conflict, the origin is reported
+							if (std::ranges::any_of(instruction.operands, [this](const auto operand) { return conflicts_[operand]; }) && instruction.op != opcode::PHI)
+							{
+								conflicts_[value] = true;
+								again = true;
+								continue;
+							}
+
+							string::string reason{};
+							const auto result = infer(value, reason);
+							if (!result)
+							{
+								conflicts_[value] = true;
+								reasons_.insert_or_assign(value, std::move(reason));
+								again = true;
+								continue;
+							}
+
+							if (instruction.type != result->type || structures_[value] != result->structure)
+							{
+								result_.changed |= instruction.type != result->type;
+								instruction.type = result->type;
+								structures_[value] = result->structure;
+								again = true;
+							}
+						}
+					}
+				}
+			}
+
+			// insert a CONVERT of the operand before position (the position of the instruction), return the new position of the instruction
+			auto coerce(const block_id id, const std::size_t position, const value_id value, const std::size_t operand, const type_t type) -> std::size_t
+			{
+				const auto from = function_.value(function_.value(value).operands[operand]);
+				if (from.type == type) { return position; }
+
+				const auto c = function_.insert(id, position, {.op = opcode::CONVERT, .type = type, .operands = {function_.value(value).operands[operand]}});
+				function_.value(value).operands[operand] = c;
+				structures_.push_back(nullptr);
+				conflicts_.push_back(false);
+
+				result_.changed = true;
+				return position + 1;
+			}
+
+			// the extent of the check of an element is the one of the array field accessed
+			auto resolve_extent(const value_id element, const ast::Structure& structure, const std::uint32_t index) -> void
+			{
+				auto& check = function_.value(element);
+				if (check.op != opcode::CHECK_BOUNDS || check.index != 0) { return; }
+
+				check.index = static_cast<std::uint32_t>(structure.get_fields()[index].variable.type->element_count());
+				result_.changed = true;
+			}
+
+			// return the position of the instruction once checked
+			auto check(const block_id id, std::size_t position, const value_id value) -> std::size_t
+			{
+				if (conflicts_[value])
+				{
+					if (const auto it = reasons_.find(value);
+						it != reasons_.end()) { error(value, it->second); }
+					return position;
+				}
+
+				const auto op = function_.value(value).op;
+				const auto type = function_.value(value).type;
+				const auto operands = function_.value(value).operands;
+				const auto type_of_operand = [&](const std::size_t index) { return function_.value(operands[index]).type; };
+
+				switch (op)
+				{
+					case opcode::ARGUMENT:
+					case opcode::LOAD_GLOBAL:
+					case opcode::CALL:
+					{
+						if (type == type_t::NIL) { error(value, "unknown type of ", op); }
+						if (op != opcode::CALL) { break; }
+
+						const auto callee = module_.get_function(function_.value(value).symbol);
+						if (!callee) { break; }
+
+						if (callee->get_arity() != operands.size())
+						{
+							error(value, "wrong number of arguments for ", op);
+							break;
+						}
+
+						const auto parameters = argument_types(*callee);
+						for (std::size_t i = 0; i < operands.size(); ++i)
+						{
+							const auto argument = type_of_operand(i);
+							if (argument == type_t::NIL || parameters[i] == type_t::NIL) { continue; }
+
+							if (!is_convertible(argument, parameters[i])) { error(value, "wrong argument type for ", op); }
+							else { position = coerce(id, position, value, i, parameters[i]); }
+						}
+						break;
+					}
+					case opcode::PHI:
+					{
+						if (type == type_t::NIL) { break; }
+
+						const auto blocks = function_.value(value).blocks;
+						for (std::size_t i = 0; i < operands.size(); ++i)
+						{
+							if (type_of_operand(i) == type || type_of_operand(i) == type_t::NIL) { continue; }
+
+							const auto c = function_.insert_before_terminator(blocks[i], {.op = opcode::CONVERT, .type = type, .operands = {operands[i]}});
+							function_.value(value).operands[i] = c;
+							structures_.push_back(nullptr);
+							conflicts_.push_back(false);
+							result_.changed = true;
+						}
+						break;
+					}
+					case opcode::ADD:
+					case opcode::SUB:
+					case opcode::MUL:
+					case opcode::DIV:
+					case opcode::REM:
+					{
+						if (type == type_t::NIL) { break; }
+
+						position = coerce(id, position, value, 0, type);
+						position = coerce(id, position, value, 1, type);
+						break;
+					}
+					case opcode::EQUAL:
+					case opcode::NOT_EQUAL:
+					case opcode::LESS:
+					case opcode::LESS_EQUAL:
+					case opcode::GREATER:
+					case opcode::GREATER_EQUAL:
+					{
+						const auto lhs = type_of_operand(0);
+						const auto rhs = type_of_operand(1);
+						if (!is_numeric(lhs) || !is_numeric(rhs)) { break; }
+
+						const auto common = is_convertible(lhs, rhs) ? rhs : lhs;
+						position = coerce(id, position, value, 0, common);
+						position = coerce(id, position, value, 1, common);
+						break;
+					}
+					case opcode::LOAD_FIELD:
+					{
+						function_.value(value).structure = structures_[operands[0]];
+						break;
+					}
+					case opcode::LOAD_ELEMENT:
+					{
+						if (type == type_t::NIL) { break; }
+
+						function_.value(value).structure = structures_[operands[0]];
+						resolve_extent(operands[1], *structures_[operands[0]], function_.value(value).index);
+						break;
+					}
+					case opcode::STORE_FIELD:
+					case opcode::STORE_ELEMENT:
+					{
+						const auto object = type_of_operand(0);
+						if (object == type_t::NIL) { break; }
+
+						const auto* structure = structures_[operands[0]];
+						if (object != type_t::STRUCTURE || !structure)
+						{
+							error(value, object != type_t::STRUCTURE ? "field of a value that is not a record" : "field of a record of unknown structure");
+							break;
+						}
+
+						const auto& fields = structure->get_fields();
+						const auto index = function_.value(value).index;
+						if (index >= fields.size() || !fields[index].variable.type)
+						{
+							error(value, "no such field");
+							break;
+						}
+
+						const auto& field = *fields[index].variable.type;
+						if (op == opcode::STORE_ELEMENT)
+						{
+							if (const auto element = type_of_operand(1);
+								element != type_t::NIL && element != type_t::INT)
+							{
+								error(value, "non integer element index");
+								break;
+							}
+							if (!field.is_array() || field.element_count() == 0)
+							{
+								error(value, field.is_array() ? "element of an empty array" : "element of a field that is not an array");
+								break;
+							}
+							resolve_extent(operands[1], *structure, index);
+						}
+
+						function_.value(value).structure = structure;
+
+						// the value of STORE_FIELD, the value of STORE_ELEMENT
+						const auto stored_operand = operands.size() - 1;
+						const auto stored = type_of_operand(stored_operand);
+						if (stored == type_t::NIL) { break; }
+
+						if ((op == opcode::STORE_FIELD && field.is_array()) || !is_convertible(stored, field.type())) { error(value, "wrong type stored in field"); }
+						else { position = coerce(id, position, value, stored_operand, field.type()); }
+						break;
+					}
+					case opcode::BRANCH:
+					{
+						if (const auto condition = type_of_operand(0);
+							condition != type_t::NIL && condition != type_t::BOOLEAN) { error(value, "non boolean condition for ", op); }
+						break;
+					}
+					case opcode::RETURN:
+					{
+						const auto expected = function_.get_return_type();
+						if (operands.empty())
+						{
+							if (expected != type_t::VOID) { error(value, "missing return value"); }
+							break;
+						}
+
+						const auto returned = type_of_operand(0);
+						if (expected == type_t::VOID) { error(value, "return value in a function returning VOID"); }
+						else if (returned != type_t::NIL && !is_convertible(returned, expected)) { error(value, "wrong return type"); }
+						else if (returned != type_t::NIL) { position = coerce(id, position, value, 0, expected); }
+						break;
+					}
+					default: { break; }
+				}
+
+				return position;
+			}
+
+		public:
+			TypeChecker(const Module& module, Function& function)
+				: module_{module},
+				function_{function},
+				structures_(function.value_count(), nullptr),
+				conflicts_(function.value_count(), false),
+				result_{.errors = {}, .changed = false} {}
+
+			[[nodiscard]] auto run() -> type_check_result
+			{
+				infer_all();
+
+				for (const auto id: function_.reverse_post_order())
+				{
+					// the conversions are inserted before the instruction checked
+					for (std::size_t position = 0; position < function_.block(id).instructions.size(); ++position)
+					{
+						position = check(id, position, function_.block(id).instructions[position]);
+					}
+				}
+
+				return std::move(result_);
+			}
+		};
+
+		[[nodiscard]] constexpr auto by_type(const type_t type, const specialized_opcode i32, const specialized_opcode f32, const specialized_opcode f64) noexcept -> specialized_opcode
+		{
+			switch (type)
+			{
+				case type_t::INT: { return i32; }
+				case type_t::FLOAT: { return f32; }
+				case type_t::DOUBLE: { return f64; }
+				default: { return specialized_opcode::UNTYPED; }
+			}
+		}
+	}
+
+	auto check_types(const Module& module, Function& function) -> type_check_result { return TypeChecker{module, function}.run(); }
+
+	auto specialize(const Function& function, const Instruction& instruction) noexcept -> specialized_opcode
+	{
+		using enum specialized_opcode;
+
+		// the operands of a comparison/conversion have the same type
+		const auto operand_type = instruction.operands.empty() ? type_t::NIL : function.value(instruction.operands[0]).type;
+
+		switch (instruction.op)
+		{
+			case opcode::CONSTANT:
+			{
+				switch (type_of(instruction.constant))
+				{
+					case type_t::BOOLEAN: { return CONSTANT_BOOLEAN; }
+					case type_t::INT: { return CONSTANT_I32; }
+					case type_t::FLOAT: { return CONSTANT_F32; }
+					case type_t::DOUBLE: { return CONSTANT_F64; }
+					default: { return UNTYPED; }
+				}
+			}
+			case opcode::ARGUMENT: { return ARGUMENT; }
+			case opcode::PHI: { return PHI; }
+			case opcode::ADD: { return instruction.type == type_t::STRING ? ADD_STRING : by_type(instruction.type, ADD_I32, ADD_F32, ADD_F64); }
+			case opcode::SUB: { return by_type(instruction.type, SUB_I32, SUB_F32, SUB_F64); }
+			case opcode::MUL: { return by_type(instruction.type, MUL_I32, MUL_F32, MUL_F64); }
+			case opcode::DIV: { return by_type(instruction.type, DIV_I32, DIV_F32, DIV_F64); }
+			case opcode::REM: { return by_type(instruction.type, REM_I32, REM_F32, REM_F64); }
+			case opcode::NEG: { return by_type(instruction.type, NEG_I32, NEG_F32, NEG_F64); }
+			case opcode::CONVERT:
+			{
+				if (operand_type == type_t::INT) { return by_type(instruction.type, UNTYPED, CONVERT_I32_TO_F32, CONVERT_I32_TO_F64); }
+				if (operand_type == type_t::FLOAT && instruction.type == type_t::DOUBLE) { return CONVERT_F32_TO_F64; }
+				return UNTYPED;
+			}
+			case opcode::EQUAL:
+			case opcode::NOT_EQUAL:
+			{
+				const auto equal = instruction.op == opcode::EQUAL;
+				switch (operand_type)
+				{
+					case type_t::BOOLEAN: { return equal ? EQUAL_BOOLEAN : NOT_EQUAL_BOOLEAN; }
+					case type_t::STRING: { return equal ? EQUAL_STRING : NOT_EQUAL_STRING; }
+					case type_t::STRUCTURE: { return equal ? EQUAL_REFERENCE : NOT_EQUAL_REFERENCE; }
+					default:
+					{
+						return equal ? by_type(operand_type, EQUAL_I32, EQUAL_F32, EQUAL_F64) : by_type(operand_type, NOT_EQUAL_I32, NOT_EQUAL_F32, NOT_EQUAL_F64);
+					}
+				}
+			}
+			case opcode::LESS: { return by_type(operand_type, LESS_I32, LESS_F32, LESS_F64); }
+			case opcode::LESS_EQUAL: { return by_type(operand_type, LESS_EQUAL_I32, LESS_EQUAL_F32, LESS_EQUAL_F64); }
+			case opcode::GREATER: { return by_type(operand_type, GREATER_I32, GREATER_F32, GREATER_F64); }
+			case opcode::GREATER_EQUAL: { return by_type(operand_type, GREATER_EQUAL_I32, GREATER_EQUAL_F32, GREATER_EQUAL_F64); }
+			case opcode::AND: { return AND; }
+			case opcode::OR: { return OR; }
+			case opcode::NOT: { return NOT; }
+			case opcode::LOAD_GLOBAL: { return LOAD_GLOBAL; }
+			case opcode::STORE_GLOBAL: { return STORE_GLOBAL; }
+			case opcode::ALLOC: { return ALLOC; }
+			case opcode::FRAME_ALLOC: { return FRAME_ALLOC; }
+			case opcode::LOAD_FIELD: { return instruction.structure ? LOAD_FIELD_OFFSET : UNTYPED; }
+			case opcode::STORE_FIELD: { return instruction.structure ? STORE_FIELD_OFFSET : UNTYPED; }
+			case opcode::LOAD_ELEMENT: { return instruction.structure ? LOAD_ELEMENT_OFFSET : UNTYPED; }
+			case opcode::STORE_ELEMENT: { return instruction.structure ? STORE_ELEMENT_OFFSET : UNTYPED; }
+			// not resolved ==> the access is not checked either
+			case opcode::CHECK_BOUNDS: { return instruction.index != 0 ? CHECK_BOUNDS : UNTYPED; }
+			case opcode::CALL: { return CALL; }
+			case opcode::JUMP: { return JUMP; }
+			case opcode::BRANCH: { return BRANCH; }
+			case opcode::RETURN: { return RETURN; }
+		}
+
+		return UNTYPED;
+	}
+
+	auto field_offset(const Instruction& instruction) noexcept -> std::size_t
+	{
+		gsl_assert(
+				(instruction.op == opcode::LOAD_FIELD || instruction.op == opcode::STORE_FIELD || instruction.op == opcode::LOAD_ELEMENT || instruction.op == opcode::STORE_ELEMENT) &&
+				instruction.structure,
+				"not a checked field access!");
+		return instruction.structure->get_fields()[instruction.index].offset;
+	}
+
+	auto element_size(const Instruction& instruction) noexcept -> std::size_t
+	{
+		gsl_assert((instruction.op == opcode::LOAD_ELEMENT || instruction.op == opcode::STORE_ELEMENT) && instruction.structure, "not a checked element access!");
+
+		const auto& field = *instruction.structure->get_fields()[instruction.index].variable.type;
+		return field.size() / field.element_count();
+	}
+}
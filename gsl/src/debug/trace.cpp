@@ -0,0 +1,175 @@
+#include <gsl/debug/trace.hpp>
+
+#ifdef GSL_TRACE
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifndef GSL_TRACE_BUFFER_SIZE
+#define GSL_TRACE_BUFFER_SIZE 8192
+#endif
+
+namespace
+{
+	namespace trace = gal::gsl::debug::trace;
+
+	struct event
+	{
+		const char* name;
+		const char* category;
+		trace::time_point_type begin;
+		trace::time_point_type end;
+		char detail[trace::detail_size];
+		std::size_t detail_length;
+	};
+
+	// Only the owner thread writes into its buffer, so recording does not contend with other threads.
+	// When the buffer is full, the oldest events are overwritten.
+	struct thread_buffer
+	{
+		constexpr static std::size_t capacity = GSL_TRACE_BUFFER_SIZE;
+
+		std::uint32_t thread_id;
+		// total number of recorded events
+		std::atomic<std::size_t> head;
+		std::array<event, capacity> events;
+	};
+
+	// Note: std containers on purpose, the collector reports its events while holding the allocation lock.
+	struct registry
+	{
+		std::mutex mutex;
+		std::vector<std::unique_ptr<thread_buffer>> buffers;
+
+		[[nodiscard]] static auto instance() -> registry&
+		{
+			static registry r;
+			return r;
+		}
+
+		[[nodiscard]] auto acquire() -> thread_buffer*
+		{
+			std::scoped_lock lock{mutex};
+
+			auto& buffer = buffers.emplace_back(std::make_unique<thread_buffer>());
+			buffer->thread_id = static_cast<std::uint32_t>(buffers.size());
+			buffer->head.store(0, std::memory_order_relaxed);
+			return buffer.get();
+		}
+	};
+
+	[[nodiscard]] auto current_buffer() -> thread_buffer*
+	{
+		thread_local thread_buffer* buffer = registry::instance().acquire();
+		return buffer;
+	}
+
+	auto write_escaped(std::FILE* file, const char* string, const std::size_t length) -> void
+	{
+		for (std::size_t i = 0; i < length; ++i)
+		{
+			switch (const auto c = string[i])
+			{
+				case '"':
+				case '\\':
+				{
+					(void)std::fputc('\\', file);
+					(void)std::fputc(c, file);
+					break;
+				}
+				default:
+				{
+					if (static_cast<unsigned char>(c) < 0x20) { (void)std::fprintf(file, "\\u%04x", static_cast<unsigned>(c)); }
+					else { (void)std::fputc(c, file); }
+				}
+			}
+		}
+	}
+}
+
+namespace gal::gsl::debug::trace
+{
+	auto now() noexcept -> time_point_type
+	{
+		static const auto epoch = std::chrono::steady_clock::now();
+
+		return static_cast<time_point_type>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
+	}
+
+	auto record(const char* name, const char* category, const time_point_type begin, const time_point_type end, const string::string_view detail) noexcept -> void
+	{
+		auto* buffer = current_buffer();
+
+		const auto head = buffer->head.load(std::memory_order_relaxed);
+		auto& [event_name, event_category, event_begin, event_end, event_detail, event_detail_length] = buffer->events[head % thread_buffer::capacity];
+
+		event_name = name;
+		event_category = category;
+		event_begin = begin;
+		event_end = end;
+		event_detail_length = std::min(detail.size(), detail_size);
+		std::ranges::copy_n(detail.data(), static_cast<std::ptrdiff_t>(event_detail_length), event_detail);
+
+		buffer->head.store(head + 1, std::memory_order_release);
+	}
+
+	auto dump(const string::string_view filename) -> bool
+	{
+		auto& r = registry::instance();
+		std::scoped_lock lock{r.mutex};
+
+		auto* file = std::fopen(filename.data(), "w");
+		if (!file) { return false; }
+
+		(void)std::fputs(R"({"displayTimeUnit":"ms","traceEvents":[)", file);
+
+		bool first = true;
+		for (const auto& buffer: r.buffers)
+		{
+			const auto head = buffer->head.load(std::memory_order_acquire);
+			const auto tail = head > thread_buffer::capacity ? head - thread_buffer::capacity : 0;
+
+			for (auto i = tail; i < head; ++i)
+			{
+				const auto& [name, category, begin, end, detail, detail_length] = buffer->events[i % thread_buffer::capacity];
+
+				(void)std::fprintf(
+						file,
+						R"(%s{"name":"%s","cat":"%s","ph":"X","pid":1,"tid":%u,"ts":%.3f,"dur":%.3f)",
+						first ? "\n" : ",\n",
+						name,
+						category,
+						buffer->thread_id,
+						static_cast<double>(begin) / 1000.0,
+						static_cast<double>(end - begin) / 1000.0);
+
+				if (detail_length != 0)
+				{
+					(void)std::fputs(R"(,"args":{"detail":")", file);
+					write_escaped(file, detail, detail_length);
+					(void)std::fputs(R"("})", file);
+				}
+				(void)std::fputc('}', file);
+
+				first = false;
+			}
+		}
+
+		(void)std::fputs("\n]}\n", file);
+
+		return std::fclose(file) == 0;
+	}
+
+	auto clear() noexcept -> void
+	{
+		auto& r = registry::instance();
+		std::scoped_lock lock{r.mutex};
+
+		for (const auto& buffer: r.buffers) { buffer->head.store(0, std::memory_order_release); }
+	}
+}
+#endif
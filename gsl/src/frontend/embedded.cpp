@@ -0,0 +1,97 @@
+#include <gsl/frontend/embedded.hpp>
+#include <gsl/debug/assert.hpp>
+#include <gsl/debug/trace.hpp>
+
+namespace gal::gsl::frontend::embedded
+{
+	namespace
+	{
+		[[nodiscard]] auto make_type(const module_view& module, const container::vector<ast::structure_type>& structures, const type_description& type) -> ast::type_declaration_type
+		{
+			const auto dimensions = module.dimensions_of(type);
+
+			return memory::make_shared<ast::TypeDeclaration>(
+					type.type,
+					type.structure == no_structure ? nullptr : structures[type.structure].get(),
+					ast::TypeDeclaration::dimension_container_type{dimensions.begin(), dimensions.end()});
+		}
+
+		// the initializer itself is not kept (yet), like the expressions of parse_file
+		[[nodiscard]] auto make_expression(const constant_description& constant) -> ast::expression_type
+		{
+			if (constant.kind == constant_description::kind_type::NONE) { return nullptr; }
+			return memory::make_shared<ast::Expression>();
+		}
+	}
+
+	auto instantiate(const module_view& module, const parse_options& options) -> ast::module_type
+	{
+		GSL_TRACE_SCOPE_DETAIL("instantiate embedded module", "frontend", module.name);
+
+		auto mod = memory::make_shared<ast::Module>(module.name);
+
+		for (const auto import: module.imports)
+		{
+			// importing itself is a cycle, reported by the registry
+			(void)mod->register_import(ast::symbol_name{import});
+		}
+
+		// the descriptions refer to the structures by index
+		container::vector<ast::structure_type> structures{};
+		structures.reserve(module.structures.size());
+		for (const auto& description: module.structures)
+		{
+			auto [success, structure] = mod->register_structure(description.name);
+			gsl_assert(success, "the embedded parser rejects duplicate structures!");
+
+			structure->set_layout(description.layout);
+			for (const auto& field: module.fields_of(description))
+			{
+				(void)structure->register_field(field.name, make_type(module, structures, field.type));
+				gsl_assert(structure->get_fields().back().offset == field.offset, "the embedded parser must lay out the fields like ast::Structure!");
+			}
+			gsl_assert(structure->get_size() == description.size, "the embedded parser must lay out the fields like ast::Structure!");
+
+			structures.push_back(std::move(structure));
+		}
+
+		for (const auto& description: module.globals)
+		{
+			auto [success, global] = description.is_mutable ? mod->register_global_mutable(description.name) : mod->register_global_immutable(description.name);
+			gsl_assert(success, "the embedded parser rejects duplicate globals!");
+
+			global->set_type(make_type(module, structures, description.type));
+			global->set_expression(make_expression(description.initializer));
+		}
+
+		if (module.functions.empty()) { return mod; }
+
+		// the lazy bodies keep it alive until they are all parsed
+		const auto source = memory::make_shared<string::string>(module.source);
+		const string::string filename{module.name};
+		const parse_options body_options{.lazy_function_bodies = true, .registry = options.registry};
+
+		for (const auto& description: module.functions)
+		{
+			auto [success, function] = mod->register_function(description.name);
+			gsl_assert(success, "the embedded parser rejects duplicate functions!");
+
+			ast::Function::arguments_container_type arguments{};
+			arguments.reserve(description.argument_count);
+			for (const auto& argument: module.arguments_of(description))
+			{
+				arguments.push_back(
+						memory::make_shared<ast::Variable>(
+								argument.name,
+								make_type(module, structures, argument.type),
+								make_expression(argument.default_value)));
+			}
+
+			function->set_arguments(std::move(arguments));
+			function->set_return_type(make_type(module, structures, description.return_type));
+			function->set_lazy_function_body(source, description.body_offset, description.body_size, make_function_body_parser(mod, filename, body_options));
+		}
+
+		return mod;
+	}
+}
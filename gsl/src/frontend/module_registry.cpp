@@ -0,0 +1,328 @@
+#include <gsl/frontend/module_registry.hpp>
+#include <gsl/container/unordered_map.hpp>
+#include <gsl/debug/trace.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <ranges>
+#include <thread>
+
+namespace gal::gsl::frontend
+{
+	namespace
+	{
+		[[nodiscard]] auto describe_cycle(const container::vector<ast::symbol_name>& cycle) -> std::string
+		{
+			std::string result{"import cycle: "};
+			for (const auto& name: cycle)
+			{
+				if (&name != &cycle.front()) { result.append(" -> "); }
+				result.append(name);
+			}
+			return result;
+		}
+
+		[[nodiscard]] auto describe_module_error(const module_error::reason_type reason, const ast::symbol_name_view name, const string::string_view path) -> std::string
+		{
+			std::string result{};
+			if (reason == module_error::reason_type::NOT_FOUND) { result.append("Cannot find module '").append(name).append("'!"); }
+			else { result.append("Module name does not match its file, '").append(path).append("' is not module '").append(name).append("'!"); }
+			return result;
+		}
+
+		template<typename Find>
+		[[nodiscard]] auto find_imported(ModuleRegistry& registry, const ast::Module& module, Find find)
+		{
+			if (auto result = find(module)) { return result; }
+
+			for (const auto& import: module.get_imports())
+			{
+				if (auto result = find(*registry.load(import))) { return result; }
+			}
+
+			return decltype(find(module)){};
+		}
+
+		// depth first over the module headers
+		class DependencyWalker
+		{
+		public:
+			constexpr static std::size_t visiting = static_cast<std::size_t>(-1);
+
+		private:
+			const ModuleRegistry& registry_;
+			// name ==> level, `visiting` while its imports are walked
+			container::unordered_map<ast::symbol_name, std::size_t, utility::string_hasher<ast::symbol_name>> levels_;
+			container::vector<ast::symbol_name> path_;
+
+		public:
+			container::vector<container::vector<ast::symbol_name>> result;
+
+			explicit DependencyWalker(const ModuleRegistry& registry)
+				: registry_{registry} {}
+
+			auto walk(const ast::symbol_name_view name) -> std::size_t
+			{
+				if (const auto it = levels_.find(name);
+					it != levels_.end())
+				{
+					if (it->second != visiting) { return it->second; }
+
+					container::vector<ast::symbol_name> cycle{std::ranges::find(path_, name), path_.end()};
+					cycle.emplace_back(name);
+					throw import_cycle_error{std::move(cycle)};
+				}
+
+				const auto path = registry_.resolve(name);
+				if (path.empty()) { throw module_error{module_error::reason_type::NOT_FOUND, name, {}}; }
+
+				auto header = parse_module_header(path);
+				if (header.name != name) { throw module_error{module_error::reason_type::NAME_MISMATCH, name, path}; }
+
+				levels_.emplace(header.name, visiting);
+				path_.push_back(header.name);
+
+				std::size_t level = 0;
+				for (const auto& import: header.imports) { level = std::ranges::max(level, walk(import) + 1); }
+
+				path_.pop_back();
+				levels_.find(name)->second = level;
+
+				if (result.size() <= level) { result.resize(level + 1); }
+				result[level].push_back(std::move(header.name));
+
+				return level;
+			}
+		};
+	}
+
+	import_cycle_error::import_cycle_error(container::vector<ast::symbol_name>&& cycle)
+		: std::runtime_error{describe_cycle(cycle)},
+		cycle_{std::move(cycle)} {}
+
+	module_error::module_error(const reason_type reason, const ast::symbol_name_view name, const string::string_view path)
+		: std::runtime_error{describe_module_error(reason, name, path)},
+		reason_{reason},
+		name_{name},
+		path_{path} {}
+
+	ModuleRegistry::ModuleRegistry(container::vector<string::string> search_paths, const parse_options& options)
+		: search_paths_{std::move(search_paths)},
+		options_{options}
+	{
+		options_.registry = this;
+	}
+
+	auto ModuleRegistry::entry_of(const ast::symbol_name_view name) -> entry&
+	{
+		if (const auto* e = modules_.find(name)) { return **e; }
+
+		return *modules_.try_emplace(ast::symbol_name{name}, [](const auto&) { return memory::make_shared<entry>(); }).second;
+	}
+
+	auto ModuleRegistry::resolve(const ast::symbol_name_view name) const -> string::string
+	{
+		for (const auto& search_path: search_paths_)
+		{
+			auto path = (std::filesystem::path{search_path.c_str()} / name).concat(module_extension);
+			if (std::error_code error;
+				std::filesystem::is_regular_file(path, error)) { return string::string{path.string()}; }
+		}
+
+		return {};
+	}
+
+	auto ModuleRegistry::begin_waiting(const std::thread::id self, const ast::symbol_name_view name) -> void
+	{
+		std::scoped_lock lock{loading_mutex_};
+
+		// the thread loading the module, the module that thread waits for, the thread loading that one...
+		// back to this thread ==> nobody would ever return from call_once
+		container::vector<std::pair<std::thread::id, ast::symbol_name_view>> chain{};
+		for (auto module = name;;)
+		{
+			const auto it = loading_by_.find(module);
+			if (it == loading_by_.end()) { break; }
+
+			chain.emplace_back(it->second, module);
+			if (it->second == self)
+			{
+				// what this thread loads from that module on, then what each thread of the chain loads from the module it was waited for on
+				const auto append = [this](container::vector<ast::symbol_name>& cycle, const std::thread::id thread, const ast::symbol_name_view from)
+				{
+					const auto& stack = loaders_.find(thread)->second.stack;
+					for (const auto loading: std::ranges::subrange{std::ranges::find(stack, from), stack.end()}) { cycle.emplace_back(loading); }
+				};
+
+				container::vector<ast::symbol_name> cycle{};
+				append(cycle, self, module);
+				for (const auto& [thread, from]: chain | std::views::take(chain.size() - 1)) { append(cycle, thread, from); }
+				cycle.emplace_back(module);
+				throw import_cycle_error{std::move(cycle)};
+			}
+
+			module = loaders_.find(it->second)->second.waiting;
+			if (module.empty()) { break; }
+		}
+
+		loaders_[self].waiting = name;
+	}
+
+	auto ModuleRegistry::end_waiting(const std::thread::id self) -> void
+	{
+		std::scoped_lock lock{loading_mutex_};
+
+		const auto it = loaders_.find(self);
+		if (it == loaders_.end()) { return; }
+
+		it->second.waiting = {};
+		if (it->second.stack.empty()) { loaders_.erase(it); }
+	}
+
+	auto ModuleRegistry::begin_loading(const std::thread::id self, const ast::symbol_name_view name) -> void
+	{
+		std::scoped_lock lock{loading_mutex_};
+
+		auto& l = loaders_[self];
+		l.waiting = {};
+		l.stack.push_back(name);
+		loading_by_.emplace(name, self);
+	}
+
+	auto ModuleRegistry::end_loading(const std::thread::id self, const ast::symbol_name_view name) -> void
+	{
+		std::scoped_lock lock{loading_mutex_};
+
+		loaders_.find(self)->second.stack.pop_back();
+		loading_by_.erase(loading_by_.find(name));
+	}
+
+	auto ModuleRegistry::load(const ast::symbol_name_view name) -> ast::module_type
+	{
+		auto& e = entry_of(name);
+		if (e.ready.load(std::memory_order_acquire)) { return e.module; }
+
+		// importing a module this thread is already loading (maybe through other threads), call_once would never return
+		const auto self = std::this_thread::get_id();
+		begin_waiting(self, name);
+
+		// an exception leaves it unloaded, the next load tries again
+		try
+		{
+			std::call_once(
+					e.loaded,
+					[this, &e, self, name]
+					{
+						GSL_TRACE_SCOPE_DETAIL("load module", "frontend", name);
+
+						const auto path = resolve(name);
+						if (path.empty()) { throw module_error{module_error::reason_type::NOT_FOUND, name, {}}; }
+
+						begin_loading(self, name);
+						ast::module_type mod;
+						try { mod = parse_file(path, options_); }
+						catch (...)
+						{
+							end_loading(self, name);
+							throw;
+						}
+						end_loading(self, name);
+
+						if (mod->get_name() != name) { throw module_error{module_error::reason_type::NAME_MISMATCH, name, path}; }
+
+						e.module = std::move(mod);
+						e.ready.store(true, std::memory_order_release);
+					});
+		}
+		catch (...)
+		{
+			end_waiting(self);
+			throw;
+		}
+		end_waiting(self);
+
+		return e.module;
+	}
+
+	auto ModuleRegistry::get(const ast::symbol_name_view name) const -> ast::module_type
+	{
+		if (const auto* e = modules_.find(name);
+			e && (*e)->ready.load(std::memory_order_acquire)) { return (*e)->module; }
+
+		return nullptr;
+	}
+
+	auto ModuleRegistry::find_structure(const ast::Module& module, const ast::symbol_name_view name) -> ast::structure_type
+	{
+		return find_imported(*this, module, [name](const ast::Module& m) { return m.get_structure(name); });
+	}
+
+	auto ModuleRegistry::find_global(const ast::Module& module, const ast::symbol_name_view name) -> ast::variable_type
+	{
+		return find_imported(*this, module, [name](const ast::Module& m) { return m.get_global(name); });
+	}
+
+	auto ModuleRegistry::find_function(const ast::Module& module, const ast::symbol_name_view name) -> ast::function_type
+	{
+		return find_imported(*this, module, [name](const ast::Module& m) { return m.get_function(name); });
+	}
+
+	auto ModuleRegistry::dependency_levels(const std::span<const ast::symbol_name> roots) const -> container::vector<container::vector<ast::symbol_name>>
+	{
+		GSL_TRACE_SCOPE("module dependency levels", "frontend");
+
+		DependencyWalker walker{*this};
+		for (const auto& root: roots) { (void)walker.walk(root); }
+
+		return std::move(walker.result);
+	}
+
+	auto ModuleRegistry::load_all(const std::span<const ast::symbol_name> roots, const std::size_t threads) -> container::vector<ast::module_type>
+	{
+		GSL_TRACE_SCOPE("load modules", "frontend");
+
+		const auto levels = dependency_levels(roots);
+		const auto wanted = threads == 0 ? std::ranges::max(std::thread::hardware_concurrency(), 1u) : threads;
+
+		container::vector<ast::module_type> result{};
+		for (const auto& level: levels)
+		{
+			// every import of a module of this level is loaded already, its parse never waits for another module
+			const auto offset = result.size();
+			result.resize(offset + level.size());
+
+			const auto workers_count = std::ranges::min(wanted, level.size());
+			std::atomic<std::size_t> next{0};
+			container::vector<std::exception_ptr> exceptions(workers_count);
+
+			const auto run = [&](const std::size_t worker)
+			{
+				try
+				{
+					for (auto i = next.fetch_add(1, std::memory_order_relaxed); i < level.size(); i = next.fetch_add(1, std::memory_order_relaxed))
+					{
+						result[offset + i] = load(level[i]);
+					}
+				}
+				catch (...) { exceptions[worker] = std::current_exception(); }
+			};
+
+			{
+				container::vector<std::jthread> workers;
+				workers.reserve(workers_count - 1);
+
+				// the calling thread is the first worker
+				for (std::size_t i = 1; i < workers_count; ++i) { workers.emplace_back(run, i); }
+				run(0);
+			}
+
+			for (const auto& exception: exceptions)
+			{
+				if (exception) { std::rethrow_exception(exception); }
+			}
+		}
+
+		return result;
+	}
+}
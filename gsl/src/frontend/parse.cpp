@@ -1,5 +1,7 @@
 #include <gsl/frontend/parse.hpp>
+#include <gsl/frontend/module_registry.hpp>
 #include <gsl/backend/ast.hpp>
+#include <gsl/debug/trace.hpp>
 
 #include <lexy/dsl.hpp>
 #include <lexy/action/parse.hpp>
@@ -9,7 +11,10 @@
 #include <lexy/callback.hpp>
 #include <lexy/visualize.hpp>
 
+#include <memory>
 #include <optional>
+#include <stdexcept>
+#include <utility>
 #include <cstdio>
 
 namespace
@@ -43,13 +48,29 @@ namespace
 		gsl::ast::module_type mod;
 
 		gsl::ast::structure_type current_structure;
+		// set by the annotations preceding a structure declaration
+		gsl::ast::Structure::layout_type pending_structure_layout = gsl::ast::Structure::layout_type::ARRAY_OF_STRUCTURES;
 		gsl::ast::function_type current_function;
+		gsl::ast::variable_type current_global;
+
+		// the whole file if the function bodies are parsed lazily, see parse_options::lazy_function_bodies
+		gsl::memory::shared_ptr<const gsl::string::string> lazy_source;
+		// resolves the names the module does not declare itself, see parse_options::registry
+		gsl::frontend::ModuleRegistry* registry = nullptr;
 
 		ParseState(gsl::string::string&& filename, context_type&& buffer)
 			: filename{std::move(filename)},
 			buffer{std::move(buffer)},
 			buffer_anchor{this->buffer} {}
 
+		// declared by this module first, then by the modules it imports
+		[[nodiscard]] auto find_structure(const symbol_name_view name) const -> gsl::ast::structure_type
+		{
+			if (auto structure = mod->get_structure(name)) { return structure; }
+			if (registry) { return registry->find_structure(*mod, name); }
+			return nullptr;
+		}
+
 		auto report_invalid_identifier(const char_type* position, const symbol_name_view identifier, const char* category) const -> void
 		{
 			const auto location = lexy::get_input_location(buffer, position, buffer_anchor);
@@ -140,6 +161,9 @@ namespace
 					});
 		}
 	};
+
+	// parse the body of the function on its first use, see grammar::function_declaration::lazy_body
+	[[nodiscard]] auto make_lazy_body_parser(const ParseState& state) -> gsl::ast::Function::body_parser_type;
 }
 
 namespace grammar
@@ -195,8 +219,9 @@ namespace grammar
 					if (type == gsl::ast::TypeDeclaration::variable_type::NIL)
 					{
 						// maybe structure?
-						if (target_structure = state.mod->get_structure(type_name);
+						if (target_structure = state.find_structure(type_name);
 							!target_structure) { state.report_invalid_identifier(type_position, type_name, "type"); }
+						type = gsl::ast::TypeDeclaration::variable_type::STRUCTURE;
 					}
 					else
 					{
@@ -220,7 +245,7 @@ namespace grammar
 					if (type == gsl::ast::TypeDeclaration::variable_type::NIL)
 					{
 						// maybe structure?
-						if (target_structure = state.mod->get_structure(type_name);
+						if (target_structure = state.find_structure(type_name);
 							!target_structure) { state.report_invalid_identifier(type_position, type_name, "type"); }
 						type = gsl::ast::TypeDeclaration::variable_type::STRUCTURE;
 					}
@@ -262,13 +287,44 @@ namespace grammar
 				);
 	};
 
+	// "text" (on one line, a backslash escapes the next character), 42 or -1.5, the literal initializers of frontend::embedded (true/false are names here)
+	struct literal
+	{
+		struct string
+		{
+			constexpr static auto rule = dsl::quoted(dsl::code_point - dsl::ascii::newline, dsl::backslash_escape.capture(dsl::code_point - dsl::ascii::newline));
+
+			constexpr static auto value = lexy::noop;
+		};
+
+		struct number
+		{
+			constexpr static auto rule = dsl::token(dsl::opt(dsl::lit_c<'-'>) + dsl::digits<> + dsl::opt(dsl::period >> dsl::while_(dsl::ascii::digit)));
+
+			constexpr static auto value = lexy::noop;
+		};
+
+		constexpr static auto rule =
+				dsl::p<string> |
+				dsl::peek(dsl::lit_c<'-'> / dsl::ascii::digit) >> dsl::p<number>;
+
+		constexpr static auto value = lexy::noop;
+	};
+
 	struct expression
 	{
 		// todo
-		constexpr static auto rule = dsl::p<identifier>;
+		constexpr static auto rule = dsl::p<literal> | dsl::else_ >> dsl::p<identifier>;
 
 		// todo
 		constexpr static auto value = ParseState::callback<gsl::ast::expression_type>(
+				// literal
+				[](const ParseState& state) -> gsl::ast::expression_type
+				{
+					(void)state;
+					return gsl::memory::make_shared<gsl::ast::Expression>();
+				},
+				// name
 				[](const ParseState& state, symbol_name&&) -> gsl::ast::expression_type
 				{
 					(void)state;
@@ -319,6 +375,20 @@ namespace grammar
 	{
 		[[nodiscard]] consteval static auto name() noexcept { return "structure declaration"; }
 
+		// @soa
+		struct annotation
+		{
+			constexpr static auto rule = dsl::lit_c<'@'> >> (dsl::position + dsl::p<identifier>);
+
+			constexpr static auto value = ParseState::callback<void>(
+					[](ParseState& state, const ParseState::char_type* position, symbol_name&& symbol) -> void
+					{
+						if (symbol == "soa") { state.pending_structure_layout = gsl::ast::Structure::layout_type::STRUCTURE_OF_ARRAYS; }
+						else if (symbol == "aos") { state.pending_structure_layout = gsl::ast::Structure::layout_type::ARRAY_OF_STRUCTURES; }
+						else { state.report_invalid_identifier(position, symbol, "annotation"); }
+					});
+		};
+
 		// struct name
 		struct header
 		{
@@ -327,9 +397,12 @@ namespace grammar
 			constexpr static auto value = ParseState::callback<void>(
 					[](ParseState& state, const ParseState::char_type* position, symbol_name&& symbol) -> void
 					{
+						GSL_TRACE_SCOPE_DETAIL("structure declaration", "frontend", symbol);
+
 						auto [success, structure] = state.mod->register_structure(std::move(symbol));
 						if (!success) { state.report_duplicate_declaration(position, structure->get_name(), "structure"); }
 
+						structure->set_layout(std::exchange(state.pending_structure_layout, gsl::ast::Structure::layout_type::ARRAY_OF_STRUCTURES));
 						state.current_structure = structure;
 					});
 		};
@@ -342,6 +415,8 @@ namespace grammar
 			constexpr static auto value = ParseState::callback<void>(
 					[](const ParseState& state, const ParseState::char_type* position, gsl::ast::Variable::variable_declaration&& variable) -> void
 					{
+						GSL_TRACE_SCOPE_DETAIL("field declaration", "frontend", variable.name);
+
 						if (!state.current_structure->register_field(std::move(variable)))
 						{
 							// We know that if the insertion fails, the 'symbol' will not be moved, so please shut up
@@ -350,11 +425,16 @@ namespace grammar
 					});
 		};
 
-		constexpr static auto rule =
-				LEXY_KEYWORD("struct", identifier::rule) >>
-				(dsl::p<header> +
+		constexpr static auto declaration =
+				dsl::p<header> +
 				// todo: forward declaration?
-				dsl::curly_bracketed.opt_list(dsl::p<field>));
+				dsl::curly_bracketed.opt_list(dsl::p<field>);
+
+		constexpr static auto rule =
+				// @annotation struct name { fields... }
+				(dsl::p<annotation> >> (dsl::while_(dsl::p<annotation>) + LEXY_KEYWORD("struct", identifier::rule) + declaration)) |
+				// struct name { fields... }
+				(LEXY_KEYWORD("struct", identifier::rule) >> declaration);
 
 		constexpr static auto value = lexy::forward<void>;
 	};
@@ -375,8 +455,10 @@ namespace grammar
 			}();
 
 			constexpr static auto value = ParseState::callback<void>(
-					[](const ParseState& state, const ParseState::char_type* position, gsl::ast::variable_type&& variable) -> void
+					[](ParseState& state, const ParseState::char_type* position, gsl::ast::variable_type&& variable) -> void
 					{
+						GSL_TRACE_SCOPE_DETAIL("global declaration", "frontend", variable->get_name());
+
 						// try register
 						auto [success, v] = state.mod->register_global_immutable(variable->get_name());
 						if (!success) { state.report_duplicate_declaration(position, v->get_name(), "global"); }
@@ -384,6 +466,7 @@ namespace grammar
 						// register succeeded, reset the pointer
 						// Note: if the global variables are duplicate defined, the original global variables will be overwritten
 						v.swap(variable);
+						state.current_global = v;
 					});
 		};
 
@@ -399,8 +482,10 @@ namespace grammar
 			}();
 
 			static constexpr auto value = ParseState::callback<void>(
-					[](const ParseState& state, const ParseState::char_type* position, gsl::ast::variable_type&& variable) -> void
+					[](ParseState& state, const ParseState::char_type* position, gsl::ast::variable_type&& variable) -> void
 					{
+						GSL_TRACE_SCOPE_DETAIL("global declaration", "frontend", variable->get_name());
+
 						// try register
 						auto [success, v] = state.mod->register_global_immutable(variable->get_name());
 						if (!success) { state.report_duplicate_declaration(position, v->get_name(), "global"); }
@@ -408,6 +493,7 @@ namespace grammar
 						// register succeeded, reset the pointer
 						// Note: if the global variables are duplicate defined, the original global variables will be overwritten
 						v.swap(variable);
+						state.current_global = v;
 					}
 					);
 		};
@@ -478,6 +564,8 @@ namespace grammar
 					// return type
 					gsl::ast::type_declaration_type&& return_type)
 					{
+						GSL_TRACE_SCOPE_DETAIL("function declaration", "frontend", function_name);
+
 						auto [success, function] = state.mod->register_function(std::move(function_name));
 						if (!success) { state.report_duplicate_declaration(function_position, function->get_name(), "function"); }
 
@@ -494,9 +582,36 @@ namespace grammar
 		{
 			constexpr static auto rule = dsl::curly_bracketed.open() >> (dsl::p<expression> + dsl::curly_bracketed.close());
 
+			constexpr static auto value = lexy::forward<gsl::ast::expression_type>;
+		};
+
+		// the body skipped by brace matching (the braces of comments and strings do not count), only its position in the source is recorded
+		struct lazy_body
+		{
+			struct braces
+			{
+				constexpr static auto rule =
+						dsl::lit_c<'{'> >>
+						dsl::loop(
+								dsl::lit_c<'}'> >> dsl::break_ |
+								dsl::peek(dsl::lit_c<'{'>) >> dsl::recurse<braces> |
+								// a '#' inside is not a comment
+								dsl::peek(dsl::lit_c<'"'>) >> dsl::p<literal::string> |
+								dsl::else_ >> dsl::code_point);
+
+				constexpr static auto value = lexy::forward<void>;
+			};
+
+			constexpr static auto rule = dsl::position + dsl::p<braces> + dsl::position;
+
 			constexpr static auto value = ParseState::callback<void>(
-					[](const ParseState& state, gsl::ast::expression_type&& body) -> void { state.current_function->set_function_body(std::move(body)); }
-					);
+					[](const ParseState& state, const ParseState::char_type* begin, const ParseState::char_type* end) -> void
+					{
+						const auto offset = static_cast<std::size_t>(begin - state.buffer.data());
+						const auto size = static_cast<std::size_t>(end - begin);
+
+						state.current_function->set_lazy_function_body(state.lazy_source, offset, size, make_lazy_body_parser(state));
+					});
 		};
 
 		constexpr static auto rule =
@@ -506,21 +621,60 @@ namespace grammar
 				// function body
 				dsl::p<body>);
 
+		constexpr static auto value = ParseState::callback<void>(
+				[](const ParseState& state, gsl::ast::expression_type&& body) -> void
+				{
+					GSL_TRACE_SCOPE_DETAIL("function body", "frontend", state.current_function->get_name());
+
+					state.current_function->set_function_body(std::move(body));
+				});
+	};
+
+	// fn name(arguments) -> type {...}, the body is parsed on first use (see ast::Function::get_function_body)
+	struct lazy_function_declaration
+	{
+		[[nodiscard]] consteval static auto name() noexcept { return "function declaration"; }
+
+		constexpr static auto rule =
+				LEXY_KEYWORD("fn", identifier::rule) >>
+				(dsl::p<function_declaration::header> +
+				dsl::p<function_declaration::lazy_body>);
+
 		constexpr static auto value = lexy::forward<void>;
 	};
 
+	constexpr auto module_whitespace =
+			// space
+			dsl::ascii::blank |
+			// new line
+			dsl::newline |
+			// comment
+			dsl::hash_sign >> dsl::until(dsl::newline);
+
+	// import module_name;
+	struct import_declaration
+	{
+		constexpr static auto rule =
+				LEXY_KEYWORD("import", identifier::rule) >>
+				(dsl::position + dsl::p<identifier> + dsl::semicolon);
+
+		constexpr static auto value = ParseState::callback<void>(
+				[](ParseState& state, const ParseState::char_type* position, symbol_name&& name) -> void
+				{
+					// importing itself is a cycle, reported by the registry
+					if (!state.mod->register_import(std::move(name)))
+					{
+						state.report_duplicate_declaration(position, name, "import");// NOLINT(bugprone-use-after-move)
+					}
+				});
+	};
+
 	// module module_name;
 	struct module_declaration
 	{
 		[[nodiscard]] consteval static auto name() noexcept { return "module declaration"; }
 
-		constexpr static auto whitespace =
-				// space
-				dsl::ascii::blank |
-				// new line
-				dsl::newline |
-				// comment
-				dsl::hash_sign >> dsl::until(dsl::newline);
+		constexpr static auto whitespace = module_whitespace;
 
 		struct header
 		{
@@ -539,22 +693,275 @@ namespace grammar
 					});
 		};
 
+		// the imports precede every other declaration
 		constexpr static auto rule =
 				dsl::p<header> +
+				dsl::while_(dsl::p<import_declaration>) +
 				dsl::terminator(dsl::eof).opt_list(
+						dsl::p<structure_declaration> |
 						dsl::p<global_declaration> |
 						dsl::p<function_declaration>
 						);
 
 		constexpr static auto value = lexy::forward<void>;
 	};
+
+	// module_declaration with lazy function bodies
+	struct lazy_module_declaration
+	{
+		[[nodiscard]] consteval static auto name() noexcept { return "module declaration"; }
+
+		constexpr static auto whitespace = module_whitespace;
+
+		constexpr static auto rule =
+				dsl::p<module_declaration::header> +
+				dsl::while_(dsl::p<import_declaration>) +
+				dsl::terminator(dsl::eof).opt_list(
+						dsl::p<structure_declaration> |
+						dsl::p<global_declaration> |
+						dsl::p<lazy_function_declaration>
+						);
+
+		constexpr static auto value = lexy::forward<void>;
+	};
+
+	// the source of one lazy function body alone
+	struct lazy_function_body
+	{
+		[[nodiscard]] consteval static auto name() noexcept { return "function body"; }
+
+		constexpr static auto whitespace = module_whitespace;
+
+		constexpr static auto rule = dsl::p<function_declaration::body> + dsl::eof;
+
+		constexpr static auto value = lexy::forward<gsl::ast::expression_type>;
+	};
+
+	// module module_name; alone, see parse_file_streaming
+	struct streaming_module_header
+	{
+		[[nodiscard]] consteval static auto name() noexcept { return "module declaration"; }
+
+		constexpr static auto whitespace = module_whitespace;
+
+		constexpr static auto rule = dsl::p<module_declaration::header> + dsl::eof;
+
+		constexpr static auto value = lexy::forward<void>;
+	};
+
+	// import module_name; alone, see parse_module_header and parse_file_streaming
+	struct streaming_import
+	{
+		[[nodiscard]] consteval static auto name() noexcept { return "import declaration"; }
+
+		constexpr static auto whitespace = module_whitespace;
+
+		constexpr static auto rule = dsl::p<import_declaration> + dsl::eof;
+
+		constexpr static auto value = lexy::forward<void>;
+	};
+
+	// one top level declaration alone (not an import, they all precede the first one), see parse_file_streaming
+	struct streaming_declaration
+	{
+		[[nodiscard]] consteval static auto name() noexcept { return "top level declaration"; }
+
+		constexpr static auto whitespace = module_whitespace;
+
+		constexpr static auto rule =
+				(dsl::p<structure_declaration> |
+				dsl::p<global_declaration> |
+				dsl::p<function_declaration>) +
+				dsl::eof;
+
+		constexpr static auto value = lexy::forward<void>;
+	};
+}
+
+namespace
+{
+	auto make_lazy_body_parser(const ParseState& state) -> gsl::ast::Function::body_parser_type
+	{
+		return gsl::frontend::make_function_body_parser(state.mod, state.filename, {.lazy_function_bodies = true, .registry = state.registry});
+	}
+
+	// `import ...` (the split source of a declaration starts with its first character)
+	[[nodiscard]] auto is_import_declaration(const std::string_view source) noexcept -> bool
+	{
+		constexpr std::string_view keyword{"import"};
+		if (!source.starts_with(keyword) || source.size() == keyword.size()) { return false; }
+
+		const auto c = source[keyword.size()];
+		return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+	}
+
+	// Split the source into top level declarations without parsing them:
+	// a declaration ends with a ';' or with the '}' closing its outermost bracket, comments ('#' until the end of the line) are skipped,
+	// and so are strings ('"' until the next unescaped '"' or the end of the line).
+	class DeclarationSplitter
+	{
+	public:
+		// read from the file at a time
+		constexpr static std::size_t block_size = 64 * 1024;
+
+	private:
+		std::FILE* file_;
+		gsl::string::string pending_;
+		// scan position in pending_, everything before it and before begin_ is consumed
+		std::size_t cursor_;
+		// start of the current declaration in pending_, npos if only whitespace/comments were seen so far
+		std::size_t begin_;
+		std::size_t depth_;
+		bool in_comment_;
+		bool in_string_;
+		// the previous character of the string is an unescaped backslash
+		bool escaped_;
+		// line of pending_[cursor_], 1-based
+		std::size_t line_;
+		std::size_t begin_line_;
+
+	public:
+		explicit DeclarationSplitter(std::FILE* file)
+			: file_{file},
+			cursor_{0},
+			begin_{gsl::string::string::npos},
+			depth_{0},
+			in_comment_{false},
+			in_string_{false},
+			escaped_{false},
+			line_{1},
+			begin_line_{1} {}
+
+		// the next declaration (nothing if there is none left) and the line it starts at
+		// an unterminated trailing declaration is returned as is, its parser reports the error
+		[[nodiscard]] auto next() -> std::optional<std::pair<gsl::string::string, std::size_t>>
+		{
+			while (true)
+			{
+				for (; cursor_ < pending_.size(); ++cursor_)
+				{
+					const auto c = pending_[cursor_];
+
+					if (c == '\n')
+					{
+						// an unterminated string ends with its line, its parser reports the error
+						in_comment_ = false;
+						in_string_ = false;
+						escaped_ = false;
+						++line_;
+						continue;
+					}
+					if (in_comment_) { continue; }
+					if (in_string_)
+					{
+						if (escaped_) { escaped_ = false; }
+						else if (c == '\\') { escaped_ = true; }
+						else if (c == '"') { in_string_ = false; }
+						continue;
+					}
+					if (c == '#')
+					{
+						in_comment_ = true;
+						continue;
+					}
+					if (c == ' ' || c == '\t' || c == '\r') { continue; }
+
+					if (begin_ == gsl::string::string::npos)
+					{
+						begin_ = cursor_;
+						begin_line_ = line_;
+					}
+
+					if (c == '"')
+					{
+						in_string_ = true;
+						continue;
+					}
+
+					if (c == '{') { ++depth_; }
+					else if (c == '}' && depth_ != 0) { --depth_; }
+					else if (c != ';' || depth_ != 0) { continue; }
+
+					if (depth_ == 0) { return take(cursor_ + 1); }
+				}
+
+				if (!fill())
+				{
+					if (begin_ == gsl::string::string::npos) { return std::nullopt; }
+					return take(pending_.size());
+				}
+			}
+		}
+
+	private:
+		[[nodiscard]] auto take(const std::size_t end) -> std::pair<gsl::string::string, std::size_t>
+		{
+			auto declaration = std::make_pair(pending_.substr(begin_, end - begin_), begin_line_);
+
+			// everything before end is consumed, dropped by the next fill
+			cursor_ = end;
+			begin_ = gsl::string::string::npos;
+			return declaration;
+		}
+
+		auto fill() -> bool
+		{
+			// drop what was consumed (or only whitespace/comments), keep the current declaration
+			const auto consumed = begin_ == gsl::string::string::npos ? cursor_ : begin_;
+			pending_.erase(0, consumed);
+			cursor_ -= consumed;
+			if (begin_ != gsl::string::string::npos) { begin_ = 0; }
+
+			const auto old_size = pending_.size();
+			pending_.resize(old_size + block_size);
+			const auto read = std::fread(pending_.data() + old_size, 1, block_size, file_);
+			pending_.resize(old_size + read);
+
+			return read != 0;
+		}
+	};
 }
 
 namespace gal::gsl::frontend
 {
-	auto parse_file(const string::string_view filename) -> ast::module_type
+	auto make_function_body_parser(const ast::module_type& module, const string::string_view filename, const parse_options& options) -> ast::Function::body_parser_type
 	{
-		auto file = lexy::read_file<lexy::utf8_encoding>(filename.data());
+		// not the module itself, it owns its functions
+		return [filename = string::string{filename}, weak_mod = std::weak_ptr<ast::Module>{module}, registry = options.registry](const ast::Function& function, const std::string_view source) -> ast::expression_type
+		{
+			GSL_TRACE_SCOPE_DETAIL("lazy function body", "frontend", function.get_name());
+
+			ParseState state{string::string{filename}, ParseState::context_type{source.data(), source.size()}};
+			state.mod = weak_mod.lock();
+			state.registry = registry;
+			if (!state.mod)
+			{
+				// todo
+				throw std::runtime_error{"Cannot parse function body, its module is gone!"};
+			}
+
+			auto result = lexy::parse<grammar::lazy_function_body>(state.buffer, state, lexy_ext::report_error.opts({.flags = lexy::visualize_fancy}).path(state.filename.c_str()));
+			if (!result.is_success())
+			{
+				// the lines reported above are relative to the body
+				(void)std::fprintf(stderr, "in the body of function '%s'\n", string::string{function.get_name()}.c_str());
+				// todo: handle it?
+				throw std::runtime_error{"Cannot parse function body!"};
+			}
+
+			return result.value();
+		};
+	}
+
+	auto parse_file(const string::string_view filename, const parse_options& options) -> ast::module_type
+	{
+		GSL_TRACE_SCOPE_DETAIL("parse file", "frontend", filename);
+
+		auto file = [filename]
+		{
+			GSL_TRACE_SCOPE("read file", "frontend");
+			return lexy::read_file<lexy::utf8_encoding>(filename.data());
+		}();
 
 		if (!file)
 		{
@@ -563,9 +970,23 @@ namespace gal::gsl::frontend
 		}
 
 		ParseState state{string::string{filename}, std::move(file).buffer()};
+		state.registry = options.registry;
 
-		if (const auto result = lexy::parse<grammar::module_declaration>(state.buffer, state, lexy_ext::report_error.opts({.flags = lexy::visualize_fancy}).path(state.filename.c_str()));
-			!result.is_success())
+		if (options.lazy_function_bodies)
+		{
+			// the lazy bodies keep it alive until they are all parsed
+			state.lazy_source = memory::make_shared<string::string>(reinterpret_cast<const char*>(state.buffer.data()), state.buffer.size());
+		}
+
+		if (const auto result = [&state, lazy = options.lazy_function_bodies]
+				{
+					GSL_TRACE_SCOPE("parse", "frontend");
+
+					const auto report = lexy_ext::report_error.opts({.flags = lexy::visualize_fancy}).path(state.filename.c_str());
+					if (lazy) { return lexy::parse<grammar::lazy_module_declaration>(state.buffer, state, report).is_success(); }
+					return lexy::parse<grammar::module_declaration>(state.buffer, state, report).is_success();
+				}();
+			!result)
 		{
 			// todo: handle it?
 			throw std::runtime_error{"Cannot parse file!"};
@@ -573,4 +994,138 @@ namespace gal::gsl::frontend
 
 		return state.mod;
 	}
+
+	auto parse_module_header(const string::string_view filename) -> module_header
+	{
+		GSL_TRACE_SCOPE_DETAIL("parse module header", "frontend", filename);
+
+		const string::string path{filename};
+
+		const std::unique_ptr<std::FILE, decltype(&std::fclose)> file{std::fopen(path.c_str(), "rb"), &std::fclose};
+		if (!file)
+		{
+			// todo
+			throw std::runtime_error{"Cannot read file!"};
+		}
+
+		DeclarationSplitter splitter{file.get()};
+		ast::module_type mod;
+
+		while (auto declaration = splitter.next())
+		{
+			auto& [source, line] = *declaration;
+
+			// the imports precede every other declaration, the rest of the file is not read
+			if (mod && !is_import_declaration(source)) { break; }
+
+			ParseState state{string::string{path}, ParseState::context_type{source.data(), source.size()}};
+			state.mod = mod;
+
+			if (const auto result = [&state, is_header = !mod]
+					{
+						const auto report = lexy_ext::report_error.opts({.flags = lexy::visualize_fancy}).path(state.filename.c_str());
+						if (is_header) { return lexy::parse<grammar::streaming_module_header>(state.buffer, state, report).is_success(); }
+						return lexy::parse<grammar::streaming_import>(state.buffer, state, report).is_success();
+					}();
+				!result)
+			{
+				// the lines reported above are relative to the declaration
+				(void)std::fprintf(stderr, "in the declaration starting at line %zu\n", line);
+				// todo: handle it?
+				throw std::runtime_error{"Cannot parse file!"};
+			}
+
+			if (!mod) { mod = std::move(state.mod); }
+		}
+
+		if (!mod)
+		{
+			// todo
+			throw std::runtime_error{"Cannot parse file!"};
+		}
+
+		return {.name = symbol_name{mod->get_name()}, .imports = mod->get_imports()};
+	}
+
+	auto parse_file_streaming(const string::string_view filename, const streaming_handler& handler) -> ast::module_type
+	{
+		GSL_TRACE_SCOPE_DETAIL("parse file streaming", "frontend", filename);
+
+		const string::string path{filename};
+
+		const std::unique_ptr<std::FILE, decltype(&std::fclose)> file{std::fopen(path.c_str(), "rb"), &std::fclose};
+		if (!file)
+		{
+			// todo
+			throw std::runtime_error{"Cannot read file!"};
+		}
+
+		DeclarationSplitter splitter{file.get()};
+		ast::module_type mod;
+		// like module_declaration, the imports precede every other declaration: one after them is parsed (and rejected) as any other
+		bool in_imports = true;
+
+		while (auto declaration = splitter.next())
+		{
+			auto& [source, line] = *declaration;
+
+			ParseState state{string::string{path}, ParseState::context_type{source.data(), source.size()}};
+			state.mod = mod;
+
+			in_imports = in_imports && (!mod || is_import_declaration(source));
+			if (const auto result = [&state, is_header = !mod, in_imports]
+					{
+						GSL_TRACE_SCOPE("parse declaration", "frontend");
+
+						const auto report = lexy_ext::report_error.opts({.flags = lexy::visualize_fancy}).path(state.filename.c_str());
+						if (is_header) { return lexy::parse<grammar::streaming_module_header>(state.buffer, state, report).is_success(); }
+						if (in_imports) { return lexy::parse<grammar::streaming_import>(state.buffer, state, report).is_success(); }
+						return lexy::parse<grammar::streaming_declaration>(state.buffer, state, report).is_success();
+					}();
+				!result)
+			{
+				// the lines reported above are relative to the declaration
+				(void)std::fprintf(stderr, "in the declaration starting at line %zu\n", line);
+				// todo: handle it?
+				throw std::runtime_error{"Cannot parse file!"};
+			}
+
+			if (!mod)
+			{
+				mod = std::move(state.mod);
+				continue;
+			}
+
+			if (state.current_structure)
+			{
+				if (handler.on_structure) { handler.on_structure(*mod, state.current_structure); }
+			}
+			else if (state.current_global)
+			{
+				if (handler.on_global)
+				{
+					const auto name = symbol_name{state.current_global->get_name()};
+					handler.on_global(*mod, std::move(state.current_global));
+					(void)mod->unregister_global(name);
+				}
+			}
+			else if (state.current_function)
+			{
+				if (handler.on_function)
+				{
+					const auto name = symbol_name{state.current_function->get_name()};
+					handler.on_function(*mod, std::move(state.current_function));
+					(void)mod->unregister_function(name);
+				}
+			}
+		}
+
+		if (!mod)
+		{
+			// todo
+			throw std::runtime_error{"Cannot parse file!"};
+		}
+
+		return mod;
+	}
 }
@@ -0,0 +1,243 @@
+#include <gsl/logger/async.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+	namespace logger = gal::gsl::logger;
+
+	// Bounded multi-producer queue (Dmitry Vyukov's MPMC ring buffer), only one thread consumes it.
+	// Every slot carries a sequence number, producers claim a position with one CAS and publish it with a release store,
+	// so neither side ever takes a lock.
+	class MessageQueue
+	{
+	public:
+		struct slot
+		{
+			std::atomic<std::size_t> sequence;
+			logger::level level;
+			std::size_t length;
+			char message[logger::logger_detail::async_message_size];
+		};
+
+	private:
+		std::size_t mask_;
+		std::unique_ptr<slot[]> slots_;
+
+		alignas(64) std::atomic<std::size_t> enqueue_position_;
+		alignas(64) std::atomic<std::size_t> dequeue_position_;
+
+	public:
+		explicit MessageQueue(const std::size_t size)
+			: mask_{std::bit_ceil(std::max(size, std::size_t{2})) - 1},
+			slots_{std::make_unique<slot[]>(mask_ + 1)},
+			enqueue_position_{0},
+			dequeue_position_{0} { for (std::size_t i = 0; i <= mask_; ++i) { slots_[i].sequence.store(i, std::memory_order_relaxed); } }
+
+		// return false if the queue is full
+		[[nodiscard]] auto try_push(const logger::level level, const std::string_view message) noexcept -> bool
+		{
+			auto position = enqueue_position_.load(std::memory_order_relaxed);
+
+			while (true)
+			{
+				auto& s = slots_[position & mask_];
+				const auto sequence = s.sequence.load(std::memory_order_acquire);
+
+				if (const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+					diff == 0)
+				{
+					if (enqueue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					{
+						s.level = level;
+						s.length = std::min(message.size(), sizeof(s.message));
+						std::ranges::copy_n(message.data(), static_cast<std::ptrdiff_t>(s.length), s.message);
+
+						s.sequence.store(position + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (diff < 0)
+				{
+					// full
+					return false;
+				}
+				else { position = enqueue_position_.load(std::memory_order_relaxed); }
+			}
+		}
+
+		// single consumer
+		template<typename Function>
+		[[nodiscard]] auto try_pop(Function function) -> bool
+		{
+			const auto position = dequeue_position_.load(std::memory_order_relaxed);
+			auto& s = slots_[position & mask_];
+
+			if (s.sequence.load(std::memory_order_acquire) != position + 1) { return false; }
+
+			dequeue_position_.store(position + 1, std::memory_order_relaxed);
+			function(s.level, std::string_view{s.message, s.length});
+			s.sequence.store(position + mask_ + 1, std::memory_order_release);
+
+			return true;
+		}
+	};
+
+	auto sink([[maybe_unused]] const logger::level level, [[maybe_unused]] const std::string_view message) -> void
+	{
+		#ifndef GSL_NO_LOGGER
+		spdlog::default_logger_raw()->log(static_cast<spdlog::level::level_enum>(level), message);
+		#endif
+	}
+
+	struct async_state
+	{
+		// guards start/stop only
+		std::mutex mutex;
+
+		std::atomic<bool> enabled{false};
+		std::atomic<bool> running{false};
+		std::atomic<std::size_t> dropped{0};
+		// producers currently inside async_log, the queue is neither drained for the last time nor replaced while any is left
+		std::atomic<std::size_t> producers{0};
+		logger::overflow_policy policy{logger::overflow_policy::BLOCK};
+
+		std::unique_ptr<MessageQueue> queue;
+		std::thread worker;
+
+		[[nodiscard]] static auto instance() -> async_state&
+		{
+			static async_state state;
+			return state;
+		}
+
+		auto wait_for_producers() const -> void
+		{
+			while (producers.load(std::memory_order_seq_cst) != 0) { std::this_thread::yield(); }
+		}
+
+		auto drain() const -> bool
+		{
+			bool any = false;
+			while (queue->try_pop(sink)) { any = true; }
+			return any;
+		}
+
+		auto work() const -> void
+		{
+			using namespace std::chrono_literals;
+
+			// back off when idle, producers never notify (no syscall on their path)
+			auto idle = 0;
+			while (running.load(std::memory_order_acquire))
+			{
+				if (drain())
+				{
+					idle = 0;
+					continue;
+				}
+
+				if (++idle < 64) { std::this_thread::yield(); }
+				else { std::this_thread::sleep_for(idle < 1024 ? 50us : 1ms); }
+			}
+
+			(void)drain();
+			#ifndef GSL_NO_LOGGER
+			spdlog::default_logger_raw()->flush();
+			#endif
+		}
+	};
+}
+
+namespace gal::gsl::logger
+{
+	namespace logger_detail
+	{
+		auto is_async() noexcept -> bool { return async_state::instance().enabled.load(std::memory_order_acquire); }
+
+		auto async_log(const level l, const std::string_view message) -> void
+		{
+			auto& state = async_state::instance();
+
+			// announce ourselves before looking at the queue, stop_async clears `enabled` and then waits for us
+			state.producers.fetch_add(1, std::memory_order_seq_cst);
+			struct leave
+			{
+				async_state& state;
+
+				~leave() noexcept { state.producers.fetch_sub(1, std::memory_order_release); }
+			} guard{state};
+
+			// stopped since is_async, write it ourselves
+			if (!state.enabled.load(std::memory_order_seq_cst))
+			{
+				sink(l, message);
+				return;
+			}
+
+			if (state.queue->try_push(l, message)) { return; }
+
+			if (state.policy == overflow_policy::DISCARD)
+			{
+				state.dropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+
+			for (auto spin = 0; !state.queue->try_push(l, message); ++spin)
+			{
+				// stopping, the sink thread may be gone soon
+				if (!state.enabled.load(std::memory_order_seq_cst))
+				{
+					sink(l, message);
+					return;
+				}
+
+				if (spin < 64) { continue; }
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	auto start_async(const async_options& options) -> bool
+	{
+		auto& state = async_state::instance();
+		std::scoped_lock lock{state.mutex};
+
+		if (state.running.load(std::memory_order_relaxed)) { return false; }
+
+		// a producer that saw the previous queue may still be leaving
+		state.wait_for_producers();
+		state.queue = std::make_unique<MessageQueue>(options.queue_size);
+		state.policy = options.policy;
+		state.dropped.store(0, std::memory_order_relaxed);
+
+		state.running.store(true, std::memory_order_release);
+		state.worker = std::thread{[&state] { state.work(); }};
+		state.enabled.store(true, std::memory_order_release);
+
+		return true;
+	}
+
+	auto stop_async() -> void
+	{
+		auto& state = async_state::instance();
+		std::scoped_lock lock{state.mutex};
+
+		if (!state.running.load(std::memory_order_relaxed)) { return; }
+
+		// new producers go synchronous from now on, the ones already in flight finish their push (or fall back) before the last drain
+		state.enabled.store(false, std::memory_order_seq_cst);
+		state.wait_for_producers();
+
+		state.running.store(false, std::memory_order_release);
+		state.worker.join();
+	}
+
+	auto dropped_messages() noexcept -> std::size_t { return async_state::instance().dropped.load(std::memory_order_relaxed); }
+}
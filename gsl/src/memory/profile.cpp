@@ -0,0 +1,264 @@
+#include <gsl/memory/profile.hpp>
+
+#ifdef GSL_MEMORY_PROFILE
+#include <gsl/memory/raw.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <ranges>
+#include <unordered_map>
+
+#ifdef GSL_MEMORY_BACKEND_BDWGC
+#include <gc.h>
+#endif
+
+namespace
+{
+	namespace profile = gal::gsl::memory::profile;
+
+	struct site_key
+	{
+		const char* file;
+		const char* function;
+		std::uint32_t line;
+
+		[[nodiscard]] friend auto operator==(const site_key&, const site_key&) noexcept -> bool = default;
+	};
+
+	struct site_key_hasher
+	{
+		[[nodiscard]] auto operator()(const site_key& key) const noexcept -> std::size_t
+		{
+			// the strings of a source_location are static, their address is their identity
+			auto hash = std::hash<const void*>{}(key.file);
+			hash ^= std::hash<const void*>{}(key.function) + 0x9e37'79b9'7f4a'7c15 + (hash << 6) + (hash >> 2);
+			hash ^= std::hash<std::uint32_t>{}(key.line) + 0x9e37'79b9'7f4a'7c15 + (hash << 6) + (hash >> 2);
+			return hash;
+		}
+	};
+
+	struct sample
+	{
+		profile::allocation_site* site;
+		// the bytes this sample stands for
+		std::size_t weight;
+		profile::allocation_kind kind;
+	};
+
+	// Note: std containers on purpose, gc allocations would be sampled themselves.
+	struct registry
+	{
+		std::mutex mutex;
+		std::unordered_map<site_key, profile::allocation_site, site_key_hasher> sites;
+		std::unordered_map<const void*, sample> samples;
+		// samples.size(), read without the lock: deallocate does not lock while nothing is sampled
+		std::atomic<std::size_t> live_samples{0};
+		std::atomic<std::size_t> interval{profile::default_sample_interval};
+
+		[[nodiscard]] static auto instance() -> registry&
+		{
+			static registry r;
+			return r;
+		}
+
+		// the lock is held
+		auto forget(const decltype(samples)::iterator it) noexcept -> void
+		{
+			auto& [site, weight, kind] = it->second;
+			site->live_bytes -= weight;
+			site->live_objects -= 1;
+
+			samples.erase(it);
+			live_samples.fetch_sub(1, std::memory_order_relaxed);
+		}
+	};
+
+	// bytes this thread allocates before its next sample, an exponential draw keeps the samples independent of the allocation pattern
+	struct thread_sampler
+	{
+		std::minstd_rand random{std::random_device{}()};
+		std::int64_t countdown = -1;
+		std::size_t interval = 0;
+
+		auto draw(const std::size_t mean) -> void
+		{
+			interval = mean;
+			countdown = static_cast<std::int64_t>(std::exponential_distribution<double>{1.0 / static_cast<double>(mean)}(random)) + 1;
+		}
+	};
+
+	[[nodiscard]] auto current_sampler() noexcept -> thread_sampler&
+	{
+		thread_local thread_sampler sampler{};
+		return sampler;
+	}
+
+	auto on_collected(void* object, void*) -> void
+	{
+		auto& r = registry::instance();
+		std::scoped_lock lock{r.mutex};
+
+		if (const auto it = r.samples.find(object);
+			it != r.samples.end()) { r.forget(it); }
+	}
+
+	#ifdef GSL_MEMORY_BACKEND_BDWGC
+	using finalizer_type = GC_finalization_proc;
+	#else
+	using finalizer_type = auto (*)(void*, void*) -> void;
+	#endif
+
+	// nullptr ==> unregister
+	// nothing is collected without the collector, an object is only forgotten when it is deallocated
+	auto watch([[maybe_unused]] void* object, const profile::allocation_kind kind, [[maybe_unused]] const finalizer_type finalizer) -> void
+	{
+		switch (kind)
+		{
+			case profile::allocation_kind::COLLECTABLE:
+			{
+				#if defined(GSL_MEMORY_BACKEND_BDWGC) && defined(GSL_MEMORY_DEBUG)
+				GC_debug_register_finalizer_no_order(object, finalizer, nullptr, nullptr, nullptr);
+				#elif defined(GSL_MEMORY_BACKEND_BDWGC)
+				GC_register_finalizer_no_order(object, finalizer, nullptr, nullptr, nullptr);
+				#endif
+				break;
+			}
+			case profile::allocation_kind::TYPED:
+			{
+				#ifdef GSL_MEMORY_BACKEND_BDWGC
+				GC_register_finalizer_no_order(object, finalizer, nullptr, nullptr, nullptr);
+				#endif
+				break;
+			}
+			case profile::allocation_kind::UNCOLLECTABLE: { break; }
+		}
+	}
+}
+
+namespace gal::gsl::memory::profile
+{
+	auto set_sample_interval(const std::size_t bytes) noexcept -> void { registry::instance().interval.store(bytes, std::memory_order_relaxed); }
+
+	auto get_sample_interval() noexcept -> std::size_t { return registry::instance().interval.load(std::memory_order_relaxed); }
+
+	auto on_allocate(void* object, const std::size_t size, const allocation_kind kind, const std::source_location& location) noexcept -> void
+	{
+		auto& sampler = current_sampler();
+
+		// fast path: one subtraction
+		sampler.countdown -= static_cast<std::int64_t>(size);
+		if (sampler.countdown > 0 || !object) { return; }
+
+		auto& r = registry::instance();
+		const auto mean = r.interval.load(std::memory_order_relaxed);
+		if (mean == 0)
+		{
+			sampler.countdown = std::numeric_limits<std::int64_t>::max();
+			return;
+		}
+
+		// the first allocation of the thread (or a changed interval) only draws the countdown
+		if (sampler.interval != mean)
+		{
+			sampler.draw(mean);
+			return;
+		}
+		sampler.draw(mean);
+
+		// an allocation of `size` bytes is sampled with a probability of 1 - e^(-size / mean)
+		const auto probability = -std::expm1(-static_cast<double>(size) / static_cast<double>(mean));
+		const auto weight = static_cast<std::size_t>(static_cast<double>(size) / probability);
+
+		try
+		{
+			std::scoped_lock lock{r.mutex};
+
+			auto& site = r.sites.try_emplace(
+					site_key{.file = location.file_name(), .function = location.function_name(), .line = location.line()},
+					allocation_site{.file = location.file_name(), .function = location.function_name(), .line = location.line(), .live_bytes = 0, .live_objects = 0, .allocated_bytes = 0, .allocated_objects = 0}).first->second;
+			site.allocated_bytes += weight;
+			site.allocated_objects += 1;
+
+			if (const auto [it, inserted] = r.samples.try_emplace(object, sample{.site = &site, .weight = weight, .kind = kind});
+				inserted)
+			{
+				site.live_bytes += weight;
+				site.live_objects += 1;
+				r.live_samples.fetch_add(1, std::memory_order_relaxed);
+
+				watch(object, kind, on_collected);
+			}
+		}
+		catch (...)
+		{
+			// lost sample
+		}
+	}
+
+	auto on_deallocate(void* object) noexcept -> void
+	{
+		auto& r = registry::instance();
+		if (!object || r.live_samples.load(std::memory_order_relaxed) == 0) { return; }
+
+		std::scoped_lock lock{r.mutex};
+
+		if (const auto it = r.samples.find(object);
+			it != r.samples.end())
+		{
+			// freed before being collected, the collector must not call us for the memory it reuses
+			watch(object, it->second.kind, nullptr);
+			r.forget(it);
+		}
+	}
+
+	auto report() -> std::vector<allocation_site>
+	{
+		auto& r = registry::instance();
+
+		std::vector<allocation_site> result{};
+		{
+			std::scoped_lock lock{r.mutex};
+
+			result.reserve(r.sites.size());
+			for (const auto& site: r.sites | std::views::values) { result.push_back(site); }
+		}
+
+		std::ranges::sort(result, std::ranges::greater{}, &allocation_site::live_bytes);
+		return result;
+	}
+
+	auto dump(const string::string_view filename) -> bool
+	{
+		const auto sites = report();
+
+		auto* file = std::fopen(filename.data(), "w");
+		if (!file) { return false; }
+
+		(void)std::fprintf(file, "live_bytes\tlive_objects\tallocated_bytes\tallocated_objects\tsite\tfunction\n");
+		for (const auto& [site_file, function, line, live_bytes, live_objects, allocated_bytes, allocated_objects]: sites)
+		{
+			(void)std::fprintf(file, "%zu\t%zu\t%zu\t%zu\t%s:%u\t%s\n", live_bytes, live_objects, allocated_bytes, allocated_objects, site_file, static_cast<unsigned>(line), function);
+		}
+
+		return std::fclose(file) == 0;
+	}
+
+	auto clear() noexcept -> void
+	{
+		auto& r = registry::instance();
+		std::scoped_lock lock{r.mutex};
+
+		for (const auto& [object, sample]: r.samples) { watch(const_cast<void*>(object), sample.kind, nullptr); }
+
+		r.samples.clear();
+		r.sites.clear();
+		r.live_samples.store(0, std::memory_order_relaxed);
+	}
+}
+#endif
@@ -1,5 +1,7 @@
 #include <gsl/memory/raw.hpp>
+#include <gsl/debug/assert.hpp>
 
+#ifdef GSL_MEMORY_BACKEND_BDWGC
 #ifdef GSL_MEMORY_DEBUG
 #define GSL_IMPL_MALLOC GC_debug_malloc
 #define GSL_IMPL_MALLOC_ATOMIC GC_debug_malloc_atomic
@@ -15,23 +17,239 @@
 	#define GSL_IMPL_REALLOC GC_realloc
 	#define GSL_IMPL_FREE GC_free
 #endif
+// no debug header
+#define GSL_IMPL_MALLOC_TYPED GC_malloc_explicitly_typed
+#define GSL_IMPL_CALLOC_TYPED GC_calloc_explicitly_typed
+#define GSL_IMPL_FREE_TYPED GC_free
 
 #include <gc.h>
+#include <gc_typed.h>
+
+#ifdef GSL_TRACE
+#include <gsl/debug/trace.hpp>
+
+namespace
+{
+	namespace trace = gal::gsl::debug::trace;
+
+	// The collector reports its phases from the collecting thread with the allocation lock held,
+	// so the begin timestamps do not need any extra synchronization.
+	auto on_collection_event(const GC_EventType event) -> void
+	{
+		static trace::time_point_type collection_begin = 0;
+		static trace::time_point_type mark_begin = 0;
+		static trace::time_point_type reclaim_begin = 0;
+
+		switch (event)
+		{
+			case GC_EVENT_START:
+			{
+				collection_begin = trace::now();
+				break;
+			}
+			case GC_EVENT_MARK_START:
+			{
+				mark_begin = trace::now();
+				break;
+			}
+			case GC_EVENT_MARK_END:
+			{
+				trace::record("mark", "memory", mark_begin, trace::now());
+				break;
+			}
+			case GC_EVENT_RECLAIM_START:
+			{
+				reclaim_begin = trace::now();
+				break;
+			}
+			case GC_EVENT_RECLAIM_END:
+			{
+				trace::record("reclaim", "memory", reclaim_begin, trace::now());
+				break;
+			}
+			case GC_EVENT_END:
+			{
+				trace::record("collection", "memory", collection_begin, trace::now());
+				break;
+			}
+			default: { break; }
+		}
+	}
+
+	[[maybe_unused]] const auto collection_event_installer = []
+	{
+		GC_set_on_collection_event(on_collection_event);
+		return true;
+	}();
+}
+#endif
+
+#else
+#include <cstdlib>
+
+#ifdef GSL_MEMORY_BACKEND_SIZE_CLASS
+#include <gsl/memory/size_class.hpp>
+#endif
+
+namespace
+{
+	namespace backend
+	{
+		#ifdef GSL_MEMORY_BACKEND_SIZE_CLASS
+		namespace size_class = gal::gsl::memory::size_class;
+
+		[[nodiscard]] auto allocate(const std::size_t size) noexcept -> void* { return size_class::allocate(size); }
+
+		[[nodiscard]] auto allocate_zeroed(const std::size_t size) noexcept -> void* { return size_class::allocate_zeroed(size); }
+
+		[[nodiscard]] auto reallocate(void* object, const std::size_t size) noexcept -> void* { return size_class::reallocate(object, size); }
+
+		auto deallocate(void* object) noexcept -> void { size_class::deallocate(object); }
+		#else
+		[[nodiscard]] auto allocate(const std::size_t size) noexcept -> void* { return std::malloc(size); }
+
+		[[nodiscard]] auto allocate_zeroed(const std::size_t size) noexcept -> void* { return std::calloc(1, size); }
+
+		[[nodiscard]] auto reallocate(void* object, const std::size_t size) noexcept -> void* { return std::realloc(object, size); }
+
+		auto deallocate(void* object) noexcept -> void { std::free(object); }
+		#endif
+	}
+
+	// same contract as the collector: zeroed if it may hold pointers, the site (GSL_MEMORY_DEBUG) is ignored
+
+	[[nodiscard]] auto malloc_zeroed(const std::size_t size, const auto&...) noexcept -> void* { return backend::allocate_zeroed(size); }
+
+	[[nodiscard]] auto malloc_atomic(const std::size_t size, const auto&...) noexcept -> void* { return backend::allocate(size); }
+
+	[[nodiscard]] auto realloc_object(void* object, const std::size_t size, const auto&...) noexcept -> void* { return backend::reallocate(object, size); }
+
+	auto free_object(void* object) noexcept -> void { backend::deallocate(object); }
+
+	[[nodiscard]] auto malloc_typed(const std::size_t size, const gal::gsl::memory::type_descriptor) noexcept -> void* { return backend::allocate_zeroed(size); }
+
+	[[nodiscard]] auto calloc_typed(const std::size_t count, const std::size_t size, const gal::gsl::memory::type_descriptor) noexcept -> void* { return backend::allocate_zeroed(count * size); }
+}
+
+	#define GSL_IMPL_MALLOC malloc_zeroed
+	#define GSL_IMPL_MALLOC_ATOMIC malloc_atomic
+	#define GSL_IMPL_MALLOC_UNCOLLECTABLE malloc_zeroed
+	#define GSL_IMPL_MALLOC_ATOMIC_UNCOLLECTABLE malloc_atomic
+	#define GSL_IMPL_REALLOC realloc_object
+	#define GSL_IMPL_FREE free_object
+	#define GSL_IMPL_MALLOC_TYPED malloc_typed
+	#define GSL_IMPL_CALLOC_TYPED calloc_typed
+	#define GSL_IMPL_FREE_TYPED free_object
+#endif
+
+#ifdef GSL_MEMORY_PROFILE
+#include <gsl/memory/profile.hpp>
+
+namespace
+{
+	using gal::gsl::memory::profile::allocation_kind;
+
+	[[nodiscard]] auto sampled(void* object, const std::size_t size, const allocation_kind kind, const std::source_location& location) noexcept -> void*
+	{
+		gal::gsl::memory::profile::on_allocate(object, size, kind, location);
+		return object;
+	}
+}
+
+	#define GSL_MEMORY_SAMPLED(object, size, kind) sampled(object, size, allocation_kind::kind, location)
+	#define GSL_MEMORY_FORGET(object) gal::gsl::memory::profile::on_deallocate(object)
+#else
+	#define GSL_MEMORY_SAMPLED(object, size, kind) (object)
+	#define GSL_MEMORY_FORGET(object)
+#endif
+
+// without GSL_MEMORY_DEBUG the profiler only uses the location
+#if defined(GSL_MEMORY_PROFILE) && !defined(GSL_MEMORY_DEBUG)
+	#define GSL_MEMORY_UNUSED_MESSAGE(message) (void)(message)
+#else
+	#define GSL_MEMORY_UNUSED_MESSAGE(message)
+#endif
 
 namespace gal::gsl::memory
 {
-	auto allocate(const std::size_t size GSL_MEMORY_DEBUG_MESSAGE(message)) -> void* { return GSL_IMPL_MALLOC(size GSL_MEMORY_DEBUG_MESSAGE_USE(message)); }
+	auto allocate(const std::size_t size GSL_MEMORY_DEBUG_MESSAGE(message)) -> void*
+	{
+		GSL_MEMORY_UNUSED_MESSAGE(message);
+		return GSL_MEMORY_SAMPLED(GSL_IMPL_MALLOC(size GSL_MEMORY_DEBUG_MESSAGE_USE(message)), size, COLLECTABLE);
+	}
 
-	auto allocate_without_pointer(const std::size_t size GSL_MEMORY_DEBUG_MESSAGE(message)) -> void* { return GSL_IMPL_MALLOC_ATOMIC(size GSL_MEMORY_DEBUG_MESSAGE_USE(message)); }
+	auto allocate_without_pointer(const std::size_t size GSL_MEMORY_DEBUG_MESSAGE(message)) -> void*
+	{
+		GSL_MEMORY_UNUSED_MESSAGE(message);
+		return GSL_MEMORY_SAMPLED(GSL_IMPL_MALLOC_ATOMIC(size GSL_MEMORY_DEBUG_MESSAGE_USE(message)), size, COLLECTABLE);
+	}
 
-	auto allocate_without_collect(const std::size_t size GSL_MEMORY_DEBUG_MESSAGE(message)) -> void* { return GSL_IMPL_MALLOC_UNCOLLECTABLE(size GSL_MEMORY_DEBUG_MESSAGE_USE(message)); }
+	auto allocate_without_collect(const std::size_t size GSL_MEMORY_DEBUG_MESSAGE(message)) -> void*
+	{
+		GSL_MEMORY_UNUSED_MESSAGE(message);
+		return GSL_MEMORY_SAMPLED(GSL_IMPL_MALLOC_UNCOLLECTABLE(size GSL_MEMORY_DEBUG_MESSAGE_USE(message)), size, UNCOLLECTABLE);
+	}
 
-	auto allocate_without_collect_and_pointer(const std::size_t size GSL_MEMORY_DEBUG_MESSAGE(message)) -> void* { return GSL_IMPL_MALLOC_ATOMIC_UNCOLLECTABLE(size GSL_MEMORY_DEBUG_MESSAGE_USE(message)); }
+	auto allocate_without_collect_and_pointer(const std::size_t size GSL_MEMORY_DEBUG_MESSAGE(message)) -> void*
+	{
+		GSL_MEMORY_UNUSED_MESSAGE(message);
+		return GSL_MEMORY_SAMPLED(GSL_IMPL_MALLOC_ATOMIC_UNCOLLECTABLE(size GSL_MEMORY_DEBUG_MESSAGE_USE(message)), size, UNCOLLECTABLE);
+	}
 
-	auto reallocate(void* old_object, const std::size_t required_size GSL_MEMORY_DEBUG_MESSAGE(message)) -> void* { return GSL_IMPL_REALLOC(old_object, required_size GSL_MEMORY_DEBUG_MESSAGE_USE(message)); }
+	auto make_type_descriptor(const std::span<const std::uintptr_t> bitmap, const std::size_t word_count) -> type_descriptor
+	{
+		gsl_assert(bitmap.size() * bits_per_bitmap_word >= word_count, "bitmap too small!");
+
+		#ifdef GSL_MEMORY_BACKEND_BDWGC
+		static_assert(sizeof(GC_word) == sizeof(std::uintptr_t) && sizeof(GC_descr) == sizeof(type_descriptor));
+		return GC_make_descriptor(reinterpret_cast<const GC_word*>(bitmap.data()), word_count);
+		#else
+		// nothing scans the objects
+		return 0;
+		#endif
+	}
+
+	auto allocate_typed(const std::size_t size, const type_descriptor descriptor GSL_MEMORY_DEBUG_MESSAGE(message)) -> void*
+	{
+		#if defined(GSL_MEMORY_DEBUG) || defined(GSL_MEMORY_PROFILE)
+		(void)message;
+		(void)location;
+		#endif
+		return GSL_MEMORY_SAMPLED(GSL_IMPL_MALLOC_TYPED(size, descriptor), size, TYPED);
+	}
+
+	auto allocate_typed_array(const std::size_t count, const std::size_t size, const type_descriptor descriptor GSL_MEMORY_DEBUG_MESSAGE(message)) -> void*
+	{
+		#if defined(GSL_MEMORY_DEBUG) || defined(GSL_MEMORY_PROFILE)
+		(void)message;
+		(void)location;
+		#endif
+		return GSL_MEMORY_SAMPLED(GSL_IMPL_CALLOC_TYPED(count, size, descriptor), count * size, TYPED);
+	}
+
+	auto reallocate(void* old_object, const std::size_t required_size GSL_MEMORY_DEBUG_MESSAGE(message)) -> void*
+	{
+		GSL_MEMORY_UNUSED_MESSAGE(message);
+		GSL_MEMORY_FORGET(old_object);
+		return GSL_MEMORY_SAMPLED(GSL_IMPL_REALLOC(old_object, required_size GSL_MEMORY_DEBUG_MESSAGE_USE(message)), required_size, COLLECTABLE);
+	}
 
 	auto deallocate(void* data) -> void
 	{
+		GSL_MEMORY_FORGET(data);
 		GSL_IMPL_FREE(data);
 	}
+
+	auto deallocate_typed(void* data) -> void
+	{
+		GSL_MEMORY_FORGET(data);
+		GSL_IMPL_FREE_TYPED(data);
+	}
+
+	auto collect() -> void
+	{
+		#ifdef GSL_MEMORY_BACKEND_BDWGC
+		GC_gcollect();
+		#endif
+	}
 }
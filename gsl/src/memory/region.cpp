@@ -0,0 +1,99 @@
+#include <gsl/memory/region.hpp>
+#include <gsl/debug/assert.hpp>
+
+#include <algorithm>
+
+namespace gal::gsl::memory
+{
+	namespace
+	{
+		thread_local Region* current_region = nullptr;
+	}
+
+	auto Region::grow(const size_type size, const size_type alignment) -> void
+	{
+		gsl_assert(alignment != 0 && (alignment & (alignment - 1)) == 0, "alignment must be a power of 2!");
+
+		// the chunk data is aligned to default_alignment, a stricter alignment may need some padding
+		const auto required = size + (alignment > default_alignment ? alignment - default_alignment : 0);
+
+		// the chunks after the current one are from before the last reset, reuse the next if big enough
+		if (auto* next = current_ ? current_->next : head_;
+			next && next->capacity >= required)
+		{
+			current_ = next;
+			cursor_ = next->begin();
+			return;
+		}
+
+		const auto capacity = std::ranges::max(chunk_size_, required);
+		auto* c = static_cast<chunk*>(allocate_without_collect(sizeof(chunk) + capacity));
+		reserved_ += capacity;
+
+		// keep the chain behind the new chunk, O(1) and nothing is lost
+		if (current_)
+		{
+			c->next = current_->next;
+			current_->next = c;
+		}
+		else
+		{
+			c->next = head_;
+			head_ = c;
+		}
+		c->capacity = capacity;
+
+		current_ = c;
+		cursor_ = c->begin();
+	}
+
+	Region::Region(const size_type chunk_size)
+		: chunk_size_{chunk_size},
+		head_{nullptr},
+		current_{nullptr},
+		cursor_{nullptr},
+		allocated_{0},
+		reserved_{0} {}
+
+	Region::~Region() noexcept
+	{
+		gsl_assert(current_region != this, "the region is still installed!");
+
+		release();
+	}
+
+	auto Region::current() noexcept -> Region* { return current_region; }
+
+	auto Region::reset() noexcept -> void
+	{
+		// the next allocation starts over from the first chunk
+		current_ = nullptr;
+		cursor_ = nullptr;
+		allocated_ = 0;
+	}
+
+	auto Region::release() noexcept -> void
+	{
+		while (head_)
+		{
+			auto* next = head_->next;
+			memory::deallocate(head_);
+			head_ = next;
+		}
+
+		reset();
+		reserved_ = 0;
+	}
+
+	auto Region::contains(const void* pointer) const noexcept -> bool
+	{
+		const auto* p = static_cast<const std::byte*>(pointer);
+		for (auto* c = head_; c; c = c->next) { if (p >= c->begin() && p < c->end()) { return true; } }
+		return false;
+	}
+
+	RegionScope::RegionScope(Region& region) noexcept
+		: previous_{current_region} { current_region = &region; }
+
+	RegionScope::~RegionScope() noexcept { current_region = previous_; }
+}
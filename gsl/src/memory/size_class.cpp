@@ -0,0 +1,220 @@
+#include <gsl/memory/size_class.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+namespace gal::gsl::memory::size_class
+{
+	namespace
+	{
+		// in front of every block
+		struct alignas(alignment) header
+		{
+			// class_count ==> large, from std::malloc
+			std::size_t size_class;
+			// large only
+			std::size_t size;
+		};
+
+		static_assert(sizeof(header) == alignment);
+
+		constexpr std::size_t large = class_count;
+
+		// the blocks are carved from spans of at least span_size bytes
+		constexpr std::size_t span_size = 64 * 1024;
+		// moved at once between a thread list and the central list
+		constexpr std::size_t batch_size = 32;
+
+		// linked through the (free) object
+		struct free_block
+		{
+			free_block* next;
+		};
+
+		[[nodiscard]] auto header_of(const void* object) noexcept -> header* { return static_cast<header*>(const_cast<void*>(object)) - 1; }
+
+		[[nodiscard]] auto object_of(header* h) noexcept -> void* { return h + 1; }
+
+		// Note: std::malloc on purpose, this is what memory::allocate* is made of.
+		struct central_list
+		{
+			std::mutex mutex;
+			free_block* head = nullptr;
+			std::size_t count = 0;
+		};
+
+		[[nodiscard]] auto central() noexcept -> std::array<central_list, class_count>&
+		{
+			// never destroyed, the threads exiting after main give their blocks back to it
+			static auto* lists = new std::array<central_list, class_count>{};
+			return *lists;
+		}
+
+		struct thread_list
+		{
+			free_block* head = nullptr;
+			std::size_t count = 0;
+		};
+
+		struct thread_cache
+		{
+			std::array<thread_list, class_count> lists{};
+
+			thread_cache() noexcept = default;
+			thread_cache(const thread_cache&) = delete;
+			auto operator=(const thread_cache&) -> thread_cache& = delete;
+			thread_cache(thread_cache&&) = delete;
+			auto operator=(thread_cache&&) -> thread_cache& = delete;
+
+			~thread_cache() noexcept
+			{
+				for (std::size_t index = 0; index < class_count; ++index)
+				{
+					while (lists[index].count != 0) { release(index, lists[index].count); }
+				}
+			}
+
+			// hand the first `count` blocks of a list back to the central list
+			auto release(const std::size_t index, const std::size_t count) noexcept -> void
+			{
+				auto& list = lists[index];
+
+				auto* first = list.head;
+				auto* last = first;
+				for (std::size_t i = 1; i < count; ++i) { last = last->next; }
+				list.head = last->next;
+				list.count -= count;
+
+				auto& c = central()[index];
+				std::scoped_lock lock{c.mutex};
+				last->next = c.head;
+				c.head = first;
+				c.count += count;
+			}
+
+			// false if out of memory
+			[[nodiscard]] auto refill(const std::size_t index) noexcept -> bool
+			{
+				auto& list = lists[index];
+				auto& c = central()[index];
+				std::scoped_lock lock{c.mutex};
+
+				if (!c.head)
+				{
+					// a new span, never given back
+					const auto block_size = sizeof(header) + size_of_class(index);
+					const auto blocks = std::ranges::max(span_size / block_size, batch_size);
+					auto* span = static_cast<std::byte*>(std::malloc(blocks * block_size));
+					if (!span) { return false; }
+
+					for (std::size_t i = blocks; i != 0; --i)
+					{
+						auto* h = reinterpret_cast<header*>(span + (i - 1) * block_size);
+						h->size_class = index;
+
+						auto* block = static_cast<free_block*>(object_of(h));
+						block->next = c.head;
+						c.head = block;
+					}
+					c.count += blocks;
+				}
+
+				for (std::size_t i = 0; i < batch_size && c.head; ++i)
+				{
+					auto* block = c.head;
+					c.head = block->next;
+					--c.count;
+
+					block->next = list.head;
+					list.head = block;
+					++list.count;
+				}
+				return true;
+			}
+		};
+
+		[[nodiscard]] auto current_cache() noexcept -> thread_cache&
+		{
+			thread_local thread_cache cache{};
+			return cache;
+		}
+	}
+
+	auto allocate(const std::size_t size) noexcept -> void*
+	{
+		if (size > max_size)
+		{
+			auto* h = static_cast<header*>(std::malloc(sizeof(header) + size));
+			if (!h) { return nullptr; }
+
+			h->size_class = large;
+			h->size = size;
+			return object_of(h);
+		}
+
+		const auto index = class_of(size);
+		auto& cache = current_cache();
+		auto& list = cache.lists[index];
+		if (!list.head && !cache.refill(index)) { return nullptr; }
+
+		auto* block = list.head;
+		list.head = block->next;
+		--list.count;
+		return block;
+	}
+
+	auto allocate_zeroed(const std::size_t size) noexcept -> void*
+	{
+		auto* object = allocate(size);
+		if (object) { std::memset(object, 0, size); }
+		return object;
+	}
+
+	auto reallocate(void* object, const std::size_t size) noexcept -> void*
+	{
+		if (!object) { return allocate(size); }
+
+		const auto old_size = usable_size(object);
+		if (size <= old_size && (header_of(object)->size_class == large || class_of(size) == header_of(object)->size_class)) { return object; }
+
+		auto* result = allocate(size);
+		if (!result) { return nullptr; }
+
+		std::memcpy(result, object, std::ranges::min(old_size, size));
+		deallocate(object);
+		return result;
+	}
+
+	auto deallocate(void* object) noexcept -> void
+	{
+		if (!object) { return; }
+
+		auto* h = header_of(object);
+		if (h->size_class == large)
+		{
+			std::free(h);
+			return;
+		}
+
+		const auto index = h->size_class;
+		auto& cache = current_cache();
+		auto& list = cache.lists[index];
+
+		auto* block = static_cast<free_block*>(object);
+		block->next = list.head;
+		list.head = block;
+		++list.count;
+
+		// a thread freeing what others allocate does not keep it all
+		if (list.count > 2 * batch_size) { cache.release(index, batch_size); }
+	}
+
+	auto usable_size(const void* object) noexcept -> std::size_t
+	{
+		const auto* h = header_of(object);
+		return h->size_class == large ? h->size : size_of_class(h->size_class);
+	}
+}
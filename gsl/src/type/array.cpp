@@ -0,0 +1,156 @@
+#include <gsl/type/array.hpp>
+
+#include <type_traits>
+
+// The kernels are plain loops over contiguous memory written so that the compiler can vectorize them
+// (no aliasing between reads and writes other than exact in-place updates, no loop-carried dependency).
+// Reductions keep one cache line of independent partial results, that is the reassociation
+// the compiler is not allowed to do on its own for floating point values.
+namespace
+{
+	namespace type = gal::gsl::type;
+
+	// integer arithmetic wraps around like the script expects instead of being undefined
+	template<typename T>
+	struct arithmetic
+	{
+		using type = T;
+	};
+
+	template<std::integral T>
+	struct arithmetic<T>
+	{
+		using type = std::make_unsigned_t<T>;
+	};
+
+	template<typename T>
+	using arithmetic_type = typename arithmetic<T>::type;
+
+	template<typename T>
+	constexpr std::size_t lanes = 64 / sizeof(T);
+
+	template<typename T, typename Function>
+	auto element_wise(const std::span<const T> lhs, const std::span<const T> rhs, const std::span<T> out, Function function) noexcept -> void
+	{
+		gsl_assert(lhs.size() == rhs.size() && lhs.size() == out.size(), "size mismatch!");
+
+		const auto* l = lhs.data();
+		const auto* r = rhs.data();
+		auto* o = out.data();
+		const auto size = out.size();
+
+		for (std::size_t i = 0; i < size; ++i)
+		{
+			o[i] = static_cast<T>(function(static_cast<arithmetic_type<T>>(l[i]), static_cast<arithmetic_type<T>>(r[i])));
+		}
+	}
+
+	template<typename T, typename Function>
+	[[nodiscard]] auto reduce(const std::span<const T> data, const arithmetic_type<T> init, Function function) noexcept -> arithmetic_type<T>
+	{
+		arithmetic_type<T> partial[lanes<T>];
+		std::ranges::fill(partial, init);
+
+		const auto* d = data.data();
+		const auto size = data.size();
+
+		std::size_t i = 0;
+		for (; i + lanes<T> <= size; i += lanes<T>)
+		{
+			for (std::size_t lane = 0; lane < lanes<T>; ++lane) { partial[lane] = function(partial[lane], static_cast<arithmetic_type<T>>(d[i + lane])); }
+		}
+		for (; i < size; ++i) { partial[0] = function(partial[0], static_cast<arithmetic_type<T>>(d[i])); }
+
+		auto result = partial[0];
+		for (std::size_t lane = 1; lane < lanes<T>; ++lane) { result = function(result, partial[lane]); }
+		return result;
+	}
+
+	constexpr auto plus = [](const auto lhs, const auto rhs) noexcept { return lhs + rhs; };
+	constexpr auto multiplies = [](const auto lhs, const auto rhs) noexcept { return static_cast<decltype(lhs)>(lhs * rhs); };
+	// for signed integers the unsigned representation does not keep the order, compare the original values
+	template<typename T>
+	constexpr auto minimum = [](const arithmetic_type<T> lhs, const arithmetic_type<T> rhs) noexcept { return static_cast<T>(rhs) < static_cast<T>(lhs) ? rhs : lhs; };
+	template<typename T>
+	constexpr auto maximum = [](const arithmetic_type<T> lhs, const arithmetic_type<T> rhs) noexcept { return static_cast<T>(lhs) < static_cast<T>(rhs) ? rhs : lhs; };
+}
+
+namespace gal::gsl::type::kernel
+{
+	template<array_element_t T>
+	auto add(const std::span<const T> lhs, const std::span<const T> rhs, const std::span<T> out) noexcept -> void { element_wise(lhs, rhs, out, plus); }
+
+	template<array_element_t T>
+	auto mul(const std::span<const T> lhs, const std::span<const T> rhs, const std::span<T> out) noexcept -> void { element_wise(lhs, rhs, out, multiplies); }
+
+	template<array_element_t T>
+	auto scale(const std::span<const T> lhs, const T scalar, const std::span<T> out) noexcept -> void
+	{
+		gsl_assert(lhs.size() == out.size(), "size mismatch!");
+
+		const auto* l = lhs.data();
+		auto* o = out.data();
+		const auto size = out.size();
+		const auto s = static_cast<arithmetic_type<T>>(scalar);
+
+		for (std::size_t i = 0; i < size; ++i) { o[i] = static_cast<T>(multiplies(static_cast<arithmetic_type<T>>(l[i]), s)); }
+	}
+
+	template<array_element_t T>
+	auto sum(const std::span<const T> data) noexcept -> T { return static_cast<T>(reduce(data, arithmetic_type<T>{0}, plus)); }
+
+	template<array_element_t T>
+	auto min(const std::span<const T> data) noexcept -> T
+	{
+		gsl_assert(!data.empty(), "min of nothing!");
+		return static_cast<T>(reduce(data, static_cast<arithmetic_type<T>>(data.front()), minimum<T>));
+	}
+
+	template<array_element_t T>
+	auto max(const std::span<const T> data) noexcept -> T
+	{
+		gsl_assert(!data.empty(), "max of nothing!");
+		return static_cast<T>(reduce(data, static_cast<arithmetic_type<T>>(data.front()), maximum<T>));
+	}
+
+	template<array_element_t T>
+	auto dot(const std::span<const T> lhs, const std::span<const T> rhs) noexcept -> T
+	{
+		gsl_assert(lhs.size() == rhs.size(), "size mismatch!");
+
+		arithmetic_type<T> partial[lanes<T>]{};
+
+		const auto* l = lhs.data();
+		const auto* r = rhs.data();
+		const auto size = lhs.size();
+
+		std::size_t i = 0;
+		for (; i + lanes<T> <= size; i += lanes<T>)
+		{
+			for (std::size_t lane = 0; lane < lanes<T>; ++lane)
+			{
+				partial[lane] += multiplies(static_cast<arithmetic_type<T>>(l[i + lane]), static_cast<arithmetic_type<T>>(r[i + lane]));
+			}
+		}
+		for (; i < size; ++i) { partial[0] += multiplies(static_cast<arithmetic_type<T>>(l[i]), static_cast<arithmetic_type<T>>(r[i])); }
+
+		auto result = partial[0];
+		for (std::size_t lane = 1; lane < lanes<T>; ++lane) { result += partial[lane]; }
+		return static_cast<T>(result);
+	}
+
+	#define GSL_ARRAY_KERNEL_INSTANTIATE(type)                                                                  \
+		template auto add<type>(std::span<const type>, std::span<const type>, std::span<type>) noexcept -> void; \
+		template auto mul<type>(std::span<const type>, std::span<const type>, std::span<type>) noexcept -> void; \
+		template auto scale<type>(std::span<const type>, type, std::span<type>) noexcept -> void;                \
+		template auto sum<type>(std::span<const type>) noexcept -> type;                                         \
+		template auto min<type>(std::span<const type>) noexcept -> type;                                         \
+		template auto max<type>(std::span<const type>) noexcept -> type;                                         \
+		template auto dot<type>(std::span<const type>, std::span<const type>) noexcept -> type;
+
+	GSL_ARRAY_KERNEL_INSTANTIATE(std::int32_t)
+	GSL_ARRAY_KERNEL_INSTANTIATE(float)
+	GSL_ARRAY_KERNEL_INSTANTIATE(double)
+
+	#undef GSL_ARRAY_KERNEL_INSTANTIATE
+}
@@ -0,0 +1,76 @@
+#include <gsl/type/function.hpp>
+#include <gsl/container/vector.hpp>
+#include <gsl/debug/assert.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+
+namespace gal::gsl::type
+{
+	auto BuiltinFunction::invoke(const std::span<const Value> arguments) const -> Value
+	{
+		gsl_assert(arguments.size() == arity_, "wrong number of arguments!");
+
+		return invoker_(arguments.data());
+	}
+
+	auto BuiltinFunction::invoke_batch(const std::span<const std::span<const Value>> columns, const std::span<Value> results, const batch_options& options) const -> void
+	{
+		gsl_assert(columns.size() == arity_, "wrong number of argument columns!");
+		gsl_assert(std::ranges::all_of(columns, [count = results.size()](const auto column) { return column.size() == count; }), "wrong number of rows!");
+
+		const auto count = results.size();
+		if (count == 0) { return; }
+
+		const auto wanted = options.threads == 0 ? std::ranges::max(std::thread::hardware_concurrency(), 1u) : options.threads;
+		const auto threads = std::ranges::max(std::ranges::min(wanted, count / std::ranges::max(options.min_rows_per_thread, std::size_t{1})), std::size_t{1});
+		const auto slice = (count + threads - 1) / threads;
+		// every one starts inside the columns (e.g. 5 rows on 4 threads ==> 3 slices of 2, 2 and 1 rows)
+		const auto slices = (count + slice - 1) / slice;
+
+		// the columns of every slice, computed here: the workers do not allocate
+		container::vector<const Value*> slice_columns(slices * arity_);
+		for (std::size_t i = 0; i < slices; ++i)
+		{
+			std::ranges::transform(columns, slice_columns.begin() + static_cast<std::ptrdiff_t>(i * arity_), [begin = i * slice](const auto column) { return column.data() + begin; });
+		}
+
+		const auto run = [&](const std::size_t i)
+		{
+			const auto begin = i * slice;
+			batch_invoker_(slice_columns.data() + i * arity_, results.data() + begin, std::ranges::min(slice, count - begin));
+		};
+
+		if (slices == 1)
+		{
+			run(0);
+			return;
+		}
+
+		container::vector<std::exception_ptr> exceptions(slices);
+		{
+			container::vector<std::jthread> workers;
+			workers.reserve(slices - 1);
+
+			// the calling thread runs the first slice
+			for (std::size_t i = 1; i < slices; ++i)
+			{
+				workers.emplace_back(
+						[&run, &exceptions, i]
+						{
+							try { run(i); }
+							catch (...) { exceptions[i] = std::current_exception(); }
+						});
+			}
+
+			try { run(0); }
+			catch (...) { exceptions[0] = std::current_exception(); }
+		}
+
+		for (const auto& exception: exceptions)
+		{
+			if (exception) { std::rethrow_exception(exception); }
+		}
+	}
+}
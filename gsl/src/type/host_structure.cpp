@@ -0,0 +1,28 @@
+#include <gsl/type/host_structure.hpp>
+
+#include <string>
+
+namespace gal::gsl::type
+{
+	namespace
+	{
+		[[nodiscard]] auto describe_binding(const ast::symbol_name_view structure, const ast::symbol_name_view field) -> std::string
+		{
+			std::string result{};
+			if (field.empty())
+			{
+				result.append("Cannot bind structure '").append(structure).append("', duplicate structure name!");
+			}
+			else
+			{
+				result.append("Cannot bind field '").append(field).append("' of structure '").append(structure).append("', duplicate field name or overlapping field!");
+			}
+			return result;
+		}
+	}
+
+	host_binding_error::host_binding_error(const ast::symbol_name_view structure, const ast::symbol_name_view field)
+		: std::runtime_error{describe_binding(structure, field)},
+		structure_{structure},
+		field_{field} {}
+}
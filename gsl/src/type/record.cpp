@@ -0,0 +1,29 @@
+#include <gsl/type/record.hpp>
+
+#include <cstring>
+
+namespace gal::gsl::type
+{
+	auto allocate_record(const ast::Structure& structure) -> void* { return allocate_records(structure, 1); }
+
+	auto allocate_records(const ast::Structure& structure, const std::size_t count) -> void*
+	{
+		const auto size = structure.get_size();
+
+		if (!structure.contains_pointer())
+		{
+			auto* records = memory::allocate_without_pointer(size * count);
+			std::memset(records, 0, size * count);
+			return records;
+		}
+
+		if (count == 1) { return memory::allocate_typed(size, structure.get_type_descriptor()); }
+		return memory::allocate_typed_array(count, size, structure.get_type_descriptor());
+	}
+
+	auto deallocate_records(const ast::Structure& structure, void* records) -> void
+	{
+		if (structure.contains_pointer()) { memory::deallocate_typed(records); }
+		else { memory::deallocate(records); }
+	}
+}
@@ -0,0 +1,127 @@
+#include <gsl/type/string.hpp>
+#include <gsl/container/unordered_map.hpp>
+#include <gsl/string/string.hpp>
+#include <gsl/memory/raw.hpp>
+#include <gsl/utility/utility.hpp>
+#include <gsl/debug/assert.hpp>
+
+#include <algorithm>
+#include <mutex>
+#include <ranges>
+
+namespace gal::gsl::type
+{
+	namespace
+	{
+		// the buffer of a heap string, only characters ==> not scanned
+		[[nodiscard]] auto allocate_characters(const std::size_t size) -> char* { return static_cast<char*>(memory::allocate_without_pointer(size)); }
+
+		class InternPool
+		{
+		private:
+			std::mutex mutex_;
+			// the keys view the buffers of the pool
+			container::unordered_map<std::string_view, const char*, utility::string_hasher<string::string>> strings_;
+
+		public:
+			[[nodiscard]] auto intern(const std::string_view string) -> const char*
+			{
+				std::scoped_lock lock{mutex_};
+
+				if (const auto it = strings_.find(string);
+					it != strings_.end()) { return it->second; }
+
+				// never collected, an interned string lives as long as the pool
+				auto* buffer = static_cast<char*>(memory::allocate_without_collect_and_pointer(string.size()));
+				std::ranges::copy(string, buffer);
+				strings_.emplace(std::string_view{buffer, string.size()}, buffer);
+				return buffer;
+			}
+
+			[[nodiscard]] auto size() -> std::size_t
+			{
+				std::scoped_lock lock{mutex_};
+				return strings_.size();
+			}
+
+			[[nodiscard]] auto strings() -> container::vector<std::string_view>
+			{
+				std::scoped_lock lock{mutex_};
+
+				container::vector<std::string_view> result{};
+				result.reserve(strings_.size());
+				for (const auto& string: strings_ | std::views::keys) { result.push_back(string); }
+				return result;
+			}
+		};
+
+		[[nodiscard]] auto intern_pool() -> InternPool&
+		{
+			static InternPool pool;
+			return pool;
+		}
+	}
+
+	String::String(const std::string_view string)
+		: String{}
+	{
+		gsl_assert(string.size() <= static_cast<size_type>(-1), "string too long!");
+
+		if (string.size() <= max_small_size)
+		{
+			std::ranges::copy(string, small_.data);
+			small_.size = static_cast<std::uint8_t>(string.size());
+			return;
+		}
+
+		auto* buffer = allocate_characters(string.size());
+		std::ranges::copy(string, buffer);
+		heap_ = {.data = buffer, .size = static_cast<size_type>(string.size()), .padding = {}, .tag = heap_tag};
+	}
+
+	auto String::intern(const std::string_view string) -> String
+	{
+		if (string.size() <= max_small_size) { return String{string}; }
+
+		return {intern_pool().intern(string), static_cast<size_type>(string.size()), interned_tag};
+	}
+
+	auto String::interned_count() -> std::size_t { return intern_pool().size(); }
+
+	auto String::interned_strings() -> container::vector<std::string_view> { return intern_pool().strings(); }
+
+	auto String::substr(const size_type position, const size_type count) const -> String
+	{
+		gsl_assert(position <= size(), "position out of range!");
+
+		const auto length = std::ranges::min(count, size() - position);
+		if (length <= max_small_size) { return String{std::string_view{data() + position, length}}; }
+
+		// a slice of a heap or interned buffer, both outlive the slice
+		return {heap_.data + position, length, heap_tag};
+	}
+
+	auto operator+(const String& lhs, const String& rhs) -> String
+	{
+		if (rhs.empty()) { return lhs; }
+		if (lhs.empty()) { return rhs; }
+
+		const auto size = static_cast<std::size_t>(lhs.size()) + rhs.size();
+		if (size <= String::max_small_size)
+		{
+			String result{};
+			std::ranges::copy(lhs.view(), result.small_.data);
+			std::ranges::copy(rhs.view(), result.small_.data + lhs.size());
+			result.small_.size = static_cast<std::uint8_t>(size);
+			return result;
+		}
+
+		gsl_assert(size <= static_cast<String::size_type>(-1), "string too long!");
+
+		auto* buffer = allocate_characters(size);
+		std::ranges::copy(rhs.view(), std::ranges::copy(lhs.view(), buffer).out);
+		return {buffer, static_cast<String::size_type>(size), String::heap_tag};
+	}
+
+	auto String::hash() const noexcept -> std::size_t { return utility::string_hasher<string::string>{}(view()); }
+}
@@ -0,0 +1,88 @@
+#include <gsl/type/structure_array.hpp>
+#include <gsl/type/record.hpp>
+
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+	namespace gsl = gal::gsl;
+
+	[[nodiscard]] auto allocate_block(const std::size_t size, const bool contains_pointer) -> std::pair<void*, std::byte*>
+	{
+		constexpr auto alignment = gsl::type::StructureArray::alignment;
+
+		// only the blocks that may contain pointer have to be scanned by the collector
+		auto* block = contains_pointer ? gsl::memory::allocate(size + alignment) : gsl::memory::allocate_without_pointer(size + alignment);
+		auto* aligned = reinterpret_cast<std::byte*>((reinterpret_cast<std::uintptr_t>(block) + alignment - 1) & ~(alignment - 1));
+
+		std::memset(aligned, 0, size);
+		return {block, aligned};
+	}
+}
+
+namespace gal::gsl::type
+{
+	StructureArray::StructureArray(ast::structure_type structure, const size_type size)
+		: structure_{std::move(structure)},
+		layout_{structure_->get_layout()},
+		size_{size}
+	{
+		const auto& fields = structure_->get_fields();
+		columns_.reserve(fields.size());
+
+		if (layout_ == layout_type::ARRAY_OF_STRUCTURES)
+		{
+			const auto record_size = structure_->get_size();
+
+			if (structure_->contains_pointer())
+			{
+				// typed records are only aligned as the collector aligns them, the fields are strided anyway
+				auto* records = allocate_records(*structure_, size_);
+				blocks_.push_back({.data = records, .records = structure_.get()});
+
+				for (const auto& field: fields) { columns_.push_back({.base = static_cast<std::byte*>(records) + field.offset, .stride = record_size}); }
+				return;
+			}
+
+			const auto [block, base] = allocate_block(record_size * size_, false);
+			blocks_.push_back({.data = block, .records = nullptr});
+
+			for (const auto& field: fields) { columns_.push_back({.base = base + field.offset, .stride = record_size}); }
+		}
+		else
+		{
+			blocks_.reserve(fields.size());
+
+			for (const auto& field: fields)
+			{
+				const auto& type = field.variable.type;
+				const auto field_size = type ? type->size() : 0;
+
+				// a column of records
+				if (type && !type->is_array() && type->type() == ast::TypeDeclaration::variable_type::STRUCTURE && type->owner() && type->contains_pointer())
+				{
+					auto* records = allocate_records(*type->owner(), size_);
+					blocks_.push_back({.data = records, .records = type->owner()});
+
+					columns_.push_back({.base = static_cast<std::byte*>(records), .stride = field_size});
+					continue;
+				}
+
+				const auto [block, base] = allocate_block(field_size * size_, !type || type->contains_pointer());
+				blocks_.push_back({.data = block, .records = nullptr});
+
+				columns_.push_back({.base = base, .stride = field_size});
+			}
+		}
+	}
+
+	StructureArray::~StructureArray() noexcept
+	{
+		for (const auto& [data, records]: blocks_)
+		{
+			if (records) { deallocate_records(*records, data); }
+			else { memory::deallocate(data); }
+		}
+	}
+}
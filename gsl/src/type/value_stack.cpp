@@ -0,0 +1,50 @@
+#include <gsl/type/value_stack.hpp>
+#include <gsl/type/function.hpp>
+
+#include <algorithm>
+
+namespace gal::gsl::type
+{
+	namespace
+	{
+		// the frames do not need as much as the slots, a frame has a few slots at least
+		constexpr std::size_t initial_frames = 256;
+	}
+
+	ValueStack::ValueStack(const size_type capacity, const size_type max_size, const size_type max_depth)
+		: slots_(std::ranges::min(capacity, max_size)),
+		max_size_{max_size},
+		max_depth_{max_depth}
+	{
+		frames_.reserve(std::ranges::min(initial_frames, std::size_t{max_depth}));
+		frames_.push_back({.base = 0, .size = 0});
+	}
+
+	auto ValueStack::grow(const std::uint64_t end) -> bool
+	{
+		if (end > max_size_) { return false; }
+
+		// doubling, the slots are addressed by index: the frames do not care where they are
+		slots_.resize(std::ranges::min(std::ranges::max(end, std::uint64_t{slots_.size()} * 2), std::uint64_t{max_size_}));
+		return true;
+	}
+
+	auto ValueStack::resize(const size_type size) -> bool
+	{
+		auto& f = current();
+		if (const auto end = static_cast<std::uint64_t>(f.base) + size;
+			end > slots_.size() && !grow(end)) { return false; }
+
+		if (size > f.size) { std::ranges::fill(slots_.begin() + f.base + f.size, slots_.begin() + f.base + size, Value{}); }
+		f.size = size;
+		return true;
+	}
+
+	auto ValueStack::call_builtin(const size_type first_argument, const BuiltinFunction& function) -> void
+	{
+		gsl_assert(first_argument < current().size && first_argument + function.get_arity() <= current().size, "arguments out of frame!");
+
+		auto& result = slots_[current().base + first_argument];
+		result = function.invoke({&result, function.get_arity()});
+	}
+}
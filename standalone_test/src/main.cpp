@@ -2,6 +2,7 @@
 #include <gsl/memory/allocator.hpp>
 #include <span>
 #include <gsl/frontend/parse.hpp>
+#include <gsl/debug/trace.hpp>
 
 auto main() -> int
 {
@@ -28,4 +29,27 @@ auto main() -> int
 		else { std::cout << "module '" << mod->get_name() << "' pass done...\n"; }
 	}
 	catch (const std::exception& e) { std::cout << "parse failed: " << e.what() << '\n'; }
+
+	try
+	{
+		// the function bodies are parsed on first use
+		const auto mod = gal::gsl::frontend::parse_file("test.txt", {.lazy_function_bodies = true});
+		std::cout << "module '" << mod->get_name() << "' lazily parsed...\n";
+	}
+	catch (const std::exception& e) { std::cout << "lazy parse failed: " << e.what() << '\n'; }
+
+	try
+	{
+		std::size_t globals = 0;
+		const auto mod = gal::gsl::frontend::parse_file_streaming(
+				"test.txt",
+				{.on_structure = {},
+				.on_global = [&globals](const auto&, const auto&) { ++globals; },
+				.on_function = {}});
+		std::cout << "module '" << mod->get_name() << "' streamed " << globals << " globals...\n";
+	}
+	catch (const std::exception& e) { std::cout << "streaming parse failed: " << e.what() << '\n'; }
+
+	// no-op unless tracing is enabled
+	(void)gal::gsl::debug::trace::dump("gsl_trace.json");
 }
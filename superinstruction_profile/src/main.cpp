@@ -0,0 +1,194 @@
+#include <gsl/backend/pass.hpp>
+#include <gsl/backend/superinstruction.hpp>
+#include <gsl/backend/type_check.hpp>
+
+#include <charconv>
+#include <cstdint>
+#include <iostream>
+#include <string_view>
+
+// Profiles the chains of specialized instructions of a corpus of checked (and optimized) functions, then writes
+// the profile as tab separated text followed by the selected set as the initializer of ir::superinstructions.
+// The selection stays manual: read the profile, then paste the table into superinstruction.hpp.
+//
+// superinstruction_profile [output file (superinstructions.tsv)] [table size (the size of the current set)]
+namespace
+{
+	namespace gsl = gal::gsl;
+	namespace ir = gsl::ir;
+
+	using ir::opcode;
+	using type = ir::type_t;
+
+	struct corpus
+	{
+		gsl::ast::structure_type range;
+		gsl::ast::structure_type particle;
+		ir::Module mod{"corpus"};
+	};
+
+	auto make_structures(corpus& c) -> void
+	{
+		using gsl::ast::Structure;
+		using gsl::ast::TypeDeclaration;
+
+		c.range = gsl::memory::make_shared<Structure>("range");
+		(void)c.range->register_field("begin", gsl::memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::INT));
+		(void)c.range->register_field("end", gsl::memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::INT));
+
+		c.particle = gsl::memory::make_shared<Structure>("particle");
+		(void)c.particle->register_field("mass", gsl::memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::DOUBLE));
+		(void)c.particle->register_field("velocity", gsl::memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::DOUBLE, nullptr, TypeDeclaration::dimension_container_type{3}));
+		(void)c.particle->register_field("hits", gsl::memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::INT));
+	}
+
+	// s = 0; for (i = r.begin; i < r.end; i += 1) { s += i; } return s;
+	auto make_sum(corpus& c) -> void
+	{
+		const auto f = c.mod.create_function("sum", 1, type::INT);
+		ir::Builder builder{*f};
+		const auto r = builder.argument(0, *c.range);
+		const auto zero = builder.constant(std::int32_t{0});
+		const auto begin = builder.load_field(r, 0);
+
+		const auto header = builder.create_block();
+		const auto body = builder.create_block();
+		const auto exit = builder.create_block();
+		builder.jump(header);
+
+		builder.set_insert_point(header);
+		const auto i = builder.phi(type::INT);
+		const auto s = builder.phi(type::INT);
+		builder.branch(builder.binary(opcode::LESS, i, builder.load_field(r, 1)), body, exit);
+
+		builder.set_insert_point(body);
+		const auto next_s = builder.binary(opcode::ADD, s, i);
+		const auto next_i = builder.binary(opcode::ADD, i, builder.constant(std::int32_t{1}));
+		builder.jump(header);
+
+		builder.add_incoming(i, begin, ir::Function::entry());
+		builder.add_incoming(i, next_i, body);
+		builder.add_incoming(s, zero, ir::Function::entry());
+		builder.add_incoming(s, next_s, body);
+
+		builder.set_insert_point(exit);
+		builder.ret(s);
+	}
+
+	// for (v: p.velocity) { v *= p.mass; } p.hits += 1;
+	auto make_scale(corpus& c) -> void
+	{
+		const auto f = c.mod.create_function("scale", 1);
+		ir::Builder builder{*f};
+		const auto p = builder.argument(0, *c.particle);
+
+		builder.for_each_element(
+				*c.particle,
+				1,
+				[&](const ir::value_id i)
+				{
+					builder.store_element(p, 1, i, builder.binary(opcode::MUL, builder.load_element(p, 1, i), builder.load_field(p, 0)));
+				});
+		builder.store_field(p, 2, builder.binary(opcode::ADD, builder.load_field(p, 2), builder.constant(std::int32_t{1})));
+		builder.ret();
+	}
+
+	// counter += 1; return sum(r);
+	auto make_tick(corpus& c) -> void
+	{
+		const auto f = c.mod.create_function("tick", 1, type::INT);
+		ir::Builder builder{*f};
+		const auto r = builder.argument(0, *c.range);
+
+		builder.store_global("counter", builder.binary(opcode::ADD, builder.load_global("counter", type::INT), builder.constant(std::int32_t{1})));
+
+		const ir::value_id arguments[]{r};
+		builder.ret(builder.call("sum", arguments, type::INT));
+	}
+
+	// for (i = 0; i < n; i += 1) { if (i != limit) { scale(p); } }
+	auto make_simulate(corpus& c) -> void
+	{
+		const auto f = c.mod.create_function("simulate", 2);
+		ir::Builder builder{*f};
+		const auto p = builder.argument(0, *c.particle);
+		const auto n = builder.argument(1, type::INT);
+
+		(void)builder.loop(
+				builder.constant(std::int32_t{0}),
+				n,
+				[&](const ir::value_id i)
+				{
+					const auto if_true = builder.create_block();
+					const auto merge = builder.create_block();
+					builder.branch(builder.binary(opcode::NOT_EQUAL, i, builder.load_global("limit", type::INT)), if_true, merge);
+
+					builder.set_insert_point(if_true);
+					const ir::value_id arguments[]{p};
+					(void)builder.call("scale", arguments, type::VOID);
+					builder.jump(merge);
+
+					builder.set_insert_point(merge);
+				});
+		builder.ret();
+	}
+
+	[[nodiscard]] auto make_corpus() -> corpus
+	{
+		corpus c{};
+		make_structures(c);
+		make_sum(c);
+		make_scale(c);
+		make_tick(c);
+		make_simulate(c);
+		return c;
+	}
+}
+
+auto main(const int argc, const char* argv[]) -> int
+{
+	const std::string_view output = argc > 1 ? argv[1] : "superinstructions.tsv";
+
+	auto table_size = ir::superinstructions.size();
+	if (argc > 2)
+	{
+		const std::string_view size{argv[2]};
+		if (const auto [end, error] = std::from_chars(size.data(), size.data() + size.size(), table_size);
+			error != std::errc{} || end != size.data() + size.size())
+		{
+			std::cerr << "invalid table size '" << size << "'\n";
+			return 1;
+		}
+	}
+
+	auto c = make_corpus();
+
+	// profile what the interpreter would run: checked, then optimized (the passes keep the functions checked)
+	for (const auto& [name, function]: c.mod.get_functions())
+	{
+		if (const auto result = ir::check_types(c.mod, *function);
+			!result.success())
+		{
+			std::cerr << "function '" << name << "' does not type check:\n";
+			for (const auto& error: result.errors) { std::cerr << "\t%" << error.value << ": " << error.message << '\n'; }
+			return 1;
+		}
+	}
+
+	auto manager = ir::PassManager::create(ir::optimization_level::O2);
+	(void)manager.run(c.mod);
+
+	ir::OpcodeSequenceProfile profile{};
+	profile.record(c.mod);
+
+	if (!profile.dump(output, table_size))
+	{
+		std::cerr << "cannot write '" << output << "'\n";
+		return 1;
+	}
+
+	std::cout << c.mod.get_functions().size() << " functions, "
+			<< profile.get_instruction_count() << " weighted instructions, "
+			<< profile.sequences().size() << " distinct sequences written to '" << output << "'\n";
+	return 0;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <gsl/backend/type_check.hpp>
+
+// The functions compiled ahead of time for aot_test: the generator emits them (see gsl::ir::emit_cpp),
+// the emitted translation unit is compiled into the unit tests, which call them through the register function.
+namespace aot_corpus
+{
+	namespace gsl = gal::gsl;
+
+	// emitted by the generator, throws std::invalid_argument if a structure of make_structures is missing from the module
+	auto register_corpus(gsl::ast::Module& module) -> void;
+
+	// the structures the emitted code is laid out against, declared in the module given to the register function
+	inline auto make_structures(gsl::ast::Module& module) -> void
+	{
+		using gsl::ast::TypeDeclaration;
+
+		const auto point = module.register_structure(std::string_view{"point"}).second;
+		(void)point->register_field("x", gsl::memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::DOUBLE));
+		(void)point->register_field("y", gsl::memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::DOUBLE));
+
+		const auto polygon = module.register_structure(std::string_view{"polygon"}).second;
+		(void)polygon->register_field("count", gsl::memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::INT));
+		(void)polygon->register_field("xs", gsl::memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::FLOAT, nullptr, TypeDeclaration::dimension_container_type{16}));
+
+		// scanned by the collector
+		const auto named = module.register_structure(std::string_view{"named"}).second;
+		(void)named->register_field("name", gsl::memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::STRING));
+		(void)named->register_field("weight", gsl::memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::DOUBLE));
+	}
+
+	// the checked functions, false if one does not check
+	inline auto make_functions(const gsl::ast::Module& structures, gsl::ir::Module& mod) -> bool
+	{
+		namespace ir = gsl::ir;
+		using ir::opcode;
+		using type = ir::type_t;
+
+		const auto& point = *structures.get_structure("point");
+		const auto& polygon = *structures.get_structure("polygon");
+		const auto& named = *structures.get_structure("named");
+
+		{
+			// norm2(p) = p.x * p.x + p.y * p.y
+			ir::Builder builder{*mod.create_function("norm2", 1, type::DOUBLE)};
+			const auto p = builder.argument(0, point);
+			const auto x = builder.load_field(p, 0);
+			const auto y = builder.load_field(p, 1);
+			builder.ret(builder.binary(opcode::ADD, builder.binary(opcode::MUL, x, x), builder.binary(opcode::MUL, y, y)));
+		}
+		{
+			// make_point(x, y) = point{x, y}
+			ir::Builder builder{*mod.create_function("make_point", 2, type::STRUCTURE)};
+			const auto p = builder.alloc(point);
+			builder.store_field(p, 0, builder.argument(0, type::DOUBLE));
+			builder.store_field(p, 1, builder.argument(1, type::DOUBLE));
+			builder.ret(p);
+		}
+		{
+			// make_named(weight) = named{"", weight}
+			ir::Builder builder{*mod.create_function("make_named", 1, type::STRUCTURE)};
+			const auto n = builder.alloc(named);
+			builder.store_field(n, 1, builder.argument(0, type::DOUBLE));
+			builder.ret(n);
+		}
+		{
+			// sum(n) = n <= 0 ? 0 : n + sum(n - 1)
+			ir::Builder builder{*mod.create_function("sum", 1, type::INT)};
+			const auto n = builder.argument(0, type::INT);
+			const auto zero = builder.constant(std::int32_t{0});
+			const auto recurse = builder.create_block();
+			const auto done = builder.create_block();
+			builder.branch(builder.binary(opcode::LESS_EQUAL, n, zero), done, recurse);
+			builder.set_insert_point(done);
+			builder.ret(zero);
+			builder.set_insert_point(recurse);
+			const ir::value_id arguments[]{builder.binary(opcode::SUB, n, builder.constant(std::int32_t{1}))};
+			builder.ret(builder.binary(opcode::ADD, n, builder.call("sum", arguments, type::INT)));
+		}
+		{
+			// square(x) = x * x (wraps around)
+			ir::Builder builder{*mod.create_function("square", 1, type::INT)};
+			const auto x = builder.argument(0, type::INT);
+			builder.ret(builder.binary(opcode::MUL, x, x));
+		}
+		{
+			// quotient(a, b) = a / b (throws if b == 0)
+			ir::Builder builder{*mod.create_function("quotient", 2, type::INT)};
+			builder.ret(builder.binary(opcode::DIV, builder.argument(0, type::INT), builder.argument(1, type::INT)));
+		}
+		{
+			// at(p, i) = p.xs[i] (throws if out of bounds)
+			ir::Builder builder{*mod.create_function("at", 2, type::FLOAT)};
+			const auto p = builder.argument(0, polygon);
+			builder.ret(builder.load_element(p, 1, builder.argument(1, type::INT)));
+		}
+
+		bool checked = true;
+		for (const auto& [_, function]: mod.get_functions()) { checked &= ir::check_types(mod, *function).success(); }
+		return checked;
+	}
+}
@@ -0,0 +1,38 @@
+#include <corpus.hpp>
+#include <gsl/backend/aot.hpp>
+
+#include <fstream>
+#include <iostream>
+
+// writes the emitted translation unit of the corpus to argv[1]
+auto main(const int argc, char* argv[]) -> int
+{
+	namespace gsl = gal::gsl;
+
+	if (argc != 2)
+	{
+		std::cerr << "usage: " << argv[0] << " <output>\n";
+		return 1;
+	}
+
+	gsl::ast::Module structures{std::string_view{"aot_corpus"}};
+	aot_corpus::make_structures(structures);
+
+	gsl::ir::Module mod{"aot_corpus"};
+	if (!aot_corpus::make_functions(structures, mod))
+	{
+		std::cerr << "the corpus does not check\n";
+		return 1;
+	}
+
+	const auto result = gsl::ir::emit_cpp(mod, {.name_space = "aot_corpus", .register_function = "register_corpus"});
+	if (!result.success())
+	{
+		std::cerr << "the corpus cannot be compiled ahead of time\n";
+		return 1;
+	}
+
+	std::ofstream file{argv[1], std::ios::binary};
+	file << result.source;
+	return file ? 0 : 1;
+}
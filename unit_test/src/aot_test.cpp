@@ -0,0 +1,196 @@
+#include <boost/ut.hpp>
+#include <corpus.hpp>
+#include <gsl/backend/aot.hpp>
+#include <gsl/type/record.hpp>
+
+#include <cstring>
+#include <stdexcept>
+
+using namespace boost::ut;
+
+namespace
+{
+	auto twice(const std::int32_t value) -> std::int32_t { return value * 2; }
+
+	// calls a function registered by the emitted translation unit
+	template<typename... Arguments>
+	[[nodiscard]] auto call(const gal::gsl::ast::Module& module, const std::string_view name, const Arguments... arguments) -> gal::gsl::type::Value
+	{
+		const auto function = module.get_function(name);
+		if (!function || !function->is_builtin()) { throw std::invalid_argument{"missing function"}; }
+
+		const gal::gsl::type::Value values[]{gal::gsl::type::ValueCaster<Arguments>::from(arguments)..., {}};
+		return static_cast<const gal::gsl::ast::BuiltinFunction&>(*function).get_builtin().invoke({values, sizeof...(Arguments)});
+	}
+}
+
+suite test_aot = []
+{
+	namespace ir = gal::gsl::ir;
+	namespace ast = gal::gsl::ast;
+
+	using ir::opcode;
+	using type = ir::type_t;
+
+	"builtin_function"_test = []
+	{
+		ast::Module mod{std::string_view{"test"}};
+		mod.redefine_function(
+				"twice",
+				gal::gsl::memory::make_shared<ast::BuiltinFunction>(
+						std::string_view{"twice"},
+						ast::Function::arguments_container_type{
+								gal::gsl::memory::make_shared<ast::Variable>(
+										std::string_view{"value"},
+										gal::gsl::memory::make_shared<ast::TypeDeclaration>(ast::TypeDeclaration::variable_type::INT))},
+						gal::gsl::memory::make_shared<ast::TypeDeclaration>(ast::TypeDeclaration::variable_type::INT),
+						gal::gsl::type::BuiltinFunction::make<&twice>()));
+
+		const auto function = mod.get_function("twice");
+		expect((function != nullptr) >> fatal);
+		expect(function->is_builtin());
+
+		const auto argument = gal::gsl::type::ValueCaster<std::int32_t>::from(21);
+		const auto result = static_cast<const ast::BuiltinFunction&>(*function).get_builtin().invoke({&argument, 1});
+		expect(result.as<std::int32_t>() == 42_i);
+	};
+
+	"emit"_test = []
+	{
+		const auto point = gal::gsl::memory::make_shared<ast::Structure>("point");
+		expect(point->register_field("x", gal::gsl::memory::make_shared<ast::TypeDeclaration>(ast::TypeDeclaration::variable_type::DOUBLE)));
+		expect(point->register_field("y", gal::gsl::memory::make_shared<ast::TypeDeclaration>(ast::TypeDeclaration::variable_type::DOUBLE)));
+
+		ir::Module mod{"geometry"};
+		{
+			// norm2(p) = p.x * p.x + p.y * p.y
+			const auto f = mod.create_function("norm2", 1, type::DOUBLE);
+			ir::Builder builder{*f};
+			const auto p = builder.argument(0, *point);
+			const auto x = builder.load_field(p, 0);
+			const auto y = builder.load_field(p, 1);
+			builder.ret(builder.binary(opcode::ADD, builder.binary(opcode::MUL, x, x), builder.binary(opcode::MUL, y, y)));
+			expect(ir::check_types(mod, *f).success() >> fatal);
+		}
+		{
+			// sum(n) = n <= 0 ? 0 : n + sum(n - 1)
+			const auto f = mod.create_function("sum", 1, type::INT);
+			ir::Builder builder{*f};
+			const auto n = builder.argument(0, type::INT);
+			const auto zero = builder.constant(std::int32_t{0});
+			const auto recurse = builder.create_block();
+			const auto done = builder.create_block();
+			builder.branch(builder.binary(opcode::LESS_EQUAL, n, zero), done, recurse);
+			builder.set_insert_point(done);
+			builder.ret(zero);
+			builder.set_insert_point(recurse);
+			const ir::value_id arguments[]{builder.binary(opcode::SUB, n, builder.constant(std::int32_t{1}))};
+			builder.ret(builder.binary(opcode::ADD, n, builder.call("sum", arguments, type::INT)));
+			expect(ir::check_types(mod, *f).success() >> fatal);
+		}
+
+		const auto result = ir::emit_cpp(mod, {.name_space = "geometry_aot", .register_function = "register_geometry"});
+		expect(result.success() >> fatal);
+
+		const std::string_view source{result.source};
+		expect(source.contains("namespace geometry_aot"));
+		expect(source.contains("auto register_geometry(gal::gsl::ast::Module& module) -> void"));
+		// sorted by name
+		expect(source.contains("auto function_0(std::byte* const argument_0) -> double"));
+		expect(source.contains("auto function_1(const std::int32_t argument_0) -> std::int32_t"));
+		// the layout of the structure
+		expect(source.contains(" + 8, sizeof("));
+		// a direct call
+		expect(source.contains("= function_1("));
+	};
+
+	"elements"_test = []
+	{
+		const auto polygon = gal::gsl::memory::make_shared<ast::Structure>("polygon");
+		expect(polygon->register_field("count", gal::gsl::memory::make_shared<ast::TypeDeclaration>(ast::TypeDeclaration::variable_type::INT)));
+		expect(polygon->register_field("xs", gal::gsl::memory::make_shared<ast::TypeDeclaration>(ast::TypeDeclaration::variable_type::FLOAT, nullptr, ast::TypeDeclaration::dimension_container_type{16})));
+
+		ir::Module mod{"geometry"};
+		// at(p, i) = p.xs[i]
+		const auto f = mod.create_function("at", 2, type::FLOAT);
+		ir::Builder builder{*f};
+		const auto p = builder.argument(0, *polygon);
+		builder.ret(builder.load_element(p, 1, builder.argument(1, type::INT)));
+		expect(ir::check_types(mod, *f).success() >> fatal);
+
+		const auto result = ir::emit_cpp(mod);
+		expect(result.success() >> fatal);
+
+		const std::string_view source{result.source};
+		expect(source.contains("= check_bounds(value_"));
+		expect(source.contains(", 16u);"));
+		expect(source.contains(" + 4 + static_cast<std::size_t>(value_"));
+		expect(source.contains(") * 4, sizeof("));
+	};
+
+	"compiled"_test = []
+	{
+		ast::Module mod{std::string_view{"corpus"}};
+		aot_corpus::make_structures(mod);
+		aot_corpus::register_corpus(mod);
+
+		expect(call(mod, "sum", std::int32_t{10}).as<std::int32_t>() == 55_i);
+		// wraps around as the interpreter does
+		expect(call(mod, "square", std::int32_t{65536}).as<std::int32_t>() == 0_i);
+		expect(call(mod, "quotient", std::int32_t{-7}, std::int32_t{2}).as<std::int32_t>() == -3_i);
+
+		bool thrown = false;
+		try { (void)call(mod, "quotient", std::int32_t{1}, std::int32_t{0}); }
+		catch (const std::runtime_error&) { thrown = true; }
+		expect(thrown);
+
+		// allocated as a record of the structure
+		const auto point = call(mod, "make_point", 3.0, 4.0).as<std::byte*>();
+		expect((point != nullptr) >> fatal);
+		expect(call(mod, "norm2", point).as<double>() == 25.0_d);
+
+		const auto named = call(mod, "make_named", 1.5).as<std::byte*>();
+		expect((named != nullptr) >> fatal);
+		double weight{};
+		std::memcpy(&weight, named + mod.get_structure("named")->get_fields()[1].offset, sizeof(weight));
+		expect(weight == 1.5_d);
+
+		const auto& polygon = *mod.get_structure("polygon");
+		const auto p = static_cast<std::byte*>(gal::gsl::type::allocate_record(polygon));
+		const float x = 2.5f;
+		std::memcpy(p + polygon.get_fields()[1].offset + 3 * sizeof(float), &x, sizeof(x));
+		expect(call(mod, "at", p, std::int32_t{3}).as<float>() == 2.5_f);
+
+		thrown = false;
+		try { (void)call(mod, "at", p, std::int32_t{16}); }
+		catch (const std::out_of_range&) { thrown = true; }
+		expect(thrown);
+	};
+
+	"compiled_missing_structure"_test = []
+	{
+		ast::Module mod{std::string_view{"corpus"}};
+
+		bool thrown = false;
+		try { aot_corpus::register_corpus(mod); }
+		catch (const std::invalid_argument&) { thrown = true; }
+		expect(thrown);
+		expect(mod.get_function("sum") == nullptr);
+	};
+
+	"unsupported"_test = []
+	{
+		ir::Module mod{"test"};
+		const auto f = mod.create_function("f", 0, type::INT);
+		ir::Builder builder{*f};
+		const auto global = builder.load_global("counter", type::INT);
+		builder.ret(global);
+		expect(ir::check_types(mod, *f).success() >> fatal);
+
+		const auto result = ir::emit_cpp(mod);
+		expect(!result.success());
+		expect((result.errors.size() == 1_ul) >> fatal);
+		expect(result.errors.front().value == global);
+		expect(result.source.empty());
+	};
+};
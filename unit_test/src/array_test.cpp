@@ -0,0 +1,52 @@
+#include <boost/ut.hpp>
+#include <gsl/type/array.hpp>
+#include <array>
+#include <tuple>
+
+using namespace boost::ut;
+
+suite test_array = []
+{
+	using gal::gsl::type::Array;
+
+	"layout"_test = []
+	{
+		const Array<float> array{3, 4, 5};
+
+		expect(array.rank() == 3_ul);
+		expect(array.size() == 60_ul);
+		expect(array.strides()[0] == 20_u and array.strides()[1] == 5_u and array.strides()[2] == 1_u);
+		expect(reinterpret_cast<std::uintptr_t>(array.data()) % Array<float>::alignment == 0_ul);
+		expect(array.offset_of(std::array<std::uint32_t, 3>{1, 2, 3}) == 33_ul);
+	};
+
+	"element wise"_test = []<typename T>
+	{
+		Array<T> lhs{2, 33};
+		Array<T> rhs{2, 33};
+		for (std::size_t i = 0; i < lhs.size(); ++i)
+		{
+			lhs[i] = static_cast<T>(i);
+			rhs[i] = static_cast<T>(2);
+		}
+
+		const auto sum = lhs + rhs;
+		const auto product = lhs * rhs;
+		for (std::size_t i = 0; i < lhs.size(); ++i)
+		{
+			expect(sum[i] == static_cast<T>(i + 2));
+			expect(product[i] == static_cast<T>(i * 2));
+		}
+	} | std::tuple<std::int32_t, float, double>{};
+
+	"reduction"_test = []<typename T>
+	{
+		Array<T> array{100};
+		for (std::size_t i = 0; i < array.size(); ++i) { array[i] = static_cast<T>(static_cast<int>(i) - 50); }
+
+		expect(array.sum() == static_cast<T>(-50));
+		expect(array.min() == static_cast<T>(-50));
+		expect(array.max() == static_cast<T>(49));
+		expect(array.dot(array) == static_cast<T>(83350));
+	} | std::tuple<std::int32_t, float, double>{};
+};
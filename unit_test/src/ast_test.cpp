@@ -0,0 +1,58 @@
+#include <boost/ut.hpp>
+#include <gsl/backend/ast.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace boost::ut;
+
+suite test_ast = []
+{
+	namespace ast = gal::gsl::ast;
+	namespace memory = gal::gsl::memory;
+
+	"lazy_function_body"_test = []
+	{
+		const auto source = memory::make_shared<gal::gsl::string::string>("fn f() -> int { a } fn g() -> int { b }");
+		const auto offset = source->rfind('{');
+
+		ast::Function function{std::string_view{"g"}};
+		std::atomic<int> parsed{0};
+		std::atomic<bool> fail{true};
+		function.set_lazy_function_body(
+				source,
+				offset,
+				source->size() - offset,
+				[&parsed, &fail](const ast::Function& f, const std::string_view body) -> ast::expression_type
+				{
+					expect(f.get_name() == std::string_view{"g"});
+					expect(body == std::string_view{"{ b }"});
+
+					if (fail.exchange(false)) { throw std::runtime_error{"first parse fails"}; }
+
+					++parsed;
+					return memory::make_shared<ast::Expression>();
+				});
+		expect(not function.is_function_body_parsed());
+
+		// a failed parse leaves it lazy
+		bool thrown = false;
+		try { (void)function.get_function_body(); }
+		catch (const std::runtime_error&) { thrown = true; }
+		expect(thrown);
+		expect(not function.is_function_body_parsed());
+
+		// parsed once whatever the number of concurrent first uses
+		std::atomic<int> empty{0};
+		{
+			std::vector<std::jthread> workers{};
+			for (int i = 0; i < 8; ++i) { workers.emplace_back([&function, &empty] { empty += function.get_function_body() == nullptr; }); }
+		}
+
+		expect(parsed.load() == 1_i);
+		expect(empty.load() == 0_i);
+		expect(function.is_function_body_parsed());
+	};
+};
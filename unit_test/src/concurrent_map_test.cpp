@@ -0,0 +1,217 @@
+#include <boost/ut.hpp>
+#include <gsl/container/concurrent_map.hpp>
+#include <gsl/backend/ast.hpp>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace boost::ut;
+
+namespace
+{
+	// how many are alive
+	struct counted
+	{
+		inline static int live = 0;
+
+		int value;
+
+		explicit counted(const int v)
+			: value{v} { ++live; }
+
+		counted(counted&& other) noexcept
+			: value{other.value} { ++live; }
+
+		counted(const counted&) = delete;
+		auto operator=(const counted&) -> counted& = delete;
+		auto operator=(counted&&) -> counted& = delete;
+
+		~counted() noexcept { --live; }
+	};
+}
+
+suite test_concurrent_map = []
+{
+	using map_type = gal::gsl::container::ConcurrentMap<std::string, int, std::hash<std::string_view>>;
+
+	"insert_erase"_test = []
+	{
+		map_type map{};
+
+		auto key = std::string{"answer"};
+		const auto [inserted, value] = map.try_emplace(std::move(key), [](const auto&) { return 42; });
+		expect(inserted and value == 42_i);
+
+		auto again = std::string{"answer"};
+		const auto [reinserted, existing] = map.try_emplace(std::move(again), [](const auto&) { return 0; });
+		expect(not reinserted and existing == 42_i);
+		// not moved from
+		expect(again == std::string_view{"answer"});
+
+		const auto* found = map.find(std::string_view{"answer"});
+		expect(found != nullptr and *found == 42_i);
+
+		map.insert_or_assign(std::string{"answer"}, 43);
+		expect(*map.find(std::string_view{"answer"}) == 43_i);
+		// still readable
+		expect(*found == 42_i);
+
+		expect(map.erase(std::string_view{"answer"}));
+		expect(not map.erase(std::string_view{"answer"}));
+		expect(map.find(std::string_view{"answer"}) == nullptr);
+		expect(map.empty());
+
+		expect(map.try_emplace(std::string{"answer"}, [](const auto&) { return 44; }).first);
+		expect(map.size() == 1_ul);
+	};
+
+	"grow"_test = []
+	{
+		map_type map{};
+
+		constexpr int count = 10'000;
+		for (int i = 0; i < count; ++i) { (void)map.try_emplace(std::to_string(i), [i](const auto&) { return i; }); }
+		for (int i = 0; i < count; i += 2) { (void)map.erase(std::to_string(i)); }
+
+		expect(map.size() == static_cast<std::size_t>(count / 2));
+
+		int missing = 0;
+		for (int i = 1; i < count; i += 2)
+		{
+			const auto* value = map.find(std::to_string(i));
+			missing += value == nullptr || *value != i;
+		}
+		expect(missing == 0_i);
+
+		std::size_t visited = 0;
+		for (const auto& [key, value]: map) { visited += std::stoi(key) == value; }
+		expect(visited == map.size());
+	};
+
+	"reclaim"_test = []
+	{
+		using counted_map_type = gal::gsl::container::ConcurrentMap<std::string, counted, std::hash<std::string_view>>;
+
+		counted::live = 0;
+		{
+			counted_map_type map{};
+
+			constexpr int keys = 100;
+			constexpr int rounds = 50;
+			for (int i = 0; i < keys; ++i) { (void)map.try_emplace(std::to_string(i), [i](const auto&) { return counted{i}; }); }
+			for (int round = 1; round <= rounds; ++round)
+			{
+				for (int i = 0; i < keys; ++i) { map.insert_or_assign(std::to_string(i), counted{i + round * keys}); }
+			}
+
+			// the replaced values are kept for the readers
+			expect(counted::live == keys * (rounds + 1));
+
+			// an erasure allocates nothing
+			for (int i = 0; i < keys; i += 2) { expect(map.erase(std::to_string(i))); }
+			expect(counted::live == keys * (rounds + 1));
+
+			map.reclaim();
+			expect(counted::live == static_cast<int>(map.size()));
+
+			int wrong = 0;
+			for (int i = 0; i < keys; ++i)
+			{
+				const auto* found = map.find(std::to_string(i));
+				wrong += i % 2 == 0 ? found != nullptr : found == nullptr || found->value != i + rounds * keys;
+			}
+			expect(wrong == 0_i);
+
+			// inserting and erasing fresh keys forever stays bounded by what is inserted between two reclaims
+			constexpr int batch = 1'000;
+			for (int round = 0; round < 20; ++round)
+			{
+				for (int i = 0; i < batch; ++i)
+				{
+					const auto n = round * batch + i;
+					(void)map.try_emplace(std::to_string(keys + n), [n](const auto&) { return counted{n}; });
+				}
+				for (int i = 0; i < batch; ++i) { (void)map.erase(std::to_string(keys + round * batch + i)); }
+
+				expect(counted::live <= static_cast<int>(map.size()) + batch);
+				map.reclaim();
+				expect(counted::live == static_cast<int>(map.size()));
+			}
+
+			expect(map.size() == static_cast<std::size_t>(keys / 2));
+			std::size_t visited = 0;
+			for (const auto& [key, value]: map) { visited += std::stoi(key) == value.value - rounds * keys; }
+			expect(visited == map.size());
+		}
+		expect(counted::live == 0_i);
+	};
+
+	"concurrent"_test = []
+	{
+		map_type map{};
+
+		constexpr int threads = 8;
+		constexpr int count = 20'000;
+
+		// every thread registers every key, only one of them inserts it
+		std::atomic<int> inserted{0};
+		std::atomic<int> wrong{0};
+		{
+			std::vector<std::jthread> workers{};
+			for (int t = 0; t < threads; ++t)
+			{
+				workers.emplace_back(
+						[&map, &inserted, &wrong, t]
+						{
+							for (int n = 0; n < count; ++n)
+							{
+								const auto i = (n * 7 + t * 1009) % count;
+								const auto [done, value] = map.try_emplace(std::to_string(i), [i](const auto&) { return i; });
+								inserted += done;
+								wrong += value != i;
+
+								// readers never wait, they see a key once it is registered
+								const auto* found = map.find(std::to_string(i));
+								wrong += found == nullptr || *found != i;
+							}
+						});
+			}
+		}
+
+		expect(inserted.load() == count);
+		expect(wrong.load() == 0_i);
+		expect(map.size() == static_cast<std::size_t>(count));
+	};
+
+	"module"_test = []
+	{
+		auto mod = gal::gsl::memory::make_shared<gal::gsl::ast::Module>(std::string_view{"parallel"});
+		const auto version = mod->get_version();
+
+		constexpr int threads = 4;
+		constexpr int count = 2'000;
+
+		std::atomic<int> inserted{0};
+		{
+			std::vector<std::jthread> workers{};
+			for (int t = 0; t < threads; ++t)
+			{
+				workers.emplace_back(
+						[&mod, &inserted]
+						{
+							for (int i = 0; i < count; ++i)
+							{
+								inserted += mod->register_function(std::string_view{std::to_string(i)}).first;
+							}
+						});
+			}
+		}
+
+		expect(inserted.load() == count);
+		expect(mod->get_version() != version);
+		expect(mod->get_functions().size() == static_cast<std::size_t>(count));
+		expect(mod->get_function("1999") != nullptr);
+	};
+};
@@ -0,0 +1,114 @@
+#include <boost/ut.hpp>
+#include <gsl/frontend/embedded.hpp>
+
+using namespace boost::ut;
+
+namespace
+{
+	namespace embedded = gal::gsl::frontend::embedded;
+
+	constexpr auto& script = embedded::embed<R"(
+module physics;
+import math;
+
+# natural alignment, declaration order
+struct vec3 { float x float y float z }
+
+@soa
+struct particle
+{
+	boolean alive
+	vec3 position
+	double mass
+	vec3[4] trail
+}
+
+global mut int count;
+global double gravity = -9.81;
+global string unit = "m/s";
+global int limit = 100;
+global vec3 origin = zero;
+global string separators = "; { } # \"";
+
+fn step(particle p, double dt = 1) -> void { p }
+fn brace() -> string
+{
+	# a } in a comment
+	"a } in a string"
+}
+fn alive() -> int { count }
+)">;
+
+	constexpr auto physics = script.view();
+
+	static_assert(physics.name == "physics");
+	static_assert(physics.imports.size() == 1 && physics.imports.front() == "math");
+
+	static_assert(physics.find_structure("vec3")->size == 12);
+	static_assert(physics.find_structure("vec3")->alignment == 4);
+	static_assert(physics.find_field(*physics.find_structure("vec3"), "z")->offset == 8);
+
+	constexpr auto& particle = *physics.find_structure("particle");
+	static_assert(particle.layout == embedded::layout_type::STRUCTURE_OF_ARRAYS);
+	static_assert(physics.find_field(particle, "position")->offset == 4);
+	static_assert(physics.find_field(particle, "mass")->offset == 16);
+	static_assert(physics.find_field(particle, "trail")->offset == 24);
+	static_assert(physics.dimensions_of(physics.find_field(particle, "trail")->type).front() == 4);
+	static_assert(particle.size == 72 && particle.alignment == 8);
+
+	static_assert(physics.find_global("count")->is_mutable);
+	static_assert(physics.find_global("count")->initializer.kind == embedded::constant_description::kind_type::NONE);
+	static_assert(physics.find_global("gravity")->initializer.floating_point == -9.81);
+	static_assert(physics.find_global("unit")->initializer.text == "m/s");
+	static_assert(physics.find_global("limit")->initializer.integer == 100);
+	static_assert(physics.find_global("origin")->initializer.kind == embedded::constant_description::kind_type::IDENTIFIER);
+	// kept as written
+	static_assert(physics.find_global("separators")->initializer.text == R"(; { } # \")");
+
+	constexpr auto& step = *physics.find_function("step");
+	static_assert(step.argument_count == 2);
+	static_assert(physics.arguments_of(step)[0].type.structure == 1);
+	// an integer literal converted to the declared type
+	static_assert(physics.arguments_of(step)[1].default_value.floating_point == 1.0);
+	static_assert(step.return_type.type == embedded::type_kind::VOID);
+	static_assert(physics.body_of(step) == "{ p }");
+	// the braces of comments and strings do not count
+	static_assert(physics.body_of(*physics.find_function("brace")) == "{\n\t# a } in a comment\n\t\"a } in a string\"\n}");
+	static_assert(physics.body_of(*physics.find_function("alive")) == "{ count }");
+
+	static_assert(physics.find_function("missing") == nullptr);
+}
+
+suite test_embedded = []
+{
+	namespace ast = gal::gsl::ast;
+
+	"instantiate"_test = []
+	{
+		const auto mod = embedded::instantiate(physics);
+		expect((mod != nullptr) >> fatal);
+
+		expect(mod->get_name() == std::string_view{"physics"});
+		expect((mod->get_imports().size() == 1_ul) >> fatal);
+		expect(mod->get_imports().front() == std::string_view{"math"});
+
+		const auto particle_structure = mod->get_structure("particle");
+		expect((particle_structure != nullptr) >> fatal);
+		expect(particle_structure->get_size() == particle.size);
+		expect(particle_structure->get_layout() == ast::Structure::layout_type::STRUCTURE_OF_ARRAYS);
+		expect(particle_structure->get_field("trail")->variable.type->owner() == mod->get_structure("vec3").get());
+
+		expect(mod->get_global("gravity")->get_type()->type() == ast::TypeDeclaration::variable_type::DOUBLE);
+
+		const auto function = mod->get_function("step");
+		expect((function != nullptr) >> fatal);
+		expect((function->get_arguments().size() == 2_ul) >> fatal);
+		expect(function->get_arguments().front()->get_type()->owner() == particle_structure.get());
+		expect(function->get_return_type()->type() == ast::TypeDeclaration::variable_type::VOID);
+
+		// the body is parsed on first use
+		expect(not function->is_function_body_parsed());
+		expect(function->get_function_body() != nullptr);
+		expect(function->is_function_body_parsed());
+	};
+};
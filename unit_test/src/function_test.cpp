@@ -0,0 +1,87 @@
+#include <boost/ut.hpp>
+#include <gsl/type/function.hpp>
+#include <gsl/type/string.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+using namespace boost::ut;
+
+namespace
+{
+	auto scale(const std::int32_t value, const double factor) -> double { return value * factor; }
+
+	auto length(const gal::gsl::type::String& string) noexcept -> std::int32_t { return static_cast<std::int32_t>(string.size()); }
+
+	auto checked(const std::int32_t value) -> std::int32_t
+	{
+		if (value < 0) { throw std::invalid_argument{"negative"}; }
+		return value;
+	}
+}
+
+suite test_function = []
+{
+	using gal::gsl::type::BuiltinFunction;
+	using gal::gsl::type::String;
+	using gal::gsl::type::Value;
+	using gal::gsl::type::ValueCaster;
+
+	"invoke"_test = []
+	{
+		constexpr auto function = BuiltinFunction::make<&scale>();
+		static_assert(function.get_arity() == 2);
+
+		const Value arguments[]{ValueCaster<std::int32_t>::from(21), ValueCaster<double>::from(2.0)};
+		expect(function.invoke(arguments).as<double>() == 42.0_d);
+
+		const auto string = BuiltinFunction::make<&length>();
+		const Value string_arguments[]{ValueCaster<String>::from(String{"hello, world"})};
+		expect(string.invoke(string_arguments).as<std::int32_t>() == 12_i);
+	};
+
+	"invoke_batch"_test = []
+	{
+		constexpr std::size_t rows = 10'000;
+
+		std::vector<Value> values(rows);
+		std::vector<Value> factors(rows);
+		for (std::size_t i = 0; i < rows; ++i)
+		{
+			values[i] = ValueCaster<std::int32_t>::from(static_cast<std::int32_t>(i));
+			factors[i] = ValueCaster<double>::from(i % 2 == 0 ? 0.5 : 2.0);
+		}
+		const std::span<const Value> columns[]{values, factors};
+
+		const auto function = BuiltinFunction::make<&scale>();
+		for (const auto threads: {std::size_t{1}, std::size_t{4}})
+		{
+			std::vector<Value> results(rows);
+			function.invoke_batch(columns, results, {.threads = threads, .min_rows_per_thread = 1000});
+
+			std::size_t mismatches = 0;
+			for (std::size_t i = 0; i < rows; ++i) { mismatches += results[i].as<double>() != static_cast<double>(i) * (i % 2 == 0 ? 0.5 : 2.0); }
+			expect(mismatches == 0_ul);
+		}
+
+		// fewer rows than threads times the slice, no slice starts past the end
+		{
+			const std::span<const Value> few_columns[]{std::span{values}.first(5), std::span{factors}.first(5)};
+			std::vector<Value> results(5);
+			function.invoke_batch(few_columns, results, {.threads = 4, .min_rows_per_thread = 1});
+
+			std::size_t mismatches = 0;
+			for (std::size_t i = 0; i < 5; ++i) { mismatches += results[i].as<double>() != static_cast<double>(i) * (i % 2 == 0 ? 0.5 : 2.0); }
+			expect(mismatches == 0_ul);
+		}
+
+		// an exception of a worker reaches the caller
+		values[rows - 1] = ValueCaster<std::int32_t>::from(-1);
+		const std::span<const Value> checked_columns[]{values};
+		std::vector<Value> results(rows);
+		bool thrown = false;
+		try { BuiltinFunction::make<&checked>().invoke_batch(checked_columns, results, {.threads = 4, .min_rows_per_thread = 1000}); }
+		catch (const std::invalid_argument&) { thrown = true; }
+		expect(thrown);
+	};
+};
@@ -0,0 +1,180 @@
+#include <boost/ut.hpp>
+#include <gsl/type/host_structure.hpp>
+#include <gsl/backend/inline_cache.hpp>
+#include <gsl/memory/raw.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+using namespace boost::ut;
+
+namespace
+{
+	struct point
+	{
+		double x;
+		double y;
+	};
+
+	struct request_context
+	{
+		std::int32_t id;
+		// not bound
+		void* host_only;
+		bool cancelled;
+		float weights[3];
+		std::array<point, 2> bounds;
+		gal::gsl::type::String path;
+	};
+}
+
+suite test_host_structure = []
+{
+	namespace ast = gal::gsl::ast;
+	namespace type = gal::gsl::type;
+
+	"bind"_test = []
+	{
+		ast::Module mod{std::string_view{"host"}};
+
+		const auto point_structure = type::bind_structure<point>(mod, "point")
+				.field<&point::x>("x")
+				.field<&point::y>("y")
+				.get();
+
+		const auto context = type::bind_structure<request_context>(mod, "request_context")
+				.field<&request_context::id>("id")
+				.field<&request_context::cancelled>("cancelled")
+				.field<&request_context::weights>("weights")
+				.field<&request_context::bounds>("bounds", point_structure)
+				.field<&request_context::path>("path")
+				.get();
+
+		expect(mod.get_structure("request_context") == context);
+		expect(context->get_size() == sizeof(request_context));
+		expect(context->get_alignment() == alignof(request_context));
+		expect((context->get_fields().size() == 5_ul) >> fatal);
+
+		expect(context->get_field("id")->offset == offsetof(request_context, id));
+		expect(context->get_field("cancelled")->offset == offsetof(request_context, cancelled));
+		expect(context->get_field("weights")->offset == offsetof(request_context, weights));
+		expect(context->get_field("bounds")->offset == offsetof(request_context, bounds));
+		expect(context->get_field("path")->offset == offsetof(request_context, path));
+		expect(context->get_field("host_only") == nullptr);
+
+		const auto& bounds = *context->get_field("bounds")->variable.type;
+		expect(bounds.owner() == point_structure.get());
+		expect((bounds.dimensions().size() == 1_ul) >> fatal);
+		expect(bounds.dimensions().front() == 2u);
+		expect(context->get_field("weights")->variable.type->type() == ast::TypeDeclaration::variable_type::FLOAT);
+
+		// the strings are still found by the collector
+		expect(context->contains_pointer());
+		expect(not point_structure->contains_pointer());
+	};
+
+	"in_place"_test = []
+	{
+		ast::Module mod{std::string_view{"host"}};
+		const auto context = type::bind_structure<request_context>(mod, "request_context")
+				.field<&request_context::id>("id")
+				.field<&request_context::cancelled>("cancelled")
+				.get();
+
+		request_context object{.id = 42, .host_only = nullptr, .cancelled = false, .weights = {}, .bounds = {}, .path = {}};
+		const auto value = type::ValueCaster<request_context*>::from(&object);
+
+		// what a script does with the record behind the pointer
+		ast::FieldInlineCache<> id{"id"};
+		ast::FieldInlineCache<> cancelled{"cancelled"};
+		auto* record = reinterpret_cast<std::byte*>(value.as<request_context*>());
+
+		const auto* id_location = id.lookup(*context);
+		expect((id_location != nullptr) >> fatal);
+		expect(*reinterpret_cast<std::int32_t*>(record + id_location->offset) == 42_i);
+
+		const auto* cancelled_location = cancelled.lookup(*context);
+		expect((cancelled_location != nullptr) >> fatal);
+		*reinterpret_cast<bool*>(record + cancelled_location->offset) = true;
+		expect(object.cancelled);
+	};
+
+	"collected_string"_test = []
+	{
+		ast::Module mod{std::string_view{"host"}};
+		const auto context = type::bind_structure<request_context>(mod, "request_context")
+				.field<&request_context::path>("path")
+				.get();
+
+		// the host object lives in scanned memory, the only reference to the heap string is its member
+		auto* object = std::construct_at(static_cast<request_context*>(gal::gsl::memory::allocate(sizeof(request_context))));
+		const std::string text(64, 'x');
+
+		// what a script storing a fresh string does
+		[](std::byte* record, const std::size_t offset, const std::string_view string)
+		{
+			*reinterpret_cast<type::String*>(record + offset) = type::String{string};
+		}(reinterpret_cast<std::byte*>(object), context->get_field("path")->offset, text);
+		expect(object->path.get_category() == type::String::category::HEAP);
+
+		gal::gsl::memory::collect();
+		// reuse whatever was freed
+		for (int i = 0; i < 1024; ++i) { std::ranges::fill_n(static_cast<char*>(gal::gsl::memory::allocate_without_pointer(64)), 64, 'y'); }
+
+		expect(object->path == std::string_view{text});
+		std::destroy_at(object);
+		gal::gsl::memory::deallocate(object);
+	};
+
+	"explicit_offset"_test = []
+	{
+		using ast::TypeDeclaration;
+
+		ast::Structure structure{"explicit"};
+		const auto int_type = gal::gsl::memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::INT);
+		const auto double_type = gal::gsl::memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::DOUBLE);
+
+		expect(structure.register_field("a", int_type, 0));
+		// a gap is fine
+		expect(structure.register_field("b", double_type, 8));
+		// misaligned
+		expect(not structure.register_field("c", double_type, 20));
+		expect(not structure.register_field("c", int_type, 2));
+		// overlapping
+		expect(not structure.register_field("c", int_type, 12));
+		expect(not structure.register_field("c", double_type, 0));
+		expect(structure.register_field("c", int_type, 4));
+		expect(structure.register_field("d", int_type, 16));
+
+		expect(structure.get_fields().size() == 4_ul);
+	};
+
+	"duplicate"_test = []
+	{
+		ast::Module mod{std::string_view{"host"}};
+		(void)type::bind_structure<point>(mod, "point");
+
+		bool thrown = false;
+		try { (void)type::bind_structure<point>(mod, "point"); }
+		catch (const type::host_binding_error& error)
+		{
+			thrown = true;
+			expect(error.structure() == "point");
+			expect(error.field().empty());
+		}
+		expect(thrown);
+
+		thrown = false;
+		try { (void)type::bind_structure<point>(mod, "other").field<&point::x>("x").field<&point::y>("x"); }
+		catch (const type::host_binding_error& error)
+		{
+			thrown = true;
+			expect(error.structure() == "other");
+			expect(error.field() == "x");
+			expect(std::string_view{error.what()}.find("'x'") != std::string_view::npos);
+		}
+		expect(thrown);
+	};
+};
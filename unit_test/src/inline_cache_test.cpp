@@ -0,0 +1,94 @@
+#include <boost/ut.hpp>
+#include <gsl/backend/inline_cache.hpp>
+
+#include <cstddef>
+#include <memory>
+
+using namespace boost::ut;
+
+suite test_inline_cache = []
+{
+	namespace gsl = gal::gsl;
+
+	using gsl::ast::Module;
+	using gsl::ast::Function;
+	using gsl::ast::Structure;
+	using gsl::ast::TypeDeclaration;
+	using gsl::ast::symbol_name_view;
+
+	"function"_test = []
+	{
+		const auto mod = gsl::memory::make_shared<Module>(symbol_name_view{"m"});
+		gsl::ast::FunctionInlineCache<2> cache{"f"};
+
+		expect(cache.lookup(*mod) == nullptr);
+
+		const auto [registered, f] = mod->register_function(symbol_name_view{"f"});
+		expect(registered);
+		expect(cache.lookup(*mod) == f.get());
+
+		// the version changes, the stale entry must not be used
+		const auto g = gsl::memory::make_shared<Function>(symbol_name_view{"f"});
+		mod->redefine_function("f", g);
+		expect(cache.lookup(*mod) == g.get());
+
+		const auto other = gsl::memory::make_shared<Module>(symbol_name_view{"other"});
+		const auto [_, h] = other->register_function(symbol_name_view{"f"});
+		expect(cache.lookup(*other) == h.get());
+		expect(cache.lookup(*mod) == g.get());
+	};
+
+	"reused_address"_test = []
+	{
+		gsl::ast::FunctionInlineCache<> cache{"f"};
+
+		// two modules constructed one after another in the same storage, as an allocator reusing a freed block would do
+		alignas(Module) std::byte storage[sizeof(Module)];
+
+		auto* first = std::construct_at(reinterpret_cast<Module*>(storage), symbol_name_view{"first"});
+		const auto [_, f] = first->register_function(symbol_name_view{"f"});
+		expect(cache.lookup(*first) == f.get());
+		const auto first_version = first->get_version();
+		std::destroy_at(first);
+
+		auto* second = std::construct_at(reinterpret_cast<Module*>(storage), symbol_name_view{"second"});
+		expect(static_cast<const void*>(second) == static_cast<const void*>(first));
+		expect(second->get_version() != first_version);
+		expect(cache.lookup(*second) == nullptr);
+
+		const auto [registered, g] = second->register_function(symbol_name_view{"f"});
+		expect(registered);
+		expect(second->get_version() != first_version);
+		expect(cache.lookup(*second) == g.get());
+		std::destroy_at(second);
+	};
+
+	"field_reused_address"_test = []
+	{
+		gsl::ast::FieldInlineCache<2> cache{"y"};
+
+		// a structure redefined with another layout, constructed where the old one lived
+		alignas(Structure) std::byte storage[sizeof(Structure)];
+
+		auto* first = std::construct_at(reinterpret_cast<Structure*>(storage), symbol_name_view{"point"});
+		expect(first->register_field("x", gsl::memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::INT)));
+		expect(first->register_field("y", gsl::memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::INT)));
+		const auto* location = cache.lookup(*first);
+		expect((location != nullptr) >> fatal);
+		expect(location->offset == 4_ul);
+		const auto first_generation = first->get_generation();
+		std::destroy_at(first);
+
+		auto* second = std::construct_at(reinterpret_cast<Structure*>(storage), symbol_name_view{"point"});
+		expect(static_cast<const void*>(second) == static_cast<const void*>(first));
+		expect(second->get_generation() != first_generation);
+		expect(cache.lookup(*second) == nullptr);
+
+		expect(second->register_field("x", gsl::memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::DOUBLE)));
+		expect(second->register_field("y", gsl::memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::DOUBLE)));
+		location = cache.lookup(*second);
+		expect((location != nullptr) >> fatal);
+		expect(location->offset == 8_ul);
+		std::destroy_at(second);
+	};
+};
@@ -0,0 +1,574 @@
+#include <boost/ut.hpp>
+#include <gsl/backend/pass.hpp>
+#include <gsl/backend/superinstruction.hpp>
+#include <gsl/backend/type_check.hpp>
+
+using namespace boost::ut;
+
+suite test_ir = []
+{
+	namespace ir = gal::gsl::ir;
+
+	using ir::opcode;
+	using type = ir::type_t;
+
+	const auto count = [](const ir::Function& function, const opcode op)
+	{
+		std::size_t total = 0;
+		for (const auto id: function.reverse_post_order())
+		{
+			for (const auto value: function.block(id).instructions) { total += function.value(value).op == op; }
+		}
+		return total;
+	};
+
+	"constant_propagation"_test = [&]
+	{
+		ir::Module mod{"test"};
+		const auto f = mod.create_function("f", 1, type::INT);
+
+		// if (2 * 3 == 6) return a + (2 * 3); else return 0;
+		ir::Builder builder{*f};
+		const auto a = builder.argument(0, type::INT);
+		const auto six = builder.binary(opcode::MUL, builder.constant(std::int32_t{2}), builder.constant(std::int32_t{3}));
+		const auto condition = builder.binary(opcode::EQUAL, six, builder.constant(std::int32_t{6}));
+		const auto if_true = builder.create_block();
+		const auto if_false = builder.create_block();
+		builder.branch(condition, if_true, if_false);
+		builder.set_insert_point(if_true);
+		builder.ret(builder.binary(opcode::ADD, a, six));
+		builder.set_insert_point(if_false);
+		builder.ret(builder.constant(std::int32_t{0}));
+		expect(f->verify());
+
+		auto manager = ir::PassManager::create(ir::optimization_level::O1);
+		expect(manager.run(mod, *f));
+		expect(f->verify());
+
+		expect(count(*f, opcode::BRANCH) == 0_ul);
+		expect(count(*f, opcode::MUL) == 0_ul);
+		expect(count(*f, opcode::RETURN) == 1_ul);
+		expect(f->reverse_post_order().size() == 1_ul);
+	};
+
+	"inline_and_licm"_test = [&]
+	{
+		ir::Module mod{"test"};
+		{
+			// square(x) = x * x
+			const auto square = mod.create_function("square", 1, type::INT);
+			ir::Builder builder{*square};
+			const auto x = builder.argument(0, type::INT);
+			builder.ret(builder.binary(opcode::MUL, x, x));
+		}
+
+		// s = 0; for (i = 0; i < n; i += 1) { s += square(a) + i; } return s;
+		const auto f = mod.create_function("f", 2, type::INT);
+		ir::Builder builder{*f};
+		const auto a = builder.argument(0, type::INT);
+		const auto n = builder.argument(1, type::INT);
+		const auto zero = builder.constant(std::int32_t{0});
+		const auto header = builder.create_block();
+		const auto body = builder.create_block();
+		const auto exit = builder.create_block();
+		builder.jump(header);
+
+		builder.set_insert_point(header);
+		const auto i = builder.phi(type::INT);
+		const auto s = builder.phi(type::INT);
+		builder.branch(builder.binary(opcode::LESS, i, n), body, exit);
+
+		builder.set_insert_point(body);
+		const ir::value_id arguments[]{a};
+		const auto next_s = builder.binary(opcode::ADD, s, builder.binary(opcode::ADD, builder.call("square", arguments, type::INT), i));
+		const auto next_i = builder.binary(opcode::ADD, i, builder.constant(std::int32_t{1}));
+		builder.jump(header);
+
+		builder.add_incoming(i, zero, ir::Function::entry());
+		builder.add_incoming(i, next_i, body);
+		builder.add_incoming(s, zero, ir::Function::entry());
+		builder.add_incoming(s, next_s, body);
+
+		builder.set_insert_point(exit);
+		builder.ret(s);
+		expect(f->verify());
+
+		auto manager = ir::PassManager::create(ir::optimization_level::O2);
+		expect(manager.run(mod, *f));
+		expect(f->verify());
+
+		expect(count(*f, opcode::CALL) == 0_ul);
+
+		// a * a is computed once, before the loop
+		const ir::DominatorTree dominator_tree{*f};
+		const auto loops = ir::find_loops(*f, dominator_tree);
+		expect((loops.size() == 1_ul) >> fatal);
+		for (const auto id: loops.front().blocks)
+		{
+			for (const auto value: f->block(id).instructions) { expect(f->value(value).op != opcode::MUL); }
+		}
+		expect(count(*f, opcode::MUL) == 1_ul);
+
+		for (const auto& statistics: manager.statistics()) { expect(statistics.runs >= 1_ul); }
+	};
+
+	"escape_analysis"_test = [&]
+	{
+		using gal::gsl::ast::Structure;
+		using gal::gsl::ast::TypeDeclaration;
+
+		const auto point = gal::gsl::memory::make_shared<Structure>("point");
+		expect(point->register_field("x", gal::gsl::memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::INT)));
+		expect(point->register_field("y", gal::gsl::memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::INT)));
+
+		ir::Module mod{"test"};
+		{
+			// get_x(p) = p.x
+			const auto get_x = mod.create_function("get_x", 1, type::INT);
+			ir::Builder builder{*get_x};
+			builder.ret(builder.load_field(builder.argument(0, type::STRUCTURE), 0, type::INT));
+		}
+
+		// p = point{}; p.x = a; if (a < 0) { p.x = -a; } p.y = 2; return get_x(p) + p.y;
+		const auto f = mod.create_function("f", 1, type::INT);
+		ir::Builder builder{*f};
+		const auto a = builder.argument(0, type::INT);
+		const auto p = builder.alloc(*point);
+		builder.store_field(p, 0, a);
+		const auto negative = builder.create_block();
+		const auto merge = builder.create_block();
+		builder.branch(builder.binary(opcode::LESS, a, builder.constant(std::int32_t{0})), negative, merge);
+
+		builder.set_insert_point(negative);
+		builder.store_field(p, 0, builder.unary(opcode::NEG, a));
+		builder.jump(merge);
+
+		builder.set_insert_point(merge);
+		builder.store_field(p, 1, builder.constant(std::int32_t{2}));
+		const ir::value_id arguments[]{p};
+		builder.ret(builder.binary(opcode::ADD, builder.call("get_x", arguments, type::INT), builder.load_field(p, 1, type::INT)));
+		expect(f->verify());
+
+		// the record is passed to a call, it escapes until the call is inlined
+		auto escape_only = ir::PassManager{};
+		escape_only.add(ir::make_escape_analysis());
+		expect(!escape_only.run(mod, *f));
+		expect(count(*f, opcode::ALLOC) == 1_ul);
+
+		auto manager = ir::PassManager::create(ir::optimization_level::O2);
+		expect(manager.run(mod, *f));
+		expect(f->verify());
+
+		expect(count(*f, opcode::ALLOC) == 0_ul);
+		expect(count(*f, opcode::FRAME_ALLOC) == 0_ul);
+		expect(count(*f, opcode::LOAD_FIELD) == 0_ul);
+		expect(count(*f, opcode::STORE_FIELD) == 0_ul);
+		// p.x depends on the branch
+		expect(count(*f, opcode::PHI) == 1_ul);
+	};
+
+	"escape_analysis_frame"_test = [&]
+	{
+		using gal::gsl::ast::Structure;
+		using gal::gsl::ast::TypeDeclaration;
+
+		const auto record = gal::gsl::memory::make_shared<Structure>("record");
+		expect(record->register_field("value", gal::gsl::memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::DOUBLE)));
+
+		ir::Module mod{"test"};
+		const auto f = mod.create_function("f", 0, type::BOOLEAN);
+		ir::Builder builder{*f};
+		const auto lhs = builder.alloc(*record);
+		const auto rhs = builder.alloc(*record);
+		const auto escaped = builder.alloc(*record);
+		builder.store_global("global", escaped);
+		builder.ret(builder.binary(opcode::EQUAL, lhs, rhs));
+
+		auto manager = ir::PassManager{};
+		manager.add(ir::make_escape_analysis());
+		expect(manager.run(mod, *f));
+
+		expect(count(*f, opcode::ALLOC) == 1_ul);
+		expect(count(*f, opcode::FRAME_ALLOC) == 2_ul);
+		expect(f->get_frame_size() == 16_ul);
+	};
+
+	"escape_analysis_pointer_fields"_test = [&]
+	{
+		using gal::gsl::ast::Structure;
+		using gal::gsl::ast::TypeDeclaration;
+
+		const auto named = gal::gsl::memory::make_shared<Structure>("named");
+		expect(named->register_field("name", gal::gsl::memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::STRING)));
+		// the string is nested
+		const auto wrapper = gal::gsl::memory::make_shared<Structure>("wrapper");
+		expect(wrapper->register_field("inner", gal::gsl::memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::STRUCTURE, named.get())));
+
+		ir::Module mod{"test"};
+		const auto f = mod.create_function("f", 0, type::BOOLEAN);
+		ir::Builder builder{*f};
+		// compared by identity, never outlive the call, would be in the frame without their strings
+		const auto lhs = builder.alloc(*named);
+		const auto rhs = builder.alloc(*wrapper);
+		builder.ret(builder.binary(opcode::EQUAL, lhs, rhs));
+
+		auto manager = ir::PassManager{};
+		manager.add(ir::make_escape_analysis());
+		expect(!manager.run(mod, *f));
+
+		// the collector does not scan the frame
+		expect(count(*f, opcode::ALLOC) == 2_ul);
+		expect(count(*f, opcode::FRAME_ALLOC) == 0_ul);
+		expect(f->get_frame_size() == 0_ul);
+	};
+
+	"escape_analysis_interior_pointer"_test = [&]
+	{
+		using gal::gsl::ast::Structure;
+		using gal::gsl::ast::TypeDeclaration;
+
+		const auto inner = gal::gsl::memory::make_shared<Structure>("inner");
+		expect(inner->register_field("x", gal::gsl::memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::INT)));
+		const auto outer = gal::gsl::memory::make_shared<Structure>("outer");
+		expect(outer->register_field("i", gal::gsl::memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::STRUCTURE, inner.get())));
+
+		ir::Module mod{"test"};
+		{
+			const auto use = mod.create_function("use", 1, type::VOID);
+			ir::Builder builder{*use};
+			(void)builder.argument(0, *inner);
+			builder.ret();
+		}
+
+		// o = outer{}; <leak o.i>
+		const auto make = [&](const std::string_view name, const type return_type, const auto& leak)
+		{
+			const auto f = mod.create_function(name, 0, return_type);
+			ir::Builder builder{*f};
+			const auto o = builder.alloc(*outer);
+			leak(builder, builder.load_field(o, 0, type::STRUCTURE));
+			expect(f->verify());
+			return f;
+		};
+
+		const auto returned = make("returned", type::STRUCTURE, [](ir::Builder& builder, const ir::value_id i) { builder.ret(i); });
+		const auto stored = make(
+				"stored",
+				type::VOID,
+				[](ir::Builder& builder, const ir::value_id i)
+				{
+					builder.store_global("global", i);
+					builder.ret();
+				});
+		const auto passed = make(
+				"passed",
+				type::VOID,
+				[](ir::Builder& builder, const ir::value_id i)
+				{
+					const ir::value_id arguments[]{i};
+					(void)builder.call("use", arguments, type::VOID);
+					builder.ret();
+				});
+		// o.i.x, the pointer never leaves the function
+		const auto read = make("read", type::INT, [](ir::Builder& builder, const ir::value_id i) { builder.ret(builder.load_field(i, 0, type::INT)); });
+
+		auto manager = ir::PassManager{};
+		manager.add(ir::make_escape_analysis());
+
+		for (const auto& f: {returned, stored, passed})
+		{
+			expect(!manager.run(mod, *f));
+			expect(count(*f, opcode::ALLOC) == 1_ul);
+			expect(count(*f, opcode::FRAME_ALLOC) == 0_ul);
+		}
+
+		expect(manager.run(mod, *read));
+		expect(count(*read, opcode::ALLOC) == 0_ul);
+		expect(count(*read, opcode::FRAME_ALLOC) == 1_ul);
+	};
+
+	"type_check"_test = [&]
+	{
+		using gal::gsl::ast::Structure;
+		using gal::gsl::ast::TypeDeclaration;
+
+		const auto sample = gal::gsl::memory::make_shared<Structure>("sample");
+		expect(sample->register_field("count", gal::gsl::memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::INT)));
+		expect(sample->register_field("weight", gal::gsl::memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::DOUBLE)));
+
+		ir::Module mod{"test"};
+		{
+			// f(s) = s.count + s.weight
+			const auto f = mod.create_function("f", 1, type::DOUBLE);
+			ir::Builder builder{*f};
+			const auto s = builder.argument(0, *sample);
+			const auto count_field = builder.load_field(s, 0);
+			const auto weight_field = builder.load_field(s, 1);
+			const auto sum = builder.binary(opcode::ADD, count_field, weight_field);
+			builder.ret(sum);
+
+			const auto result = ir::check_types(mod, *f);
+			expect(result.success());
+			expect(result.changed);
+			expect(f->verify());
+
+			expect(f->value(count_field).type == type::INT);
+			expect(f->value(sum).type == type::DOUBLE);
+			expect(count(*f, opcode::CONVERT) == 1_ul);
+			expect(ir::specialize(*f, f->value(sum)) == ir::specialized_opcode::ADD_F64);
+			expect(ir::specialize(*f, f->value(f->value(sum).operands[0])) == ir::specialized_opcode::CONVERT_I32_TO_F64);
+			expect(ir::specialize(*f, f->value(weight_field)) == ir::specialized_opcode::LOAD_FIELD_OFFSET);
+			expect(ir::field_offset(f->value(weight_field)) == sample->get_fields()[1].offset);
+
+			// nothing left to do
+			expect(!ir::check_types(mod, *f).changed);
+		}
+		{
+			// g(a) = if (a) 1 else 2, a is not a boolean
+			const auto g = mod.create_function("g", 1, type::INT);
+			ir::Builder builder{*g};
+			const auto if_true = builder.create_block();
+			const auto if_false = builder.create_block();
+			const auto branch = builder.branch(builder.argument(0, type::INT), if_true, if_false);
+			builder.set_insert_point(if_true);
+			builder.ret(builder.constant(std::int32_t{1}));
+			builder.set_insert_point(if_false);
+			builder.ret(builder.constant(std::int32_t{2}));
+
+			const auto result = ir::check_types(mod, *g);
+			expect(!result.success());
+			expect(result.errors.size() == 1_ul);
+			expect(result.errors.front().value == branch);
+		}
+	};
+
+	"bounds_check_elimination"_test = [&]
+	{
+		using gal::gsl::ast::Structure;
+		using gal::gsl::ast::TypeDeclaration;
+
+		const auto samples = gal::gsl::memory::make_shared<Structure>("samples");
+		expect(samples->register_field("count", gal::gsl::memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::INT)));
+		expect(samples->register_field("values", gal::gsl::memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::DOUBLE, nullptr, TypeDeclaration::dimension_container_type{2, 4})));
+
+		const auto in_loop = [](const ir::Function& function)
+		{
+			std::size_t total = 0;
+			const ir::DominatorTree dominator_tree{function};
+			for (const auto& loop: ir::find_loops(function, dominator_tree))
+			{
+				for (const auto id: loop.blocks)
+				{
+					for (const auto value: function.block(id).instructions) { total += function.value(value).op == opcode::CHECK_BOUNDS; }
+				}
+			}
+			return total;
+		};
+
+		ir::Module mod{"test"};
+		{
+			// for (v: samples.values) { v += 1; } return samples.values[7];
+			const auto f = mod.create_function("increment", 1, type::DOUBLE);
+			ir::Builder builder{*f};
+			const auto object = builder.argument(0, *samples);
+			builder.for_each_element(
+					*samples,
+					1,
+					[&](const ir::value_id i)
+					{
+						builder.store_element(object, 1, i, builder.binary(opcode::ADD, builder.load_element(object, 1, i), builder.constant(1.0)));
+					});
+			builder.ret(builder.load_element(object, 1, builder.constant(std::int32_t{7})));
+			expect(f->verify());
+
+			const auto result = ir::check_types(mod, *f);
+			expect(result.success() >> fatal);
+
+			// the extent is the one of the whole array
+			for (const auto id: f->reverse_post_order())
+			{
+				for (const auto value: f->block(id).instructions)
+				{
+					if (const auto& instruction = f->value(value);
+						instruction.op == opcode::CHECK_BOUNDS)
+					{
+						expect(instruction.index == 8_ul);
+						expect(ir::specialize(*f, instruction) == ir::specialized_opcode::CHECK_BOUNDS);
+					}
+					else if (instruction.op == opcode::LOAD_ELEMENT)
+					{
+						expect(ir::specialize(*f, instruction) == ir::specialized_opcode::LOAD_ELEMENT_OFFSET);
+						expect(ir::element_size(instruction) == sizeof(double));
+					}
+				}
+			}
+			expect(count(*f, opcode::CHECK_BOUNDS) == 3_ul);
+
+			auto manager = ir::PassManager{};
+			manager.add(ir::make_bounds_check_elimination());
+			expect(manager.run(mod, *f));
+			expect(f->verify());
+
+			// 0 <= i < 8 in the loop, 7 after it
+			expect(count(*f, opcode::CHECK_BOUNDS) == 0_ul);
+			expect(count(*f, opcode::LOAD_ELEMENT) == 2_ul);
+			expect(count(*f, opcode::STORE_ELEMENT) == 1_ul);
+		}
+		{
+			// for (i = 0; i < n; i += 1) { samples.values[i] = 0; samples.values[i] = 1; } return samples.values[8];
+			const auto f = mod.create_function("fill", 2, type::DOUBLE);
+			ir::Builder builder{*f};
+			const auto object = builder.argument(0, *samples);
+			const auto n = builder.argument(1, type::INT);
+			(void)builder.loop(
+					builder.constant(std::int32_t{0}),
+					n,
+					[&](const ir::value_id i)
+					{
+						builder.store_element(object, 1, i, builder.constant(0.0));
+						builder.store_element(object, 1, i, builder.constant(1.0));
+					});
+			const auto outside = builder.load_element(object, 1, builder.constant(std::int32_t{8}));
+			builder.ret(outside);
+			expect(ir::check_types(mod, *f).success() >> fatal);
+			expect(count(*f, opcode::CHECK_BOUNDS) == 3_ul);
+
+			auto manager = ir::PassManager::create(ir::optimization_level::O2);
+			expect(manager.run(mod, *f));
+			expect(f->verify());
+
+			// the second check of i is redundant, the first is hoisted: n - 1 is checked once before the loop
+			expect(in_loop(*f) == 0_ul);
+			expect(count(*f, opcode::CHECK_BOUNDS) == 2_ul);
+			// out of range, still checked
+			expect(f->value(f->value(outside).operands[1]).op == opcode::CHECK_BOUNDS);
+		}
+		{
+			// for (i = 0; i < n; i += 1) { if (i < 8) { values[i] = 0; } }, the check is not executed on every iteration
+			const auto f = mod.create_function("guarded", 2, type::VOID);
+			ir::Builder builder{*f};
+			const auto object = builder.argument(0, *samples);
+			const auto n = builder.argument(1, type::INT);
+			(void)builder.loop(
+					builder.constant(std::int32_t{0}),
+					n,
+					[&](const ir::value_id i)
+					{
+						const auto store = builder.create_block();
+						const auto next = builder.create_block();
+						builder.branch(builder.binary(opcode::LESS, i, builder.constant(std::int32_t{8})), store, next);
+						builder.set_insert_point(store);
+						builder.store_element(object, 1, i, builder.constant(0.0));
+						builder.jump(next);
+						builder.set_insert_point(next);
+					});
+			builder.ret();
+			expect(ir::check_types(mod, *f).success() >> fatal);
+
+			auto manager = ir::PassManager{};
+			manager.add(ir::make_bounds_check_elimination());
+			expect(manager.run(mod, *f));
+			expect(f->verify());
+			expect(count(*f, opcode::CHECK_BOUNDS) == 0_ul);
+		}
+		{
+			// for (i = 0; i < n; i += 1) { if (c) { values[i] = 0; } }, neither proven nor hoisted
+			const auto f = mod.create_function("conditional", 3, type::VOID);
+			ir::Builder builder{*f};
+			const auto object = builder.argument(0, *samples);
+			const auto n = builder.argument(1, type::INT);
+			const auto c = builder.argument(2, type::BOOLEAN);
+			(void)builder.loop(
+					builder.constant(std::int32_t{0}),
+					n,
+					[&](const ir::value_id i)
+					{
+						const auto store = builder.create_block();
+						const auto next = builder.create_block();
+						builder.branch(c, store, next);
+						builder.set_insert_point(store);
+						builder.store_element(object, 1, i, builder.constant(0.0));
+						builder.jump(next);
+						builder.set_insert_point(next);
+					});
+			builder.ret();
+			expect(ir::check_types(mod, *f).success() >> fatal);
+
+			auto manager = ir::PassManager{};
+			manager.add(ir::make_bounds_check_elimination());
+			expect(!manager.run(mod, *f));
+			expect(in_loop(*f) == 1_ul);
+		}
+	};
+
+	"superinstruction"_test = [&]
+	{
+		using gal::gsl::ast::Structure;
+		using gal::gsl::ast::TypeDeclaration;
+		using ir::specialized_opcode;
+
+		const auto range = gal::gsl::memory::make_shared<Structure>("range");
+		expect(range->register_field("end", gal::gsl::memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::INT)));
+
+		ir::Module mod{"test"};
+		// i = 0; while (i < r.end) { i += 1; } return i;
+		const auto f = mod.create_function("f", 1, type::INT);
+		ir::Builder builder{*f};
+		const auto r = builder.argument(0, *range);
+		const auto zero = builder.constant(std::int32_t{0});
+		const auto header = builder.create_block();
+		const auto body = builder.create_block();
+		const auto exit = builder.create_block();
+		builder.jump(header);
+
+		builder.set_insert_point(header);
+		const auto i = builder.phi(type::INT);
+		const auto end = builder.load_field(r, 0);
+		const auto condition = builder.binary(opcode::LESS, i, end);
+		const auto branch = builder.branch(condition, body, exit);
+
+		builder.set_insert_point(body);
+		const auto next = builder.binary(opcode::ADD, i, builder.constant(std::int32_t{1}));
+		builder.jump(header);
+
+		builder.set_insert_point(exit);
+		builder.ret(i);
+
+		builder.add_incoming(i, zero, ir::Function::entry());
+		builder.add_incoming(i, next, body);
+		expect(f->verify());
+		expect(ir::check_types(mod, *f).success() >> fatal);
+
+		ir::OpcodeSequenceProfile profile{};
+		profile.record(mod);
+
+		// the loop header counts 8 times
+		const ir::superinstruction_pattern compare_branch{{specialized_opcode::LOAD_FIELD_OFFSET, specialized_opcode::LESS_I32, specialized_opcode::BRANCH}, 3};
+		const auto sequences = profile.sequences();
+		const auto it = std::ranges::find(sequences, compare_branch, &ir::OpcodeSequenceProfile::entry::sequence);
+		expect((it != sequences.end()) >> fatal);
+		expect(static_cast<std::size_t>(it->count) == 8_ul);
+
+		const auto selected = profile.select(1);
+		expect((selected.size() == 1_ul) >> fatal);
+		expect(selected.front() == compare_branch);
+
+		const auto blocks = ir::fuse_superinstructions(*f);
+		const auto header_block = std::ranges::find(blocks, header, &ir::dispatch_block::id);
+		expect((header_block != blocks.end()) >> fatal);
+
+		// phi, then load + compare + branch
+		expect((header_block->dispatches.size() == 2_ul) >> fatal);
+		const auto& fused = header_block->dispatches[1];
+		expect(fused.superinstruction != ir::dispatch::no_superinstruction);
+		expect(ir::superinstructions[fused.superinstruction] == compare_branch);
+		expect(fused.length == 3_ul);
+		expect(fused.values[0] == end);
+		expect(fused.values[2] == branch);
+
+		// the constant and the increment, the sum only feeds the phi
+		const auto body_block = std::ranges::find(blocks, body, &ir::dispatch_block::id);
+		expect((body_block != blocks.end()) >> fatal);
+		expect(body_block->dispatches.size() == 2_ul);
+	};
+};
@@ -0,0 +1,221 @@
+#include <boost/ut.hpp>
+#include <gsl/logger/async.hpp>
+
+#ifndef GSL_NO_LOGGER
+
+#include <spdlog/sinks/base_sink.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace boost::ut;
+
+namespace
+{
+	// collect the raw messages, optionally holding the writer until released
+	class CaptureSink final : public spdlog::sinks::base_sink<std::mutex>
+	{
+	public:
+		std::vector<std::string> messages;
+
+		std::mutex hold_mutex;
+		std::condition_variable hold_condition;
+		bool hold = false;
+		std::atomic<bool> holding{false};
+
+		auto release() -> void
+		{
+			{
+				std::scoped_lock lock{hold_mutex};
+				hold = false;
+			}
+			hold_condition.notify_all();
+		}
+
+	protected:
+		auto sink_it_(const spdlog::details::log_msg& msg) -> void override
+		{
+			messages.emplace_back(msg.payload.data(), msg.payload.size());
+
+			std::unique_lock lock{hold_mutex};
+			if (hold)
+			{
+				holding.store(true);
+				hold_condition.wait(lock, [this] { return !hold; });
+			}
+		}
+
+		auto flush_() -> void override {}
+	};
+
+	// install a capturing default logger for the scope of a test
+	class Capture
+	{
+		std::shared_ptr<spdlog::logger> previous_;
+
+	public:
+		std::shared_ptr<CaptureSink> sink;
+
+		Capture()
+			: previous_{spdlog::default_logger()},
+			sink{std::make_shared<CaptureSink>()}
+		{
+			auto logger = std::make_shared<spdlog::logger>("capture", sink);
+			logger->set_level(spdlog::level::trace);
+			spdlog::set_default_logger(std::move(logger));
+		}
+
+		Capture(const Capture&) = delete;
+		auto operator=(const Capture&) -> Capture& = delete;
+
+		~Capture() { spdlog::set_default_logger(previous_); }
+
+		// only safe once the sink thread is stopped
+		[[nodiscard]] auto messages() const -> const std::vector<std::string>& { return sink->messages; }
+	};
+}
+
+suite test_logger = []
+{
+	namespace logger = gal::gsl::logger;
+
+	"compile_time_level"_test = []
+	{
+		static_assert(!logger::is_enabled_v<logger::level::OFF>);
+		static_assert(logger::is_enabled_v<logger::level::CRITICAL> == (GSL_LOGGER_LEVEL <= 5));
+		static_assert(logger::is_enabled_v<logger::level::TRACE> == (GSL_LOGGER_LEVEL <= 0));
+
+		const Capture capture{};
+
+		// arguments of a compiled out call are not evaluated
+		int evaluated = 0;
+		GSL_LOGGER_TRACE("trace {}", ++evaluated);
+		GSL_LOGGER_CRITICAL("critical {}", ++evaluated);
+
+		const auto expected = static_cast<int>(GSL_LOGGER_LEVEL <= 0) + static_cast<int>(GSL_LOGGER_LEVEL <= 5);
+		expect(evaluated == expected);
+		expect(capture.messages().size() == static_cast<std::size_t>(expected));
+	};
+
+	"async_order"_test = []
+	{
+		const Capture capture{};
+
+		constexpr int count = 10'000;
+
+		expect(logger::start_async({.queue_size = 64, .policy = logger::overflow_policy::BLOCK}));
+		expect(not logger::start_async());
+		for (int i = 0; i < count; ++i) { logger::critical("message {}", i); }
+		// everything queued is written before returning
+		logger::stop_async();
+
+		expect(logger::dropped_messages() == 0);
+		expect((capture.messages().size() == static_cast<std::size_t>(count)) >> fatal);
+		for (int i = 0; i < count; ++i) { expect(capture.messages()[static_cast<std::size_t>(i)] == "message " + std::to_string(i)); }
+	};
+
+	"async_runtime_level"_test = []
+	{
+		const Capture capture{};
+		spdlog::set_level(spdlog::level::warn);
+
+		expect(logger::start_async({.queue_size = 4, .policy = logger::overflow_policy::DISCARD}));
+
+		// filtered out before formatting, none of them takes a slot
+		for (int i = 0; i < 32; ++i) { logger::info("info {}", i); }
+		logger::warn("warn");
+		logger::stop_async();
+
+		expect(logger::dropped_messages() == 0);
+		expect((capture.messages().size() == 1) >> fatal);
+		expect(capture.messages().front() == "warn");
+	};
+
+	"async_discard"_test = []
+	{
+		const Capture capture{};
+		capture.sink->hold = true;
+
+		constexpr std::size_t queue_size = 4;
+		constexpr std::size_t count = 32;
+
+		expect(logger::start_async({.queue_size = queue_size, .policy = logger::overflow_policy::DISCARD}));
+
+		// the sink thread takes the first message and stays in the sink, nothing else leaves the queue
+		logger::critical("first");
+		while (!capture.sink->holding.load()) { std::this_thread::yield(); }
+
+		for (std::size_t i = 0; i < count; ++i) { logger::critical("message {}", i); }
+		const auto dropped = logger::dropped_messages();
+
+		capture.sink->release();
+		logger::stop_async();
+
+		expect(dropped >= count - queue_size);
+		expect(dropped == logger::dropped_messages());
+		expect(capture.messages().size() + dropped == count + 1);
+		expect(capture.messages().front() == "first");
+	};
+
+	"async_restart"_test = []
+	{
+		const Capture capture{};
+
+		expect(logger::start_async());
+		logger::critical("first");
+		logger::stop_async();
+		// stopping twice is fine
+		logger::stop_async();
+
+		logger::critical("synchronous");
+
+		expect(logger::start_async({.queue_size = 16, .policy = logger::overflow_policy::DISCARD}));
+		expect(logger::dropped_messages() == 0);
+		logger::critical("second");
+		logger::stop_async();
+
+		expect((capture.messages().size() == 3) >> fatal);
+		expect(capture.messages()[0] == "first");
+		expect(capture.messages()[1] == "synchronous");
+		expect(capture.messages()[2] == "second");
+	};
+
+	"async_stop_with_producers"_test = []
+	{
+		const Capture capture{};
+
+		constexpr int threads = 4;
+		constexpr int count = 5'000;
+
+		std::atomic<int> finished{0};
+		{
+			std::vector<std::jthread> workers{};
+			for (int t = 0; t < threads; ++t)
+			{
+				workers.emplace_back(
+						[&finished]
+						{
+							for (int i = 0; i < count; ++i) { logger::critical("message {}", i); }
+							finished.fetch_add(1);
+						});
+			}
+
+			// producers keep running across stops and restarts (with a new queue each time), nothing is lost
+			while (finished.load() != threads)
+			{
+				(void)logger::start_async({.queue_size = 8, .policy = logger::overflow_policy::BLOCK});
+				std::this_thread::yield();
+				logger::stop_async();
+			}
+		}
+
+		expect(capture.messages().size() == static_cast<std::size_t>(threads * count));
+	};
+};
+
+#endif
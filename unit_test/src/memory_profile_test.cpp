@@ -0,0 +1,62 @@
+#include <boost/ut.hpp>
+#include <gsl/memory/profile.hpp>
+#include <gsl/memory/raw.hpp>
+
+#include <string_view>
+
+using namespace boost::ut;
+
+suite test_memory_profile = []
+{
+	#ifdef GSL_MEMORY_PROFILE
+	namespace memory = gal::gsl::memory;
+	namespace profile = memory::profile;
+
+	"live_bytes"_test = []
+	{
+		profile::clear();
+		const auto interval = profile::get_sample_interval();
+		// every allocation
+		profile::set_sample_interval(1);
+
+		// the first allocation of the thread only starts the countdown
+		memory::deallocate(memory::allocate_without_collect(64));
+
+		constexpr std::size_t count = 16;
+		void* objects[count];
+		for (auto& object: objects) { object = memory::allocate_without_collect(1024); }
+
+		const auto find_site = []
+		{
+			for (const auto& site: profile::report())
+			{
+				if (std::string_view{site.file}.ends_with("memory_profile_test.cpp")) { return site; }
+			}
+			return profile::allocation_site{};
+		};
+
+		const auto site = find_site();
+		expect(site.live_objects == count);
+		expect(site.live_bytes >= count * 1024);
+
+		for (auto* object: objects) { memory::deallocate(object); }
+		expect(find_site().live_bytes == 0_ul);
+		expect(find_site().allocated_objects == count);
+
+		profile::set_sample_interval(interval);
+		profile::clear();
+	};
+	#else
+	namespace memory = gal::gsl::memory;
+	namespace profile = memory::profile;
+
+	// see .github/workflows/unit_test.yml for a build with GAL_SCRIPT_LANG_ENABLE_MEMORY_PROFILE
+	"compiled_out"_test = []
+	{
+		// allocating does not go through the profile, nothing is written
+		memory::deallocate(memory::allocate_without_collect(64));
+		profile::clear();
+		expect(not profile::dump("gsl_memory_profile_test.tsv"));
+	};
+	#endif
+};
@@ -0,0 +1,180 @@
+#include <boost/ut.hpp>
+#include <gsl/frontend/module_registry.hpp>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <latch>
+#include <string_view>
+#include <thread>
+
+using namespace boost::ut;
+
+suite test_module_registry = []
+{
+	namespace ast = gal::gsl::ast;
+	namespace frontend = gal::gsl::frontend;
+
+	const auto directory = std::filesystem::temp_directory_path() / "gsl_module_registry_test";
+	std::filesystem::create_directories(directory);
+
+	const auto write = [&directory](const std::string_view name, const std::string_view source)
+	{
+		std::ofstream file{directory / (std::string{name} + ".gsl")};
+		file << source;
+	};
+
+	write("base", "module base;\n\nstruct point\n{\n\tfloat x\n\tfloat y\n}\n");
+	write("shapes", "module shapes;\nimport base;\n\nglobal mut point origin;\n");
+	write("app", "module app;\nimport shapes;\nimport base;\n\nglobal mut point cursor;\n");
+	// a cycle through the types of their globals
+	write("ping", "module ping;\nimport pong;\n\nglobal mut pong_type p;\n");
+	write("pong", "module pong;\nimport ping;\n\nglobal mut ping_type p;\n");
+	// the same cycle, but a long way to the global using the other side, both threads are likely in the middle of their load at once
+	const auto write_slow = [&write](const std::string_view name, const std::string_view other)
+	{
+		std::string source{};
+		source.append("module ").append(name).append(";\nimport ").append(other).append(";\n\n");
+		for (int i = 0; i < 2'000; ++i) { source.append("struct s").append(std::to_string(i)).append("\n{\n\tint x\n}\n"); }
+		source.append("global mut ").append(other).append("_type p;\n");
+		write(name, source);
+	};
+	write_slow("tick", "tock");
+	write_slow("tock", "tick");
+	// the file of `misnamed` declares another module
+	write("misnamed", "module renamed;\n");
+	write("broken", "module broken;\nimport misnamed;\n");
+
+	const gal::gsl::container::vector<gal::gsl::string::string> search_paths{gal::gsl::string::string{directory.string().c_str()}};
+
+	"header"_test = [&directory]
+	{
+		const auto header = frontend::parse_module_header((directory / "app.gsl").string().c_str());
+		expect(header.name == std::string_view{"app"});
+		expect(header.imports.size() == 2_ul);
+		expect(header.imports[0] == std::string_view{"shapes"});
+		expect(header.imports[1] == std::string_view{"base"});
+	};
+
+	"lazy"_test = [&search_paths]
+	{
+		frontend::ModuleRegistry registry{search_paths};
+
+		const auto shapes = registry.load("shapes");
+		expect(shapes != nullptr);
+		// point is not declared by shapes, looking it up loaded base
+		const auto base = registry.get("base");
+		expect(base != nullptr);
+		expect(shapes->get_global("origin")->get_type()->owner() == base->get_structure("point").get());
+		// loaded once
+		expect(registry.load("shapes") == shapes);
+
+		expect(registry.find_structure(*shapes, "point") != nullptr);
+		// nothing imports app
+		expect(registry.get("app") == nullptr);
+	};
+
+	"levels"_test = [&search_paths]
+	{
+		frontend::ModuleRegistry registry{search_paths};
+
+		const ast::symbol_name roots[]{ast::symbol_name{"app"}};
+		const auto levels = registry.dependency_levels(roots);
+		expect(levels.size() == 3_ul);
+		expect(levels[0].size() == 1_ul and levels[0][0] == std::string_view{"base"});
+		expect(levels[1].size() == 1_ul and levels[1][0] == std::string_view{"shapes"});
+		expect(levels[2].size() == 1_ul and levels[2][0] == std::string_view{"app"});
+
+		const auto modules = registry.load_all(roots, 4);
+		expect(modules.size() == 3_ul);
+		expect(modules.back()->get_name() == std::string_view{"app"});
+		expect(registry.get("base") == modules.front());
+	};
+
+	"cycle"_test = [&search_paths]
+	{
+		frontend::ModuleRegistry registry{search_paths};
+
+		const ast::symbol_name roots[]{ast::symbol_name{"ping"}};
+		std::size_t cycle = 0;
+		try { (void)registry.dependency_levels(roots); }
+		catch (const frontend::import_cycle_error& error) { cycle = error.cycle().size(); }
+		expect(cycle == 3_ul);
+
+		// pong looks ping_type up in ping, which is still being loaded
+		cycle = 0;
+		try { (void)registry.load("ping"); }
+		catch (const frontend::import_cycle_error& error) { cycle = error.cycle().size(); }
+		expect(cycle == 3_ul);
+		expect(registry.get("ping") == nullptr);
+	};
+
+	"cycle_across_threads"_test = [&search_paths]
+	{
+		// each thread starts from one side of the cycle, the one reaching the other side loaded by the other thread fails instead of waiting
+		for (int round = 0; round < 16; ++round)
+		{
+			frontend::ModuleRegistry registry{search_paths};
+
+			std::latch start{2};
+			std::atomic<int> cycles{0};
+			{
+				const auto run = [&](const std::string_view name)
+				{
+					start.arrive_and_wait();
+					try { (void)registry.load(name); }
+					catch (const frontend::import_cycle_error& error)
+					{
+						if (error.cycle().size() == 3) { cycles.fetch_add(1); }
+					}
+				};
+
+				std::jthread tick{run, "tick"};
+				std::jthread tock{run, "tock"};
+			}
+
+			expect(cycles.load() == 2_i);
+			expect(registry.get("tick") == nullptr);
+			expect(registry.get("tock") == nullptr);
+		}
+	};
+
+	"module_error"_test = [&search_paths]
+	{
+		frontend::ModuleRegistry registry{search_paths};
+
+		bool thrown = false;
+		try { (void)registry.load("missing"); }
+		catch (const frontend::module_error& error)
+		{
+			thrown = true;
+			expect(error.reason() == frontend::module_error::reason_type::NOT_FOUND);
+			expect(error.name() == std::string_view{"missing"});
+			expect(error.path().empty());
+		}
+		expect(thrown);
+
+		thrown = false;
+		try { (void)registry.load("misnamed"); }
+		catch (const frontend::module_error& error)
+		{
+			thrown = true;
+			expect(error.reason() == frontend::module_error::reason_type::NAME_MISMATCH);
+			expect(error.name() == std::string_view{"misnamed"});
+			expect(error.path() == std::string_view{registry.resolve("misnamed")});
+		}
+		expect(thrown);
+
+		const ast::symbol_name roots[]{ast::symbol_name{"broken"}};
+		thrown = false;
+		try { (void)registry.dependency_levels(roots); }
+		catch (const frontend::module_error& error)
+		{
+			thrown = true;
+			expect(error.reason() == frontend::module_error::reason_type::NAME_MISMATCH);
+			expect(error.name() == std::string_view{"misnamed"});
+		}
+		expect(thrown);
+	};
+};
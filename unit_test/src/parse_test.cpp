@@ -0,0 +1,185 @@
+#include <boost/ut.hpp>
+#include <gsl/frontend/parse.hpp>
+#include <gsl/frontend/embedded.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+using namespace boost::ut;
+
+namespace
+{
+	namespace embedded = gal::gsl::frontend::embedded;
+
+	// accepted by both parsers, literal initializers included
+	constexpr embedded::fixed_string shared_source{R"(
+module shared;
+
+struct vec3 { float x float y float z }
+
+@soa
+struct particle
+{
+	boolean alive
+	vec3 position
+	double mass
+	vec3[4] trail
+}
+
+global mut int count;
+global mut vec3 origin;
+global double gravity = -9.81;
+global float scale = 2.;
+global string unit = "m/s";
+global int limit = 100;
+global boolean enabled = true;
+global int alias = limit;
+global string separators = "; { } # \"";
+
+fn step(particle p, double dt = 1, string tag = "step") -> void { p }
+fn brace() -> string
+{
+	# a } in a comment
+	"a } in a string"
+}
+fn alive() -> int { count }
+)"};
+}
+
+suite test_parse = []
+{
+	namespace frontend = gal::gsl::frontend;
+
+	const auto directory = std::filesystem::temp_directory_path() / "gsl_parse_test";
+	std::filesystem::create_directories(directory);
+
+	const auto write = [&directory](const std::string_view name, const std::string_view source) -> std::string
+	{
+		const auto path = directory / (std::string{name} + ".gsl");
+		std::ofstream file{path};
+		file << source;
+		return path.string();
+	};
+
+	"streaming_imports"_test = [&write]
+	{
+		const auto path = write("imports", "module imports;\nimport a;\nimport b;\n\nstruct point\n{\n\tfloat x\n\tfloat y\n}\n");
+
+		const auto mod = frontend::parse_file_streaming(path.c_str(), {});
+		expect((mod->get_imports().size() == 2_ul) >> fatal);
+		expect(mod->get_imports()[0] == std::string_view{"a"});
+		expect(mod->get_imports()[1] == std::string_view{"b"});
+		expect(mod->get_structure("point") != nullptr);
+	};
+
+	"streaming_late_import"_test = [&write]
+	{
+		// rejected by parse_file as well
+		const auto path = write("late_import", "module late_import;\nimport a;\n\nstruct point\n{\n\tfloat x\n\tfloat y\n}\n\nimport b;\n");
+
+		bool thrown = false;
+		try { (void)frontend::parse_file_streaming(path.c_str(), {}); }
+		catch (const std::runtime_error&) { thrown = true; }
+		expect(thrown);
+
+		thrown = false;
+		try { (void)frontend::parse_file(path.c_str()); }
+		catch (const std::runtime_error&) { thrown = true; }
+		expect(thrown);
+	};
+
+	"streaming_strings"_test = [&write]
+	{
+		// none of ; { } # of the strings ends a declaration
+		const auto path = write(
+				"streaming_strings",
+				"module streaming_strings;\nglobal string separators = \"; { } # \\\"\";\n\n"
+				"fn brace() -> string { \"} # ;\" }\n\n"
+				"struct point\n{\n\tfloat x\n\tfloat y\n}\n");
+
+		const auto mod = frontend::parse_file_streaming(path.c_str(), {});
+		expect(mod->get_global("separators") != nullptr);
+		expect((mod->get_function("brace") != nullptr) >> fatal);
+		expect(mod->get_function("brace")->get_function_body() != nullptr);
+		expect(mod->get_structure("point") != nullptr);
+	};
+
+	"lazy_body_strings"_test = [&write]
+	{
+		const auto path = write(
+				"lazy_body_strings",
+				"module lazy_body_strings;\n\n"
+				"fn brace() -> string\n{\n\t# a } in a comment\n\t\"a } # { in a \\\"string\\\"\"\n}\n\n"
+				"fn after() -> string { \"{\" }\n");
+
+		const auto mod = frontend::parse_file(path.c_str(), {.lazy_function_bodies = true});
+		expect((mod->get_function("brace") != nullptr and mod->get_function("after") != nullptr) >> fatal);
+		expect(mod->get_function("brace")->get_function_body() != nullptr);
+		expect(mod->get_function("after")->get_function_body() != nullptr);
+	};
+
+	"same_as_embedded"_test = [&write]
+	{
+		namespace ast = gal::gsl::ast;
+
+		constexpr auto view = embedded::embed<shared_source>.view();
+		const auto embedded_module = embedded::instantiate(view);
+		const auto parsed_module = frontend::parse_file(write("shared", shared_source.view()).c_str(), {.lazy_function_bodies = true});
+		expect((embedded_module != nullptr and parsed_module != nullptr) >> fatal);
+
+		expect(parsed_module->get_name() == embedded_module->get_name());
+
+		const auto same_type = [](const ast::TypeDeclaration& lhs, const ast::TypeDeclaration& rhs) -> bool
+		{
+			if (lhs.type() != rhs.type() || lhs.size() != rhs.size()) { return false; }
+			if (!std::ranges::equal(lhs.dimensions(), rhs.dimensions())) { return false; }
+			return (lhs.owner() == nullptr) == (rhs.owner() == nullptr) && (lhs.owner() == nullptr || lhs.owner()->get_name() == rhs.owner()->get_name());
+		};
+
+		for (const auto& structure: view.structures)
+		{
+			const auto lhs = embedded_module->get_structure(structure.name);
+			const auto rhs = parsed_module->get_structure(structure.name);
+			expect((lhs != nullptr and rhs != nullptr) >> fatal);
+
+			expect(lhs->get_layout() == rhs->get_layout());
+			expect(lhs->get_size() == rhs->get_size());
+			expect(lhs->get_alignment() == rhs->get_alignment());
+			for (const auto& field: view.fields_of(structure))
+			{
+				const auto* l = lhs->get_field(field.name);
+				const auto* r = rhs->get_field(field.name);
+				expect((l != nullptr and r != nullptr) >> fatal);
+				expect(l->offset == r->offset);
+				expect(same_type(*l->variable.type, *r->variable.type));
+			}
+		}
+
+		for (const auto& global: view.globals)
+		{
+			const auto lhs = embedded_module->get_global(global.name);
+			const auto rhs = parsed_module->get_global(global.name);
+			expect((lhs != nullptr and rhs != nullptr) >> fatal);
+			expect(same_type(*lhs->get_type(), *rhs->get_type()));
+		}
+
+		for (const auto& function: view.functions)
+		{
+			const auto lhs = embedded_module->get_function(function.name);
+			const auto rhs = parsed_module->get_function(function.name);
+			expect((lhs != nullptr and rhs != nullptr) >> fatal);
+			expect(same_type(*lhs->get_return_type(), *rhs->get_return_type()));
+			expect((lhs->get_arguments().size() == rhs->get_arguments().size()) >> fatal);
+			for (std::size_t i = 0; i < lhs->get_arguments().size(); ++i)
+			{
+				expect(lhs->get_arguments()[i]->get_name() == rhs->get_arguments()[i]->get_name());
+				expect(same_type(*lhs->get_arguments()[i]->get_type(), *rhs->get_arguments()[i]->get_type()));
+			}
+		}
+	};
+};
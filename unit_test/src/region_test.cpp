@@ -0,0 +1,65 @@
+#include <boost/ut.hpp>
+#include <gsl/memory/region.hpp>
+#include <vector>
+
+using namespace boost::ut;
+
+suite test_region = []
+{
+	namespace memory = gal::gsl::memory;
+
+	"bump"_test = []
+	{
+		memory::Region region{1024};
+
+		auto* a = region.make<std::int32_t>(42);
+		auto* b = static_cast<std::byte*>(region.allocate(100, 64));
+		expect(*a == 42_i);
+		expect(reinterpret_cast<std::uintptr_t>(b) % 64 == 0_ul);
+		expect(region.contains(a) and region.contains(b));
+		expect(region.bytes_allocated() == 104_ul);
+
+		// bigger than a chunk
+		auto* big = region.allocate(4096);
+		expect(region.contains(big));
+		const auto reserved = region.bytes_reserved();
+
+		// the chunks are reused after a reset
+		region.reset();
+		expect(region.bytes_allocated() == 0_ul);
+		for (int i = 0; i < 4; ++i) { (void)region.allocate(1000); }
+		expect(region.bytes_reserved() == reserved);
+
+		region.release();
+		expect(region.bytes_reserved() == 0_ul);
+		expect(not region.contains(a));
+	};
+
+	"scope"_test = []
+	{
+		expect(memory::Region::current() == nullptr);
+
+		memory::Region region;
+		{
+			memory::RegionScope scope{region};
+			expect(memory::Region::current() == &region);
+
+			std::vector<int, memory::RegionAllocator<int>> values;
+			for (int i = 0; i < 1000; ++i) { values.push_back(i); }
+			expect(region.contains(values.data()));
+			expect(values[999] == 999_i);
+
+			memory::Region inner;
+			{
+				memory::RegionScope inner_scope{inner};
+				expect(memory::Region::current() == &inner);
+			}
+			expect(memory::Region::current() == &region);
+		}
+		expect(memory::Region::current() == nullptr);
+
+		// no region ==> the collector
+		const memory::RegionAllocator<int> allocator{};
+		expect(allocator.get_region() == nullptr);
+	};
+};
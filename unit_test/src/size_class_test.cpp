@@ -0,0 +1,95 @@
+#include <boost/ut.hpp>
+#include <gsl/memory/size_class.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace boost::ut;
+
+suite test_size_class = []
+{
+	namespace size_class = gal::gsl::memory::size_class;
+
+	"classes"_test = []
+	{
+		std::size_t wrong = 0;
+		for (std::size_t size = 0; size <= size_class::max_size; ++size)
+		{
+			const auto index = size_class::class_of(size);
+			// the smallest class holding the size
+			wrong += index >= size_class::class_count || size_class::size_of_class(index) < size || (index != 0 && size_class::size_of_class(index - 1) >= size);
+		}
+		expect(wrong == 0_ul);
+	};
+
+	"allocate"_test = []
+	{
+		std::vector<void*> objects{};
+		for (std::size_t size = 1; size <= 2 * size_class::max_size; size = size * 3 / 2 + 1)
+		{
+			auto* object = size_class::allocate_zeroed(size);
+			expect(object != nullptr);
+			expect(reinterpret_cast<std::uintptr_t>(object) % size_class::alignment == 0_ul);
+			expect(size_class::usable_size(object) >= size);
+			expect(static_cast<unsigned char*>(object)[size - 1] == 0);
+			std::memset(object, 0xab, size);
+			objects.push_back(object);
+		}
+
+		for (auto* object: objects) { size_class::deallocate(object); }
+
+		// the last freed block of a class is reused first
+		auto* first = size_class::allocate(100);
+		size_class::deallocate(first);
+		expect(size_class::allocate(100) == first);
+		size_class::deallocate(first);
+	};
+
+	"reallocate"_test = []
+	{
+		auto* object = static_cast<char*>(size_class::allocate(20));
+		std::memcpy(object, "0123456789", 10);
+
+		// same class
+		expect(size_class::reallocate(object, 30) == object);
+
+		auto* grown = static_cast<char*>(size_class::reallocate(object, 1000));
+		expect(std::memcmp(grown, "0123456789", 10) == 0_i);
+
+		auto* large = static_cast<char*>(size_class::reallocate(grown, size_class::max_size * 4));
+		expect(std::memcmp(large, "0123456789", 10) == 0_i);
+		expect(size_class::usable_size(large) == size_class::max_size * 4);
+		size_class::deallocate(large);
+	};
+
+	"threads"_test = []
+	{
+		// allocated by one thread, freed by another
+		constexpr std::size_t count = 10'000;
+		std::vector<void*> objects(count);
+		std::jthread{[&objects] { for (auto& object: objects) { object = size_class::allocate(48); } }}.join();
+
+		std::atomic<std::size_t> failed{0};
+		{
+			std::vector<std::jthread> workers{};
+			for (std::size_t t = 0; t < 4; ++t)
+			{
+				workers.emplace_back(
+						[&objects, &failed, t]
+						{
+							for (std::size_t i = t; i < count; i += 4) { size_class::deallocate(objects[i]); }
+							for (std::size_t i = 0; i < count; ++i)
+							{
+								auto* object = size_class::allocate(48);
+								failed += object == nullptr;
+								size_class::deallocate(object);
+							}
+						});
+			}
+		}
+		expect(failed.load() == 0_ul);
+	};
+};
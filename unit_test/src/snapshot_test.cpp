@@ -0,0 +1,171 @@
+#include <boost/ut.hpp>
+#include <gsl/backend/snapshot.hpp>
+#include <gsl/type/host_structure.hpp>
+#include <gsl/type/string.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+
+using namespace boost::ut;
+
+namespace
+{
+	struct host_record
+	{
+		// not bound
+		void* handle;
+		std::int32_t id;
+		gal::gsl::type::String name;
+		double weight;
+	};
+}
+
+suite test_snapshot = []
+{
+	namespace ast = gal::gsl::ast;
+	using ast::Structure;
+	using ast::TypeDeclaration;
+	namespace memory = gal::gsl::memory;
+
+	const auto make_module = []
+	{
+		auto mod = memory::make_shared<ast::Module>(std::string_view{"snapshot"});
+
+		// declared in the reverse order of their dependencies, the snapshot reorders them
+		const auto [line_inserted, line] = mod->register_structure(std::string_view{"line"});
+		const auto [point_inserted, point] = mod->register_structure(std::string_view{"point"});
+		expect(line_inserted and point_inserted);
+
+		expect(point->register_field("x", memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::FLOAT)));
+		expect(point->register_field("y", memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::FLOAT)));
+		expect(line->register_field("points", memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::STRUCTURE, point.get(), TypeDeclaration::dimension_container_type{2})));
+		expect(line->register_field("name", memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::STRING)));
+		line->set_layout(Structure::layout_type::STRUCTURE_OF_ARRAYS);
+
+		const auto [global_inserted, global] = mod->register_global_mutable(std::string_view{"origin"});
+		expect(global_inserted);
+		global->set_type(memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::STRUCTURE, point.get()));
+
+		const auto [function_inserted, function] = mod->register_function(std::string_view{"length"});
+		expect(function_inserted);
+		function->set_return_type(memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::DOUBLE));
+		ast::Function::arguments_container_type arguments{};
+		arguments.push_back(memory::make_shared<ast::Variable>(std::string_view{"l"}, memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::STRUCTURE, line.get())));
+		function->set_arguments(std::move(arguments));
+
+		return mod;
+	};
+
+	"round_trip"_test = [&]
+	{
+		const auto original = make_module();
+		(void)gal::gsl::type::String::intern("a string interned before the snapshot");
+
+		const auto image = ast::make_snapshot(*original);
+		const auto restored = ast::restore_snapshot(image);
+		expect(restored != nullptr);
+
+		expect(restored->get_name() == original->get_name());
+		expect(restored->get_structures().size() == 2_ul);
+
+		const auto line = restored->get_structure("line");
+		expect(line != nullptr);
+		expect(line->get_layout() == Structure::layout_type::STRUCTURE_OF_ARRAYS);
+		expect(line->get_size() == original->get_structure("line")->get_size());
+		expect(line->get_fields()[0].variable.type->owner() == restored->get_structure("point").get());
+		expect(line->get_fields()[0].variable.type->dimensions().size() == 1_ul);
+
+		expect(restored->get_global("origin")->get_type()->owner() == restored->get_structure("point").get());
+
+		const auto function = restored->get_function("length");
+		expect(function != nullptr);
+		expect(function->get_return_type()->type() == TypeDeclaration::variable_type::DOUBLE);
+		expect(function->get_arguments().size() == 1_ul);
+		expect(function->get_arguments()[0]->get_name() == std::string_view{"l"});
+	};
+
+	"host_structure"_test = []
+	{
+		auto original = memory::make_shared<ast::Module>(std::string_view{"host"});
+		(void)gal::gsl::type::bind_structure<host_record>(*original, "host_record")
+				.field<&host_record::id>("id")
+				.field<&host_record::name>("name")
+				.field<&host_record::weight>("weight");
+
+		const auto restored = ast::restore_snapshot(ast::make_snapshot(*original));
+		expect((restored != nullptr) >> fatal);
+
+		// the layout of the host type, not the natural one of the fields
+		const auto record = restored->get_structure("host_record");
+		expect((record != nullptr) >> fatal);
+		expect(record->get_size() == sizeof(host_record));
+		expect(record->get_alignment() == alignof(host_record));
+		expect(record->get_field("id")->offset == offsetof(host_record, id));
+		expect(record->get_field("name")->offset == offsetof(host_record, name));
+		expect(record->get_field("weight")->offset == offsetof(host_record, weight));
+		expect(record->pointer_bitmap() == original->get_structure("host_record")->pointer_bitmap());
+	};
+
+	"imported_structure"_test = []
+	{
+		auto geometry = memory::make_shared<ast::Module>(std::string_view{"geometry"});
+		const auto point = geometry->register_structure(std::string_view{"point"}).second;
+		expect(point->register_field("x", memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::FLOAT)));
+
+		auto scene = memory::make_shared<ast::Module>(std::string_view{"scene"});
+		expect(scene->register_import(ast::symbol_name{"geometry"}));
+		const auto segment = scene->register_structure(std::string_view{"segment"}).second;
+		expect(segment->register_field("points", memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::STRUCTURE, point.get(), TypeDeclaration::dimension_container_type{2})));
+		const auto global = scene->register_global_mutable(std::string_view{"origin"}).second;
+		global->set_type(memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::STRUCTURE, point.get()));
+
+		const auto image = ast::make_snapshot(*scene);
+
+		// not resolved ==> not restored
+		expect(ast::restore_snapshot(image) == nullptr);
+
+		const auto resolver = [&geometry](const ast::Module& mod, const ast::symbol_name_view name) -> ast::structure_type
+		{
+			if (const auto own = mod.get_structure(name)) { return own; }
+			return mod.get_imports().front() == std::string_view{"geometry"} ? geometry->get_structure(name) : nullptr;
+		};
+		const auto restored = ast::restore_snapshot(image, resolver);
+		expect((restored != nullptr) >> fatal);
+
+		// the structure of geometry itself, not a copy
+		expect(restored->get_structures().size() == 1_ul);
+		expect(restored->get_structure("segment")->get_fields()[0].variable.type->owner() == point.get());
+		expect(restored->get_global("origin")->get_type()->owner() == point.get());
+
+		// shadowed by a structure of its own, could not be resolved again
+		(void)scene->register_structure(std::string_view{"point"});
+		bool thrown = false;
+		try { (void)ast::make_snapshot(*scene); }
+		catch (const std::invalid_argument&) { thrown = true; }
+		expect(thrown);
+	};
+
+	"corrupted"_test = [&]
+	{
+		auto image = ast::make_snapshot(*make_module());
+		image.back() = static_cast<std::byte>(~static_cast<unsigned char>(image.back()));
+		expect(ast::restore_snapshot(image) == nullptr);
+
+		image.resize(image.size() / 2);
+		expect(ast::restore_snapshot(image) == nullptr);
+	};
+
+	"file"_test = [&]
+	{
+		constexpr std::string_view filename{"gsl_snapshot_test.image"};
+
+		expect(ast::save_snapshot(*make_module(), filename));
+		const auto restored = ast::load_snapshot(filename);
+		expect(restored != nullptr);
+		expect(restored->has_function("length"));
+		(void)std::remove(filename.data());
+
+		expect(ast::load_snapshot(filename) == nullptr);
+	};
+};
@@ -0,0 +1,58 @@
+#include <boost/ut.hpp>
+#include <gsl/type/string.hpp>
+
+using namespace boost::ut;
+
+suite test_string = []
+{
+	using gal::gsl::type::String;
+	using gal::gsl::type::Value;
+
+	"small"_test = []
+	{
+		const String empty{};
+		expect(empty.empty() and empty.is_small());
+
+		const String key{"content-type"};
+		expect(key.is_small());
+		expect(key == std::string_view{"content-type"});
+		expect(key.substr(8) == std::string_view{"type"});
+		expect(key == String{"content-"} + String{"type"});
+
+		const auto value = Value{}.as<String>();
+		expect(value == empty);
+		expect(gal::gsl::type::ValueCaster<String>::from(key).as<String>() == key);
+	};
+
+	"slice"_test = []
+	{
+		const String header{"accept-encoding: gzip, deflate, br"};
+		expect(not header.is_small());
+
+		// shares the buffer
+		const auto value = header.substr(17);
+		expect(value.get_category() == String::category::HEAP);
+		expect(value.data() == header.data() + 17);
+		expect(value == std::string_view{"gzip, deflate, br"});
+
+		const auto name = header.substr(0, 15);
+		expect(name.is_small());
+		expect(name == std::string_view{"accept-encoding"});
+
+		expect(name + String{": "} + value == header);
+		expect(header.hash() == String{header.view()}.hash());
+	};
+
+	"intern"_test = []
+	{
+		const auto lhs = String::intern("x-forwarded-for-client");
+		const auto rhs = String::intern(String{"x-forwarded-for-client"}.view());
+		expect(lhs.is_interned() and rhs.is_interned());
+		expect(lhs.data() == rhs.data());
+		expect(lhs == rhs);
+		expect(lhs == String{"x-forwarded-for-client"});
+		expect(lhs != String::intern("x-forwarded-for-server"));
+
+		expect(String::intern("short").is_small());
+	};
+};
@@ -0,0 +1,78 @@
+#include <boost/ut.hpp>
+#include <gsl/type/structure_array.hpp>
+
+using namespace boost::ut;
+
+suite test_structure_array = []
+{
+	namespace gsl = gal::gsl;
+
+	using gsl::ast::TypeDeclaration;
+	using gsl::ast::Structure;
+
+	"layout"_test = [](const Structure::layout_type layout)
+	{
+		const auto structure = gsl::memory::make_shared<Structure>("record");
+		expect(structure->register_field("id", gsl::memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::INT)));
+		expect(structure->register_field("weight", gsl::memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::DOUBLE)));
+		expect(structure->register_field("score", gsl::memory::make_shared<TypeDeclaration>(TypeDeclaration::variable_type::FLOAT)));
+		structure->set_layout(layout);
+
+		expect(structure->get_size() == 24_ul);
+		expect(structure->get_field("weight")->offset == 8_ul);
+
+		gsl::type::StructureArray array{structure, 1000};
+
+		const auto score = array.field<float>("score");
+		const auto weight = array.field<double>("weight");
+		for (std::size_t i = 0; i < array.size(); ++i)
+		{
+			score[i] = static_cast<float>(i);
+			weight[i] = 2;
+		}
+
+		expect(score.is_contiguous() == (layout == Structure::layout_type::STRUCTURE_OF_ARRAYS));
+		expect(gsl::type::sum<float>(score) == 499500._f);
+		expect(gsl::type::max<float>(score) == 999._f);
+		expect(gsl::type::dot<double>(weight, weight) == 4000._d);
+		expect(array.field<std::int32_t>("id")[999] == 0_i);
+	} | std::vector{Structure::layout_type::ARRAY_OF_STRUCTURES, Structure::layout_type::STRUCTURE_OF_ARRAYS};
+
+	"pointer_bitmap"_test = []
+	{
+		using variable_type = TypeDeclaration::variable_type;
+
+		const auto inner = gsl::memory::make_shared<Structure>("inner");
+		expect(inner->register_field("id", gsl::memory::make_shared<TypeDeclaration>(variable_type::INT)));
+		expect(inner->register_field("name", gsl::memory::make_shared<TypeDeclaration>(variable_type::STRING)));
+
+		const auto outer = gsl::memory::make_shared<Structure>("outer");
+		expect(outer->register_field("weight", gsl::memory::make_shared<TypeDeclaration>(variable_type::DOUBLE)));
+		expect(outer->register_field("children", gsl::memory::make_shared<TypeDeclaration>(variable_type::STRUCTURE, inner.get(), TypeDeclaration::dimension_container_type{2})));
+		expect(outer->register_field("best", gsl::memory::make_shared<TypeDeclaration>(variable_type::STRUCTURE, inner.get())));
+		expect(outer->contains_pointer());
+
+		const auto bitmap = outer->pointer_bitmap();
+		const auto is_marked = [&](const std::size_t offset)
+		{
+			const auto word = offset / sizeof(void*);
+			return ((bitmap[word / gsl::memory::bits_per_bitmap_word] >> (word % gsl::memory::bits_per_bitmap_word)) & 1) != 0;
+		};
+
+		const auto children = outer->get_field("children")->offset;
+		const auto name = inner->get_field("name")->offset;
+		expect(!is_marked(outer->get_field("weight")->offset));
+		expect(!is_marked(children + inner->get_field("id")->offset));
+		expect(!is_marked(children + inner->get_size() + inner->get_field("id")->offset));
+		expect(is_marked(children + name));
+		expect(is_marked(children + inner->get_size() + name));
+		expect(is_marked(outer->get_field("best")->offset + name));
+
+		for (const auto layout: {Structure::layout_type::ARRAY_OF_STRUCTURES, Structure::layout_type::STRUCTURE_OF_ARRAYS})
+		{
+			outer->set_layout(layout);
+			gsl::type::StructureArray array{outer, 100};
+			expect(array.field<double>("weight")[99] == 0._d);
+		}
+	};
+};
@@ -0,0 +1,158 @@
+#include <boost/ut.hpp>
+#include <gsl/debug/trace.hpp>
+
+#ifdef GSL_TRACE
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace boost::ut;
+
+namespace
+{
+	// the fields of one line of the dump (one event per line)
+	struct event
+	{
+		std::string name;
+		std::string category;
+		std::string phase;
+		std::string tid;
+		std::string detail;
+		// nanoseconds
+		long long begin;
+		long long end;
+	};
+
+	// the raw value of a field, strings unquoted (none of the tested ones is escaped)
+	[[nodiscard]] auto field_of(const std::string_view line, const std::string_view key) -> std::string
+	{
+		const auto pattern = std::string{"\""} + std::string{key} + "\":";
+		const auto at = line.find(pattern);
+		if (at == std::string_view::npos) { return {}; }
+
+		auto value = line.substr(at + pattern.size());
+		if (value.starts_with('"'))
+		{
+			value.remove_prefix(1);
+			return std::string{value.substr(0, value.find('"'))};
+		}
+		return std::string{value.substr(0, value.find_first_of(",}"))};
+	}
+
+	[[nodiscard]] auto nanoseconds_of(const std::string& microseconds) -> long long { return std::llround(std::stod(microseconds) * 1000.0); }
+
+	[[nodiscard]] auto read_events(const std::filesystem::path& path) -> std::vector<event>
+	{
+		std::vector<event> events{};
+
+		std::ifstream file{path};
+		for (std::string line; std::getline(file, line);)
+		{
+			if (!line.starts_with(R"({"name":)")) { continue; }
+
+			const auto begin = nanoseconds_of(field_of(line, "ts"));
+			events.push_back({
+					.name = field_of(line, "name"),
+					.category = field_of(line, "cat"),
+					.phase = field_of(line, "ph"),
+					.tid = field_of(line, "tid"),
+					.detail = field_of(line, "detail"),
+					.begin = begin,
+					.end = begin + nanoseconds_of(field_of(line, "dur"))});
+		}
+		return events;
+	}
+}
+
+suite test_trace = []
+{
+	namespace trace = gal::gsl::debug::trace;
+
+	"nested_spans"_test = []
+	{
+		trace::clear();
+
+		// longer than what an event keeps
+		const std::string long_detail(trace::detail_size + 16, 'd');
+
+		{
+			std::vector<std::jthread> workers{};
+			for (int t = 0; t < 2; ++t)
+			{
+				workers.emplace_back(
+						[&long_detail, t]
+						{
+							const auto detail = "thread " + std::to_string(t);
+							GSL_TRACE_SCOPE_DETAIL("outer", "test", detail);
+							{
+								GSL_TRACE_SCOPE_DETAIL("inner", "test", long_detail);
+							}
+						});
+			}
+		}
+
+		const auto path = std::filesystem::temp_directory_path() / "gsl_trace_test.json";
+		expect(trace::dump(path.string()) >> fatal);
+
+		const auto events = read_events(path);
+		expect((events.size() == 4_ul) >> fatal);
+
+		for (int t = 0; t < 2; ++t)
+		{
+			const auto detail = "thread " + std::to_string(t);
+			const auto outer = std::ranges::find(events, detail, &event::detail);
+			expect((outer != events.end()) >> fatal);
+			expect(outer->name == std::string_view{"outer"});
+
+			// the inner span of the same thread, recorded (closed) first
+			const auto inner = std::ranges::find_if(events, [&outer](const event& e) { return e.name == "inner" && e.tid == outer->tid; });
+			expect((inner != events.end()) >> fatal);
+			expect(inner < outer);
+			expect(inner->detail == std::string_view{long_detail}.substr(0, trace::detail_size));
+			expect(inner->begin >= outer->begin and inner->end <= outer->end);
+		}
+
+		for (const auto& e: events)
+		{
+			expect(e.phase == std::string_view{"X"});
+			expect(e.category == std::string_view{"test"});
+			expect(not e.tid.empty());
+		}
+		// a buffer (and a tid) per thread
+		expect(std::ranges::count(events, events.front().tid, &event::tid) == 2);
+
+		trace::clear();
+		expect(trace::dump(path.string()));
+		expect(read_events(path).empty());
+	};
+};
+
+#else
+
+using namespace boost::ut;
+
+suite test_trace = []
+{
+	namespace trace = gal::gsl::debug::trace;
+
+	// see .github/workflows/unit_test.yml for a build with GAL_SCRIPT_LANG_ENABLE_TRACE
+	"compiled_out"_test = []
+	{
+		int evaluated = 0;
+		GSL_TRACE_SCOPE("outer", "test");
+		GSL_TRACE_SCOPE_DETAIL("inner", "test", (++evaluated, "detail"));
+
+		// the spans and their arguments are gone, nothing is written
+		expect(evaluated == 0_i);
+		trace::clear();
+		expect(not trace::dump("gsl_trace_test.json"));
+	};
+};
+
+#endif
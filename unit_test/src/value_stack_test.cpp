@@ -0,0 +1,124 @@
+#include <boost/ut.hpp>
+#include <gsl/type/function.hpp>
+#include <gsl/type/value_stack.hpp>
+
+#include <algorithm>
+
+using namespace boost::ut;
+
+namespace
+{
+	using gal::gsl::type::Value;
+	using gal::gsl::type::ValueStack;
+
+	auto add(const int a, const int b) -> int { return a + b; }
+
+	// frame of fib: n | outgoing n - 1 | outgoing n - 2
+	auto fib(ValueStack& stack) -> void
+	{
+		const auto n = stack[0].as<int>();
+		if (n < 2)
+		{
+			stack.ret(Value{stack[0]});
+			return;
+		}
+
+		stack[1] = gal::gsl::type::ValueCaster<int>::from(n - 1);
+		expect(stack.call(1, 1, 3) >> fatal);
+		fib(stack);
+
+		stack[2] = gal::gsl::type::ValueCaster<int>::from(n - 2);
+		expect(stack.call(2, 1, 3) >> fatal);
+		fib(stack);
+
+		stack.ret(gal::gsl::type::ValueCaster<int>::from(stack[1].as<int>() + stack[2].as<int>()));
+	}
+
+	// frame of sum: n | accumulator, tail calls itself
+	auto sum(ValueStack& stack) -> std::size_t
+	{
+		std::size_t max_depth = 0;
+		while (true)
+		{
+			max_depth = std::ranges::max(max_depth, stack.depth());
+
+			const auto n = stack[0].as<int>();
+			const auto accumulator = stack[1].as<int>();
+			if (n == 0)
+			{
+				stack.ret(Value{stack[1]});
+				return max_depth;
+			}
+
+			stack[0] = gal::gsl::type::ValueCaster<int>::from(n - 1);
+			stack[1] = gal::gsl::type::ValueCaster<int>::from(accumulator + n);
+			expect(stack.tail_call(0, 2, 2) >> fatal);
+		}
+	}
+}
+
+suite test_value_stack = []
+{
+	using gal::gsl::type::ValueCaster;
+
+	"call"_test = []
+	{
+		ValueStack stack{8};
+
+		expect(stack.resize(1));
+		stack[0] = ValueCaster<int>::from(20);
+		expect(stack.call(0, 1, 3));
+		fib(stack);
+		expect(stack.depth() == 1_ul);
+		expect(stack[0].as<int>() == 6765_i);
+
+		// the deepest frame was reached once, the second run does not grow
+		const auto capacity = stack.capacity();
+		expect(stack.call(0, 1, 3));
+		stack[0] = ValueCaster<int>::from(20);
+		fib(stack);
+		expect(stack.capacity() == capacity);
+	};
+
+	"tail_call"_test = []
+	{
+		ValueStack stack{4};
+
+		expect(stack.resize(2));
+		stack[0] = ValueCaster<int>::from(10'000);
+		stack[1] = ValueCaster<int>::from(0);
+		expect(stack.call(0, 2, 2));
+		expect(sum(stack) == 2_ul);
+		expect(stack[0].as<int>() == 50'005'000_i);
+		expect(stack.capacity() == 4_ul);
+	};
+
+	"overflow"_test = []
+	{
+		ValueStack stack{4, 16, 4};
+
+		expect(stack.resize(1));
+		expect(not stack.call(0, 1, 17));
+		expect(stack.depth() == 1_ul);
+
+		expect(stack.call(0, 1, 1));
+		expect(stack.call(0, 1, 1));
+		expect(stack.call(0, 1, 1));
+		// max depth
+		expect(not stack.call(0, 1, 1));
+		expect(stack.depth() == 4_ul);
+	};
+
+	"builtin"_test = []
+	{
+		ValueStack stack{};
+		constexpr auto function = gal::gsl::type::BuiltinFunction::make<&add>();
+
+		expect(stack.resize(3));
+		stack[1] = ValueCaster<int>::from(40);
+		stack[2] = ValueCaster<int>::from(2);
+		stack.call_builtin(1, function);
+		expect(stack[1].as<int>() == 42_i);
+		expect(stack.depth() == 1_ul);
+	};
+};